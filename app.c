@@ -98,6 +98,66 @@ sl_power_manager_on_isr_exit_t app_sleep_on_isr_exit(void)
 
 
 
+/**************************************************************************//**
+ * Periodic wakeup/energy accounting, event handler profile, button, EM token,
+ * sampler and coalescer reports, piggyback on the LETIMER0 UF wakeup.
+ *****************************************************************************/
+static void report_if_due(sl_bt_msg_t *evt)
+{
+  if (evt->data.evt_system_external_signal.extsignals & evtLETIMER0_UF)
+    {
+      energyReportIfDue();
+      bleDispatchReportIfDue();
+      buttonsReportIfDue();
+      emTokenReportIfDue();
+      samplerReportIfDue();
+      coalesceReportIfDue();
+    }
+} // report_if_due()
+
+/**************************************************************************//**
+ * Handlers of this device's role, subscribed once its role is known.
+ *****************************************************************************/
+static void subscribe_role_handlers(void)
+{
+  ble_subscribe_handlers();
+  bleDispatchSubscribe(sl_bt_evt_system_external_signal_id, report_if_due, "report_if_due");
+  bleDispatchSubscribe(sl_bt_evt_system_external_signal_id, powerProfileOnSignal, "powerProfileOnSignal"); // before the LETIMER0 delays start
+#if BUILD_INCLUDES_BLE_SERVER
+  if (IsServerDevice())
+    {
+      // sequence through states driven by events
+      bleDispatchSubscribe(sl_bt_evt_system_external_signal_id, temperature_state_machine, "temperature_state_machine");
+    }
+#endif
+#if BUILD_INCLUDES_BLE_CLIENT
+  if (IsClientDevice())
+    {
+      bleDispatchSubscribe(sl_bt_evt_connection_opened_id, discovery_state_machine, "discovery_state_machine");
+      bleDispatchSubscribe(sl_bt_evt_gatt_procedure_completed_id, discovery_state_machine, "discovery_state_machine");
+      bleDispatchSubscribe(sl_bt_evt_gatt_characteristic_value_id, discovery_state_machine, "discovery_state_machine");
+    }
+#endif
+} // subscribe_role_handlers()
+
+/**************************************************************************//**
+ * Boot: the role and server address are in NVM, which can only be read from
+ * here. The role's handlers are appended to the boot event's list, so its own
+ * boot handler still runs for this boot event.
+ *****************************************************************************/
+static void on_system_boot(sl_bt_msg_t *evt)
+{
+  (void) evt;
+  roleLoad();
+#if DEVICE_ROLE_RUNTIME
+  subscribe_role_handlers();
+#endif
+} // on_system_boot()
+
+// Held for good with LOWEST_ENERGY_MODE 1, EM2 and EM3 follow the power profile
+static em_token_t lowest_energy_mode_token = EM_TOKEN_LONG_LIVED("LOWEST_ENERGY_MODE", SL_POWER_MANAGER_EM1);
+
+
 /**************************************************************************//**
  * Application Init.
  *****************************************************************************/
@@ -107,9 +167,14 @@ SL_WEAK void app_init(void)
   // This is called once during start-up.
   // Don't call any Bluetooth API functions until after the boot event.
   gpioInit();
+  buttonsInit();
+  energyInit();
+  emTokenInit();
+  coalesceInit();
   displayInit();
   oscInit();
   letimer0Init();
+  samplerInit();
   i2cInit();
   //ble_init();
   NVIC_ClearPendingIRQ(LETIMER0_IRQn);
@@ -122,9 +187,29 @@ SL_WEAK void app_init(void)
   //NVIC_EnableIRQ(I2C0_IRQn);
 
   if(LOWEST_ENERGY_MODE == 1)
-    sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
-  else if (LOWEST_ENERGY_MODE == 2)
-    sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM2);
+    emTokenAcquire(&lowest_energy_mode_token);
+  powerProfileInit();
+
+  // BT stack event handlers, run in this order for each event
+  bleDispatchSubscribe(BLE_DISPATCH_ANY, eventRecorderRecord, "eventRecorderRecord"); // timestamp and payload of every event, for replay
+  bleDispatchSubscribe(BLE_DISPATCH_ANY, bleTraceEvent, "bleTraceEvent"); // timestamp every event and update the connection metrics
+#if BENCH_ENABLE
+  bleDispatchSubscribe(sl_bt_evt_system_boot_id, benchRun, "benchRun"); // before the boot handlers redraw the display
+#endif
+  bleDispatchSubscribe(sl_bt_evt_system_boot_id, on_system_boot, "on_system_boot");
+  // Deferred work (LCD flushes, Si7021 waits) due in this wakeup
+  bleDispatchSubscribe(sl_bt_evt_system_boot_id, coalesceOnSignal, "coalesceOnSignal");
+  bleDispatchSubscribe(sl_bt_evt_system_external_signal_id, coalesceOnSignal, "coalesceOnSignal");
+  // Sampling period lined up with the connection events
+  bleDispatchSubscribe(sl_bt_evt_connection_parameters_id, samplerOnConnection, "samplerOnConnection");
+  bleDispatchSubscribe(sl_bt_evt_connection_closed_id, samplerOnConnection, "samplerOnConnection");
+#if DEVICE_ROLE_RUNTIME
+  // A role written over GATT applies once the writer disconnects
+  bleDispatchSubscribe(sl_bt_evt_gatt_server_attribute_value_id, roleOnAttributeValue, "roleOnAttributeValue");
+  bleDispatchSubscribe(sl_bt_evt_connection_closed_id, roleOnConnectionClosed, "roleOnConnectionClosed");
+#else
+  subscribe_role_handlers();
+#endif
 
 } // app_init()
 
@@ -187,24 +272,8 @@ SL_WEAK void app_process_action(void)
 void sl_bt_on_event(sl_bt_msg_t *evt)
 {
 
-  // Just a trick to hide a compiler warning about unused input parameter evt.
-  (void) evt;
-
-  // For A5 onward:
-  // Some events require responses from our application code,
-  // and don’t necessarily advance our state machines.
-  // For A5 uncomment the next 2 function calls
-  handle_ble_event(evt); // put this code in ble.c/.h
-
- #if DEVICE_IS_BLE_SERVER
-   // sequence through states driven by events
-   temperature_state_machine(evt);    // put this code in scheduler.c/.h
-
- #else
-   discovery_state_machine(evt);
-
- #endif
-
+  // Each module subscribed in app_init() to the events it needs, see src/ble_dispatch.h
+  bleDispatch(evt);
 
 } // sl_bt_on_event()
 
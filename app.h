@@ -67,11 +67,33 @@
 #include "src/i2c.h"
 #include "src/scheduler.h"
 #include "src/ble.h"
+#include "src/energy.h"
+#include "src/ble_trace.h"
+#include "src/gatt_cache.h"
+#include "src/bonding.h"
+#include "src/scan_filter.h"
+#include "src/conn_params.h"
+#include "src/broadcast.h"
+#include "src/link.h"
+#include "src/gatt_batch.h"
+#include "src/gatt_publisher.h"
+#include "src/ble_dispatch.h"
+#include "src/role.h"
+#include "src/buttons.h"
+#include "src/event_recorder.h"
+#include "src/bench.h"
+#include "src/em_token.h"
+#include "src/power_profile.h"
+#include "src/sampler.h"
+#include "src/coalesce.h"
+#include "src/client_values.h"
+#include "src/history.h"
 /*
  * Macros
  */
 
 //To select energy mode comment and un-comment as required L74-77
+//2 and 3 pick the power profile at reset, src/power_profile.h switches between them at run time
 //#define LOWEST_ENERGY_MODE 0
 //#define LOWEST_ENERGY_MODE 1
 #define LOWEST_ENERGY_MODE 2
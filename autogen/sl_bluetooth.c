@@ -28,6 +28,7 @@ static const struct sli_bgapi_class * const bt_class_table[] =
   SL_BT_BGAPI_CLASS(gatt),
   SL_BT_BGAPI_CLASS(gatt_server),
   SL_BT_BGAPI_CLASS(sm),
+  SL_BT_BGAPI_CLASS(nvm),
   NULL
 };
 #if !defined(SL_CATALOG_KERNEL_PRESENT)
@@ -81,6 +81,42 @@
 
 // Custom defines can be placed here before check_config.h is included.
 
+// Crypto path of each primitive: 1 on the CRYPTO peripheral, 0 in the mbedtls C code.
+// The Bluetooth stack pairs with the same mbedtls, the bench build (src/bench.h) times both.
+// Build with -DCRYPTO_ACCEL_AES=0 and so on to override, as the host benchmark does.
+#ifndef CRYPTO_ACCEL_AES
+#define CRYPTO_ACCEL_AES       1
+#endif
+#ifndef CRYPTO_ACCEL_CMAC
+#define CRYPTO_ACCEL_CMAC      1
+#endif
+#ifndef CRYPTO_ACCEL_SHA256
+#define CRYPTO_ACCEL_SHA256    1
+#endif
+#ifndef CRYPTO_ACCEL_ECP
+#define CRYPTO_ACCEL_ECP       1
+#endif
+
+#if !CRYPTO_ACCEL_AES
+#undef MBEDTLS_AES_ALT
+#endif
+#if !CRYPTO_ACCEL_CMAC
+#undef MBEDTLS_CMAC_ALT
+#endif
+#if !CRYPTO_ACCEL_SHA256
+#undef MBEDTLS_SHA256_ALT
+#endif
+#if !CRYPTO_ACCEL_ECP
+#undef MBEDTLS_ECP_INTERNAL_ALT
+#undef ECP_SHORTWEIERSTRASS
+#undef MBEDTLS_ECP_ADD_MIXED_ALT
+#undef MBEDTLS_ECP_DOUBLE_JAC_ALT
+#undef MBEDTLS_ECP_NORMALIZE_JAC_MANY_ALT
+#undef MBEDTLS_ECP_NORMALIZE_JAC_ALT
+#undef MBEDTLS_ECP_RANDOMIZE_JAC_ALT
+#undef MBEDTLS_ECP_NO_FALLBACK
+#endif
+
 #include "mbedtls/config_psa.h"
 
 #include "mbedtls/check_config.h"
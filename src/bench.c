@@ -0,0 +1,535 @@
+/*
+ * File name: bench.c
+ * File description: This file defines the micro-benchmark APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ARM Cortex-M4 Technical Reference Manual, DWT CYCCNT https://developer.arm.com/documentation/100166/0001/Data-Watchpoint-and-Trace-Unit
+ *  [2] Mbed TLS 2.26 API documentation https://tls.mbed.org/api/
+ *  [3] Bluetooth Core Specification v5.2, Vol 3, Part H, 2.2 (f4) and Vol 6, Part E (AES-CCM)
+ */
+
+#include "src/bench.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+#if BENCH_ENABLE
+
+#include "glib.h"
+#include "dmd.h"
+#include "mbedtls/aes.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/ecdh.h"
+#include "mbedtls/cipher.h"
+#include "mbedtls/cmac.h"
+#if defined(MBEDTLS_CCM_C)
+#include "mbedtls/ccm.h"
+#endif
+
+typedef struct
+{
+  const char *name;
+  void      (*run)(void);   // one call
+  uint32_t    samples;
+  uint32_t    batch;        // calls timed together in each sample
+  uint32_t    bytes;        // processed per call, for the throughput, 0 if not a data path
+  const char *path;         // crypto cases: "CRYPTO" peripheral or mbedtls "software"
+} bench_case_t;
+
+// Path each primitive was built with, chosen by the CRYPTO_ACCEL_* switches in config/mbedtls_config.h
+#if defined(MBEDTLS_AES_ALT)
+#define PATH_AES    "CRYPTO"
+#else
+#define PATH_AES    "software"
+#endif
+#if defined(MBEDTLS_CMAC_ALT)
+#define PATH_CMAC   "CRYPTO"
+#else
+#define PATH_CMAC   "software"
+#endif
+#if defined(MBEDTLS_CCM_C) && defined(MBEDTLS_CCM_ALT)
+#define PATH_CCM    "CRYPTO"
+#elif defined(MBEDTLS_CCM_C)
+#define PATH_CCM    "software"
+#else
+#define PATH_CCM    PATH_AES      // ble_ccm() below, on mbedtls_aes_crypt_ecb()
+#endif
+#if defined(MBEDTLS_SHA256_ALT)
+#define PATH_SHA256 "CRYPTO"
+#else
+#define PATH_SHA256 "software"
+#endif
+#if defined(MBEDTLS_ECP_INTERNAL_ALT)
+#define PATH_ECP    "CRYPTO"
+#else
+#define PATH_ECP    "software"
+#endif
+
+// Sizes of the pairing and link layer inputs [3]
+#define CMAC_F4_BYTES   (65)      // f4(U, V, X, Z): 32 + 32 + 1 bytes under key X
+#define CCM_PDU_BYTES   (27)      // largest LL data payload without length extension
+#define CCM_NONCE_BYTES (13)
+#define CCM_MIC_BYTES   (4)
+
+// Fixed inputs, every run and every build sees the same data
+static const uint8_t key[16] =
+{
+  0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+static uint8_t block[80];
+static uint8_t digest[32];
+static uint8_t mic[16];
+static const uint8_t nonce[CCM_NONCE_BYTES] =
+{
+  0x00, 0x00, 0x00, 0x00, 0x80, 0x66, 0xa2, 0x33, 0x18, 0x1e, 0x76, 0x2a, 0xbf
+};
+// HTM temperature measurement, flags then 23.45 C as an IEEE-11073 FLOAT
+static const uint8_t htm_value[5] = { 0x00, 0x29, 0x09, 0x00, 0xfe };
+
+static queue_struct_t      queue;
+static GLIB_Context_t      glib;
+static mbedtls_aes_context aes;
+#if defined(MBEDTLS_CCM_C)
+static mbedtls_ccm_context ccm;
+#endif
+static mbedtls_ecp_group   group;
+static mbedtls_mpi         own_private;
+static mbedtls_ecp_point   own_public;
+static mbedtls_mpi         peer_private;
+static mbedtls_ecp_point   peer_public;
+static mbedtls_mpi         shared;
+static uint32_t            rng_state;
+
+static volatile int32_t    sink; // keeps results the compiler could otherwise drop
+
+/*
+ * @brief Deterministic random source for the ECDH cases, so the same keys are
+ *        generated on every run. Not for real keys.
+ * @param ctx, unused
+ * @param output, bytes to fill
+ * @param len, number of bytes
+ * @return 0
+ */
+static int bench_rng(void *ctx, unsigned char *output, size_t len)
+{
+  (void) ctx;
+  for (size_t i = 0; i < len; i++)
+    {
+      // xorshift32
+      rng_state ^= rng_state << 13;
+      rng_state ^= rng_state >> 17;
+      rng_state ^= rng_state << 5;
+      output[i] = (uint8_t) rng_state;
+    }
+  return 0;
+} // bench_rng()
+
+static void run_nothing(void)
+{
+} // run_nothing()
+
+static void run_get_next_event(void)
+{
+  sink = (int32_t) getNextEvent();
+} // run_get_next_event()
+
+static void run_queue(void)
+{
+  uint16_t handle;
+  size_t   len;
+  uint8_t  buffer[sizeof(htm_value)];
+
+  write_queue(&queue, gattdb_temperature_measurement, sizeof(htm_value), (uint8_t *) htm_value);
+  read_queue(&queue, &handle, &len, buffer);
+  sink = (int32_t) len;
+} // run_queue()
+
+#if BUILD_INCLUDES_BLE_CLIENT
+static void run_float_to_int32(void)
+{
+  sink = FLOAT_TO_INT32(htm_value);
+} // run_float_to_int32()
+#endif
+
+static void run_read_temp(void)
+{
+  sink = read_temp_from_si7021();
+} // run_read_temp()
+
+static void run_glib_draw(void)
+{
+  sink = (int32_t) GLIB_drawStringOnLine(&glib, "Bench 23.45 C", DISPLAY_ROW_11, GLIB_ALIGN_CENTER, 0, 0, true);
+} // run_glib_draw()
+
+static void run_memlcd_draw(void)
+{
+  // DMD_updateDisplay() is the sl_memlcd_draw() of the whole frame buffer
+  sink = (int32_t) DMD_updateDisplay();
+} // run_memlcd_draw()
+
+static void run_display_printf(void)
+{
+  displayPrintf(DISPLAY_ROW_11, "Bench %d", (int) sink);
+#if COALESCE_LCD_FLUSHES
+  // displayPrintf() leaves the flush to the coalescer, time it here as before
+  sink = (int32_t) DMD_updateDisplay();
+#endif
+} // run_display_printf()
+
+#if COALESCE_LCD_FLUSHES
+static void run_display_printf_deferred(void)
+{
+  // The part of displayPrintf() that runs in the caller
+  displayPrintf(DISPLAY_ROW_11, "Bench %d", (int) sink);
+} // run_display_printf_deferred()
+#endif
+
+static void run_aes_ecb(void)
+{
+  sink = mbedtls_aes_crypt_ecb(&aes, MBEDTLS_AES_ENCRYPT, block, block);
+} // run_aes_ecb()
+
+#if !defined(MBEDTLS_CCM_C)
+/*
+ * @brief AES-CCM encryption as the BLE link layer does it [3]: 13 byte nonce, 1 byte of
+ *        additional data (the PDU header), 4 byte MIC, CBC-MAC and CTR on the AES block
+ *        cipher. Stands in for mbedtls_ccm_encrypt_and_tag(), MBEDTLS_CCM_C is not in this
+ *        build.
+ * @param header, the additional authenticated data
+ * @param payload, encrypted in place
+ * @param len, payload length, up to 255
+ * @param tag, returns the MIC
+ * @return 0, or the mbedtls_aes_crypt_ecb() error
+ */
+static int ble_ccm(uint8_t header, uint8_t *payload, uint8_t len, uint8_t *tag)
+{
+  uint8_t x[16];
+  uint8_t a[16];
+  uint8_t s[16];
+  int     ret;
+
+  // B0: flags (Adata, M = 4, L = 2), nonce, length
+  x[0] = 0x49;
+  memcpy(&x[1], nonce, CCM_NONCE_BYTES);
+  x[14] = 0;
+  x[15] = len;
+  ret = mbedtls_aes_crypt_ecb(&aes, MBEDTLS_AES_ENCRYPT, x, x);
+  // B1: additional data length and the header
+  x[1] ^= 1;
+  x[2] ^= header;
+  ret |= mbedtls_aes_crypt_ecb(&aes, MBEDTLS_AES_ENCRYPT, x, x);
+  for (uint32_t offset = 0; offset < len; offset += 16)
+    {
+      for (uint32_t i = 0; (i < 16) && ((offset + i) < len); i++)
+        x[i] ^= payload[offset + i];
+      ret |= mbedtls_aes_crypt_ecb(&aes, MBEDTLS_AES_ENCRYPT, x, x);
+    }
+
+  // A_i: flags (L = 2), nonce, counter, A_0 encrypts the MIC
+  a[0] = 0x01;
+  memcpy(&a[1], nonce, CCM_NONCE_BYTES);
+  a[14] = 0;
+  for (uint32_t offset = 0; offset < len; offset += 16)
+    {
+      a[15] = (uint8_t) (1 + offset / 16);
+      ret |= mbedtls_aes_crypt_ecb(&aes, MBEDTLS_AES_ENCRYPT, a, s);
+      for (uint32_t i = 0; (i < 16) && ((offset + i) < len); i++)
+        payload[offset + i] ^= s[i];
+    }
+  a[15] = 0;
+  ret |= mbedtls_aes_crypt_ecb(&aes, MBEDTLS_AES_ENCRYPT, a, s);
+  for (uint32_t i = 0; i < CCM_MIC_BYTES; i++)
+    tag[i] = x[i] ^ s[i];
+  return ret;
+} // ble_ccm()
+#endif
+
+static void run_aes_ccm(void)
+{
+#if defined(MBEDTLS_CCM_C)
+  uint8_t header = 0x02;
+
+  sink = mbedtls_ccm_encrypt_and_tag(&ccm, CCM_PDU_BYTES, nonce, CCM_NONCE_BYTES, &header, 1,
+                                     block, block, mic, CCM_MIC_BYTES);
+#else
+  sink = ble_ccm(0x02, block, CCM_PDU_BYTES, mic);
+#endif
+} // run_aes_ccm()
+
+static void run_aes_cmac(void)
+{
+  sink = mbedtls_cipher_cmac(mbedtls_cipher_info_from_type(MBEDTLS_CIPHER_AES_128_ECB),
+                             key, 128, block, CMAC_F4_BYTES, mic);
+} // run_aes_cmac()
+
+static void run_sha256(void)
+{
+  sink = mbedtls_sha256_ret(block, 64, digest, 0);
+} // run_sha256()
+
+static void run_ecdh_gen_public(void)
+{
+  sink = mbedtls_ecdh_gen_public(&group, &own_private, &own_public, bench_rng, NULL);
+} // run_ecdh_gen_public()
+
+static void run_ecdh_compute_shared(void)
+{
+  sink = mbedtls_ecdh_compute_shared(&group, &shared, &peer_public, &own_private, bench_rng, NULL);
+} // run_ecdh_compute_shared()
+
+static const bench_case_t cases[] =
+{
+  { "getNextEvent",             run_get_next_event,          BENCH_ITERATIONS,      BENCH_BATCH,        0,             NULL },
+  { "write_queue+read_queue",   run_queue,                   BENCH_ITERATIONS,      BENCH_BATCH,        0,             NULL },
+#if BUILD_INCLUDES_BLE_CLIENT
+  { "FLOAT_TO_INT32",           run_float_to_int32,          BENCH_ITERATIONS,      BENCH_BATCH,        0,             NULL },
+#endif
+  { "read_temp_from_si7021",    run_read_temp,               BENCH_ITERATIONS,      BENCH_BATCH,        0,             NULL },
+  { "GLIB_drawStringOnLine",    run_glib_draw,               BENCH_ITERATIONS,      BENCH_BATCH,        0,             NULL },
+  { "sl_memlcd_draw",           run_memlcd_draw,             BENCH_ITERATIONS,      BENCH_BATCH_LCD,    0,             NULL },
+  { "displayPrintf",            run_display_printf,          BENCH_ITERATIONS,      BENCH_BATCH_LCD,    0,             NULL },
+#if COALESCE_LCD_FLUSHES
+  { "displayPrintf_deferred",   run_display_printf_deferred, BENCH_ITERATIONS,      BENCH_BATCH,        0,             NULL },
+#endif
+  { "aes128_ecb_block",         run_aes_ecb,                 BENCH_ITERATIONS,      BENCH_BATCH_CRYPTO, 16,            PATH_AES },
+  { "aes128_ccm_27B",           run_aes_ccm,                 BENCH_ITERATIONS,      BENCH_BATCH_CRYPTO, CCM_PDU_BYTES, PATH_CCM },
+  { "aes128_cmac_65B",          run_aes_cmac,                BENCH_ITERATIONS,      BENCH_BATCH_CRYPTO, CMAC_F4_BYTES, PATH_CMAC },
+  { "sha256_64B",               run_sha256,                  BENCH_ITERATIONS,      BENCH_BATCH_CRYPTO, 64,            PATH_SHA256 },
+  { "ecdh_p256_gen_public",     run_ecdh_gen_public,         BENCH_ITERATIONS_ECDH, 1,                  0,             PATH_ECP },
+  { "ecdh_p256_compute_shared", run_ecdh_compute_shared,     BENCH_ITERATIONS_ECDH, 1,                  0,             PATH_ECP },
+};
+
+/*
+ * @brief Times one case, a batch of calls per sample
+ * @param bench, the case
+ * @param overhead, cycles of an empty sample of the same batch, taken off every sample
+ * @param min, avg, max, return the cycles per sample
+ * @return none
+ */
+static void measure(const bench_case_t *bench, uint32_t overhead,
+                    uint32_t *min, uint32_t *avg, uint32_t *max)
+{
+  uint64_t total = 0;
+  uint32_t start;
+  uint32_t cycles;
+
+  *min = UINT32_MAX;
+  *max = 0;
+  for (uint32_t i = 0; i < bench->samples; i++)
+    {
+      start  = CYCLE_COUNT();
+      for (uint32_t call = 0; call < bench->batch; call++)
+        bench->run();
+      cycles = CYCLE_COUNT() - start;
+      cycles = (cycles > overhead) ? (cycles - overhead) : 0;
+
+      total += cycles;
+      if (cycles < *min)
+        *min = cycles;
+      if (cycles > *max)
+        *max = cycles;
+    }
+  *avg = (uint32_t) (total / bench->samples);
+} // measure()
+
+/*
+ * @brief Cycles of a sample per call, in hundredths, so a call under one cycle of the
+ *        clock still shows
+ * @param cycles, of a sample
+ * @param batch, calls in the sample
+ * @return the cycles per call times 100
+ */
+static uint64_t per_call_x100(uint32_t cycles, uint32_t batch)
+{
+  return ((uint64_t) cycles * 100) / batch;
+} // per_call_x100()
+
+/*
+ * @brief Time of a sample per call, in hundredths of a ns
+ * @param cycles, of a sample
+ * @param batch, calls in the sample
+ * @param cpu_hz, the core clock
+ * @return the ns per call times 100
+ */
+static uint64_t ns_per_call_x100(uint32_t cycles, uint32_t batch, uint32_t cpu_hz)
+{
+  return ((uint64_t) cycles * 100000000000ull) / ((uint64_t) cpu_hz * batch);
+} // ns_per_call_x100()
+
+/*
+ * @brief Sets up the inputs and contexts of the cases
+ * @param none
+ * @return true if the crypto contexts are ready
+ */
+static bool setup(void)
+{
+  int ret;
+
+  memset(&queue, 0, sizeof(queue));
+  queue.empty = true;
+  for (uint32_t i = 0; i < sizeof(block); i++)
+    block[i] = (uint8_t) i;
+  rng_state = 0x5eed1234;
+
+  GLIB_contextInit(&glib);
+  glib.backgroundColor = White;
+  glib.foregroundColor = Black;
+  GLIB_setFont(&glib, (GLIB_Font_t *) &GLIB_FontNarrow6x8);
+
+  mbedtls_aes_init(&aes);
+#if defined(MBEDTLS_CCM_C)
+  mbedtls_ccm_init(&ccm);
+#endif
+  mbedtls_ecp_group_init(&group);
+  mbedtls_mpi_init(&own_private);
+  mbedtls_ecp_point_init(&own_public);
+  mbedtls_mpi_init(&peer_private);
+  mbedtls_ecp_point_init(&peer_public);
+  mbedtls_mpi_init(&shared);
+
+  ret = mbedtls_aes_setkey_enc(&aes, key, 128);
+  if (ret != 0)
+    {
+      LOG_ERROR("mbedtls_aes_setkey_enc() returned != 0 status=%d", ret);
+      return false;
+    }
+#if defined(MBEDTLS_CCM_C)
+  ret = mbedtls_ccm_setkey(&ccm, MBEDTLS_CIPHER_ID_AES, key, 128);
+  if (ret != 0)
+    {
+      LOG_ERROR("mbedtls_ccm_setkey() returned != 0 status=%d", ret);
+      return false;
+    }
+#endif
+  ret = mbedtls_ecp_group_load(&group, MBEDTLS_ECP_DP_SECP256R1);
+  if (ret != 0)
+    {
+      LOG_ERROR("mbedtls_ecp_group_load() returned != 0 status=%d", ret);
+      return false;
+    }
+  // The peer's key pair and our own, compute_shared needs both
+  ret = mbedtls_ecdh_gen_public(&group, &peer_private, &peer_public, bench_rng, NULL);
+  if (ret == 0)
+    ret = mbedtls_ecdh_gen_public(&group, &own_private, &own_public, bench_rng, NULL);
+  if (ret != 0)
+    {
+      LOG_ERROR("mbedtls_ecdh_gen_public() returned != 0 status=%d", ret);
+      return false;
+    }
+  return true;
+} // setup()
+
+/*
+ * @brief Frees the crypto contexts
+ * @param none
+ * @return none
+ */
+static void teardown(void)
+{
+  mbedtls_aes_free(&aes);
+#if defined(MBEDTLS_CCM_C)
+  mbedtls_ccm_free(&ccm);
+#endif
+  mbedtls_ecp_group_free(&group);
+  mbedtls_mpi_free(&own_private);
+  mbedtls_ecp_point_free(&own_public);
+  mbedtls_mpi_free(&peer_private);
+  mbedtls_ecp_point_free(&peer_public);
+  mbedtls_mpi_free(&shared);
+} // teardown()
+
+/**
+ * @brief Runs every benchmark and logs the results. Subscribe to sl_bt_evt_system_boot_id
+ *        ahead of the role's handlers, they redraw the display rows it overwrites.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void benchRun(sl_bt_msg_t *evt)
+{
+  bench_case_t       empty = { "overhead", run_nothing, BENCH_ITERATIONS, 1, 0, NULL };
+  uint32_t           overhead;
+  uint32_t           min;
+  uint32_t           avg;
+  uint32_t           max;
+  uint32_t           count = 0;
+  uint32_t           cpu_hz = SystemCoreClockGet();
+
+  (void) evt;
+  cycleCounterInit();
+  if (!setup())
+    {
+      teardown();
+      return;
+    }
+
+  measure(&empty, 0, &overhead, &avg, &max);
+  LOG_INFO("{\"bench\":\"start\",\"build\":\"%s\",\"cpu_hz\":%u,\"overhead\":%u}",
+           BENCH_BUILD_ID, (unsigned int) cpu_hz, (unsigned int) overhead);
+
+  for (uint32_t i = 0; i < (sizeof(cases) / sizeof(cases[0])); i++)
+    {
+      uint32_t batch = cases[i].batch;
+      uint64_t min_x100;
+      uint64_t avg_x100;
+      uint64_t max_x100;
+      uint64_t ns_x100;
+      uint64_t us_x100;
+      uint64_t kbps;
+
+      // The loop of the batch is part of the overhead
+      empty.batch = batch;
+      measure(&empty, 0, &overhead, &avg, &max);
+      measure(&cases[i], overhead, &min, &avg, &max);
+      min_x100 = per_call_x100(min, batch);
+      avg_x100 = per_call_x100(avg, batch);
+      max_x100 = per_call_x100(max, batch);
+      ns_x100  = ns_per_call_x100(min, batch, cpu_hz);
+      if (cases[i].path == NULL)
+        {
+          LOG_INFO("{\"bench\":\"%s\",\"samples\":%u,\"batch\":%u,\"min\":%u.%02u,\"avg\":%u.%02u,"
+                   "\"max\":%u.%02u,\"ns\":%u.%02u}",
+                   cases[i].name, (unsigned int) cases[i].samples, (unsigned int) batch,
+                   (unsigned int) (min_x100 / 100), (unsigned int) (min_x100 % 100),
+                   (unsigned int) (avg_x100 / 100), (unsigned int) (avg_x100 % 100),
+                   (unsigned int) (max_x100 / 100), (unsigned int) (max_x100 % 100),
+                   (unsigned int) (ns_x100 / 100), (unsigned int) (ns_x100 % 100));
+        }
+      else
+        {
+          // Latency and throughput from the min, the run least disturbed by interrupts, and
+          // only from a min the clock counted
+          if (min >= BENCH_MIN_SAMPLE_CYCLES)
+            {
+              us_x100 = ns_x100 / 1000;
+              kbps    = ((uint64_t) cases[i].bytes * batch * cpu_hz) / ((uint64_t) min * 1000);
+            }
+          else
+            {
+              us_x100 = 0;
+              kbps    = 0;
+            }
+          LOG_INFO("{\"bench\":\"%s\",\"samples\":%u,\"batch\":%u,\"min\":%u.%02u,\"avg\":%u.%02u,"
+                   "\"max\":%u.%02u,\"ns\":%u.%02u,\"path\":\"%s\",\"bytes\":%u,\"us\":%u.%02u,\"kBps\":%u}",
+                   cases[i].name, (unsigned int) cases[i].samples, (unsigned int) batch,
+                   (unsigned int) (min_x100 / 100), (unsigned int) (min_x100 % 100),
+                   (unsigned int) (avg_x100 / 100), (unsigned int) (avg_x100 % 100),
+                   (unsigned int) (max_x100 / 100), (unsigned int) (max_x100 % 100),
+                   (unsigned int) (ns_x100 / 100), (unsigned int) (ns_x100 % 100),
+                   cases[i].path, (unsigned int) cases[i].bytes,
+                   (unsigned int) (us_x100 / 100), (unsigned int) (us_x100 % 100), (unsigned int) kbps);
+        }
+      count++;
+    }
+
+  LOG_INFO("{\"bench\":\"end\",\"cases\":%u}", (unsigned int) count);
+  displayPrintf(DISPLAY_ROW_11, "%s", "");
+  teardown();
+} // benchRun()
+
+#else
+
+void benchRun(sl_bt_msg_t *evt) { (void) evt; }
+
+#endif // BENCH_ENABLE
@@ -0,0 +1,75 @@
+/*
+ * File name: bench.h
+ * File description: This file declares the micro-benchmark APIs. Each hot path (scheduler,
+ *                   indication queue, IEEE-11073 float decode, Si7021 read, LCD text, memory
+ *                   LCD transfer and the mbedtls primitives used for pairing) is timed over
+ *                   a fixed number of samples with the DWT cycle counter and the results
+ *                   are logged as one JSON object per line, so runs of two commits can be
+ *                   compared from the VCOM output. The crypto cases (AES, link layer AES-CCM,
+ *                   f4 sized AES-CMAC, SHA-256, ECDH P-256) also log the path they were built
+ *                   with, set per primitive by CRYPTO_ACCEL_* in config/mbedtls_config.h, so
+ *                   a build with a switch at 0 gives the software numbers to compare.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ARM Cortex-M4 Technical Reference Manual, DWT CYCCNT https://developer.arm.com/documentation/100166/0001/Data-Watchpoint-and-Trace-Unit
+ *  [2] Mbed TLS 2.26 API documentation https://tls.mbed.org/api/
+ */
+#ifndef SRC_BENCH_H_
+#define SRC_BENCH_H_
+
+#include "app.h"
+
+// Set to 1 for the benchmark build, the suite then runs once from the boot event, or
+// build with -DBENCH_ENABLE=1
+#ifndef BENCH_ENABLE
+#define BENCH_ENABLE                0
+#endif
+// Samples of the cheap cases and of the public key operations
+#define BENCH_ITERATIONS            (100)
+#define BENCH_ITERATIONS_ECDH       (4)
+// Calls timed together in each sample, so a call shorter than the clock's resolution
+// still adds up to a count: the cheap cases, the LCD transfers (a frame is ms on the board)
+#ifndef BENCH_BATCH
+#define BENCH_BATCH                 (32)
+#endif
+#ifndef BENCH_BATCH_LCD
+#define BENCH_BATCH_LCD             (4)
+#endif
+// Calls per sample of the symmetric crypto cases, the public key operations time one each
+#ifndef BENCH_BATCH_CRYPTO
+#define BENCH_BATCH_CRYPTO          (8)
+#endif
+// Counts a min sample needs for its latency and throughput to be reported, 1% of the clock's
+// resolution. Under it both are logged as 0, not a number made up from a rounded time.
+#define BENCH_MIN_SAMPLE_CYCLES     (100)
+// Tag of the build the results belong to, override with -DBENCH_BUILD_ID=\"<git sha>\"
+#ifndef BENCH_BUILD_ID
+#define BENCH_BUILD_ID              __DATE__ " " __TIME__
+#endif
+
+/*
+ * Output, one line each:
+ *   {"bench":"start","build":"<id>","cpu_hz":<core clock>,"overhead":<cycles>}
+ *   {"bench":"<case>","samples":<n>,"batch":<calls>,"min":<cycles>,"avg":<cycles>,"max":<cycles>,"ns":<time>}
+ *   {"bench":"<case>",...,"path":"CRYPTO"|"software","bytes":<n>,"us":<latency>,"kBps":<throughput>}
+ *   {"bench":"end","cases":<n>}
+ * Each sample times a batch of calls. min, avg and max are the cycles of a sample per
+ * call, and ns the min per call in ns, with two decimals. Cycles exclude the measured
+ * overhead of an empty sample of the same batch. Interrupts stay enabled, so min is the
+ * number to compare, avg and max include the radio and timer interrupts. Latency (with two
+ * decimals) and throughput of the crypto cases are worked out from min and cpu_hz, both 0
+ * when the min sample counts under BENCH_MIN_SAMPLE_CYCLES.
+ */
+
+/**
+ * @brief Runs every benchmark and logs the results. Subscribe to sl_bt_evt_system_boot_id
+ *        ahead of the role's handlers, they redraw the display rows it overwrites.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void benchRun(sl_bt_msg_t *evt);
+
+#endif /* SRC_BENCH_H_ */
@@ -12,28 +12,13 @@
 #define INCLUDE_LOG_DEBUG 1
 #include "src/log.h"
 
-//Macros
-//#define LOG_CONNECTION_PARAMETERS 1
-
 //Variables required
 //DOS ble_data_struct_t ble_data_ptr; // DOS this isn't a pointer to the data, its the actual data !!!
 ble_data_struct_t ble_data; // DOS this isn't a pointer to the data, its the actual data !!!
 
-queue_struct_t indication_queue;
 uint8_t button_state[2];
 
 uint32_t advertising_interval_max = 0x190, advertising_interval_min = 0x190; //Set the Advertising minimum and maximum to 250mS. 250/0.625 = 400 = 0x190
-uint16_t connection_interval_max = 0x3c, connection_interval_min = 0x3c; //Set Connection Interval minimum and maximum to 75mS. 75/1.25 =60 = 0x3c
-uint16_t peripheral_latency = 4;
-uint16_t supervision_timeout = 0x53; //(peripheral_latency+1)*(connection_interval * 2) + connection interval max = 825ms, approximated to 830 for integer quotient;
-uint16_t log_timeout, log_latency, log_interval;
-
-#if DEVICE_IS_BLE_SERVER == 0
-uint8_t scan_interval = 0x50;
-uint8_t scan_window = 0x28;
-bd_addr serverAddress = SERVER_BT_ADDRESS;
-
-#endif
 
 //htm temperature variables
 uint8_t htm_temperature_buffer[5];
@@ -44,9 +29,211 @@ int32_t temperature_in_c;
 uint8_t ServiceUUID[2] = {0x09,0x18};
 uint8_t CharacteristicUUID[2] = {0x1c, 0x2a}; //[2]
 
+uint8_t TemperatureTypeUUID[2] = {0x1d, 0x2a};
+uint8_t MeasurementIntervalUUID[2] = {0x21, 0x2a};
+
 uint8_t Button_CharacteristicUUID[16] = {0x89, 0x62, 0x13, 0x2d, 0x2a, 0x65, 0xec, 0x87, 0x3e, 0x43, 0xc8, 0x38, 0x02, 0x00, 0x00, 0x00};
 uint8_t Button_ServiceUUID[16] = {0x89, 0x62, 0x13, 0x2d, 0x2a, 0x65, 0xec, 0x87, 0x3e, 0x43, 0xc8, 0x38, 0x01, 0x00, 0x00, 0x00};
 
+uint8_t GattServiceUUID[2] = {0x01, 0x18};      // Generic Attribute service, its Database Hash is read by UUID
+
+#if BUILD_INCLUDES_BLE_CLIENT
+// Services and characteristics the client needs, matched against every
+// sl_bt_evt_gatt_service_id / sl_bt_evt_gatt_characteristic_id event
+static const gatt_service_entry_t discovery_services[] =
+{
+  { ServiceUUID,        sizeof(ServiceUUID),        offsetof(ble_server_t, htm_service_handle)    },
+  { Button_ServiceUUID, sizeof(Button_ServiceUUID), offsetof(ble_server_t, button_service_handle) },
+#if GATT_CACHE_ENABLE
+  { GattServiceUUID,    sizeof(GattServiceUUID),    offsetof(ble_server_t, gatt_service_handle)   },
+#endif
+};
+
+static const gatt_characteristic_entry_t discovery_characteristics[] =
+{
+  { CharacteristicUUID,        sizeof(CharacteristicUUID),        offsetof(ble_server_t, htm_characteristic_handle)     },
+  { Button_CharacteristicUUID, sizeof(Button_CharacteristicUUID), offsetof(ble_server_t, button_characteristic_handle)  },
+  // Read with the button state in one batch, found by the single pass discovery only
+  { TemperatureTypeUUID,       sizeof(TemperatureTypeUUID),       offsetof(ble_server_t, temperature_type_handle)       },
+  { MeasurementIntervalUUID,   sizeof(MeasurementIntervalUUID),   offsetof(ble_server_t, measurement_interval_handle)   },
+};
+
+#define DISCOVERY_SERVICE_COUNT        (sizeof(discovery_services) / sizeof(discovery_services[0]))
+#define DISCOVERY_CHARACTERISTIC_COUNT (sizeof(discovery_characteristics) / sizeof(discovery_characteristics[0]))
+
+// LCD row showing each server's reading
+static const uint8_t server_display_rows[] = { DISPLAY_ROW_TEMPVALUE, DISPLAY_ROW_8, DISPLAY_ROW_10, DISPLAY_ROW_11 };
+#if (BLE_MAX_SERVERS > 4) || (BROADCAST_MAX_SENDERS > 4)
+#error "server_display_rows[] has no LCD row for every server"
+#endif
+
+static uint32_t aggregate_samples        = 0; // HTM samples received from all servers since boot
+static uint32_t aggregate_last_samples   = 0;
+static uint32_t aggregate_last_report_ms = 0;
+
+/**
+ * @brief Get the table of services the client discovers on the server.
+ *
+ * @param count, returns the number of entries in the table
+ *
+ * @return pointer to the first table entry
+ */
+const gatt_service_entry_t *get_discovery_service_table(uint8_t *count)
+{
+  *count = DISCOVERY_SERVICE_COUNT;
+  return &discovery_services[0];
+}
+
+/**
+ * @brief Clears every service and characteristic handle filled in by discovery.
+ *
+ * @param server, the server whose handles are cleared
+ *
+ * @return none
+ */
+void clear_discovered_handles(ble_server_t *server)
+{
+  for (uint32_t i = 0; i < DISCOVERY_SERVICE_COUNT; i++)
+    DISCOVERED_SERVICE(server, &discovery_services[i]) = 0;
+  for (uint32_t i = 0; i < DISCOVERY_CHARACTERISTIC_COUNT; i++)
+    DISCOVERED_CHARACTERISTIC(server, &discovery_characteristics[i]) = 0;
+}
+
+/**
+ * @brief Client: finds the server on a connection.
+ *
+ * @param connection, connection handle
+ *
+ * @return pointer to the server, NULL if the connection is not to one of our servers
+ */
+ble_server_t *get_server_by_connection(uint8_t connection)
+{
+  for (int i = 0; i < BLE_MAX_SERVERS; i++)
+    {
+      if (ble_data.servers[i].in_use && (ble_data.servers[i].connection == connection))
+        return &ble_data.servers[i];
+    }
+  return NULL;
+}
+
+/*
+ @brief Finds a connected server by address
+ @param address the server address
+ @return pointer to the server, NULL if not connected
+ */
+static ble_server_t *get_server_by_address (const bd_addr *address)
+{
+  for (int i = 0; i < BLE_MAX_SERVERS; i++)
+    {
+      if (ble_data.servers[i].in_use &&
+          (memcmp (ble_data.servers[i].address.addr, address->addr, sizeof(address->addr)) == 0))
+        return &ble_data.servers[i];
+    }
+  return NULL;
+}
+
+/*
+ @brief Shows one server's latest reading on its LCD row
+ @param server the server
+ @return none
+ */
+static void display_server (const ble_server_t *server)
+{
+  uint8_t row = server_display_rows[server - &ble_data.servers[0]];
+
+  if (!server->in_use)
+    displayPrintf (row, "");
+  else if (server->samples == 0)
+    displayPrintf (row, "%02x%02x Temp=--", server->address.addr[1], server->address.addr[0]);
+  else
+    displayPrintf (row, "%02x%02x Temp=%d", server->address.addr[1], server->address.addr[0],
+                   server->temp_char_value);
+}
+
+/*
+ @brief Logs the HTM samples per minute summed over all servers, every BLE_AGGREGATE_REPORT_PERIOD_MS
+ @param none
+ @return none
+ */
+static void report_aggregate_throughput (void)
+{
+  uint32_t now_ms  = letimerMilliseconds ();
+  uint32_t elapsed = now_ms - aggregate_last_report_ms;
+
+  if (elapsed < BLE_AGGREGATE_REPORT_PERIOD_MS)
+    return;
+
+  LOG_INFO("Aggregate: %u servers, %u HTM samples/min", (unsigned int) ble_data.server_count,
+           (unsigned int) (((uint64_t) (aggregate_samples - aggregate_last_samples) * 60000) / elapsed));
+  aggregate_last_samples   = aggregate_samples;
+  aggregate_last_report_ms = now_ms;
+}
+
+/*
+ @brief gatt_batch callback, button_state read on PB1
+ @param connection, characteristic, value, len as in gatt_batch_callback_t
+ @return none
+ */
+static void read_button_state (uint8_t connection, uint16_t characteristic, const uint8_t *value, uint8_t len)
+{
+  (void) connection;
+  (void) characteristic;
+  (void) len;
+  if (value[0] == 0) //Reading button state flag bit
+    displayPrintf (DISPLAY_ROW_9, "Button Released");
+  else if (value[0] == 1)
+    displayPrintf (DISPLAY_ROW_9, "Button Pressed");
+}
+
+/*
+ @brief gatt_batch callback, HTM Temperature Type read on PB1
+ @param connection, characteristic, value, len as in gatt_batch_callback_t
+ @return none
+ */
+static void read_temperature_type (uint8_t connection, uint16_t characteristic, const uint8_t *value, uint8_t len)
+{
+  ble_server_t *server = get_server_by_connection (connection);
+
+  (void) characteristic;
+  (void) len;
+  if (server == NULL)
+    return;
+  server->temperature_type = value[0];
+  LOG_INFO("Server %02x%02x: temperature type %u", server->address.addr[1], server->address.addr[0],
+           (unsigned int) server->temperature_type);
+}
+
+/*
+ @brief gatt_batch callback, HTM Measurement Interval read on PB1
+ @param connection, characteristic, value, len as in gatt_batch_callback_t
+ @return none
+ */
+static void read_measurement_interval (uint8_t connection, uint16_t characteristic, const uint8_t *value, uint8_t len)
+{
+  ble_server_t *server = get_server_by_connection (connection);
+
+  (void) characteristic;
+  (void) len;
+  if (server == NULL)
+    return;
+  server->measurement_interval_s = (uint16_t) (value[0] | (value[1] << 8));
+  LOG_INFO("Server %02x%02x: measurement interval %u s", server->address.addr[1], server->address.addr[0],
+           (unsigned int) server->measurement_interval_s);
+}
+
+/*
+ @brief Compares a UUID from a GATT event against a table UUID, length included,
+        so a 128-bit UUID whose first bytes happen to match a 16-bit one is rejected
+ @param uuid, uuid_len the table entry
+ @param evt_uuid the UUID carried by the event
+ @return true on a match
+ */
+static bool uuid_matches (const uint8_t *uuid, uint8_t uuid_len, const uint8array *evt_uuid)
+{
+  return (evt_uuid->len == uuid_len) && (memcmp (evt_uuid->data, uuid, uuid_len) == 0);
+}
+#endif
+
 /*
  @brief Calculate the next pointer value in a circular buffer
  @param ptr The current pointer value
@@ -60,72 +247,106 @@ static uint32_t nextPtr (uint32_t ptr)
 } // nextPtr()
 
 /**
- * @brief Writes data to the indication queue.
+ * @brief Writes data to an indication queue.
  *
  * This function writes data to the indication queue, storing information about the
  * character handle, buffer length, and the buffer itself.
  *
+ * @param queue The client's indication queue.
  * @param charHandle The handle of the character.
  * @param bufferLength The length of the buffer.
  * @param buffer A pointer to the buffer containing data to be written to the queue.
  *
  * @return Returns READ_SUCCESS on successful write, or READ_FAILURE if the queue is full.
  */
-bool write_queue (uint16_t charHandle, size_t bufferLength, uint8_t *buffer)
+bool write_queue (queue_struct_t *queue, uint16_t charHandle, size_t bufferLength, uint8_t *buffer)
 {
-  if (nextPtr (indication_queue.wptr) != indication_queue.rptr) //Checking if queue is full
+  if (bufferLength > QUEUE_BUFFER_SIZE)
+    return READ_FAILURE ;
+  if (nextPtr (queue->wptr) != queue->rptr) //Checking if queue is full
     {
-      indication_queue.element[indication_queue.wptr].charHandle = charHandle;
-      indication_queue.element[indication_queue.wptr].bufferLength =
-          bufferLength;
-      memcpy (&indication_queue.element[indication_queue.wptr].buffer, buffer,
-              bufferLength);
-      indication_queue.wptr = nextPtr (indication_queue.wptr); // write ptr incremented to next position in queue
+      queue->element[queue->wptr].charHandle = charHandle;
+      queue->element[queue->wptr].bufferLength = bufferLength;
+      memcpy (&queue->element[queue->wptr].buffer, buffer, bufferLength);
+      queue->wptr = nextPtr (queue->wptr); // write ptr incremented to next position in queue
       return READ_SUCCESS ;
     }
   return READ_FAILURE ;
 } //write_queue()
 
 /**
- * @brief Reads data from the indication queue.
+ * @brief Overwrites the newest queued indication of a characteristic with a new value,
+ *        the element keeps its place in the queue.
+ *
+ * @param queue The client's indication queue.
+ * @param charHandle The handle of the character.
+ * @param bufferLength The length of the buffer.
+ * @param buffer A pointer to the new data.
+ *
+ * @return Returns WRITE_SUCCESS if an element was replaced, or WRITE_FAILURE if none is queued.
+ */
+bool replace_queue (queue_struct_t *queue, uint16_t charHandle, size_t bufferLength, uint8_t *buffer)
+{
+  uint32_t ptr = queue->wptr;
+
+  if (bufferLength > QUEUE_BUFFER_SIZE)
+    return WRITE_FAILURE ;
+  while (ptr != queue->rptr)
+    {
+      ptr = (ptr + QUEUE_DEPTH - 1) % (QUEUE_DEPTH); // step back to the newest unread element
+      if (queue->element[ptr].charHandle == charHandle)
+        {
+          queue->element[ptr].bufferLength = bufferLength;
+          memcpy (&queue->element[ptr].buffer, buffer, bufferLength);
+          return WRITE_SUCCESS ;
+        }
+    }
+  return WRITE_FAILURE ;
+} //replace_queue()
+
+/**
+ * @brief Reads data from an indication queue.
  *
  * This function reads data from the indication queue, retrieving information about
  * the character handle, buffer length, and the buffer itself.
  *
+ * @param queue The client's indication queue.
  * @param charHandle A pointer to store the character handle.
  * @param bufferLength A pointer to store the buffer length.
  * @param buffer A pointer to the buffer where data will be copied.
  *
  * @return Returns WRITE_SUCCESS on successful read, or WRITE_FAILURE if the queue is empty.
  */
-bool read_queue (uint16_t *charHandle, size_t *bufferLength, uint8_t *buffer)
+bool read_queue (queue_struct_t *queue, uint16_t *charHandle, size_t *bufferLength, uint8_t *buffer)
 {
-  if (indication_queue.rptr != indication_queue.wptr) //Checking if queue is empty
+  if (queue->rptr != queue->wptr) //Checking if queue is empty
     {
-      *charHandle = indication_queue.element[indication_queue.rptr].charHandle;
-      *bufferLength = indication_queue.element[indication_queue.rptr].bufferLength;
-      memcpy (buffer, &indication_queue.element[indication_queue.rptr].buffer,
-              indication_queue.element[indication_queue.rptr].bufferLength);
+      *charHandle = queue->element[queue->rptr].charHandle;
+      *bufferLength = queue->element[queue->rptr].bufferLength;
+      memcpy (buffer, &queue->element[queue->rptr].buffer,
+              queue->element[queue->rptr].bufferLength);
 
-      indication_queue.rptr = nextPtr (indication_queue.rptr); // read ptr incremented to next position in queue
+      queue->rptr = nextPtr (queue->rptr); // read ptr incremented to next position in queue
       return WRITE_SUCCESS ;
     }
   return WRITE_FAILURE ;
 }//read_queue
 
 /**
- * @brief Gets the depth of the indication queue.
+ * @brief Gets the depth of an indication queue.
  *
  * This function calculates and returns the depth of the indication queue, representing
  * the number of elements in the queue.
  *
+ * @param queue The client's indication queue.
+ *
  * @return The depth of the indication queue.
  */
-uint32_t get_queue_depth (void)
+uint32_t get_queue_depth (const queue_struct_t *queue)
 {
-  if (indication_queue.wptr >= indication_queue.rptr)
-    return (indication_queue.wptr - indication_queue.rptr);
-  return (QUEUE_DEPTH - indication_queue.rptr + indication_queue.wptr); //when wptr < rptr
+  if (queue->wptr >= queue->rptr)
+    return (queue->wptr - queue->rptr);
+  return (QUEUE_DEPTH - queue->rptr + queue->wptr); //when wptr < rptr
 }
 /**
  * @brief Get a pointer to the BLE data structure.
@@ -139,1010 +360,1470 @@ ble_data_struct_t* get_ble_data_ptr (void)
   return &ble_data;
 }
 
+#if BUILD_INCLUDES_BLE_SERVER
+/*
+ @brief Finds the client on a connection
+ @param connection the connection handle
+ @return pointer to the client, NULL if the connection is unknown
+ */
+static ble_client_t *get_client_by_connection (uint8_t connection)
+{
+  for (int i = 0; i < BLE_MAX_CLIENTS; i++)
+    {
+      if (ble_data.clients[i].in_use && (ble_data.clients[i].connection == connection))
+        return &ble_data.clients[i];
+    }
+  return NULL;
+}
+
+/*
+ @brief Checks if any connected client has enabled a kind of indication, for the LEDs
+ @param htm true for the HTM CCCD, false for the button_state CCCD
+ @return true if at least one client has indications enabled
+ */
+static bool any_client_subscribed (bool htm)
+{
+  for (int i = 0; i < BLE_MAX_CLIENTS; i++)
+    {
+      if (ble_data.clients[i].in_use &&
+          (htm ? ble_data.clients[i].ok_to_send_htm_indications : ble_data.clients[i].ok_to_send_PB0_indications))
+        return true;
+    }
+  return false;
+}
+
+/*
+ @brief Starts advertising if it was stopped and a client slot is free.
+        The stack stops the advertising set when a connection opens on it.
+ @param none
+ @return none
+ */
+static void advertise_if_slot_free (void)
+{
+  sl_status_t sc;
+
+  if (ble_data.advertising || (ble_data.client_count >= BLE_MAX_CLIENTS))
+    return;
+#if BROADCAST_ENABLE
+  // Our own advertising data, carrying the latest reading
+  sc = broadcastStart (ble_data.advertisingSetHandle);
+#else
+  /* Start advertising of a given advertising set with specified discoverable and connectable modes. */
+  sc = sl_bt_advertiser_start (ble_data.advertisingSetHandle,
+                               sl_bt_advertiser_general_discoverable,
+                               sl_bt_advertiser_connectable_scannable);
+#endif
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_advertiser_start() returned != 0 status=0x%04x", (unsigned int) sc);
+      return;
+    }
+  ble_data.advertising = true;
+}
+
+/*
+ @brief Shows the number of connected clients
+ @param none
+ @return none
+ */
+static void display_clients (void)
+{
+  if (ble_data.client_count == 0)
+    displayPrintf (DISPLAY_ROW_CONNECTION, "Advertising");
+  else
+    displayPrintf (DISPLAY_ROW_CONNECTION, "Connected %d/%d", ble_data.client_count, BLE_MAX_CLIENTS);
+}
+
 /**
- * @brief Handle Bluetooth Low Energy (BLE) events, including device boot, connection management,
- * and GATT (Generic Attribute Profile) operations for both clients and servers.
+ * @brief Server: hands one indication to the stack for a client and starts its latency
+ *        measurement.
  *
- * @param evt - Pointer to the BLE event message.
- *
- * @returns none
+ * @param client, the client
+ * @param charHandle, bufferLength, buffer, the indication
  *
- * @reference ECEN5823 Lecture 10,12 slides
+ * @return true if the stack accepted it
  */
-void handle_ble_event (sl_bt_msg_t *evt)
+bool ble_send_indication (ble_client_t *client, uint16_t charHandle, size_t bufferLength, uint8_t *buffer)
 {
-  sl_status_t sc = SL_STATUS_OK;
+  sl_status_t sc;
 
-#if DEVICE_IS_BLE_SERVER
+  sc = sl_bt_gatt_server_send_indication (client->connection, charHandle, bufferLength, buffer);
+  if (sc != SL_STATUS_OK) {
+      LOG_ERROR("sl_bt_gatt_server_send_indication() returned != 0 status=0x%04x", (unsigned int) sc);
+      return false;
+  }
+  client->indication_inflight = true;
+  client->indication_sent_tick = sl_sleeptimer_get_tick_count ();
+  bleTraceIndicationSent (client->connection, bufferLength);
+  return true;
+}
 
+/**
+ * @brief Sends the oldest queued indication of a client if none is in flight.
+ *        Called from the soft timer and when the client confirms an indication,
+ *        so the queue drains without a soft timer when LCD_EXTCOMIN_HW_TOGGLE is 1.
+ *
+ * @param client, the client
+ *
+ * @return none
+ */
+static void send_deferred_indication (ble_client_t *client)
+{
+  sl_status_t sc;
   uint16_t    defered_ind_handle;
   size_t      deferred_ind_length;
-  uint8_t     deferred_ind_data[5];
+  uint8_t     deferred_ind_data[QUEUE_BUFFER_SIZE];
 
-  //ble_data_struct_t *ble_data_ptr = get_ble_data_ptr (); // don't need this - ble_data is local to this file !!!
+  // Start of code from the instructor.
+  if (client->indication_inflight == false && (get_queue_depth (&client->indication_queue) > 0)) { // if ok to send
 
-  switch (SL_BT_MSG_ID(evt->header))
-  {
-    // ******************************************************
-    // Events common to both Servers and Clients
-    // ******************************************************
-    // --------------------------------------------------------
-    // This event indicates the device has started and the radio is ready.
-    // Do not call any stack API commands before receiving this boot event!
-    // Including starting BT stack soft timers!
-    // --------------------------------------------------------
-    case sl_bt_evt_system_boot_id:
-      //LOG_INFO("sl_bt_evt_system_boot_id\n\r");
-      //Clearing all boolean flags
-      ble_data.passkey_available = false;
-      ble_data.bonding_flag = false; //yet to bond
-      ble_data.connection_open = false; //false = closed
-      ble_data.ok_to_send_htm_indications = false;
-      ble_data.indication_inflight = false;
+      sc = read_queue (&client->indication_queue, &defered_ind_handle, &deferred_ind_length, &deferred_ind_data[0]);
+      if (sc != 0) {
+          LOG_ERROR("read_queue() returned != 0 status=0x%04x", (unsigned int) sc);
+      } else {
+          ble_send_indication (client, defered_ind_handle, deferred_ind_length, &deferred_ind_data[0]);
+      }
 
+  } // if - ok to send
+  // End of code from the instructor.
+} // send_deferred_indication()
 
-      /*
-       * Read the Bluetooth identity address used by the device, which can be a public
-       * or random static device address.
-       */
-      sc = sl_bt_system_get_identity_address (&ble_data.myAddress,
-                                              &ble_data.myAddressType);
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR(
-              "sl_bt_system_get_identity_address() returned != 0 status=0x%04x\n\r",
-              (unsigned int) sc);
-        }
-      /*
-       * Create an advertising set. The handle of the created advertising set is
-       * returned in response.
-       */
-      sc = sl_bt_advertiser_create_set (&ble_data.advertisingSetHandle);
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR(
-              "sl_bt_advertiser_create_set() returned != 0 status=0x%04x\n\r", (unsigned int) sc);
-        }
-      /*
-       * Set the advertising timing parameters of the given advertising set. This
-       * setting will take effect next time that advertising is enabled.
-       */
-      sc = sl_bt_advertiser_set_timing (ble_data.advertisingSetHandle,
-                                        advertising_interval_min,
-                                        advertising_interval_max, 0, 0);
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR(
-              "sl_bt_advertiser_set_timing() returned != 0 status=0x%04x\n\r", (unsigned int) sc);
-        }
-      /*Start advertising of a given advertising set with specified discoverable and connectable modes*/
-      //@reference Immediate line of code based on soc_thermometer example app.c line 157-160
-      sc = sl_bt_advertiser_start (ble_data.advertisingSetHandle,
-                                   sl_bt_advertiser_general_discoverable,
-                                   sl_bt_advertiser_connectable_scannable);
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_advertiser_start() returned != 0 status=0x%04x\n\r", (unsigned int) sc);
-        }
+/*
+ @brief Logs the indication count and confirmation latency of a client
+ @param client the client
+ @return none
+ */
+static void report_client_latency (const ble_client_t *client)
+{
+  LOG_INFO("Client %d: %u indications confirmed, latency avg %u ms max %u ms",
+           (int) client->connection, (unsigned int) client->indications,
+           (unsigned int) ((client->indications) ? (client->latency_sum_ms / client->indications) : 0),
+           (unsigned int) client->latency_max_ms);
+}
+#endif
 
-      /*
-       *  Configure security requirements and I/O capabilities of the system.
-       */
-      sc = sl_bt_sm_configure (0x0F, sm_io_capability_displayyesno); // MITM protection, Display with Yes/No-buttons
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_sm_configure() returned != 0 status=0x%04x", (unsigned int) sc);
-        }
-      /*
-       * Delete all bonding information and accept list filtering from the persistent
-       * store. This will also delete device local identity resolving key (IRK).
-       */
-      sc = sl_bt_sm_delete_bondings ();
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR(
-              "sl_bt_sm_delete_bondings() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
-        }
+/*
+ @brief Shows the passkey waiting for PB0, or clears the passkey rows
+ @param passkey the passkey, NULL if none is waiting
+ @return none
+ */
+static void display_passkey (const uint32_t *passkey)
+{
+  if (passkey == NULL) {
+      displayPrintf (DISPLAY_ROW_PASSKEY, "");
+      displayPrintf (DISPLAY_ROW_ACTION, "");
+      return;
+  }
+  displayPrintf (DISPLAY_ROW_PASSKEY, "%d", (int) *passkey);
+  displayPrintf (DISPLAY_ROW_ACTION, "Confirm with PB0");
+}
 
-      displayPrintf (DISPLAY_ROW_NAME, "Server");
-      displayPrintf (DISPLAY_ROW_BTADDR, "%02x:%02x:%02x:%02x:%02x:%02x",
-                     ble_data.myAddress.addr[0],
-                     ble_data.myAddress.addr[1],
-                     ble_data.myAddress.addr[2],
-                     ble_data.myAddress.addr[3],
-                     ble_data.myAddress.addr[4],
-                     ble_data.myAddress.addr[5]);
-      displayPrintf (DISPLAY_ROW_CONNECTION, "Advertising");
-      displayPrintf (DISPLAY_ROW_ASSIGNMENT, "A9");
-
-      break;
-
-
-
-      //This event indicates that a new connection was opened.
-    case sl_bt_evt_connection_opened_id:
-      //LOG_INFO("sl_bt_evt_connection_opened_id\n\r");
-      /* @reference
-       Immediate line of code generated using ChatGPT with the following prompt:
-       "After event: sl_bt_evt_connection_opened_id
-       sl_bt_advertiser_stop() is called,
-       Step to do: Save this connection handle. Use this value in all subsequent calls that require a connect handle, when this connection is open to the client"
-       */
-      ble_data.connection_handle = evt->data.evt_connection_opened.connection; // Save the connection handle for future use
-      ble_data.connection_open = true;
-      /*
-       * Stop the advertising of the given advertising set. Counterpart with @ref
-       * sl_bt_advertiser_start.
-       */
-      sc = sl_bt_advertiser_stop (ble_data.advertisingSetHandle);
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_advertiser_stop() returned != 0 status=0x%04x\r\n", (unsigned int) sc);
-        }
+#if BUILD_INCLUDES_BLE_SERVER
+/*
+ @brief Server: returns the first client with a passkey waiting for PB0, its passkey is the one on the LCD
+ @param none
+ @return the client, NULL if none
+ */
+static ble_client_t *pending_passkey_client (void)
+{
+  for (int i = 0; i < BLE_MAX_CLIENTS; i++) {
+      if (ble_data.clients[i].in_use && ble_data.clients[i].passkey_available)
+        return &ble_data.clients[i];
+  }
+  return NULL;
+}
 
-      /*
-       * Request a change in the connection parameters of a Bluetooth connection.
-       */
-      sc = sl_bt_connection_set_parameters (ble_data.connection_handle,
-                                            connection_interval_min,
-                                            connection_interval_max,
-                                            peripheral_latency,
-                                            supervision_timeout, 0, 4);
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR(
-              "sl_bt_connection_set_parameters() returned != 0 status=0x%04x",
-              (unsigned int) sc);
-        }
-      displayPrintf (DISPLAY_ROW_CONNECTION, "Connected");
+/*
+ @brief Server: shows the passkey of the next client waiting for PB0, or clears it
+ @param none
+ @return none
+ */
+static void display_pending_passkey (void)
+{
+  ble_client_t *client = pending_passkey_client ();
+
+  display_passkey ((client != NULL) ? &client->passkey : NULL);
+}
+
+/*
+ @brief Server: the device has started and the radio is ready. Do not call any stack API commands
+        before receiving this boot event! Including starting BT stack soft timers!
+ @param evt the sl_bt_evt_system_boot_id event
+ @return none
+ */
+static void server_on_system_boot (sl_bt_msg_t *evt)
+{
+  sl_status_t sc;
 
-      break;
+  //LOG_INFO("sl_bt_evt_system_boot_id\n\r");
+  //Clearing all boolean flags
+  ble_data.connection_open = false; //false = closed
+  memset (ble_data.clients, 0, sizeof(ble_data.clients));
+  ble_data.client_count = 0;
+  ble_data.advertising = false;
 
 
-      //This event indicates that a connection was closed.
-    case sl_bt_evt_connection_closed_id:
-      //LOG_INFO("sl_bt_evt_connection_closed_id\n\r");
-      ble_data.ok_to_send_htm_indications = false;
-      ble_data.connection_open = false;
-      ble_data.bonding_flag = false; //not bonded
-      ble_data.passkey_available = false;
-      ble_data.indication_inflight = false; //DOS
-
-      /* Start advertising of a given advertising set with specified discoverable and connectable modes. */
-      sc = sl_bt_advertiser_start (ble_data.advertisingSetHandle,
-                                   sl_bt_advertiser_general_discoverable,
-                                   sl_bt_advertiser_connectable_scannable);
+  /*
+   * Read the Bluetooth identity address used by the device, which can be a public
+   * or random static device address.
+   */
+  sc = sl_bt_system_get_identity_address (&ble_data.myAddress,
+                                          &ble_data.myAddressType);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR(
+          "sl_bt_system_get_identity_address() returned != 0 status=0x%04x\n\r",
+          (unsigned int) sc);
+    }
+  /*
+   * Create an advertising set. The handle of the created advertising set is
+   * returned in response.
+   */
+  sc = sl_bt_advertiser_create_set (&ble_data.advertisingSetHandle);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR(
+          "sl_bt_advertiser_create_set() returned != 0 status=0x%04x\n\r", (unsigned int) sc);
+    }
+  /*
+   * Set the advertising timing parameters of the given advertising set. This
+   * setting will take effect next time that advertising is enabled.
+   */
+  sc = sl_bt_advertiser_set_timing (ble_data.advertisingSetHandle,
+                                    advertising_interval_min,
+                                    advertising_interval_max, 0, 0);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR(
+          "sl_bt_advertiser_set_timing() returned != 0 status=0x%04x\n\r", (unsigned int) sc);
+    }
+#if BROADCAST_ENABLE
+  broadcastInit (ble_data.advertisingSetHandle);
+#endif
+  /*Start advertising of a given advertising set with specified discoverable and connectable modes*/
+  //@reference Immediate line of code based on soc_thermometer example app.c line 157-160
+  advertise_if_slot_free ();
+
+  /*
+   *  Configure security requirements and I/O capabilities of the system.
+   */
+  sc = sl_bt_sm_configure (0x0F, sm_io_capability_displayyesno); // MITM protection, Display with Yes/No-buttons
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_sm_configure() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+  // Bonds survive disconnects and resets, bounded table with LRU replacement
+  bondingInit ();
+  // Offer the largest ATT MTU for bulk transfers
+  linkInit ();
+
+  displayPrintf (DISPLAY_ROW_NAME, "Server");
+  displayPrintf (DISPLAY_ROW_BTADDR, "%02x:%02x:%02x:%02x:%02x:%02x",
+                 ble_data.myAddress.addr[0],
+                 ble_data.myAddress.addr[1],
+                 ble_data.myAddress.addr[2],
+                 ble_data.myAddress.addr[3],
+                 ble_data.myAddress.addr[4],
+                 ble_data.myAddress.addr[5]);
+  displayPrintf (DISPLAY_ROW_CONNECTION, "Advertising");
+  displayPrintf (DISPLAY_ROW_ASSIGNMENT, "A9");
+} // server_on_system_boot()
+
+/*
+ @brief Server: a new connection was opened
+ @param evt the sl_bt_evt_connection_opened_id event
+ @return none
+ */
+static void server_on_connection_opened (sl_bt_msg_t *evt)
+{
+  sl_status_t sc;
+  ble_client_t *client; // the client the event belongs to
+
+  //LOG_INFO("sl_bt_evt_connection_opened_id\n\r");
+  // The stack stopped the advertising set this connection came in on
+  ble_data.advertising = false;
+  client = NULL;
+  for (int i = 0; (i < BLE_MAX_CLIENTS) && (client == NULL); i++)
+    {
+      if (!ble_data.clients[i].in_use)
+        client = &ble_data.clients[i];
+    }
+  if (client == NULL)
+    {
+      LOG_ERROR("No free client slot for connection %d", (int) evt->data.evt_connection_opened.connection);
+      sc = sl_bt_connection_close (evt->data.evt_connection_opened.connection);
       if (sc != SL_STATUS_OK)
         {
-          LOG_ERROR("sl_bt_advertiser_start() returned != 0 status=0x%04x", (unsigned int) sc);
+          LOG_ERROR("sl_bt_connection_close() returned != 0 status=0x%04x", (unsigned int) sc);
         }
-      displayPrintf (DISPLAY_ROW_CONNECTION, "Advertising");
+      return;
+    }
+  // Each client starts with no CCCDs set, nothing in flight and an empty queue
+  memset (client, 0, sizeof(*client));
+  client->in_use = true;
+  client->connection = evt->data.evt_connection_opened.connection;
+  ble_data.client_count++;
+  ble_data.connection_open = true;
+
+  // Short interval while the client discovers, subscribes and pairs, relaxed later
+  connParamsOpened (client->connection);
+  // Upgrade to the 2M PHY, 1M stays if the client refuses
+  linkOpened (client->connection);
+  display_clients ();
+  // Keep advertising while another client can connect
+  advertise_if_slot_free ();
+  // A bonded client resumes encryption with the stored LTK, no passkey this time
+  bondingConnectionOpened (client->connection, evt->data.evt_connection_opened.bonding);
+} // server_on_connection_opened()
+
+/*
+ @brief Server: a connection was closed
+ @param evt the sl_bt_evt_connection_closed_id event
+ @return none
+ */
+static void server_on_connection_closed (sl_bt_msg_t *evt)
+{
+  ble_client_t *client; // the client the event belongs to
+
+  //LOG_INFO("sl_bt_evt_connection_closed_id\n\r");
+  bondingConnectionClosed (evt->data.evt_connection_closed.connection);
+  connParamsClosed (evt->data.evt_connection_closed.connection);
+  linkClosed (evt->data.evt_connection_closed.connection);
+  client = get_client_by_connection (evt->data.evt_connection_closed.connection);
+  if (client != NULL)
+    {
+      report_client_latency (client);
+      client->in_use = false;
+      ble_data.client_count--;
+    }
+  // The passkey shown may have belonged to this connection
+  display_pending_passkey ();
+
+  advertise_if_slot_free ();
+  display_clients ();
+  if (!any_client_subscribed (true))
+    gpioLed0SetOff ();
+  if (!any_client_subscribed (false))
+    gpioLed1SetOff ();
+  if (ble_data.client_count == 0)
+    {
+      ble_data.connection_open = false;
       displayPrintf (DISPLAY_ROW_TEMPVALUE, "");
       displayPrintf (DISPLAY_ROW_9, "");
-      displayPrintf (DISPLAY_ROW_ACTION, "");
-      displayPrintf (DISPLAY_ROW_PASSKEY, "");
-      gpioLed0SetOff ();
-      gpioLed1SetOff ();
-      sc = sl_bt_sm_delete_bondings ();
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR(
-              "sl_bt_sm_delete_bondings() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
-        }
-      break;
-
+    }
+} // server_on_connection_closed()
 
+/*
+ @brief Server: connection parameters changed, also sent when a connection is established and when
+        encryption is resumed with a stored bond (there is no sl_bt_evt_sm_bonded_id for it)
+ @param evt the sl_bt_evt_connection_parameters_id event
+ @return none
+ */
+static void server_on_connection_parameters (sl_bt_msg_t *evt)
+{
+  ble_client_t *client; // the client the event belongs to
+
+  connParamsChanged (&evt->data.evt_connection_parameters);
+  linkParameters (&evt->data.evt_connection_parameters);
+  // Encryption resumed with a stored bond, there is no sl_bt_evt_sm_bonded_id for it
+  if (bondingEncryptionResumed (&evt->data.evt_connection_parameters)) {
+      client = get_client_by_connection (evt->data.evt_connection_parameters.connection);
+      if (client != NULL)
+        client->bonding_flag = true;
+      displayPrintf (DISPLAY_ROW_CONNECTION, "Bonded");
+  }
+} // server_on_connection_parameters()
 
+/*
+ @brief Server: PHY update procedure completed, 2M or the 1M fallback
+ @param evt the sl_bt_evt_connection_phy_status_id event
+ @return none
+ */
+static void server_on_connection_phy_status (sl_bt_msg_t *evt)
+{
+  linkPhyStatus (&evt->data.evt_connection_phy_status);
+} // server_on_connection_phy_status()
 
-      //Informational. Triggered whenever the connection parameters are changed and at any time a connection is established
-    case sl_bt_evt_connection_parameters_id:
-#if LOG_CONNECTION_PARAMETERS
-      log_interval = (evt->data.evt_connection_parameters.interval)*1.25;
-      log_latency = evt->data.evt_connection_parameters.latency;
-      log_timeout = (evt->data.evt_connection_parameters.timeout)*10;
-      LOG_INFO("Logged sl_bt_evt_connection_parameters_id values from sl_bt_connection_set_parameters() call.\
-          Interval: %dms Latency: %d and Timeout: %dms\n\r",\
-          log_interval, log_latency,log_timeout);
-#endif
-      break;
-
-
-      //This event indicates that sl_bt_external_signal(myEvent) was called and returns the myEvent value in the event data structure: evt->data.evt_system_external_signal.extsignals
-      /*Credit: sl_bt_evt_system_external_signal_id code developed with the help of Aditi Vijay Nanaware's A8 submission*/
-    case sl_bt_evt_system_external_signal_id:
-      //Instructor edit: entire sl_bt_evt_system_external_signal_id implementation
-      // Start of code from the instructor.
-      //LOG_INFO("sl_bt_evt_system_external_signal_id\n\r");
-      // ---------------------
-      // Deal with Security
-      // ---------------------
-      if ( (evt->data.evt_system_external_signal.extsignals == evtPB0_pressed) &&
-          (GPIO_PinInGet (PB0_port, PB0_pin) == 0) &&
-          (ble_data.connection_open == true) &&
-          ( ble_data.passkey_available) && // we're displaying the passkey to the user
-          (!ble_data.bonding_flag) ) {     // and we're not bonded yet
-
-          // Accept or reject the reported passkey confirm value.
-          sl_bt_sm_passkey_confirm (ble_data.connection_handle, 1); //Creating bond after confirming passkey
-          ble_data.passkey_available = false;
-
-      } // PB0 press for Security
-
-
-      // ------------------------------------------------
-      // Deal with GATT DB and button indications for PB0
-      // ------------------------------------------------
-      if ( (evt->data.evt_system_external_signal.extsignals == evtPB0_pressed) ||
-          (evt->data.evt_system_external_signal.extsignals == evtPB0_released) ) {
-
-          // Prepare the data for GATT DB updates and sending/queuing an indication below
-          button_state[0] = 0; // prep the flag byte for an indication below
-          button_state[1] = ((uint8_t) GPIO_PinInGet (PB0_port, PB0_pin)) ? 0 : 1 ; // set the data to write to the GATT DB
-
-          //LOG_INFO("   **PB0 press/release=%d", (int) button_state[1]);
-
-          // Update the LCD
-          if (button_state[1]) {
-              displayPrintf (DISPLAY_ROW_9, "Button Pressed"); // =1 is pressed
-          }
-          else {
-              displayPrintf (DISPLAY_ROW_9, "Button Released"); // =0 is released
-          }
-
-          // Unconditionally update GATT database with button state value
-          sc = sl_bt_gatt_server_write_attribute_value (
-              gattdb_button_state,
-              0, // offset
-              1, // 1-byte
-              (const uint8_t*) &button_state[1]
-          );
-          if (sc != SL_STATUS_OK) {
-              LOG_ERROR("sl_bt_gatt_server_write_attribute_value() returned != 0 status=0x%04x", (unsigned int)sc);
-          }
-
-
-          if (ble_data.indication_inflight == false) {
-
-              // Send indication if conditions are correct
-              if ( (ble_data.ok_to_send_PB0_indications == true) &&
-                  (ble_data.connection_open == true) &&
-                  (ble_data.bonding_flag == true) ) {
-
-                  sc = sl_bt_gatt_server_send_indication (
-                      ble_data.connection_handle,
-                      gattdb_button_state,
-                      sizeof(button_state),
-                      &button_state[0]);
-                  if (sc != SL_STATUS_OK) {
-                      LOG_ERROR("sl_bt_gatt_server_send_indication() returned != 0 status=0x%04x", (unsigned int)sc);
-                  }
-                  else {
-                      ble_data.indication_inflight = true;
-                      //LOG_INFO("  **sent BTN indication");
-                  }
-
-              } else {
-
-                  // Queue indication
-                  if ( (ble_data.ok_to_send_PB0_indications == true) &&
-                      (ble_data.connection_open == true) &&
-                      (ble_data.bonding_flag == true) ) {
-
-                      sc = write_queue (gattdb_button_state,
-                                        sizeof(button_state),
-                                        &button_state[0]
-                      );
-                      if (sc != SL_STATUS_OK) {
-                          LOG_ERROR("write_queue() returned != 0 status=0x%04x", (unsigned int)sc);
-                      } else {
-                          //LOG_INFO("  **queued BTN indication");
-                      }
-
-                  } // Queue indication
-
-              } // else
-
-          } // else indication in-flight
-
-      } // PB0 press or release
-
-      // End of code from the instructor.
-
-      break;
+/*
+ @brief Server: ATT MTU agreed with the peer, sets the largest notification/indication payload
+ @param evt the sl_bt_evt_gatt_mtu_exchanged_id event
+ @return none
+ */
+static void server_on_gatt_mtu_exchanged (sl_bt_msg_t *evt)
+{
+  linkMtuExchanged (&evt->data.evt_gatt_mtu_exchanged);
+} // server_on_gatt_mtu_exchanged()
 
+/*
+ @brief Server: writes the PB0 state to the GATT DB if it changed, shows it on the LCD and
+        indicates it to every bonded client with indications enabled
+ @param pressed the debounced PB0 state
+ @return none
+ */
+static void publish_button_state (bool pressed)
+{
+  // Prepare the data for GATT DB updates and sending/queuing an indication below
+  button_state[0] = 0; // prep the flag byte for an indication below
+  button_state[1] = (pressed) ? 1 : 0; // set the data to write to the GATT DB
 
+  //LOG_INFO("   **PB0 press/release=%d", (int) button_state[1]);
 
-    case sl_bt_evt_system_soft_timer_id:
+  // Update the LCD
+  if (button_state[1]) {
+      displayPrintf (DISPLAY_ROW_9, "Button Pressed"); // =1 is pressed
+  }
+  else {
+      displayPrintf (DISPLAY_ROW_9, "Button Released"); // =0 is released
+  }
 
-      //LOG_INFO("sl_bt_evt_system_soft_timer_id\n\r");
-      //This event indicates that soft timer has expired.
+  // GATT DB write if changed, then every bonded client with indications enabled
+  gattPublish (gattdb_button_state, &button_state[1], 1, &button_state[0], sizeof(button_state));
+} // publish_button_state()
 
-      displayUpdate ();
-      // Start of code from the instructor.
-      if (ble_data.indication_inflight == false && (get_queue_depth () > 0)) { // if ok to send
+/*Credit: sl_bt_evt_system_external_signal_id code developed with the help of Aditi Vijay Nanaware's A8 submission*/
+/*
+ @brief Server: sl_bt_external_signal(myEvent) was called, the myEvent value is in
+        evt->data.evt_system_external_signal.extsignals
+ @param evt the sl_bt_evt_system_external_signal_id event
+ @return none
+ */
+static void server_on_system_external_signal (sl_bt_msg_t *evt)
+{
+  sl_status_t   sc;
+  ble_client_t *client; // the client the event belongs to
+
+  //Instructor edit: entire sl_bt_evt_system_external_signal_id implementation
+  // Start of code from the instructor.
+  //LOG_INFO("sl_bt_evt_system_external_signal_id\n\r");
+  // Connection parameter policy, with each client's queue depth, on the 3 s LETIMER0 tick
+  if (evt->data.evt_system_external_signal.extsignals & evtLETIMER0_UF) {
+      gattPublisherReportIfDue ();
+      for (int i = 0; i < BLE_MAX_CLIENTS; i++) {
+          if (ble_data.clients[i].in_use)
+            connParamsUpdate (ble_data.clients[i].connection, get_queue_depth (&ble_data.clients[i].indication_queue));
+      }
+  }
 
-          sc = read_queue (&defered_ind_handle, &deferred_ind_length, &deferred_ind_data[2]); // BOB
-          if (sc != 0) {
-              LOG_ERROR("read_queue() returned != 0 status=0x%04x", (unsigned int) sc);
-          } else {
-              sc = sl_bt_gatt_server_send_indication(ble_data.connection_handle, defered_ind_handle, deferred_ind_length, &deferred_ind_data[0]);
-              if (sc != SL_STATUS_OK) {
-                  LOG_ERROR("sl_bt_gatt_server_send_indication() deferred returned != 0 status=0x%04x",(unsigned int) sc);
-              } else {
-                  ble_data.indication_inflight = true;
-                  //LOG_INFO("  **sent deferred indication");
-              }
-          }
+  // ---------------------
+  // Deal with Security
+  // ---------------------
+  client = pending_passkey_client (); // the client whose passkey we're displaying
+  if ( (evt->data.evt_system_external_signal.extsignals & evtPB0_pressed) && // debounced, src/buttons.c
+      (client != NULL) &&
+      (!client->bonding_flag) ) {      // and we're not bonded yet
 
-      } // if - ok to send
-      // End of code from the instructor.
+      // Accept or reject the reported passkey confirm value.
+      sc = sl_bt_sm_passkey_confirm (client->connection, 1); //Creating bond after confirming passkey
+      if (sc != SL_STATUS_OK)
+        {
+          LOG_ERROR("sl_bt_sm_passkey_confirm() returned != 0 status=0x%04x", (unsigned int) sc);
+        }
+      client->passkey_available = false;
+      display_pending_passkey (); // the next client waiting, if any
 
-      break;
+  } // PB0 press for Security
 
 
+  // ------------------------------------------------
+  // Deal with GATT DB and button indications for PB0
+  // ------------------------------------------------
+  if ( (evt->data.evt_system_external_signal.extsignals & evtPB0_pressed) &&
+      (evt->data.evt_system_external_signal.extsignals & evtPB0_released) ) {
+      // A press and its release (or the reverse) came in before this event ran, send both in order
+      publish_button_state (!buttonsPressed (BUTTON_PB0));
+      publish_button_state (buttonsPressed (BUTTON_PB0));
+  }
+  else if (evt->data.evt_system_external_signal.extsignals & (evtPB0_pressed | evtPB0_released)) {
+      publish_button_state ((evt->data.evt_system_external_signal.extsignals & evtPB0_pressed) != 0);
+  } // PB0 press or release
 
+  // End of code from the instructor.
+} // server_on_system_external_signal()
 
-      /********************************/
-      /*Events only for Slaves/Servers*/
-      /********************************/
-      /*
-       * Indicates either:
-       * A local Client Characteristic Configuration descriptor (CCCD) was changed by the remote GATT client, or
-       * That a confirmation from the remote GATT Client was received upon a successful reception of the indication I.e. we sent an indication from our server to the client with sl_bt_gatt_server_send_indication()
-       */
+/*
+ @brief Server: a soft timer has expired
+ @param evt the sl_bt_evt_system_soft_timer_id event
+ @return none
+ */
+static void server_on_system_soft_timer (sl_bt_msg_t *evt)
+{
+  //LOG_INFO("sl_bt_evt_system_soft_timer_id\n\r");
+  //This event indicates that soft timer has expired.
+
+  energyCountWakeup (WAKEUP_SOFT_TIMER);
+  displayUpdate ();
+  for (int i = 0; i < BLE_MAX_CLIENTS; i++) {
+      if (ble_data.clients[i].in_use)
+        send_deferred_indication (&ble_data.clients[i]);
+  }
+} // server_on_system_soft_timer()
 
-    case sl_bt_evt_gatt_server_characteristic_status_id:
-      //LOG_INFO("sl_bt_evt_gatt_server_characteristic_status_id\n\r");
-      /*********
-       * HTM
-       *********/
-
-      /*******************************************************************************
-       * @brief Data structure of the characteristic_status event
-       ******************************************************************************/
-      //      PACKSTRUCT( struct sl_bt_evt_gatt_server_characteristic_status_s
-      //      {
-      //        uint8_t  connection;          /**< Connection handle */
-      //        uint16_t characteristic;      /**< GATT characteristic handle. This value is
-      //                                           normally received from the
-      //                                           gatt_characteristic event. */
-      //        uint8_t  status_flags;        /**< Enum @ref
-      //                                           sl_bt_gatt_server_characteristic_status_flag_t.
-      //                                           Describes whether Client Characteristic
-      //                                           Configuration was changed or if a
-      //                                           confirmation was received. Values:
-      //                                             - <b>sl_bt_gatt_server_client_config
-      //                                               (0x1):</b> Characteristic client
-      //                                               configuration has been changed.
-      //                                             - <b>sl_bt_gatt_server_confirmation
-      //                                               (0x2):</b> Characteristic confirmation
-      //                                               has been received. */
-      //        uint16_t client_config_flags; /**< Enum @ref
-      //                                           sl_bt_gatt_server_client_configuration_t.
-      //                                           This field carries the new value of the
-      //                                           Client Characteristic Configuration. If the
-      //                                           status_flags is 0x2 (confirmation
-      //                                           received), the value of this field can be
-      //                                           ignored. */
-      //        uint16_t client_config;       /**< The handle of client-config descriptor. */
-      //      });
-      //sl_bt_api.h: line 5300: sl_bt_gatt_server_characteristic_status_flag_t sl_bt_gatt_server_client_config = 0x1
-
-      // DOS - rewrite of this code:
-      // Client writes HTM CCCD
-      if ( (evt->data.evt_gatt_server_characteristic_status.characteristic == gattdb_temperature_measurement) &&
-          (evt->data.evt_gatt_server_characteristic_status.status_flags == sl_bt_gatt_server_client_config) )
+/*
+ @brief Server: a client changed one of our CCCDs, or confirmed an indication we sent with
+        sl_bt_gatt_server_send_indication()
+ @param evt the sl_bt_evt_gatt_server_characteristic_status_id event
+ @return none
+ */
+static void server_on_gatt_server_characteristic_status (sl_bt_msg_t *evt)
+{
+  ble_client_t *client; // the client the event belongs to
+
+  //LOG_INFO("sl_bt_evt_gatt_server_characteristic_status_id\n\r");
+  /*********
+   * HTM
+   *********/
+
+  /*******************************************************************************
+   * @brief Data structure of the characteristic_status event
+   ******************************************************************************/
+  //      PACKSTRUCT( struct sl_bt_evt_gatt_server_characteristic_status_s
+  //      {
+  //        uint8_t  connection;          /**< Connection handle */
+  //        uint16_t characteristic;      /**< GATT characteristic handle. This value is
+  //                                           normally received from the
+  //                                           gatt_characteristic event. */
+  //        uint8_t  status_flags;        /**< Enum @ref
+  //                                           sl_bt_gatt_server_characteristic_status_flag_t.
+  //                                           Describes whether Client Characteristic
+  //                                           Configuration was changed or if a
+  //                                           confirmation was received. Values:
+  //                                             - <b>sl_bt_gatt_server_client_config
+  //                                               (0x1):</b> Characteristic client
+  //                                               configuration has been changed.
+  //                                             - <b>sl_bt_gatt_server_confirmation
+  //                                               (0x2):</b> Characteristic confirmation
+  //                                               has been received. */
+  //        uint16_t client_config_flags; /**< Enum @ref
+  //                                           sl_bt_gatt_server_client_configuration_t.
+  //                                           This field carries the new value of the
+  //                                           Client Characteristic Configuration. If the
+  //                                           status_flags is 0x2 (confirmation
+  //                                           received), the value of this field can be
+  //                                           ignored. */
+  //        uint16_t client_config;       /**< The handle of client-config descriptor. */
+  //      });
+  //sl_bt_api.h: line 5300: sl_bt_gatt_server_characteristic_status_flag_t sl_bt_gatt_server_client_config = 0x1
+
+  // CCCDs and confirmations are per client
+  client = get_client_by_connection (evt->data.evt_gatt_server_characteristic_status.connection);
+  if (client == NULL)
+    return;
+
+  // DOS - rewrite of this code:
+  // Client writes HTM CCCD
+  if ( (evt->data.evt_gatt_server_characteristic_status.characteristic == gattdb_temperature_measurement) &&
+      (evt->data.evt_gatt_server_characteristic_status.status_flags == sl_bt_gatt_server_client_config) )
+    {
+      //sl_bt_api.h line 3735: sl_bt_gatt_client_config_flag_t sl_bt_gatt_disable = 0x0
+      if (evt->data.evt_gatt_server_characteristic_status.client_config_flags == sl_bt_gatt_disable)
         {
-          //sl_bt_api.h line 3735: sl_bt_gatt_client_config_flag_t sl_bt_gatt_disable = 0x0
-          if (evt->data.evt_gatt_server_characteristic_status.client_config_flags == sl_bt_gatt_disable)
-            {
-              ble_data.ok_to_send_htm_indications = false;
-              // DOS             displayPrintf (DISPLAY_ROW_TEMPVALUE, "");
-              // DOS             displayPrintf (DISPLAY_ROW_9, "");
-              gpioLed0SetOff();
-            }
-          //sl_bt_api.h line 3735: sl_bt_gatt_client_config_flag_t sl_bt_gatt_indication = 0x02
-          else if (evt->data.evt_gatt_server_characteristic_status.client_config_flags == sl_bt_gatt_indication)
-            {
-              ble_data.ok_to_send_htm_indications = true;
-              // DOS             displayPrintf (DISPLAY_ROW_9, "");
-              gpioLed0SetOn();
+          client->ok_to_send_htm_indications = false;
+          // DOS             displayPrintf (DISPLAY_ROW_TEMPVALUE, "");
+          // DOS             displayPrintf (DISPLAY_ROW_9, "");
+          if (!any_client_subscribed (true))
+            gpioLed0SetOff();
+        }
+      //sl_bt_api.h line 3735: sl_bt_gatt_client_config_flag_t sl_bt_gatt_indication = 0x02
+      else if (evt->data.evt_gatt_server_characteristic_status.client_config_flags == sl_bt_gatt_indication)
+        {
+          client->ok_to_send_htm_indications = true;
+          // The client is done with discovery and subscribing
+          connParamsSetBusy (client->connection, CONN_BUSY_SETUP, false);
+          // DOS             displayPrintf (DISPLAY_ROW_9, "");
+          gpioLed0SetOn();
 
-            }
         }
+    }
 
-      // DOS - rewrite of this code:
-      // Client writes BTN CCCD
-      if ( (evt->data.evt_gatt_server_characteristic_status.characteristic == gattdb_button_state) &&
-          (evt->data.evt_gatt_server_characteristic_status.status_flags == sl_bt_gatt_server_client_config) )
+  // DOS - rewrite of this code:
+  // Client writes BTN CCCD
+  if ( (evt->data.evt_gatt_server_characteristic_status.characteristic == gattdb_button_state) &&
+      (evt->data.evt_gatt_server_characteristic_status.status_flags == sl_bt_gatt_server_client_config) )
+    {
+      if (evt->data.evt_gatt_server_characteristic_status.client_config_flags == sl_bt_gatt_disable)
         {
-          if (evt->data.evt_gatt_server_characteristic_status.client_config_flags == sl_bt_gatt_disable)
-            {
-              //LOG_INFO("sl_bt_evt_gatt_server_characteristic_status_id, button_state characteristic, ok to send pb0 indications false\n\r");
-              ble_data.ok_to_send_PB0_indications = false;
-              //DOS displayPrintf (DISPLAY_ROW_9, "");
-              gpioLed1SetOff ();
-            }
-          else if (evt->data.evt_gatt_server_characteristic_status.client_config_flags == sl_bt_gatt_indication)
-            {
-              //LOG_INFO("sl_bt_evt_gatt_server_characteristic_status_id, button_state characteristic, ok to send pb0 indications true\n\r");
-              ble_data.ok_to_send_PB0_indications = true;
-              //DOS displayPrintf (DISPLAY_ROW_9, "Button Released");
-              gpioLed1SetOn ();
+          //LOG_INFO("sl_bt_evt_gatt_server_characteristic_status_id, button_state characteristic, ok to send pb0 indications false\n\r");
+          client->ok_to_send_PB0_indications = false;
+          //DOS displayPrintf (DISPLAY_ROW_9, "");
+          if (!any_client_subscribed (false))
+            gpioLed1SetOff ();
+        }
+      else if (evt->data.evt_gatt_server_characteristic_status.client_config_flags == sl_bt_gatt_indication)
+        {
+          //LOG_INFO("sl_bt_evt_gatt_server_characteristic_status_id, button_state characteristic, ok to send pb0 indications true\n\r");
+          client->ok_to_send_PB0_indications = true;
+          //DOS displayPrintf (DISPLAY_ROW_9, "Button Released");
+          gpioLed1SetOn ();
 
-            }
         }
+    }
 
 
-      // DOS - rewrite of this code:
-      // An indication confirmation was received from the Client
-      if (evt->data.evt_gatt_server_characteristic_status.status_flags == sl_bt_gatt_server_confirmation) // indication received
+  // DOS - rewrite of this code:
+  // An indication confirmation was received from the Client
+  if (evt->data.evt_gatt_server_characteristic_status.status_flags == sl_bt_gatt_server_confirmation) // indication received
+    {
+      //LOG_INFO("sl_bt_evt_gatt_server_characteristic_status_id, button_state characteristic, indication inflight false\n\r");
+      if (client->indication_inflight)
         {
-          //LOG_INFO("sl_bt_evt_gatt_server_characteristic_status_id, button_state characteristic, indication inflight false\n\r");
-          ble_data.indication_inflight = false;
+          uint32_t latency_ms = sl_sleeptimer_tick_to_ms (sl_sleeptimer_get_tick_count () - client->indication_sent_tick);
+
+          client->indications++;
+          client->latency_sum_ms += latency_ms;
+          if (latency_ms > client->latency_max_ms)
+            client->latency_max_ms = latency_ms;
         }
+      client->indication_inflight = false;
+      send_deferred_indication (client);
+    }
+} // server_on_gatt_server_characteristic_status()
 
+/*
+ @brief Server: a client did not confirm an indication in time
+ @param evt the sl_bt_evt_gatt_server_indication_timeout_id event
+ @return none
+ */
+static void server_on_gatt_server_indication_timeout (sl_bt_msg_t *evt)
+{
+  ble_client_t *client; // the client the event belongs to
+
+  LOG_ERROR("Indication timed out on connection %d\n\r", (int) evt->data.evt_gatt_server_indication_timeout.connection);
+  client = get_client_by_connection (evt->data.evt_gatt_server_indication_timeout.connection);
+  if (client == NULL)
+    return;
+  client->indication_inflight = false;
+  // No more ATT PDUs may go out on this connection after the timeout, drop what is queued
+  if (get_queue_depth (&client->indication_queue) > 0) {
+      LOG_ERROR("Dropped %u queued indications on connection %d", (unsigned int) get_queue_depth (&client->indication_queue),
+                (int) client->connection);
+      client->indication_queue.rptr = client->indication_queue.wptr;
+  }
+  connParamsUpdate (client->connection, 0);
+} // server_on_gatt_server_indication_timeout()
 
-      break;
+/*
+ @brief Server: a new bonding request was received and needs to be confirmed
+ @param evt the sl_bt_evt_sm_confirm_bonding_id event
+ @return none
+ */
+static void server_on_sm_confirm_bonding (sl_bt_msg_t *evt)
+{
+  sl_status_t sc;
 
+  //LOG_INFO("sl_bt_evt_sm_confirm_bonding_id\n\r");
+  /*
+   *
+   * Accept or reject the bonding request.
+   * @param[in] connection Connection handle
+   * @param[in] confirm Acceptance. Values:
+   *     - <b>0:</b> Reject
+   *     - <b>1:</b> Accept bonding request
+   */
+  sc = sl_bt_sm_bonding_confirm (evt->data.evt_sm_confirm_bonding.connection, 1);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_sm_bonding_confirm() returned != 0 status=0x%04x",(unsigned int) sc);
+    }
+} // server_on_sm_confirm_bonding()
 
-    case sl_bt_evt_gatt_server_indication_timeout_id:
-      LOG_ERROR("Indication timed out\n\r");
-      ble_data.indication_inflight = false; //indication reached
-      break;
+/*
+ @brief Server: a passkey needs to be displayed and confirmed by the user
+ @param evt the sl_bt_evt_sm_confirm_passkey_id event
+ @return none
+ */
+static void server_on_sm_confirm_passkey (sl_bt_msg_t *evt)
+{
+  ble_client_t *client; // the client the event belongs to
+
+  //LOG_INFO("sl_bt_evt_sm_confirm_passkey_id\n\r");
+  // A known peer pairing again is confirmed by the user too, it may not be that peer
+  client = get_client_by_connection (evt->data.evt_sm_confirm_passkey.connection);
+  if (client == NULL)
+    return;
+  client->passkey = evt->data.evt_sm_confirm_passkey.passkey;
+  client->passkey_available = true;
+  connParamsSetBusy (client->connection, CONN_BUSY_PAIRING, true);
+  // One passkey on the LCD at a time, the first client waiting, PB0 confirms that one
+  display_pending_passkey ();
+} // server_on_sm_confirm_passkey()
 
-      //Indicates a user request to display that the new bonding request is received and for the user to confirm the request.
-    case sl_bt_evt_sm_confirm_bonding_id:
-      //LOG_INFO("sl_bt_evt_sm_confirm_bonding_id\n\r");
-      // ble_data.connection_handle = evt->data.evt_sm_confirm_bonding.connection;
-      /*
-       *
-       * Accept or reject the bonding request.
-       * @param[in] connection Connection handle
-       * @param[in] confirm Acceptance. Values:
-       *     - <b>0:</b> Reject
-       *     - <b>1:</b> Accept bonding request
-       */
-      sc = sl_bt_sm_bonding_confirm (ble_data.connection_handle, 1);
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_sm_bonding_confirm() returned != 0 status=0x%04x",(unsigned int) sc);
-        }
-      // ble_data.bonding_flag = true;
+/*
+ @brief Server: the pairing or bonding procedure completed successfully
+ @param evt the sl_bt_evt_sm_bonded_id event
+ @return none
+ */
+static void server_on_sm_bonded (sl_bt_msg_t *evt)
+{
+  ble_client_t *client; // the client the event belongs to
+
+  //LOG_INFO("sl_bt_evt_sm_bonded_id\n\r");
+  bondingBonded (evt->data.evt_sm_bonded.connection, evt->data.evt_sm_bonded.bonding);
+  connParamsSetBusy (evt->data.evt_sm_bonded.connection, CONN_BUSY_PAIRING, false);
+  displayPrintf (DISPLAY_ROW_CONNECTION, "Bonded");
+  client = get_client_by_connection (evt->data.evt_sm_bonded.connection);
+  if (client != NULL) {
+      client->bonding_flag = true;
+      client->passkey_available = false;
+  }
+  display_pending_passkey ();
+} // server_on_sm_bonded()
 
-      break;
+/*
+ @brief Server: the pairing or bonding procedure failed
+ @param evt the sl_bt_evt_sm_bonding_failed_id event
+ @return none
+ */
+static void server_on_sm_bonding_failed (sl_bt_msg_t *evt)
+{
+  ble_client_t *client; // the client the event belongs to
+
+  //LOG_INFO("sl_bt_evt_sm_bonding_failed_id\n\r");
+  LOG_ERROR("Bonding failed with reason: 0x%04x", evt->data.evt_sm_bonding_failed.reason);
+  bondingFailed (evt->data.evt_sm_bonding_failed.connection, evt->data.evt_sm_bonding_failed.reason);
+  connParamsSetBusy (evt->data.evt_sm_bonding_failed.connection, CONN_BUSY_PAIRING, false);
+  client = get_client_by_connection (evt->data.evt_sm_bonding_failed.connection);
+  if (client != NULL) {
+      client->bonding_flag = false;
+      client->passkey_available = false;
+  }
+  display_pending_passkey ();
+} // server_on_sm_bonding_failed()
 
-      //Indicates a request for passkey display and confirmation by the user.
-    case sl_bt_evt_sm_confirm_passkey_id:
-      //LOG_INFO("sl_bt_evt_sm_confirm_passkey_id\n\r");
-      ble_data.passkey = evt->data.evt_sm_confirm_passkey.passkey;
-      ble_data.passkey_available = true;
-      displayPrintf (DISPLAY_ROW_PASSKEY, "%d", ble_data.passkey);
-      displayPrintf (DISPLAY_ROW_ACTION, "Confirm with PB0");
+#endif
 
-      break;
+#if BUILD_INCLUDES_BLE_CLIENT
+/*
+ @brief Client: returns the first server with a passkey waiting for PB0, its passkey is the one on the LCD
+ @param none
+ @return the server, NULL if none
+ */
+static ble_server_t *pending_passkey_server (void)
+{
+  for (int i = 0; i < BLE_MAX_SERVERS; i++) {
+      if (ble_data.servers[i].in_use && ble_data.servers[i].passkey_available)
+        return &ble_data.servers[i];
+  }
+  return NULL;
+}
 
-      //Triggered after the pairing or bonding procedure is successfully completed.
-    case sl_bt_evt_sm_bonded_id:
-      //LOG_INFO("sl_bt_evt_sm_bonded_id\n\r");
-      displayPrintf (DISPLAY_ROW_CONNECTION, "Bonded");
-      displayPrintf (DISPLAY_ROW_PASSKEY, " ");
-      displayPrintf (DISPLAY_ROW_ACTION, " ");
-      ble_data.bonding_flag = true;
-      ble_data.passkey_available = false;
-
-      break;
-    case sl_bt_evt_sm_bonding_failed_id:
-      //LOG_INFO("sl_bt_evt_sm_bonding_failed_id\n\r");
-      LOG_ERROR("Bonding failed with reason: 0x%04x", evt->data.evt_sm_bonding_failed.reason);
-      ble_data.bonding_flag = false;
-      ble_data.passkey_available = false;
-      break;
-  } // end - switch for SERVER
+/*
+ @brief Client: shows the passkey of the next server waiting for PB0, or clears it
+ @param none
+ @return none
+ */
+static void display_pending_server_passkey (void)
+{
+  ble_server_t *server = pending_passkey_server ();
 
-#else
+  display_passkey ((server != NULL) ? &server->passkey : NULL);
+}
 
-  //DOS ble_data_struct_t *ble_data_ptr = get_ble_data_ptr(); // this is local to this file !!!
+/*
+ @brief Client: the device has started and the radio is ready. Do not call any stack API commands
+        before receiving this boot event! Including starting BT stack soft timers!
+ @param evt the sl_bt_evt_system_boot_id event
+ @return none
+ */
+static void client_on_system_boot (sl_bt_msg_t *evt)
+{
+  sl_status_t sc;
 
-  switch (SL_BT_MSG_ID(evt->header))
-  {
+  //LOG_INFO("sl_bt_evt_system_boot_id\n\r");
+  //DOS ble_data.gatt_procedure_complete = false;
+  ble_data.connection_open = false;
 
-    // ******************************************************
-    // Events common to both Servers and Clients
-    // ******************************************************
-    // --------------------------------------------------------
-    // This event indicates the device has started and the radio is ready.
-    // Do not call any stack API commands before receiving this boot event!
-    // Including starting BT stack soft timers!
-    // --------------------------------------------------------
-    case sl_bt_evt_system_boot_id:
-      //LOG_INFO("sl_bt_evt_system_boot_id\n\r");
-      //DOS ble_data.gatt_procedure_complete = false;
-      ble_data.connection_open = false;
-      ble_data.passkey_available  = false;
-      ble_data.bonding_flag = false; //yet to bond
-      ble_data.ok_to_send_PB0_indications = false;
+  /* Read the Bluetooth identity address used by the device, which can be a public or random static device address. */
+  sc = sl_bt_system_get_identity_address(&ble_data.myAddress, &ble_data.myAddressType);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_system_get_identity_address() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+  /*
+   *  Set the scan mode on the specified PHYs. If the device is currently scanning
+   *  for advertising devices on PHYs, new parameters will take effect when
+   *  scanning is restarted
+   *  @param[in] scan_mode @parblock
+   *   Scan mode. Values:
+   *     - <b>0:</b> Passive scanning
+   *     - <b>1:</b> Active scanning
+   */
+  sc = sl_bt_scanner_set_mode(sl_bt_gap_1m_phy,0x00); //second argument: 0 Passive scanning
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_scanner_set_mode() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+  /*
+   *  Set the default Bluetooth connection parameters. The values are valid for all
+   *  subsequent connections initiated by this device.
+   */
+  // Connections start with the fast profile, the parameter manager relaxes them later
+  sc = sl_bt_connection_set_default_parameters(CONN_FAST_INTERVAL_MIN, CONN_FAST_INTERVAL_MAX, CONN_FAST_LATENCY,
+                                               CONN_FAST_TIMEOUT, 0, 4);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_connection_set_default_parameters() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+  /*
+   * Start the GAP discovery procedure to scan for advertising devices on the
+   * specified scanning PHYs. The scan filter sets the timing and backs it off
+   * while no server is seen.
+   */
+  clientValuesInit();
+  historyInit();
+  scanFilterInit();
+  scanFilterAddServer(roleServerAddress(), SERVER_BT_ADDRESS_TYPE);
+#if BLE_MAX_SERVERS > 1
+  // Any other thermometer server too, they advertise the Health Thermometer service
+  scanFilterSetServiceUuid(ServiceUUID, sizeof(ServiceUUID));
+#endif
+  scanFilterStartScan();
+  /*
+   * Configure security requirements and I/O capabilities of the system.
+   */
+  sc = sl_bt_sm_configure(0x0F, sm_io_capability_displayyesno);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_sm_configure() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+  // Bonds survive disconnects and resets, bounded table with LRU replacement
+  bondingInit();
+  // Offer the largest ATT MTU for bulk transfers
+  linkInit();
+  displayPrintf(DISPLAY_ROW_NAME, "Client");
+  displayPrintf(DISPLAY_ROW_BTADDR, "%02x:%02x:%02x:%02x:%02x:%02x",
+                ble_data.myAddress.addr[0], ble_data.myAddress.addr[1],
+                ble_data.myAddress.addr[2], ble_data.myAddress.addr[3],
+                ble_data.myAddress.addr[4], ble_data.myAddress.addr[5]);
+  displayPrintf(DISPLAY_ROW_CONNECTION, "Discovering");
+  displayPrintf(DISPLAY_ROW_ASSIGNMENT,"A9");
+} // client_on_system_boot()
 
-      /* Read the Bluetooth identity address used by the device, which can be a public or random static device address. */
-      sc = sl_bt_system_get_identity_address(&ble_data.myAddress, &ble_data.myAddressType);
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_system_get_identity_address() returned != 0 status=0x%04x", (unsigned int) sc);
-        }
-      /*
-       *  Set the scan mode on the specified PHYs. If the device is currently scanning
-       *  for advertising devices on PHYs, new parameters will take effect when
-       *  scanning is restarted
-       *  @param[in] scan_mode @parblock
-       *   Scan mode. Values:
-       *     - <b>0:</b> Passive scanning
-       *     - <b>1:</b> Active scanning
-       */
-      sc = sl_bt_scanner_set_mode(sl_bt_gap_1m_phy,0x00); //second argument: 0 Passive scanning
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_scanner_set_mode() returned != 0 status=0x%04x", (unsigned int) sc);
-        }
-      /*
-       * Set the scanning timing parameters on the specified PHYs. If the device is
-       * currently scanning for advertising devices on PHYs, new parameters will take
-       * effect when scanning is restarted.
-       */
-      sc = sl_bt_scanner_set_timing(sl_bt_gap_1m_phy, scan_interval ,scan_window);
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_scanner_set_timing() returned != 0 status=0x%04x", (unsigned int) sc);
-        }
-      /*
-       *  Set the default Bluetooth connection parameters. The values are valid for all
-       *  subsequent connections initiated by this device.
-       */
-      sc = sl_bt_connection_set_default_parameters(connection_interval_min, connection_interval_max,  peripheral_latency,
-                                                   supervision_timeout, 0,4);
-      /*
-       * Start the GAP discovery procedure to scan for advertising devices on the
-       * specified scanning PHYs
-       */
-      sc = sl_bt_scanner_start(sl_bt_gap_1m_phy, sl_bt_scanner_discover_generic);
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_scanner_start() returned != 0 status=0x%04x", (unsigned int) sc);
-        }
-      /*
-       * Configure security requirements and I/O capabilities of the system.
-       */
-      sc = sl_bt_sm_configure(0x0F, sm_io_capability_displayyesno);
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_sm_configure() returned != 0 status=0x%04x", (unsigned int) sc);
-        }
-      /*
-       * Delete all bonding information and accept list filtering from the persistent
-       * store. This will also delete device local identity resolving key (IRK).
-       */
-      sc = sl_bt_sm_delete_bondings ();
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_sm_delete_bondings() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
-        }
-      displayPrintf(DISPLAY_ROW_NAME, "Client");
-      displayPrintf(DISPLAY_ROW_BTADDR, "%02x:%02x:%02x:%02x:%02x:%02x",
-                    ble_data.myAddress.addr[0], ble_data.myAddress.addr[1],
-                    ble_data.myAddress.addr[2], ble_data.myAddress.addr[3],
-                    ble_data.myAddress.addr[4], ble_data.myAddress.addr[5]);
-      displayPrintf(DISPLAY_ROW_CONNECTION, "Discovering");
-      displayPrintf(DISPLAY_ROW_ASSIGNMENT,"A9");
-      break;
-
-      //This event indicates that a new connection was opened.
-    case sl_bt_evt_connection_opened_id:
-      //LOG_INFO("sl_bt_evt_connection_opened_id\n\r");
-      //DOS ble_data.gatt_procedure_complete = false;
-      ble_data.connection_open = true;
-      ble_data.connection_handle = evt->data.evt_connection_opened.connection; //saving connection handle
-      ble_data.ok_to_send_PB0_indications = true; // DOS for the Client this is "set" by the discovery state machine
-      displayPrintf(DISPLAY_ROW_BTADDR2, "%02x:%02x:%02x:%02x:%02x:%02x",
-                    serverAddress.addr[0],serverAddress.addr[1],
-                    serverAddress.addr[2],serverAddress.addr[3],
-                    serverAddress.addr[4],serverAddress.addr[5]);
-      displayPrintf(DISPLAY_ROW_CONNECTION, "Connected");
-
-      break;
-
-
-      //This event indicates that a connection was closed.
-    case sl_bt_evt_connection_closed_id:
-      //LOG_INFO("sl_bt_evt_connection_closed_id\n\r");
-      //DOS ble_data.gatt_procedure_complete = false;
-      ble_data.connection_open = false;
-      ble_data.ok_to_send_htm_indications = false;
-      ble_data.passkey_available = false;
-      ble_data.ok_to_send_PB0_indications = false;
-      ble_data.bonding_flag = false;
+/*
+ @brief Client: a new connection was opened
+ @param evt the sl_bt_evt_connection_opened_id event
+ @return none
+ */
+static void client_on_connection_opened (sl_bt_msg_t *evt)
+{
+  //LOG_INFO("sl_bt_evt_connection_opened_id\n\r");
+  //DOS ble_data.gatt_procedure_complete = false;
+  ble_data.connection_open = true;
+  {
+    ble_server_t *server = NULL;
+
+    // First free server slot
+    for (int i = 0; (i < BLE_MAX_SERVERS) && (server == NULL); i++)
+      server = (ble_data.servers[i].in_use) ? NULL : &ble_data.servers[i];
+    if (server == NULL)
+      {
+        // Only opened from the scan report handler when a slot is free, should not happen
+        LOG_ERROR("No free server slot for connection %d", (int) evt->data.evt_connection_opened.connection);
+        sl_bt_connection_close(evt->data.evt_connection_opened.connection);
+        return;
+      }
+    memset(server, 0, sizeof(*server));
+    server->in_use     = true;
+    server->connection = evt->data.evt_connection_opened.connection;
+    server->address    = evt->data.evt_connection_opened.address;
+    server->ok_to_send_PB0_indications = true; // DOS for the Client this is "set" by the discovery state machine
+    ble_data.server_count++;
+    display_server(server);
+    displayPrintf(DISPLAY_ROW_BTADDR2, "%02x:%02x:%02x:%02x:%02x:%02x",
+                  server->address.addr[0],server->address.addr[1],
+                  server->address.addr[2],server->address.addr[3],
+                  server->address.addr[4],server->address.addr[5]);
+  }
+  displayPrintf(DISPLAY_ROW_CONNECTION, "Connected %d/%d", (int) ble_data.server_count, BLE_MAX_SERVERS);
+  scanFilterConnected();
+  // Keep scanning for the other servers
+  if (ble_data.server_count < BLE_MAX_SERVERS)
+    scanFilterStartScan();
+  // A bonded server: encrypt with the stored LTK now, before discovery hits an encrypted attribute
+  bondingConnectionOpened(evt->data.evt_connection_opened.connection, evt->data.evt_connection_opened.bonding);
+  // Fast until the discovery state machine reports indications enabled
+  connParamsOpened(evt->data.evt_connection_opened.connection);
+  // Upgrade to the 2M PHY, 1M stays if the server refuses
+  linkOpened(evt->data.evt_connection_opened.connection);
+} // client_on_connection_opened()
+
+/*
+ @brief Client: a connection was closed
+ @param evt the sl_bt_evt_connection_closed_id event
+ @return none
+ */
+static void client_on_connection_closed (sl_bt_msg_t *evt)
+{
+  //LOG_INFO("sl_bt_evt_connection_closed_id\n\r");
+  //DOS ble_data.gatt_procedure_complete = false;
+  {
+    ble_server_t *server = get_server_by_connection(evt->data.evt_connection_closed.connection);
+
+    if (server)
+      {
+        clientValuesForget(server->connection);
+        server->in_use = false;
+        ble_data.server_count--;
+        display_server(server);
+      }
+  }
+  // The passkey shown may have belonged to this connection
+  display_pending_server_passkey ();
+  ble_data.connection_open = (ble_data.server_count > 0);
+  if (!ble_data.connection_open)
+    {
       gpioLed0SetOff ();
       gpioLed1SetOff ();
       displayPrintf(DISPLAY_ROW_CONNECTION, "Discovering");
-      displayPrintf(DISPLAY_ROW_TEMPVALUE, "");
       displayPrintf(DISPLAY_ROW_BTADDR2,"");
       //displayPrintf (DISPLAY_ROW_ACTION, "");
-      displayPrintf (DISPLAY_ROW_PASSKEY, "");
       displayPrintf (DISPLAY_ROW_9, "");
-      /*Start the GAP discovery procedure to scan for advertising devices on the
-       * specified scanning PHYs
-       */
-      sc = sl_bt_scanner_start(sl_bt_gap_1m_phy, sl_bt_scanner_discover_generic);
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_scanner_start() returned != 0 status=0x%04x", (unsigned int) sc);
-        }
-      sc = sl_bt_sm_delete_bondings ();
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_sm_delete_bondings() returned != 0 status=0x%04x\n\r",(unsigned int) sc);
-        }
-
-      break;
+    }
+  else
+    displayPrintf(DISPLAY_ROW_CONNECTION, "Connected %d/%d", (int) ble_data.server_count, BLE_MAX_SERVERS);
+  /*Start the GAP discovery procedure to scan for advertising devices on the
+   * specified scanning PHYs
+   */
+  scanFilterStartScan();
+  bondingConnectionClosed(evt->data.evt_connection_closed.connection);
+  connParamsClosed(evt->data.evt_connection_closed.connection);
+  linkClosed(evt->data.evt_connection_closed.connection);
+  gattBatchClosed(evt->data.evt_connection_closed.connection);
+} // client_on_connection_closed()
 
+/*
+ @brief Client: a soft timer has expired
+ @param evt the sl_bt_evt_system_soft_timer_id event
+ @return none
+ */
+static void client_on_system_soft_timer (sl_bt_msg_t *evt)
+{
+  energyCountWakeup (WAKEUP_SOFT_TIMER);
+  displayUpdate();
+} // client_on_system_soft_timer()
 
-      //This event indicates that a soft timer has expired.
-    case sl_bt_evt_system_soft_timer_id:
-      displayUpdate();
-      break;
+/*
+ @brief Client: connection parameters changed, also sent when a connection is established and when
+        encryption is resumed with a stored bond (there is no sl_bt_evt_sm_bonded_id for it)
+ @param evt the sl_bt_evt_connection_parameters_id event
+ @return none
+ */
+static void client_on_connection_parameters (sl_bt_msg_t *evt)
+{
+  connParamsChanged(&evt->data.evt_connection_parameters);
+  linkParameters(&evt->data.evt_connection_parameters);
+  if (bondingEncryptionResumed(&evt->data.evt_connection_parameters)) {
+      ble_server_t *server = get_server_by_connection(evt->data.evt_connection_parameters.connection);
+
+      displayPrintf(DISPLAY_ROW_CONNECTION, "Bonded");
+      if (server != NULL) {
+          server->bonding_flag = true;
+          server->passkey_available = false;
+      }
+      display_pending_server_passkey();
+  }
+} // client_on_connection_parameters()
 
+/*
+ @brief Client: PHY update procedure completed, 2M or the 1M fallback
+ @param evt the sl_bt_evt_connection_phy_status_id event
+ @return none
+ */
+static void client_on_connection_phy_status (sl_bt_msg_t *evt)
+{
+  linkPhyStatus(&evt->data.evt_connection_phy_status);
+} // client_on_connection_phy_status()
 
+/*
+ @brief Client: ATT MTU agreed with the peer, sets the largest notification/indication payload
+ @param evt the sl_bt_evt_gatt_mtu_exchanged_id event
+ @return none
+ */
+static void client_on_gatt_mtu_exchanged (sl_bt_msg_t *evt)
+{
+  linkMtuExchanged(&evt->data.evt_gatt_mtu_exchanged);
+} // client_on_gatt_mtu_exchanged()
 
-      /*********************************/
-      /*Events only for Masters/Clients*/
-      /*********************************/
+/*
+ @brief Client: an advertising or scan response packet was received by sl_bt_scanner_start()
+ @param evt the sl_bt_evt_scanner_scan_report_id event
+ @return none
+ */
+static void client_on_scanner_scan_report (sl_bt_msg_t *evt)
+{
+  sl_status_t sc;
+  uint8_t     connection;
+
+  //LOG_INFO("sl_bt_evt_scanner_scan_report_id\n\r");
+  /*
+   * PACKSTRUCT( struct sl_bt_evt_scanner_scan_report_s
+   * {
+   * uint8_t    packet_type;       < <b>Bits 0..2</b> : advertising packet type
+                                   - <b>000</b> : Connectable scannable
+                                     undirected advertising
+                                   - <b>001</b> : Connectable undirected
+                                     advertising
+                                   - <b>010</b> : Scannable undirected
+                                     advertising
+                                   - <b>011</b> : Non-connectable
+                                     non-scannable undirected advertising
+                                   - <b>100</b> : Scan Response. Note that
+                                     this is received only if the device is
+                                     in active scan mode.
+
+                                 <b>Bits 3..4</b> : Reserved for future
+
+                                 <b>Bits 5..6</b> : data completeness
+                                   - <b>00:</b> Complete
+                                   - <b>01:</b> Incomplete, more data to
+                                     come in new events
+                                   - <b>10:</b> Incomplete, data truncated,
+                                     no more to come
+
+                                 <b>Bit 7</b> : legacy or extended
+                                 advertising
+                                   - <b>0:</b> Legacy advertising PDUs used
+                                   - <b>1:</b> Extended advertising PDUs
+                                     used
+  bd_addr    address;           < Bluetooth address of the remote device
+  uint8_t    address_type;      < Advertiser address type. Values:
+                                   - <b>0:</b> Public address
+                                   - <b>1:</b> Random address
+                                   - <b>255:</b> No address provided
+                                     (anonymous advertising)
+  .....}*/
+#if BROADCAST_SCAN_ONLY
+  // Dashboard mode: show the servers' broadcast readings, never connect
+  {
+    broadcast_reading_t reading;
+    int                 sender = broadcastReceived(&evt->data.evt_scanner_scan_report, &reading);
+
+    if (sender >= 0)
+      displayPrintf(server_display_rows[sender], "%02x%02x T=%d #%u",
+                    evt->data.evt_scanner_scan_report.address.addr[1],
+                    evt->data.evt_scanner_scan_report.address.addr[0],
+                    reading.temperature_centi_c / 100, (unsigned int) reading.sequence);
+  }
+  return;
+#endif
+  // Connectable report from one of our servers, see src/scan_filter.c
+  if (scanFilterMatch(&evt->data.evt_scanner_scan_report) &&
+      (ble_data.server_count < BLE_MAX_SERVERS) &&
+      (get_server_by_address(&evt->data.evt_scanner_scan_report.address) == NULL))
+    {
+      scanFilterStopScan();
       /*
-       * Received for advertising or scan response packets generated by: sl_bt_scanner_start().
+       * Connect to an advertising device with the specified initiating PHY on which
+       * connectable advertisements on primary advertising channels are received. The
+       * Bluetooth stack will enter a state where it continuously scans for the
+       * connectable advertising packets from the remote device, which matches the
+       * Bluetooth address given as a parameter
        */
-    case sl_bt_evt_scanner_scan_report_id:
-      //LOG_INFO("sl_bt_evt_scanner_scan_report_id\n\r");
-      /*
-       * PACKSTRUCT( struct sl_bt_evt_scanner_scan_report_s
-       * {
-       * uint8_t    packet_type;       < <b>Bits 0..2</b> : advertising packet type
-                                       - <b>000</b> : Connectable scannable
-                                         undirected advertising
-                                       - <b>001</b> : Connectable undirected
-                                         advertising
-                                       - <b>010</b> : Scannable undirected
-                                         advertising
-                                       - <b>011</b> : Non-connectable
-                                         non-scannable undirected advertising
-                                       - <b>100</b> : Scan Response. Note that
-                                         this is received only if the device is
-                                         in active scan mode.
-
-                                     <b>Bits 3..4</b> : Reserved for future
-
-                                     <b>Bits 5..6</b> : data completeness
-                                       - <b>00:</b> Complete
-                                       - <b>01:</b> Incomplete, more data to
-                                         come in new events
-                                       - <b>10:</b> Incomplete, data truncated,
-                                         no more to come
-
-                                     <b>Bit 7</b> : legacy or extended
-                                     advertising
-                                       - <b>0:</b> Legacy advertising PDUs used
-                                       - <b>1:</b> Extended advertising PDUs
-                                         used
-      bd_addr    address;           < Bluetooth address of the remote device
-      uint8_t    address_type;      < Advertiser address type. Values:
-                                       - <b>0:</b> Public address
-                                       - <b>1:</b> Random address
-                                       - <b>255:</b> No address provided
-                                         (anonymous advertising)
-      .....}*/
-      if(evt->data.evt_scanner_scan_report.address_type == 0x00 && evt->data.evt_scanner_scan_report.packet_type == 0x00)       //Address type = Public address, Packet type = Connectable scannable undirected advertising
+      sc = sl_bt_connection_open(evt->data.evt_scanner_scan_report.address,
+                                 evt->data.evt_scanner_scan_report.address_type,
+                                 sl_bt_gap_1m_phy,
+                                 &connection); // the opened event brings it too
+      if (sc != SL_STATUS_OK)
         {
-          if((evt->data.evt_scanner_scan_report.address.addr[0] == serverAddress.addr[0]) &&
-              (evt->data.evt_scanner_scan_report.address.addr[1] == serverAddress.addr[1]) &&
-              (evt->data.evt_scanner_scan_report.address.addr[2] == serverAddress.addr[2]) &&
-              (evt->data.evt_scanner_scan_report.address.addr[3] == serverAddress.addr[3]) &&
-              (evt->data.evt_scanner_scan_report.address.addr[4] == serverAddress.addr[4]) &&
-              (evt->data.evt_scanner_scan_report.address.addr[5] == serverAddress.addr[5]))
-            {
-
-              //LOG_INFO("sl_bt_evt_scanner_scan_report_id\n\r");
-
-              // Stop scanning for advertising devices
-              sc = sl_bt_scanner_stop();
-              if (sc != SL_STATUS_OK)
-                {
-                  LOG_ERROR("sl_bt_scanner_stop() returned != 0 status=0x%04x", (unsigned int) sc);
-                }
-              /*
-               * Connect to an advertising device with the specified initiating PHY on which
-               * connectable advertisements on primary advertising channels are received. The
-               * Bluetooth stack will enter a state where it continuously scans for the
-               * connectable advertising packets from the remote device, which matches the
-               * Bluetooth address given as a parameter
-               */
-              sc = sl_bt_connection_open(evt->data.evt_scanner_scan_report.address,
-                                         evt->data.evt_scanner_scan_report.address_type,
-                                         sl_bt_gap_1m_phy,
-                                         &ble_data.connection_handle);
-              if (sc != SL_STATUS_OK)
-                {
-                  LOG_ERROR("sl_bt_connection_open() returned != 0 status=0x%04x", (unsigned int) sc);
-                }
-            }
+          LOG_ERROR("sl_bt_connection_open() returned != 0 status=0x%04x", (unsigned int) sc);
+          scanFilterStartScan(); // keep looking
         }
-      break;
-
-
-
-      /*We get this event when it’s ok to call the next GATT command*/
-    case sl_bt_evt_gatt_procedure_completed_id:
+    }
+} // client_on_scanner_scan_report()
 
+/*
+ @brief Client: a GATT procedure completed, it is ok to call the next GATT command
+ @param evt the sl_bt_evt_gatt_procedure_completed_id event
+ @return none
+ */
+static void client_on_gatt_procedure_completed (sl_bt_msg_t *evt)
+{
+  sl_status_t sc;
 
-      //Checking for error code when PB1 is pressed for first time
-      //LOG_INFO("sl_bt_evt_gatt_procedure_completed_id=%x\n\r", (unsigned int) evt->data.evt_gatt_procedure_completed.result);
+  //Checking for error code when PB1 is pressed for first time
+  //LOG_INFO("sl_bt_evt_gatt_procedure_completed_id=%x\n\r", (unsigned int) evt->data.evt_gatt_procedure_completed.result);
 
-      if(evt->data.evt_gatt_procedure_completed.result == 0x110F)
+  if(evt->data.evt_gatt_procedure_completed.result == 0x110F)
+    {
+      //LOG_INFO("   ***Calling sl_bt_sm_increase_security()\n\r");
+      sc = sl_bt_sm_increase_security(evt->data.evt_gatt_procedure_completed.connection);
+      if(sc != SL_STATUS_OK)
         {
-          //LOG_INFO("   ***Calling sl_bt_sm_increase_security()\n\r");
-          sc = sl_bt_sm_increase_security(ble_data.connection_handle);
-          if(sc != SL_STATUS_OK)
-            {
-              LOG_ERROR("sl_bt_sm_increase_security() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
-            }
+          LOG_ERROR("sl_bt_sm_increase_security() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
         }
+    }
+  // Next procedure of a PB1 batch read
+  gattBatchCompleted(&evt->data.evt_gatt_procedure_completed);
+} // client_on_gatt_procedure_completed()
 
-      break;
-
-
-
-      /* A GATT service in the remote GATT database was discovered*/
-    case sl_bt_evt_gatt_service_id:
-      //LOG_INFO("sl_bt_evt_gatt_service_id\n\r");
-
-      if (memcmp(evt->data.evt_gatt_service.uuid.data, ServiceUUID , sizeof(ServiceUUID)) == 0) {
-
-          ble_data.htm_service_handle = evt->data.evt_gatt_service.service;
-          //LOG_INFO("HTM Service Discovered");
-
-      }
-
-      if(memcmp(evt->data.evt_gatt_service.uuid.data, Button_ServiceUUID, sizeof(Button_ServiceUUID)) == 0) {
-
-          ble_data.button_service_handle = evt->data.evt_gatt_service.service;
-          //LOG_INFO("BTN Service Discovered");
-
-      }
-
-      break;
-
-
-      /* A GATT characteristic in the remote GATT database was discovered*/
-    case sl_bt_evt_gatt_characteristic_id:
-      //LOG_INFO("sl_bt_evt_gatt_characteristic_id\n\r");
-
-      if (memcmp(evt->data.evt_gatt_characteristic.uuid.data, CharacteristicUUID, sizeof(CharacteristicUUID)) == 0) {
+/*
+ @brief Client: a GATT service in the remote GATT database was discovered
+ @param evt the sl_bt_evt_gatt_service_id event
+ @return none
+ */
+static void client_on_gatt_service (sl_bt_msg_t *evt)
+{
+  ble_server_t *server; // the server the event belongs to
 
-          ble_data.htm_characteristic_handle = evt->data.evt_gatt_characteristic.characteristic;
-          //LOG_INFO("HTM Char Discovered");
+  //LOG_INFO("sl_bt_evt_gatt_service_id\n\r");
 
+  // Works for both by-UUID discovery and the single pass discovery of all services
+  server = get_server_by_connection(evt->data.evt_gatt_service.connection);
+  for (uint32_t i = 0; (server != NULL) && (i < DISCOVERY_SERVICE_COUNT); i++) {
+      if (uuid_matches (discovery_services[i].uuid, discovery_services[i].uuid_len,
+                        &evt->data.evt_gatt_service.uuid)) {
+          DISCOVERED_SERVICE(server, &discovery_services[i]) = evt->data.evt_gatt_service.service;
+          break;
       }
+  }
+} // client_on_gatt_service()
 
-      if(memcmp(evt->data.evt_gatt_characteristic.uuid.data, Button_CharacteristicUUID , sizeof(Button_CharacteristicUUID)) == 0) {
+/*
+ @brief Client: a GATT characteristic in the remote GATT database was discovered
+ @param evt the sl_bt_evt_gatt_characteristic_id event
+ @return none
+ */
+static void client_on_gatt_characteristic (sl_bt_msg_t *evt)
+{
+  ble_server_t *server; // the server the event belongs to
 
-          ble_data.button_characteristic_handle = evt->data.evt_gatt_characteristic.characteristic;
-          //LOG_INFO("BTN Char Discovered");
+  //LOG_INFO("sl_bt_evt_gatt_characteristic_id\n\r");
 
+  server = get_server_by_connection(evt->data.evt_gatt_characteristic.connection);
+  for (uint32_t i = 0; (server != NULL) && (i < DISCOVERY_CHARACTERISTIC_COUNT); i++) {
+      if (uuid_matches (discovery_characteristics[i].uuid, discovery_characteristics[i].uuid_len,
+                        &evt->data.evt_gatt_characteristic.uuid)) {
+          DISCOVERED_CHARACTERISTIC(server, &discovery_characteristics[i]) = evt->data.evt_gatt_characteristic.characteristic;
+          break;
       }
+  }
+} // client_on_gatt_characteristic()
 
-      break;
-
+/*
+ @brief Client: shows the samples waiting in the value ring, the latest HTM reading on its
+        server's row and the button state on row 9
+ @param none
+ @return none
+ */
+static void display_values (void)
+{
+  const value_sample_t *sample;
+  ble_server_t *server;
 
-      /*
-       * If an indication or notification has been enabled for a characteristic, this event is
-       * triggered whenever an indication or notification is received from the remote GATT server.
-       */
-    case sl_bt_evt_gatt_characteristic_value_id:
-      //LOG_INFO("sl_bt_evt_gatt_characteristic_value_id\n\r");
-      //      /**
-      //       * @brief
-      //                      These values indicate which attribute request or response has caused the event.
-      //
-      //       */
-      //      typedef enum
-      //      {
-      //        sl_bt_gatt_read_by_type_request      = 0x8,  /**< (0x8) Read by type request */
-      //        sl_bt_gatt_read_by_type_response     = 0x9,  /**< (0x9) Read by type response */
-      //        sl_bt_gatt_read_request              = 0xa,  /**< (0xa) Read request */
-      //        sl_bt_gatt_read_response             = 0xb,  /**< (0xb) Read response */
-      //        sl_bt_gatt_read_blob_request         = 0xc,  /**< (0xc) Read blob request */
-      //        sl_bt_gatt_read_blob_response        = 0xd,  /**< (0xd) Read blob response */
-      //        sl_bt_gatt_read_multiple_request     = 0xe,  /**< (0xe) Read multiple request */
-      //        sl_bt_gatt_read_multiple_response    = 0xf,  /**< (0xf) Read multiple response */
-      //        sl_bt_gatt_write_request             = 0x12, /**< (0x12) Write request */
-      //        sl_bt_gatt_write_response            = 0x13, /**< (0x13) Write response */
-      //        sl_bt_gatt_write_command             = 0x52, /**< (0x52) Write command */
-      //        sl_bt_gatt_prepare_write_request     = 0x16, /**< (0x16) Prepare write request */
-      //        sl_bt_gatt_prepare_write_response    = 0x17, /**< (0x17) Prepare write
-      //                                                          response */
-      //        sl_bt_gatt_execute_write_request     = 0x18, /**< (0x18) Execute write request */
-      //        sl_bt_gatt_execute_write_response    = 0x19, /**< (0x19) Execute write
-      //                                                          response */
-      //        sl_bt_gatt_handle_value_notification = 0x1b, /**< (0x1b) Notification */
-      //        sl_bt_gatt_handle_value_indication   = 0x1d  /**< (0x1d) Indication */
-      //      } sl_bt_gatt_att_opcode_t;
-
-      // HTM indication
-      if( (evt->data.evt_gatt_characteristic_value.characteristic == ble_data.htm_characteristic_handle) &&
-          (evt->data.evt_gatt_characteristic_value.att_opcode == sl_bt_gatt_handle_value_indication) )
+  while ((sample = clientValuesPeek(VALUE_CONSUMER_DISPLAY)) != NULL)
+    {
+      server = get_server_by_connection(sample->connection);
+      if ((sample->kind == VALUE_TEMPERATURE) && (server != NULL))
         {
-          ble_data.temp_char_value = FLOAT_TO_INT32(evt->data.evt_gatt_characteristic_value.value.data);
-          displayPrintf(DISPLAY_ROW_TEMPVALUE, "Temp=%d", ble_data.temp_char_value);
-
-          sc = sl_bt_gatt_send_characteristic_confirmation(ble_data.connection_handle);
-          if (sc != SL_STATUS_OK)
-            {
-              LOG_ERROR("sl_bt_gatt_send_characteristic_confirmation() HTM returned != 0 status=0x%04x", (unsigned int) sc);
-            }
+          server->temp_char_value = sample->value;
+          server->samples++;
+          aggregate_samples++;
+          display_server(server);
         }
-
-      // Button indication
-      if ( (evt->data.evt_gatt_characteristic_value.characteristic == ble_data.button_characteristic_handle) &&
-          (evt-> data.evt_gatt_characteristic_value.att_opcode == sl_bt_gatt_handle_value_indication) )
+      else if (sample->kind == VALUE_BUTTON)
         {
-          if(evt->data.evt_gatt_characteristic_value.value.data[1]==0)
-            {
-              displayPrintf(DISPLAY_ROW_9, "Button Released");
-            }
-          else if(evt->data.evt_gatt_characteristic_value.value.data[1]==1)
-            {
-              displayPrintf(DISPLAY_ROW_9, "Button Pressed");
-            }
-
-          sc = sl_bt_gatt_send_characteristic_confirmation(ble_data.connection_handle);
-          if (sc != SL_STATUS_OK)
-            {
-              LOG_ERROR("sl_bt_gatt_send_characteristic_confirmation() returned != 0 status=0x%04x", (unsigned int) sc);
-            }
+          displayPrintf(DISPLAY_ROW_9, sample->value ? "Button Pressed" : "Button Released");
         }
+      clientValuesNext(VALUE_CONSUMER_DISPLAY);
+    }
+} // display_values()
 
-      // Button read response
-      if ( (evt->data.evt_gatt_characteristic_value.characteristic == ble_data.button_characteristic_handle) &&
-          (evt-> data.evt_gatt_characteristic_value.att_opcode == sl_bt_gatt_read_response) )
+/*
+ @brief Client: a characteristic value was received from the remote GATT server: an indication,
+        a read response or a read multiple response
+ @param evt the sl_bt_evt_gatt_characteristic_value_id event
+ @return none
+ */
+static void client_on_gatt_characteristic_value (sl_bt_msg_t *evt)
+{
+  uint32_t start = CYCLE_COUNT();
+  sl_status_t sc;
+  ble_server_t *server; // the server the event belongs to
+
+  //LOG_INFO("sl_bt_evt_gatt_characteristic_value_id\n\r");
+  //      /**
+  //       * @brief
+  //                      These values indicate which attribute request or response has caused the event.
+  //
+  //       */
+  //      typedef enum
+  //      {
+  //        sl_bt_gatt_read_by_type_request      = 0x8,  /**< (0x8) Read by type request */
+  //        sl_bt_gatt_read_by_type_response     = 0x9,  /**< (0x9) Read by type response */
+  //        sl_bt_gatt_read_request              = 0xa,  /**< (0xa) Read request */
+  //        sl_bt_gatt_read_response             = 0xb,  /**< (0xb) Read response */
+  //        sl_bt_gatt_read_blob_request         = 0xc,  /**< (0xc) Read blob request */
+  //        sl_bt_gatt_read_blob_response        = 0xd,  /**< (0xd) Read blob response */
+  //        sl_bt_gatt_read_multiple_request     = 0xe,  /**< (0xe) Read multiple request */
+  //        sl_bt_gatt_read_multiple_response    = 0xf,  /**< (0xf) Read multiple response */
+  //        sl_bt_gatt_write_request             = 0x12, /**< (0x12) Write request */
+  //        sl_bt_gatt_write_response            = 0x13, /**< (0x13) Write response */
+  //        sl_bt_gatt_write_command             = 0x52, /**< (0x52) Write command */
+  //        sl_bt_gatt_prepare_write_request     = 0x16, /**< (0x16) Prepare write request */
+  //        sl_bt_gatt_prepare_write_response    = 0x17, /**< (0x17) Prepare write
+  //                                                          response */
+  //        sl_bt_gatt_execute_write_request     = 0x18, /**< (0x18) Execute write request */
+  //        sl_bt_gatt_execute_write_response    = 0x19, /**< (0x19) Execute write
+  //                                                          response */
+  //        sl_bt_gatt_handle_value_notification = 0x1b, /**< (0x1b) Notification */
+  //        sl_bt_gatt_handle_value_indication   = 0x1d  /**< (0x1d) Indication */
+  //      } sl_bt_gatt_att_opcode_t;
+
+  server = get_server_by_connection(evt->data.evt_gatt_characteristic_value.connection);
+  if (server == NULL)
+    return;
+
+  // HTM and button_state indications, decoded where the stack left them into the value ring
+  if ((evt->data.evt_gatt_characteristic_value.att_opcode == sl_bt_gatt_handle_value_indication) &&
+      clientValuesDecode(&evt->data.evt_gatt_characteristic_value))
+    {
+      sc = sl_bt_gatt_send_characteristic_confirmation(server->connection);
+      if (sc != SL_STATUS_OK)
         {
-          if(evt->data.evt_gatt_characteristic_value.value.data[0]==0) //Reading button state flag bit
-            {
-              displayPrintf(DISPLAY_ROW_9, "Button Released");
-            }
-          else if(evt->data.evt_gatt_characteristic_value.value.data[0]==1)
-            {
-              displayPrintf(DISPLAY_ROW_9, "Button Pressed");
-            }
+          LOG_ERROR("sl_bt_gatt_send_characteristic_confirmation() returned != 0 status=0x%04x", (unsigned int) sc);
         }
+      display_values();
+      clientValuesTimed(CYCLE_COUNT() - start);
+    }
 
-      break;
+  // Read responses of a PB1 batch, handed to the read_*() callbacks
+  gattBatchValue(&evt->data.evt_gatt_characteristic_value);
+} // client_on_gatt_characteristic_value()
 
+/*
+ @brief Client: sl_bt_external_signal(myEvent) was called, the myEvent value is in
+        evt->data.evt_system_external_signal.extsignals
+ @param evt the sl_bt_evt_system_external_signal_id event
+ @return none
+ */
+static void client_on_system_external_signal (sl_bt_msg_t *evt)
+{
+  sl_status_t sc;
+  ble_server_t *server; // the server the event belongs to
 
-    case sl_bt_evt_system_external_signal_id:
+  // Scan duty cycle backoff and the aggregate report, checked on the 3 s LETIMER0 tick
+  if (evt->data.evt_system_external_signal.extsignals & evtLETIMER0_UF) {
+#if BROADCAST_SCAN_ONLY
+      // Keep the scan duty cycle up, broadcasts are the only data
+      broadcastReportIfDue();
+#else
+      scanFilterTick();
+#endif
+      report_aggregate_throughput();
+      historyUpdate();
+      historyReportIfDue();
+      clientValuesReportIfDue();
+      // The client has no indication queue, only the busy reasons count
+      for (int i = 0; i < BLE_MAX_SERVERS; i++) {
+          if (ble_data.servers[i].in_use)
+            connParamsUpdate(ble_data.servers[i].connection, 0);
+      }
+  }
 
-      // Security - PB0
-      if ( (evt->data.evt_system_external_signal.extsignals == evtPB0_pressed) && // PB0 pressed event
-          (GPIO_PinInGet (PB0_port, PB0_pin) == 0) ) {
+  // Security - PB0
+  if (evt->data.evt_system_external_signal.extsignals & evtPB0_pressed) { // debounced PB0 press, src/buttons.c
 
-          //LOG_INFO("In sl_bt_evt_system_external_signal_id, PB0 pressed if loop\n\r");
+      //LOG_INFO("In sl_bt_evt_system_external_signal_id, PB0 pressed if loop\n\r");
 
-          if ( (ble_data.bonding_flag == false) &&
-              (ble_data.passkey_available == true) &&
-              (ble_data.connection_open == true) )
+      server = pending_passkey_server (); // the server whose passkey we're displaying
+      if ( (server != NULL) &&
+          (server->bonding_flag == false) )
+        {
+          //Accept or reject the reported passkey confirm value.
+          sc = sl_bt_sm_passkey_confirm (server->connection, 1); //Creating bond after confirming passkey
+          if (sc != SL_STATUS_OK)
             {
-              //Accept or reject the reported passkey confirm value.
-              sl_bt_sm_passkey_confirm (ble_data.connection_handle, 1); //Creating bond after confirming passkey
-              // DOS: No status check !!!
-              ble_data.passkey_available = false;
+              LOG_ERROR("sl_bt_sm_passkey_confirm() returned != 0 status=0x%04x", (unsigned int) sc);
             }
+          server->passkey_available = false;
+          display_pending_server_passkey (); // the next server waiting, if any
+        }
 
-      } // Security - PB0
+  } // Security - PB0
 
-      // Reading from gattdb, PB1 pressed by itself
-      if ( (evt->data.evt_system_external_signal.extsignals == evtPB1_pressed) && // PB1 pressed event AND
-          (GPIO_PinInGet (PB0_port, PB0_pin) == 1) && // PB0 is not pressed
-          (ble_data.connection_open == true) ) {
+  // Reading from gattdb, PB1 pressed by itself
+  if ( (evt->data.evt_system_external_signal.extsignals & evtPB1_pressed) && // PB1 pressed event AND
+      !(evt->data.evt_system_external_signal.extsignals & evtPB_chord) && // PB0 is not pressed
+      (ble_data.connection_open == true) ) {
 
-          //LOG_INFO("In sl_bt_evt_system_external_signal_id, PB1 pressed and PB0 not pressed if loop\n\r");
+      //LOG_INFO("In sl_bt_evt_system_external_signal_id, PB1 pressed and PB0 not pressed if loop\n\r");
 
-          //LOG_INFO("   ***Calling sl_bt_gatt_read_characteristic_value()");
-          sc = sl_bt_gatt_read_characteristic_value(ble_data.connection_handle, ble_data.button_characteristic_handle);
+      // One Read Multiple per server instead of one read procedure per characteristic
+      for (int i = 0; i < BLE_MAX_SERVERS; i++) {
+          server = &ble_data.servers[i];
+          if (!server->in_use || (server->button_characteristic_handle == 0))
+            continue;
+          gattBatchAdd(server->connection, server->button_characteristic_handle, 1, read_button_state);
+          gattBatchAdd(server->connection, server->temperature_type_handle, 1, read_temperature_type);
+          gattBatchAdd(server->connection, server->measurement_interval_handle, 2, read_measurement_interval);
+          sc = gattBatchSubmit(server->connection);
           if(sc!=SL_STATUS_OK)
             {
-              LOG_ERROR("sl_bt_gatt_read_characteristic_value() returned!=0 status = 0x%04x", (unsigned int)sc);
+              LOG_ERROR("gattBatchSubmit() returned!=0 status = 0x%04x", (unsigned int)sc);
             }
+      }
 
-      } // Reading from gattdb
-
-      /* Attribution: Both buttons pressed case code leveraged from Isha Burange*/
-      if ( (evt->data.evt_system_external_signal.extsignals == evtPB1_pressed) && // PB1 pressed event AND
-          (GPIO_PinInGet (PB0_port, PB0_pin) == 0) && // PB0 is pressed
-          (ble_data.connection_open == true) )  {
-
-          //LOG_INFO("In sl_bt_evt_system_external_signal_id, PB1 pressed and PB0 pressed if loop\n\r");
+  } // Reading from gattdb
 
-          if(ble_data.ok_to_send_PB0_indications)
-            {
-              sc = sl_bt_gatt_set_characteristic_notification(ble_data.connection_handle,
-                                                              ble_data.button_characteristic_handle,
-                                                              sl_bt_gatt_disable); //enabled, so disabling
+  /* Attribution: Both buttons pressed case code leveraged from Isha Burange*/
+  if ( (evt->data.evt_system_external_signal.extsignals & evtPB_chord) && // both buttons down, either one first
+      (ble_data.connection_open == true) )  {
 
-              if(sc!=SL_STATUS_OK)
-                {
-                  LOG_ERROR("sl_bt_gatt_set_characteristic_notification() returned!=0 status = 0x%04x", (unsigned int)sc);
-                }
-              ble_data.ok_to_send_PB0_indications = false; //toggling flag
+      //LOG_INFO("In sl_bt_evt_system_external_signal_id, PB1 pressed and PB0 pressed if loop\n\r");
 
-            }
-          else
+      for (int i = 0; i < BLE_MAX_SERVERS; i++) {
+          server = &ble_data.servers[i];
+          if (!server->in_use || (server->button_characteristic_handle == 0))
+            continue;
+          // enabled, so disabling / disabled, so enable
+          sc = sl_bt_gatt_set_characteristic_notification(server->connection,
+                                                          server->button_characteristic_handle,
+                                                          (server->ok_to_send_PB0_indications) ? sl_bt_gatt_disable : sl_bt_gatt_indication);
+          if(sc!=SL_STATUS_OK)
             {
-              sc = sl_bt_gatt_set_characteristic_notification(ble_data.connection_handle,
-                                                              ble_data.button_characteristic_handle,
-                                                              sl_bt_gatt_indication); //disabled, so enable
-
-              if(sc!=SL_STATUS_OK)
-                {
-                  LOG_ERROR("sl_bt_gatt_set_characteristic_notification() returned!=0 status = 0x%04x", (unsigned int)sc);
-                }
-              ble_data.ok_to_send_PB0_indications = true; //toggling flag
+              LOG_ERROR("sl_bt_gatt_set_characteristic_notification() returned!=0 status = 0x%04x", (unsigned int)sc);
             }
-
+          server->ok_to_send_PB0_indications = !server->ok_to_send_PB0_indications; //toggling flag
       }
 
-      break;
-
-
-
-
+  }
+} // client_on_system_external_signal()
 
+/*
+ @brief Client: a new bonding request was received and needs to be confirmed
+ @param evt the sl_bt_evt_sm_confirm_bonding_id event
+ @return none
+ */
+static void client_on_sm_confirm_bonding (sl_bt_msg_t *evt)
+{
+  sl_status_t sc;
 
+  sc = sl_bt_sm_bonding_confirm (evt->data.evt_sm_confirm_bonding.connection, 1);
 
-    case sl_bt_evt_sm_confirm_bonding_id:
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_advertiser_start() returned!=0 status = 0x%04x", (unsigned int)sc);
+    }
+} // client_on_sm_confirm_bonding()
 
-      sc = sl_bt_sm_bonding_confirm (ble_data.connection_handle, 1);
+/*
+ @brief Client: a passkey needs to be displayed and confirmed by the user
+ @param evt the sl_bt_evt_sm_confirm_passkey_id event
+ @return none
+ */
+static void client_on_sm_confirm_passkey (sl_bt_msg_t *evt)
+{
+  ble_server_t *server; // the server the event belongs to
+
+  //LOG_INFO("sl_bt_evt_sm_confirm_passkey_id\n\r");
+  // A known peer pairing again is confirmed by the user too, it may not be that peer
+  server = get_server_by_connection (evt->data.evt_sm_confirm_passkey.connection);
+  if (server == NULL)
+    return;
+  server->passkey = evt->data.evt_sm_confirm_passkey.passkey;
+  server->passkey_available = true;
+  connParamsSetBusy (server->connection, CONN_BUSY_PAIRING, true);
+  // One passkey on the LCD at a time, the first server waiting, PB0 confirms that one
+  display_pending_server_passkey ();
+} // client_on_sm_confirm_passkey()
 
-      if (sc != SL_STATUS_OK)
-        {
-          LOG_ERROR("sl_bt_advertiser_start() returned!=0 status = 0x%04x", (unsigned int)sc);
-        }
-      break;
-
-    case sl_bt_evt_sm_confirm_passkey_id:
-      //LOG_INFO("sl_bt_evt_sm_confirm_passkey_id\n\r");
-      ble_data.passkey = evt->data.evt_sm_confirm_passkey.passkey;
-      ble_data.passkey_available = true;
-      displayPrintf (DISPLAY_ROW_PASSKEY, "%d", ble_data.passkey);
-      displayPrintf (DISPLAY_ROW_ACTION, "Confirm with PB0");
-      break;
-
-    case sl_bt_evt_sm_bonding_failed_id:
-      //LOG_INFO("sl_bt_evt_sm_bonding_failed_id\n\r");
-      LOG_ERROR("Bonding failed with reason: 0x%04x", evt->data.evt_sm_bonding_failed.reason);
-      break;
-      /*
-       * @brief Triggered after the pairing or bonding procedure is successfully
-       * completed.
-       */
-    case sl_bt_evt_sm_bonded_id:
-      //LOG_INFO("sl_bt_evt_sm_bonded_id\n\r");
-      displayPrintf (DISPLAY_ROW_CONNECTION, "Bonded");
-      displayPrintf (DISPLAY_ROW_PASSKEY, " ");
-      displayPrintf (DISPLAY_ROW_ACTION, " ");
-      ble_data.bonding_flag = true;
-      ble_data.passkey_available = false;
-      break;
+/*
+ @brief Client: the pairing or bonding procedure failed
+ @param evt the sl_bt_evt_sm_bonding_failed_id event
+ @return none
+ */
+static void client_on_sm_bonding_failed (sl_bt_msg_t *evt)
+{
+  ble_server_t *server; // the server the event belongs to
+
+  //LOG_INFO("sl_bt_evt_sm_bonding_failed_id\n\r");
+  LOG_ERROR("Bonding failed with reason: 0x%04x", evt->data.evt_sm_bonding_failed.reason);
+  bondingFailed (evt->data.evt_sm_bonding_failed.connection, evt->data.evt_sm_bonding_failed.reason);
+  connParamsSetBusy (evt->data.evt_sm_bonding_failed.connection, CONN_BUSY_PAIRING, false);
+  server = get_server_by_connection (evt->data.evt_sm_bonding_failed.connection);
+  if (server != NULL) {
+      server->bonding_flag = false;
+      server->passkey_available = false;
+  }
+  display_pending_server_passkey ();
+} // client_on_sm_bonding_failed()
 
-  }//end switch for CLIENT
+/*
+ @brief Client: the pairing or bonding procedure completed successfully
+ @param evt the sl_bt_evt_sm_bonded_id event
+ @return none
+ */
+static void client_on_sm_bonded (sl_bt_msg_t *evt)
+{
+  ble_server_t *server; // the server the event belongs to
+
+  //LOG_INFO("sl_bt_evt_sm_bonded_id\n\r");
+  bondingBonded (evt->data.evt_sm_bonded.connection, evt->data.evt_sm_bonded.bonding);
+  connParamsSetBusy (evt->data.evt_sm_bonded.connection, CONN_BUSY_PAIRING, false);
+  displayPrintf (DISPLAY_ROW_CONNECTION, "Bonded");
+  server = get_server_by_connection (evt->data.evt_sm_bonded.connection);
+  if (server != NULL) {
+      server->bonding_flag = true;
+      server->passkey_available = false;
+  }
+  display_pending_server_passkey ();
+} // client_on_sm_bonded()
 #endif
 
-} // handle_ble_event()
+/**
+ * @brief Subscribes the BLE event handlers of this device's role to the event dispatcher.
+ *        Call once, after roleLoad(). Subscribed from a boot handler, the role's boot
+ *        handler still runs for that boot event.
+ *
+ * @param none
+ *
+ * @returns none
+ *
+ * @reference ECEN5823 Lecture 10,12 slides
+ */
+void ble_subscribe_handlers (void)
+{
+#if BUILD_INCLUDES_BLE_SERVER
+  if (IsServerDevice ()) {
+    bleDispatchSubscribe (sl_bt_evt_system_boot_id, server_on_system_boot, "server_on_system_boot");
+    bleDispatchSubscribe (sl_bt_evt_connection_opened_id, server_on_connection_opened, "server_on_connection_opened");
+    bleDispatchSubscribe (sl_bt_evt_connection_closed_id, server_on_connection_closed, "server_on_connection_closed");
+    bleDispatchSubscribe (sl_bt_evt_connection_parameters_id, server_on_connection_parameters, "server_on_connection_parameters");
+    bleDispatchSubscribe (sl_bt_evt_connection_phy_status_id, server_on_connection_phy_status, "server_on_connection_phy_status");
+    bleDispatchSubscribe (sl_bt_evt_gatt_mtu_exchanged_id, server_on_gatt_mtu_exchanged, "server_on_gatt_mtu_exchanged");
+    bleDispatchSubscribe (sl_bt_evt_system_external_signal_id, server_on_system_external_signal, "server_on_system_external_signal");
+    bleDispatchSubscribe (sl_bt_evt_system_soft_timer_id, server_on_system_soft_timer, "server_on_system_soft_timer");
+    bleDispatchSubscribe (sl_bt_evt_gatt_server_characteristic_status_id, server_on_gatt_server_characteristic_status, "server_on_gatt_server_characteristic_status");
+    bleDispatchSubscribe (sl_bt_evt_gatt_server_indication_timeout_id, server_on_gatt_server_indication_timeout, "server_on_gatt_server_indication_timeout");
+    bleDispatchSubscribe (sl_bt_evt_sm_confirm_bonding_id, server_on_sm_confirm_bonding, "server_on_sm_confirm_bonding");
+    bleDispatchSubscribe (sl_bt_evt_sm_confirm_passkey_id, server_on_sm_confirm_passkey, "server_on_sm_confirm_passkey");
+    bleDispatchSubscribe (sl_bt_evt_sm_bonded_id, server_on_sm_bonded, "server_on_sm_bonded");
+    bleDispatchSubscribe (sl_bt_evt_sm_bonding_failed_id, server_on_sm_bonding_failed, "server_on_sm_bonding_failed");
+  }
+#endif
+#if BUILD_INCLUDES_BLE_CLIENT
+  if (IsClientDevice ()) {
+    bleDispatchSubscribe (sl_bt_evt_system_boot_id, client_on_system_boot, "client_on_system_boot");
+    bleDispatchSubscribe (sl_bt_evt_connection_opened_id, client_on_connection_opened, "client_on_connection_opened");
+    bleDispatchSubscribe (sl_bt_evt_connection_closed_id, client_on_connection_closed, "client_on_connection_closed");
+    bleDispatchSubscribe (sl_bt_evt_system_soft_timer_id, client_on_system_soft_timer, "client_on_system_soft_timer");
+    bleDispatchSubscribe (sl_bt_evt_connection_parameters_id, client_on_connection_parameters, "client_on_connection_parameters");
+    bleDispatchSubscribe (sl_bt_evt_connection_phy_status_id, client_on_connection_phy_status, "client_on_connection_phy_status");
+    bleDispatchSubscribe (sl_bt_evt_gatt_mtu_exchanged_id, client_on_gatt_mtu_exchanged, "client_on_gatt_mtu_exchanged");
+    bleDispatchSubscribe (sl_bt_evt_scanner_scan_report_id, client_on_scanner_scan_report, "client_on_scanner_scan_report");
+    bleDispatchSubscribe (sl_bt_evt_gatt_procedure_completed_id, client_on_gatt_procedure_completed, "client_on_gatt_procedure_completed");
+    bleDispatchSubscribe (sl_bt_evt_gatt_service_id, client_on_gatt_service, "client_on_gatt_service");
+    bleDispatchSubscribe (sl_bt_evt_gatt_characteristic_id, client_on_gatt_characteristic, "client_on_gatt_characteristic");
+    bleDispatchSubscribe (sl_bt_evt_gatt_characteristic_value_id, client_on_gatt_characteristic_value, "client_on_gatt_characteristic_value");
+    bleDispatchSubscribe (sl_bt_evt_system_external_signal_id, client_on_system_external_signal, "client_on_system_external_signal");
+    bleDispatchSubscribe (sl_bt_evt_sm_confirm_bonding_id, client_on_sm_confirm_bonding, "client_on_sm_confirm_bonding");
+    bleDispatchSubscribe (sl_bt_evt_sm_confirm_passkey_id, client_on_sm_confirm_passkey, "client_on_sm_confirm_passkey");
+    bleDispatchSubscribe (sl_bt_evt_sm_bonding_failed_id, client_on_sm_bonding_failed, "client_on_sm_bonding_failed");
+    bleDispatchSubscribe (sl_bt_evt_sm_bonded_id, client_on_sm_bonded, "client_on_sm_bonded");
+  }
+#endif
+} // ble_subscribe_handlers()
 
-#if DEVICE_IS_BLE_SERVER
+#if BUILD_INCLUDES_BLE_SERVER
 /**
  * @brief This function reads temperature data from the SI7021 sensor, converts it to IEEE-11073 format,
  *        and writes it to the specified GATT characteristic in the BLE GATT server
@@ -1162,82 +1843,30 @@ void ble_write_temp_from_si7021 (void)
   temperature_in_c = read_temp_from_si7021 ();
   htm_temperature_flt = UINT32_TO_FLOAT(temperature_in_c * 1000, -3);
   UINT32_TO_BITSTREAM(p, htm_temperature_flt);
-  sl_status_t sc;
 
 
   // Display the temp
   displayPrintf (DISPLAY_ROW_TEMPVALUE, "Temp=%d", temperature_in_c);
+#if BROADCAST_ENABLE
+  // Dashboards read it from the advertising data, no connection needed, in 0.01 C
+  broadcastUpdate (ble_data.advertisingSetHandle, read_temp_centi_c_from_si7021 ());
+#endif
   //LOG_INFO("Temp in c: %d\n\r", temperature_in_c);
 
 
   // -------------------------------
-  // Write our local GATT DB
+  // Write our local GATT DB, if the reading changed, and indicate it (IEEE-11073 format)
+  // to every client with HTM indications enabled. A client with an indication in flight
+  // gets its queued reading replaced by this one.
   // -------------------------------
-  sc = sl_bt_gatt_server_write_attribute_value (
-      gattdb_temperature_measurement, // handle from gatt_db.h
-      0, // offset
-      4, // length
-      (uint8_t*) &(temperature_in_c) // pointer to buffer where data is
-  );
-
-  if (sc != SL_STATUS_OK)
-    {
-      LOG_ERROR(
-          "sl_bt_gatt_server_write_attribute_value() HTM returned != 0 status=0x%04x",
-          (unsigned int) sc);
-    }
-
-
-  // DOS: Don't you think it would be a good idea to check if there is an indication in-flight already?
-  // DOS: And where is queuing your indication if an indication is in-flight ?????????????????????????????
-
-  if (ble_data.indication_inflight == false) {
-
-      // No indication in-flight, send it
-      if ( (ble_data.ok_to_send_htm_indications == true) &&
-          (ble_data.connection_open == true) ) {
-
-          sc = sl_bt_gatt_server_send_indication (ble_data.connection_handle,
-                                                  gattdb_temperature_measurement, //handle from gatt_db.h
-                                                  5,
-                                                  &htm_temperature_buffer[0] //in IEEE-11073 format
-          );
-          if (sc != SL_STATUS_OK) {
-              LOG_ERROR("sl_bt_gatt_server_send_indication() HTM returned != 0 status=0x%04x", (unsigned int) sc);
-          }
-          else
-            {
-              ble_data.indication_inflight = true;
-              //LOG_INFO("  **sent HTM indication");
-              //displayPrintf (DISPLAY_ROW_TEMPVALUE, "Temp=%d", temperature_in_c); // DOS - why does the success or failure of sending an indication have an impact on displaying the temp on your LCD?
-              //LOG_INFO("Temp in c: %d\n\r", temperature_in_c);
-            }
-      } // if
-
-  } else {
-
-      // else an indication is in-flight, queue the indication
-      if ( (ble_data.ok_to_send_htm_indications == true) &&
-          (ble_data.connection_open == true) ) {
-
-          sc = write_queue (gattdb_temperature_measurement,
-                            5,
-                            &htm_temperature_buffer[0] //in IEEE-11073 format
-          );
-          if (sc != SL_STATUS_OK) {
-              LOG_ERROR("write_queue() HTM returned != 0 status=0x%04x", (unsigned int)sc);
-          } else {
-              //LOG_INFO("  **queued HTM indication");
-          }
-
-      } // if
-
-  } // else
-
+  gattPublish (gattdb_temperature_measurement, (const uint8_t*) &temperature_in_c, 4,
+               &htm_temperature_buffer[0], 5);
 
 } //ble_write_temp_from_si7021()
 
-#else
+#endif
+
+#if BUILD_INCLUDES_BLE_CLIENT
 /**
  * Convert a Little Endian formatted floating-point value to a 32-bit signed integer.
  * @param value_start_little_endian - Pointer to the Little Endian formatted data.
@@ -21,6 +21,7 @@
 #define UINT32_TO_FLOAT(m, e) (((uint32_t)(m) & 0x00FFFFFFU) | (uint32_t)((int32_t)(e) << 24))
 
 #define QUEUE_DEPTH      (16)
+#define QUEUE_BUFFER_SIZE (5)
 #define READ_SUCCESS (bool)false
 #define WRITE_SUCCESS (bool)false
 #define READ_FAILURE (bool)true
@@ -30,7 +31,7 @@ typedef struct
 {
   uint16_t charHandle; // Char handle from gatt_db.h
   size_t bufferLength; // Length of buffer in bytes to send
-  uint8_t buffer[5]; // The actual data buffer for the indication.
+  uint8_t buffer[QUEUE_BUFFER_SIZE]; // The actual data buffer for the indication.
   // Need space for HTM (5 bytes) and button_state (2 bytes)
   // indications, array [0] holds the flags byte.
 }queue_element_t;
@@ -43,10 +44,68 @@ typedef struct
   bool empty;
   bool full;
 }queue_struct_t ;
+
+// Server: clients served at the same time, advertising continues while a slot is free
+#define BLE_MAX_CLIENTS  (4)
+#if BLE_MAX_CLIENTS > SL_BT_CONFIG_MAX_CONNECTIONS
+#error "BLE_MAX_CLIENTS is larger than SL_BT_CONFIG_MAX_CONNECTIONS (config/sl_bluetooth_connection_config.h)"
+#endif
+
+// Server: one connected client, its CCCD state, in-flight indication and queue
+typedef struct
+{
+  bool     in_use;
+  uint8_t  connection;
+  bool     ok_to_send_htm_indications;     // HTM CCCD
+  bool     ok_to_send_PB0_indications;     // button_state CCCD
+  bool     bonding_flag;                   // link encrypted with a bond
+  bool     passkey_available;              // passkey waiting for PB0
+  uint32_t passkey;
+  bool     indication_inflight;            // waiting for this client's confirmation
+  uint32_t indication_sent_tick;           // sl_sleeptimer tick the in-flight indication was sent
+  uint32_t indications;                    // indications confirmed by this client
+  uint32_t latency_sum_ms;                 // send -> confirmation
+  uint32_t latency_max_ms;
+  queue_struct_t indication_queue;         // indications waiting for the one in flight
+}ble_client_t;
+
 // BLE Data Structure, save all of our private BT data in here.
 // Modern C (circa 2021 does it this way)
 // typedef ble_data_struct_t is referred to as an anonymous struct definition
 
+// Client: thermometer servers kept connected at the same time
+#define BLE_MAX_SERVERS  (3)
+#if BLE_MAX_SERVERS > SL_BT_CONFIG_MAX_CONNECTIONS
+#error "BLE_MAX_SERVERS is larger than SL_BT_CONFIG_MAX_CONNECTIONS (config/sl_bluetooth_connection_config.h)"
+#endif
+// Client: how often the aggregate HTM sample rate is logged
+#define BLE_AGGREGATE_REPORT_PERIOD_MS (60000)
+
+// Client: one connected server, its discovered handles and latest reading
+typedef struct ble_server_s
+{
+  bool     in_use;
+  uint8_t  connection;
+  bd_addr  address;
+  uint32_t htm_service_handle;
+  uint16_t htm_characteristic_handle;
+  uint32_t button_service_handle;
+  uint16_t button_characteristic_handle;
+  uint32_t gatt_service_handle;            // Generic Attribute service, its database hash is read by UUID
+  uint16_t db_hash_characteristic_handle;
+  uint16_t temperature_type_handle;        // HTM Temperature Type, 0 if not discovered
+  uint16_t measurement_interval_handle;    // HTM Measurement Interval, 0 if not discovered
+  uint8_t  temperature_type;               // last values read on PB1
+  uint16_t measurement_interval_s;
+  bool     ok_to_send_PB0_indications;     // button_state indications enabled on this server
+  bool     bonding_flag;                   // link encrypted with a bond
+  bool     passkey_available;              // passkey waiting for PB0
+  uint32_t passkey;
+  //DOS - don't you think a signed variable would be better? What if the temp when negative?????
+  int32_t  temp_char_value;                // latest HTM reading
+  uint32_t samples;                        // HTM indications received on this connection
+}ble_server_t;
+
 typedef struct
 {
   // values that are common to servers and clients
@@ -55,29 +114,35 @@ typedef struct
   // values unique for server
   // The advertising set handle allocated from Bluetooth stack.
   uint8_t advertisingSetHandle; //handle
-  uint8_t connection_handle;
+  bool advertising;
+  ble_client_t clients[BLE_MAX_CLIENTS];
+  uint8_t client_count; // clients connected
   bool connection_open;
-  bool ok_to_send_htm_indications;
-  bool indication_inflight;
-  //PB0
-  bool passkey_available;
-  bool ok_to_send_PB0_indications;
-  bool bonding_flag;
-//DOS  bool PB0_pressed;
-  uint32_t passkey;
-//DOS  bool PB1_pressed;
   // values unique for client
-  //DOS - don't you think a signed variable would be better? What if the temp when negative?????
-  //DOS uint32_t temp_char_value; //for storing characteristic value return
-  int32_t temp_char_value; //for storing characteristic value return
-
-  uint32_t htm_service_handle;
-  uint16_t htm_characteristic_handle;
-  uint32_t button_service_handle;
-  uint16_t button_characteristic_handle;
+  ble_server_t servers[BLE_MAX_SERVERS];
+  uint8_t server_count; // servers connected
 
 }ble_data_struct_t;
 
+// Client discovery tables, one entry per service/characteristic we need from the server
+typedef struct
+{
+  const uint8_t *uuid;        // little endian, as carried in the GATT events
+  uint8_t        uuid_len;    // 2 or 16
+  uint16_t       offset;      // offsetof() the uint32_t service handle in ble_server_t
+}gatt_service_entry_t;
+
+typedef struct
+{
+  const uint8_t *uuid;
+  uint8_t        uuid_len;
+  uint16_t       offset;      // offsetof() the uint16_t characteristic handle in ble_server_t
+}gatt_characteristic_entry_t;
+
+// The handle a discovery table entry refers to, in one server's ble_server_t
+#define DISCOVERED_SERVICE(server, entry)        (*(uint32_t *) ((uint8_t *) (server) + (entry)->offset))
+#define DISCOVERED_CHARACTERISTIC(server, entry) (*(uint16_t *) ((uint8_t *) (server) + (entry)->offset))
+
 //Function macros
 
 /**
@@ -90,16 +155,17 @@ typedef struct
 ble_data_struct_t *get_ble_data_ptr(void);
 
 /**
- * @brief Handle Bluetooth Low Energy (BLE) events, including device boot, connection management,
- * and GATT (Generic Attribute Profile) operations for both clients and servers.
+ * @brief Subscribes the BLE event handlers of this device's role to the event dispatcher.
+ *        Call once, after roleLoad(). Subscribed from a boot handler, the role's boot
+ *        handler still runs for that boot event.
  *
- * @param evt - Pointer to the BLE event message.
+ * @param none
  *
  * @returns none
  *
  * @reference ECEN5823 Lecture 10,12 slides
  */
-void handle_ble_event(sl_bt_msg_t *evt);
+void ble_subscribe_handlers(void);
 
 /**
  * @brief This function reads temperature data from the SI7021 sensor, converts it to IEEE-11073 format,
@@ -114,6 +180,18 @@ void handle_ble_event(sl_bt_msg_t *evt);
 void ble_write_temp_from_si7021(void);
 
 void ble_send_button_state();
+
+/**
+ * @brief Server: hands one indication to the stack for a client and starts its latency
+ *        measurement.
+ *
+ * @param client, the client
+ * @param charHandle, bufferLength, buffer, the indication
+ *
+ * @return true if the stack accepted it
+ */
+bool ble_send_indication(ble_client_t *client, uint16_t charHandle, size_t bufferLength, uint8_t *buffer);
+
 /**
  * Convert a Little Endian formatted floating-point value to a 32-bit signed integer.
  * @param value_start_little_endian - Pointer to the Little Endian formatted data.
@@ -123,40 +201,84 @@ void ble_send_button_state();
 int32_t FLOAT_TO_INT32(const uint8_t *value_start_little_endian);
 
 /**
- * @brief Writes data to the indication queue.
+ * @brief Get the table of services the client discovers on the server.
+ *
+ * @param count, returns the number of entries in the table
+ *
+ * @return pointer to the first table entry
+ */
+const gatt_service_entry_t *get_discovery_service_table(uint8_t *count);
+
+/**
+ * @brief Clears every service and characteristic handle filled in by discovery.
+ *
+ * @param server, the server whose handles are cleared
+ *
+ * @return none
+ */
+void clear_discovered_handles(ble_server_t *server);
+
+/**
+ * @brief Client: finds the server on a connection.
+ *
+ * @param connection, connection handle
+ *
+ * @return pointer to the server, NULL if the connection is not to one of our servers
+ */
+ble_server_t *get_server_by_connection(uint8_t connection);
+
+/**
+ * @brief Writes data to an indication queue.
  *
  * This function writes data to the indication queue, storing information about the
  * character handle, buffer length, and the buffer itself.
  *
+ * @param queue The client's indication queue.
  * @param charHandle The handle of the character.
  * @param bufferLength The length of the buffer.
  * @param buffer A pointer to the buffer containing data to be written to the queue.
  *
  * @return Returns READ_SUCCESS on successful write, or READ_FAILURE if the queue is full.
  */
-bool     write_queue (uint16_t charHandle, size_t bufferLength,uint8_t *buffer);
+bool     write_queue (queue_struct_t *queue, uint16_t charHandle, size_t bufferLength,uint8_t *buffer);
+
+/**
+ * @brief Overwrites the newest queued indication of a characteristic with a new value,
+ *        the element keeps its place in the queue.
+ *
+ * @param queue The client's indication queue.
+ * @param charHandle The handle of the character.
+ * @param bufferLength The length of the buffer.
+ * @param buffer A pointer to the new data.
+ *
+ * @return Returns WRITE_SUCCESS if an element was replaced, or WRITE_FAILURE if none is queued.
+ */
+bool     replace_queue (queue_struct_t *queue, uint16_t charHandle, size_t bufferLength, uint8_t *buffer);
 
 /**
- * @brief Reads data from the indication queue.
+ * @brief Reads data from an indication queue.
  *
  * This function reads data from the indication queue, retrieving information about
  * the character handle, buffer length, and the buffer itself.
  *
+ * @param queue The client's indication queue.
  * @param charHandle A pointer to store the character handle.
  * @param bufferLength A pointer to store the buffer length.
  * @param buffer A pointer to the buffer where data will be copied.
  *
  * @return Returns WRITE_SUCCESS on successful read, or WRITE_FAILURE if the queue is empty.
  */
-bool     read_queue (uint16_t *charHandle, size_t *bufferLength,uint8_t *buffer);
+bool     read_queue (queue_struct_t *queue, uint16_t *charHandle, size_t *bufferLength,uint8_t *buffer);
 
 /**
- * @brief Gets the depth of the indication queue.
+ * @brief Gets the depth of an indication queue.
  *
  * This function calculates and returns the depth of the indication queue, representing
  * the number of elements in the queue.
  *
+ * @param queue The client's indication queue.
+ *
  * @return The depth of the indication queue.
  */
-uint32_t get_queue_depth (void);
+uint32_t get_queue_depth (const queue_struct_t *queue);
 #endif /* SRC_BLE_H_ */
@@ -34,6 +34,14 @@
  */
 #define DEVICE_IS_BLE_SERVER 1
 
+/*
+ * Set to 1 to build the server and the client into one image. The role is read from
+ * NVM at boot (src/role.h), DEVICE_IS_BLE_SERVER is only the default for a new board.
+ * Set to 0 to build the DEVICE_IS_BLE_SERVER role alone: the other role's code is
+ * compiled out, and -ffunction-sections with --gc-sections drops what it referenced.
+ */
+#define DEVICE_ROLE_RUNTIME 1
+
 // Students:
 // For your Bluetooth Client implementations, starting with A7,
 // set this #define to the bd_addr of the Gecko that will be your Server.
@@ -47,8 +55,20 @@
 // Instructor's Server
 ///#define SERVER_BT_ADDRESS {{ 0xb0, 0x2e, 0xef, 0x57, 0x0b, 0x00 }}
 
+// The Server advertises with its public identity address, sl_bt_gap_public_address
+#define SERVER_BT_ADDRESS_TYPE (0)
+
+
+#if DEVICE_ROLE_RUNTIME
+
+#define BUILD_INCLUDES_BLE_SERVER 1
+#define BUILD_INCLUDES_BLE_CLIENT 1
+bool roleIsServer(void); // src/role.c
+#define BLE_DEVICE_TYPE_STRING (roleIsServer() ? "Server" : "Client")
+static inline bool IsServerDevice() { return roleIsServer(); }
+static inline bool IsClientDevice() { return !roleIsServer(); }
 
-#if DEVICE_IS_BLE_SERVER
+#elif DEVICE_IS_BLE_SERVER
 
 #define BUILD_INCLUDES_BLE_SERVER 1
 #define BUILD_INCLUDES_BLE_CLIENT 0
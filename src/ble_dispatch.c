@@ -0,0 +1,150 @@
+/*
+ * File name: ble_dispatch.c
+ * File description: This file defines the BT stack event dispatcher APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 5 (BT stack events)
+ *  [2] ARM Cortex-M4 Technical Reference Manual, DWT CYCCNT https://developer.arm.com/documentation/100166/0001/Data-Watchpoint-and-Trace-Unit
+ */
+
+#include "src/ble_dispatch.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+typedef struct ble_dispatch_entry_s
+{
+  uint32_t                     event_id;
+  ble_event_handler_t          handler;
+  const char                  *name;
+  struct ble_dispatch_entry_s *next;        // next handler in the same bucket
+  // Profile, in DWT cycles
+  uint32_t                     calls;
+  uint64_t                     total_cycles;
+  uint32_t                     max_cycles;
+} ble_dispatch_entry_t;
+
+static ble_dispatch_entry_t  entries[BLE_DISPATCH_MAX_HANDLERS];
+static uint32_t              entry_count = 0;
+static ble_dispatch_entry_t *buckets[BLE_DISPATCH_BUCKETS];
+static ble_dispatch_entry_t *any_handlers = NULL;
+static uint32_t              last_report_ms = 0;
+
+/*
+ * @brief Runs one handler and adds its run time to its profile
+ * @param entry, the subscription
+ * @param evt, the event
+ * @return none
+ */
+static void run_handler(ble_dispatch_entry_t *entry, sl_bt_msg_t *evt)
+{
+  uint32_t start = CYCLE_COUNT();
+  uint32_t cycles;
+
+  entry->handler(evt);
+  cycles = CYCLE_COUNT() - start;
+  entry->calls++;
+  entry->total_cycles += cycles;
+  if (cycles > entry->max_cycles)
+    entry->max_cycles = cycles;
+} // run_handler()
+
+/**
+ * @brief Subscribes a handler to one event.
+ *
+ * @param event_id, sl_bt_evt_*_id, or BLE_DISPATCH_ANY for every event
+ * @param handler, called with the event
+ * @param name, shown in the profile log
+ *
+ * @return true if subscribed, false if BLE_DISPATCH_MAX_HANDLERS is reached
+ */
+bool bleDispatchSubscribe(uint32_t event_id, ble_event_handler_t handler, const char *name)
+{
+  ble_dispatch_entry_t  *entry;
+  ble_dispatch_entry_t **tail;
+
+  if (entry_count == BLE_DISPATCH_MAX_HANDLERS)
+    {
+      LOG_ERROR("bleDispatchSubscribe() no free entry for %s", name);
+      return false;
+    }
+  // The handlers are timed from the first subscription on
+  if (entry_count == 0)
+    cycleCounterInit();
+  entry = &entries[entry_count++];
+  memset(entry, 0, sizeof(*entry));
+  entry->event_id = event_id;
+  entry->handler  = handler;
+  entry->name     = name;
+
+  // Appended, handlers of an event run in the order they subscribed
+  tail = (event_id == BLE_DISPATCH_ANY) ? &any_handlers : &buckets[BLE_DISPATCH_HASH(event_id)];
+  while (*tail)
+    tail = &(*tail)->next;
+  *tail = entry;
+  return true;
+} // bleDispatchSubscribe()
+
+/**
+ * @brief Drops every subscription, before subscribing the handlers of another role.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void bleDispatchReset(void)
+{
+  memset(buckets, 0, sizeof(buckets));
+  any_handlers = NULL;
+  entry_count  = 0;
+} // bleDispatchReset()
+
+/**
+ * @brief Runs the handlers subscribed to an event. Call from sl_bt_on_event().
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void bleDispatch(sl_bt_msg_t *evt)
+{
+  uint32_t              event_id = SL_BT_MSG_ID(evt->header);
+  ble_dispatch_entry_t *entry;
+
+  for (entry = any_handlers; entry != NULL; entry = entry->next)
+    run_handler(entry, evt);
+
+  for (entry = buckets[BLE_DISPATCH_HASH(event_id)]; entry != NULL; entry = entry->next)
+    {
+      if (entry->event_id == event_id)
+        run_handler(entry, evt);
+    }
+} // bleDispatch()
+
+/**
+ * @brief Logs the calls, total and longest run time of every handler, every
+ *        BLE_DISPATCH_REPORT_PERIOD_MS. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void bleDispatchReportIfDue(void)
+{
+  uint32_t now_ms = letimerMilliseconds();
+  uint32_t hz     = CMU_ClockFreqGet(cmuClock_CORE);
+
+  if ((hz == 0) || (now_ms - last_report_ms) < BLE_DISPATCH_REPORT_PERIOD_MS)
+    return;
+  last_report_ms = now_ms;
+
+  for (uint32_t i = 0; i < entry_count; i++)
+    {
+      if (entries[i].calls == 0)
+        continue;
+      LOG_INFO("Dispatch %s: %u calls, %u cycles max, %u us total, %u us max", entries[i].name,
+               (unsigned int) entries[i].calls, (unsigned int) entries[i].max_cycles,
+               (unsigned int) ((entries[i].total_cycles * 1000000) / hz),
+               (unsigned int) (((uint64_t) entries[i].max_cycles * 1000000) / hz));
+    }
+} // bleDispatchReportIfDue()
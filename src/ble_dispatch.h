@@ -0,0 +1,74 @@
+/*
+ * File name: ble_dispatch.h
+ * File description: This file declares the BT stack event dispatcher APIs. Modules subscribe
+ *                   a handler to the events they need. sl_bt_on_event() hands every event to
+ *                   bleDispatch(), which finds the event's handler list through a small hash of
+ *                   SL_BT_MSG_ID() and runs the handlers in subscription order, timing each one
+ *                   with the DWT cycle counter.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 5 (BT stack events)
+ *  [2] ARM Cortex-M4 Technical Reference Manual, DWT CYCCNT https://developer.arm.com/documentation/100166/0001/Data-Watchpoint-and-Trace-Unit
+ */
+#ifndef SRC_BLE_DISPATCH_H_
+#define SRC_BLE_DISPATCH_H_
+
+#include "app.h"
+
+// Handler lists, a power of 2. Events sharing a bucket are told apart by their full ID.
+#define BLE_DISPATCH_BUCKETS           (32)
+// Subscriptions over all events
+#define BLE_DISPATCH_MAX_HANDLERS      (48)
+// Subscribe to every event, these handlers run before the per event ones
+#define BLE_DISPATCH_ANY               (0)
+// How often the per handler profile is logged
+#define BLE_DISPATCH_REPORT_PERIOD_MS  (600000)
+
+// Event IDs are 0xIICC00a0, ID in the top byte and class in the next. The classes used here
+// are small and the IDs within a class are dense, so class * 5 + ID spreads them well.
+#define BLE_DISPATCH_HASH(event_id) \
+  (((((event_id) >> 16) & 0xff) * 5 + (((event_id) >> 24) & 0xff)) & (BLE_DISPATCH_BUCKETS - 1))
+
+typedef void (*ble_event_handler_t)(sl_bt_msg_t *evt);
+
+/**
+ * @brief Subscribes a handler to one event.
+ *
+ * @param event_id, sl_bt_evt_*_id, or BLE_DISPATCH_ANY for every event
+ * @param handler, called with the event
+ * @param name, shown in the profile log
+ *
+ * @return true if subscribed, false if BLE_DISPATCH_MAX_HANDLERS is reached
+ */
+bool bleDispatchSubscribe(uint32_t event_id, ble_event_handler_t handler, const char *name);
+
+/**
+ * @brief Drops every subscription, before subscribing the handlers of another role.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void bleDispatchReset(void);
+
+/**
+ * @brief Runs the handlers subscribed to an event. Call from sl_bt_on_event().
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void bleDispatch(sl_bt_msg_t *evt);
+
+/**
+ * @brief Logs the calls, total and longest run time of every handler, every
+ *        BLE_DISPATCH_REPORT_PERIOD_MS. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void bleDispatchReportIfDue(void);
+
+#endif /* SRC_BLE_DISPATCH_H_ */
@@ -0,0 +1,380 @@
+/*
+ * File name: ble_trace.c
+ * File description: This file defines the BLE event trace and per connection metrics APIs.
+ *                   Every BT stack event is stamped with the sleeptimer tick and kept in a
+ *                   RAM ring, and each connection is reduced to time to encryption, time to
+ *                   first indication, indication throughput and confirmation latency.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides weeks 5-8
+ *  [2] Silicon Labs sleeptimer documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-sleeptimer
+ */
+
+#include "src/ble_trace.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+#if BLE_TRACE_ENABLE
+
+static ble_trace_entry_t   trace_ring[BLE_TRACE_DEPTH];
+static uint32_t            trace_wptr  = 0;
+static uint32_t            trace_count = 0; // total events recorded since boot
+
+typedef struct
+{
+  bool                in_use;
+  uint8_t             connection;
+  uint32_t            open_tick;
+  ble_scenario_kind_t kind;
+} trace_connection_t;
+
+static ble_trace_metrics_t metrics;
+static bool                connection_open   = false;
+// Every open connection's open time and kind, traced or not
+static trace_connection_t  connections[BLE_TRACE_CONNECTIONS];
+static bool                indication_pending = false; // server: sent, waiting for confirmation
+static uint32_t            indication_sent_tick;
+static uint32_t            scenario_count = 0;
+
+static const char *scenario_kind_names[BLE_SCENARIO_KIND_COUNT] =
+{
+  "connect",
+  "cached reconnect"
+};
+
+// Time to first indication averaged per scenario kind, over the connections that got one
+static uint32_t kind_count[BLE_SCENARIO_KIND_COUNT];
+static uint32_t kind_first_indication_sum_ms[BLE_SCENARIO_KIND_COUNT];
+
+// Time to encryption, [0] after a new pairing, [1] with stored keys
+static uint32_t encrypt_count[2];
+static uint32_t encrypt_sum_ms[2];
+
+/*
+ * @brief Converts a tick interval to milliseconds, handles RTCC wrap around
+ * @param from, start tick
+ * @param to, end tick
+ * @return elapsed ms
+ */
+static uint32_t ticks_to_ms(uint32_t from, uint32_t to)
+{
+  return sl_sleeptimer_tick_to_ms(to - from);
+} // ticks_to_ms()
+
+/*
+ * @brief Returns the event specific argument stored with a trace entry
+ * @param evt, pointer to the Bluetooth event message
+ * @return argument value
+ */
+static uint32_t trace_arg(sl_bt_msg_t *evt)
+{
+  switch (SL_BT_MSG_ID(evt->header))
+  {
+    case sl_bt_evt_system_external_signal_id:
+      return evt->data.evt_system_external_signal.extsignals;
+    case sl_bt_evt_system_soft_timer_id:
+      return evt->data.evt_system_soft_timer.handle;
+    case sl_bt_evt_connection_opened_id:
+      return evt->data.evt_connection_opened.connection;
+    case sl_bt_evt_connection_closed_id:
+      return evt->data.evt_connection_closed.reason;
+    case sl_bt_evt_connection_parameters_id:
+      return evt->data.evt_connection_parameters.interval;
+    case sl_bt_evt_gatt_procedure_completed_id:
+      return evt->data.evt_gatt_procedure_completed.result;
+    case sl_bt_evt_gatt_characteristic_value_id:
+      return evt->data.evt_gatt_characteristic_value.characteristic;
+    case sl_bt_evt_gatt_server_characteristic_status_id:
+      return evt->data.evt_gatt_server_characteristic_status.characteristic;
+    default:
+      return 0;
+  }
+} // trace_arg()
+
+/*
+ * @brief Finds the open time of a connection
+ * @param connection, connection handle
+ * @return pointer to the entry, NULL if the connection is not open
+ */
+static trace_connection_t *find_connection(uint8_t connection)
+{
+  for (int i = 0; i < BLE_TRACE_CONNECTIONS; i++)
+    {
+      if (connections[i].in_use && (connections[i].connection == connection))
+        return &connections[i];
+    }
+  return NULL;
+} // find_connection()
+
+/*
+ * @brief Keeps the open time of a new connection
+ * @param connection, connection handle
+ * @param now, the open tick
+ * @return none
+ */
+static void add_connection(uint8_t connection, uint32_t now)
+{
+  trace_connection_t *entry = find_connection(connection);
+
+  for (int i = 0; (i < BLE_TRACE_CONNECTIONS) && (entry == NULL); i++)
+    {
+      if (!connections[i].in_use)
+        entry = &connections[i];
+    }
+  if (entry == NULL)
+    return;
+  entry->in_use     = true;
+  entry->connection = connection;
+  entry->open_tick  = now;
+  entry->kind       = BLE_SCENARIO_CONNECT;
+} // add_connection()
+
+/*
+ * @brief Adds one send -> confirmation latency sample to the metrics
+ * @param latency_ms, the measured latency
+ * @return none
+ */
+static void add_latency_sample(uint32_t latency_ms)
+{
+  if (metrics.latency_count == 0 || latency_ms < metrics.latency_min_ms)
+    metrics.latency_min_ms = latency_ms;
+  if (latency_ms > metrics.latency_max_ms)
+    metrics.latency_max_ms = latency_ms;
+  metrics.latency_sum_ms += latency_ms;
+  metrics.latency_count++;
+} // add_latency_sample()
+
+/**
+ * @brief Records a BT stack event in the trace ring and updates the connection metrics.
+ *        Call this for every event, from sl_bt_on_event().
+ *
+ * @param evt, pointer to the Bluetooth event message
+ *
+ * @return none
+ */
+void bleTraceEvent(sl_bt_msg_t *evt)
+{
+  uint32_t            now = sl_sleeptimer_get_tick_count();
+  uint32_t            id  = SL_BT_MSG_ID(evt->header);
+  trace_connection_t *closed;
+
+  trace_ring[trace_wptr].tick = now;
+  trace_ring[trace_wptr].id   = id;
+  trace_ring[trace_wptr].arg  = trace_arg(evt);
+  trace_wptr = (trace_wptr + 1) % BLE_TRACE_DEPTH;
+  trace_count++;
+
+  switch (id)
+  {
+    case sl_bt_evt_connection_opened_id:
+      add_connection(evt->data.evt_connection_opened.connection, now);
+      if (connection_open)
+        break; // already tracing another connection
+      memset(&metrics, 0, sizeof(metrics));
+      metrics.scenario   = ++scenario_count;
+      metrics.connection = evt->data.evt_connection_opened.connection;
+      metrics.open_tick  = now;
+      metrics.stored_keys = (evt->data.evt_connection_opened.bonding != SL_BT_INVALID_BONDING_HANDLE);
+      connection_open    = true;
+      indication_pending = false;
+      break;
+
+    case sl_bt_evt_connection_parameters_id:
+      if (connection_open && metrics.encrypted_ms == 0 &&
+          evt->data.evt_connection_parameters.connection == metrics.connection &&
+          evt->data.evt_connection_parameters.security_mode != sl_bt_connection_mode1_level1)
+        metrics.encrypted_ms = ticks_to_ms(metrics.open_tick, now);
+      break;
+
+    case sl_bt_evt_gatt_server_characteristic_status_id:
+      // Server: the client confirmed our indication
+      if (indication_pending &&
+          evt->data.evt_gatt_server_characteristic_status.connection == metrics.connection &&
+          evt->data.evt_gatt_server_characteristic_status.status_flags == sl_bt_gatt_server_confirmation)
+        {
+          add_latency_sample(ticks_to_ms(indication_sent_tick, now));
+          indication_pending = false;
+        }
+      break;
+
+    case sl_bt_evt_gatt_characteristic_value_id:
+      // Client: an indication arrived from the server
+      if (evt->data.evt_gatt_characteristic_value.att_opcode == sl_bt_gatt_handle_value_indication &&
+          evt->data.evt_gatt_characteristic_value.connection == metrics.connection)
+        {
+          if (metrics.indications == 0)
+            metrics.first_indication_ms = ticks_to_ms(metrics.open_tick, now);
+          metrics.indications++;
+          metrics.indication_bytes += evt->data.evt_gatt_characteristic_value.value.len;
+        }
+      break;
+
+    case sl_bt_evt_connection_closed_id:
+      closed = find_connection(evt->data.evt_connection_closed.connection);
+      if (closed != NULL)
+        closed->in_use = false;
+      if (connection_open && evt->data.evt_connection_closed.connection == metrics.connection)
+        {
+          connection_open = false;
+          if (metrics.indications)
+            {
+              kind_count[metrics.kind]++;
+              kind_first_indication_sum_ms[metrics.kind] += metrics.first_indication_ms;
+            }
+          if (metrics.encrypted_ms)
+            {
+              encrypt_count[metrics.stored_keys]++;
+              encrypt_sum_ms[metrics.stored_keys] += metrics.encrypted_ms;
+            }
+          bleTraceReport();
+#if BLE_TRACE_DUMP_ON_CLOSE
+          bleTraceDump();
+#endif
+        }
+      break;
+
+    default:
+      break;
+  }
+} // bleTraceEvent()
+
+/**
+ * @brief Marks an indication as handed to the stack by the server, starts the
+ *        send -> confirmation latency measurement. Only the traced connection counts.
+ *
+ * @param connection, connection handle the indication was sent on
+ * @param length, indication payload length in bytes
+ *
+ * @return none
+ */
+void bleTraceIndicationSent(uint8_t connection, size_t length)
+{
+  if (!connection_open || (connection != metrics.connection))
+    return;
+  indication_sent_tick = sl_sleeptimer_get_tick_count();
+  indication_pending   = true;
+  if (metrics.indications == 0)
+    metrics.first_indication_ms = ticks_to_ms(metrics.open_tick, indication_sent_tick);
+  metrics.indications++;
+  metrics.indication_bytes += length;
+} // bleTraceIndicationSent()
+
+/**
+ * @brief Sets the kind of a connection. If it is the traced one, its metrics are
+ *        reported and averaged with the other connections of the same kind.
+ *
+ * @param connection, connection handle
+ * @param kind, the scenario kind
+ *
+ * @return none
+ */
+void bleTraceSetScenarioKind(uint8_t connection, ble_scenario_kind_t kind)
+{
+  trace_connection_t *entry = find_connection(connection);
+
+  if ((entry == NULL) || (kind >= BLE_SCENARIO_KIND_COUNT))
+    return;
+  entry->kind = kind;
+  if (connection_open && (connection == metrics.connection))
+    metrics.kind = kind;
+} // bleTraceSetScenarioKind()
+
+/**
+ * @brief Returns the metrics of the current (or last closed) connection.
+ *
+ * @param none
+ *
+ * @return pointer to the metrics structure
+ */
+const ble_trace_metrics_t *bleTraceGetMetrics(void)
+{
+  return &metrics;
+} // bleTraceGetMetrics()
+
+/**
+ * @brief Returns the milliseconds since a connection was opened.
+ *
+ * @param connection, connection handle
+ *
+ * @return ms since its open, 0 if the connection is not open
+ */
+uint32_t bleTraceMsSinceOpen(uint8_t connection)
+{
+  trace_connection_t *entry = find_connection(connection);
+
+  if (entry == NULL)
+    return 0;
+  return ticks_to_ms(entry->open_tick, sl_sleeptimer_get_tick_count());
+} // bleTraceMsSinceOpen()
+
+/**
+ * @brief Logs the metrics of the current (or last closed) connection.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void bleTraceReport(void)
+{
+  uint32_t duration_ms = (metrics.scenario) ? ticks_to_ms(metrics.open_tick, sl_sleeptimer_get_tick_count()) : 0;
+  uint32_t avg_latency = (metrics.latency_count) ? (metrics.latency_sum_ms / metrics.latency_count) : 0;
+  // indications per minute over the life of the connection
+  uint32_t per_minute  = (duration_ms) ? (uint32_t)(((uint64_t) metrics.indications * 60000) / duration_ms) : 0;
+
+  LOG_INFO("BLE scenario %u (%s): %u ms open, encrypted after %u ms, first indication after %u ms",
+           (unsigned int) metrics.scenario, scenario_kind_names[metrics.kind], (unsigned int) duration_ms,
+           (unsigned int) metrics.encrypted_ms, (unsigned int) metrics.first_indication_ms);
+  LOG_INFO("  indications=%u (%u bytes, %u/min), confirmation latency min/avg/max=%u/%u/%u ms",
+           (unsigned int) metrics.indications, (unsigned int) metrics.indication_bytes,
+           (unsigned int) per_minute, (unsigned int) metrics.latency_min_ms,
+           (unsigned int) avg_latency, (unsigned int) metrics.latency_max_ms);
+  for (int i = 0; i < 2; i++)
+    {
+      if (encrypt_count[i] == 0)
+        continue;
+      LOG_INFO("  %s: avg encrypted after %u ms over %u connections", (i) ? "stored keys" : "new pairing",
+               (unsigned int) (encrypt_sum_ms[i] / encrypt_count[i]), (unsigned int) encrypt_count[i]);
+    }
+  for (int i = 0; i < BLE_SCENARIO_KIND_COUNT; i++)
+    {
+      if (kind_count[i] == 0)
+        continue;
+      LOG_INFO("  %s: avg first indication after %u ms over %u connections", scenario_kind_names[i],
+               (unsigned int) (kind_first_indication_sum_ms[i] / kind_count[i]), (unsigned int) kind_count[i]);
+    }
+} // bleTraceReport()
+
+/**
+ * @brief Logs every entry of the trace ring, oldest first.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void bleTraceDump(void)
+{
+  uint32_t entries = (trace_count < BLE_TRACE_DEPTH) ? trace_count : BLE_TRACE_DEPTH;
+  uint32_t rptr    = (trace_wptr + BLE_TRACE_DEPTH - entries) % BLE_TRACE_DEPTH;
+  uint32_t first   = trace_ring[rptr].tick;
+
+  for (uint32_t i = 0; i < entries; i++)
+    {
+      LOG_INFO("trace %u: +%u ms id=0x%08x arg=0x%x", (unsigned int) i,
+               (unsigned int) ticks_to_ms(first, trace_ring[rptr].tick),
+               (unsigned int) trace_ring[rptr].id, (unsigned int) trace_ring[rptr].arg);
+      rptr = (rptr + 1) % BLE_TRACE_DEPTH;
+    }
+} // bleTraceDump()
+
+#else
+
+void bleTraceEvent(sl_bt_msg_t *evt) { (void) evt; }
+void bleTraceIndicationSent(uint8_t connection, size_t length) { (void) connection; (void) length; }
+void bleTraceSetScenarioKind(uint8_t connection, ble_scenario_kind_t kind) { (void) connection; (void) kind; }
+const ble_trace_metrics_t *bleTraceGetMetrics(void) { static const ble_trace_metrics_t none; return &none; }
+uint32_t bleTraceMsSinceOpen(uint8_t connection) { (void) connection; return 0; }
+void bleTraceReport(void) {}
+void bleTraceDump(void) {}
+
+#endif // BLE_TRACE_ENABLE
@@ -0,0 +1,128 @@
+/*
+ * File name: ble_trace.h
+ * File description: This file declares the BLE event trace and per connection metrics APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides weeks 5-8
+ *  [2] Silicon Labs sleeptimer documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-sleeptimer
+ */
+#ifndef SRC_BLE_TRACE_H_
+#define SRC_BLE_TRACE_H_
+
+#include "app.h"
+#include "sl_sleeptimer.h"
+
+// Set to 0 to compile the trace out, all APIs become empty
+#define BLE_TRACE_ENABLE    1
+// Number of events kept in the RAM ring, oldest entries are overwritten
+#define BLE_TRACE_DEPTH     (64)
+// Set to 1 to dump the whole ring to the VCOM port when a connection closes
+#define BLE_TRACE_DUMP_ON_CLOSE 0
+// Connections whose open time and kind are kept, see bleTraceMsSinceOpen()
+#define BLE_TRACE_CONNECTIONS   (SL_BT_CONFIG_MAX_CONNECTIONS)
+
+typedef struct
+{
+  uint32_t tick;   // sleeptimer tick (RTCC, 32768 Hz) the event was seen at
+  uint32_t id;     // SL_BT_MSG_ID() of the event
+  uint32_t arg;    // event specific: connection handle, extsignals, characteristic, ...
+} ble_trace_entry_t;
+
+// Kind of connection a scenario measures, reported and averaged separately
+typedef enum
+{
+  BLE_SCENARIO_CONNECT,            // full GATT discovery
+  BLE_SCENARIO_CACHED_RECONNECT,   // client: handles from the GATT cache, only the database hash was read
+  BLE_SCENARIO_KIND_COUNT
+} ble_scenario_kind_t;
+
+// A "scenario" is one connection, from sl_bt_evt_connection_opened_id to _closed_id.
+// With several connections open only the first one is traced, until it closes. The open
+// time and kind of every connection are kept for bleTraceMsSinceOpen().
+typedef struct
+{
+  uint32_t scenario;               // number of connections seen since boot
+  uint8_t  connection;             // handle of the traced connection
+  ble_scenario_kind_t kind;        // BLE_SCENARIO_CONNECT unless changed by bleTraceSetScenarioKind()
+  uint32_t open_tick;              // connection opened
+  uint32_t encrypted_ms;           // open -> encryption/bonding, 0 if never
+  bool     stored_keys;            // peer was already bonded, encryption resumed with the stored LTK
+  uint32_t first_indication_ms;    // open -> first HTM/button indication sent (server) or received (client)
+  uint32_t indications;            // indications sent (server) or received (client)
+  uint32_t indication_bytes;       // payload bytes of those indications
+  uint32_t latency_count;          // indications with a measured send -> confirmation latency
+  uint32_t latency_min_ms;
+  uint32_t latency_max_ms;
+  uint32_t latency_sum_ms;
+} ble_trace_metrics_t;
+
+/**
+ * @brief Records a BT stack event in the trace ring and updates the connection metrics.
+ *        Call this for every event, from sl_bt_on_event().
+ *
+ * @param evt, pointer to the Bluetooth event message
+ *
+ * @return none
+ */
+void bleTraceEvent(sl_bt_msg_t *evt);
+
+/**
+ * @brief Marks an indication as handed to the stack by the server, starts the
+ *        send -> confirmation latency measurement. Only the traced connection counts.
+ *
+ * @param connection, connection handle the indication was sent on
+ * @param length, indication payload length in bytes
+ *
+ * @return none
+ */
+void bleTraceIndicationSent(uint8_t connection, size_t length);
+
+/**
+ * @brief Sets the kind of a connection. If it is the traced one, its metrics are
+ *        reported and averaged with the other connections of the same kind.
+ *
+ * @param connection, connection handle
+ * @param kind, the scenario kind
+ *
+ * @return none
+ */
+void bleTraceSetScenarioKind(uint8_t connection, ble_scenario_kind_t kind);
+
+/**
+ * @brief Returns the metrics of the current (or last closed) connection.
+ *
+ * @param none
+ *
+ * @return pointer to the metrics structure
+ */
+const ble_trace_metrics_t *bleTraceGetMetrics(void);
+
+/**
+ * @brief Returns the milliseconds since a connection was opened.
+ *
+ * @param connection, connection handle
+ *
+ * @return ms since its open, 0 if the connection is not open
+ */
+uint32_t bleTraceMsSinceOpen(uint8_t connection);
+
+/**
+ * @brief Logs the metrics of the current (or last closed) connection.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void bleTraceReport(void);
+
+/**
+ * @brief Logs every entry of the trace ring, oldest first.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void bleTraceDump(void);
+
+#endif /* SRC_BLE_TRACE_H_ */
@@ -0,0 +1,186 @@
+/*
+ * File name: bonding.c
+ * File description: This file defines the bonding policy APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 9 (BLE security)
+ *  [2] Silicon Labs Bluetooth API reference, Security Manager https://docs.silabs.com/bluetooth/3.2/group-sl-bt-sm
+ */
+
+#include "src/bonding.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+typedef struct
+{
+  uint8_t connection;  // 0 = unused entry
+  uint8_t bonding;     // SL_BT_INVALID_BONDING_HANDLE if the peer is not bonded
+  bool    encrypted;
+} bond_connection_t;
+
+static bond_connection_t connections[BONDING_MAX_CONNECTIONS];
+
+/*
+ * @brief Finds the table entry of a connection
+ * @param connection, connection handle
+ * @return pointer to the entry, NULL if not tracked
+ */
+static bond_connection_t *find_connection(uint8_t connection)
+{
+  for (int i = 0; i < BONDING_MAX_CONNECTIONS; i++)
+    {
+      if (connections[i].connection == connection)
+        return &connections[i];
+    }
+  return NULL;
+} // find_connection()
+
+/**
+ * @brief Sets up the bond table size and LRU replacement. Call from the boot event.
+ *        Deletes all bonds if PB0 is held down (BONDING_CLEAR_WITH_PB0).
+ *
+ * @param none
+ *
+ * @return none
+ */
+void bondingInit(void)
+{
+  sl_status_t sc;
+
+  memset(connections, 0, sizeof(connections));
+
+#if BONDING_CLEAR_WITH_PB0
+  if (GPIO_PinInGet(PB0_port, PB0_pin) == 0)
+    {
+      /*
+       * Delete all bonding information and accept list filtering from the persistent
+       * store. This will also delete device local identity resolving key (IRK).
+       */
+      sc = sl_bt_sm_delete_bondings();
+      if (sc != SL_STATUS_OK)
+        {
+          LOG_ERROR("sl_bt_sm_delete_bondings() returned != 0 status=0x%04x", (unsigned int) sc);
+        }
+      else
+        LOG_INFO("PB0 held at boot, all bondings deleted");
+    }
+#endif
+
+  sc = sl_bt_sm_store_bonding_configuration(BONDING_MAX_COUNT, BONDING_POLICY_LRU);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_sm_store_bonding_configuration() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+} // bondingInit()
+
+/**
+ * @brief Records the bond of a new connection. A peer with a stored bond is asked to
+ *        encrypt right away, with the stored LTK, so no pairing or passkey is needed.
+ *
+ * @param connection, connection handle
+ * @param bonding, bonding handle from sl_bt_evt_connection_opened_id, SL_BT_INVALID_BONDING_HANDLE if none
+ *
+ * @return true if the peer is already bonded
+ */
+bool bondingConnectionOpened(uint8_t connection, uint8_t bonding)
+{
+  bond_connection_t *entry = find_connection(0); // free entry
+  sl_status_t        sc;
+
+  if (entry == NULL)
+    {
+      LOG_ERROR("bondingConnectionOpened() no free entry for connection %d", (int) connection);
+      return false;
+    }
+  entry->connection = connection;
+  entry->bonding    = bonding;
+  entry->encrypted  = false;
+
+  if (bonding == SL_BT_INVALID_BONDING_HANDLE)
+    return false;
+
+  // Central: starts encryption. Peripheral: sends a security request to the central.
+  sc = sl_bt_sm_increase_security(connection);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_sm_increase_security() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+  return true;
+} // bondingConnectionOpened()
+
+/**
+ * @brief Forgets the bond state of a closed connection, the bond itself stays in NVM.
+ *
+ * @param connection, connection handle
+ *
+ * @return none
+ */
+void bondingConnectionClosed(uint8_t connection)
+{
+  bond_connection_t *entry = find_connection(connection);
+
+  if (entry)
+    memset(entry, 0, sizeof(*entry));
+} // bondingConnectionClosed()
+
+/**
+ * @brief Records the bonding handle of a pairing that just completed.
+ *
+ * @param connection, connection handle
+ * @param bonding, bonding handle from sl_bt_evt_sm_bonded_id
+ *
+ * @return none
+ */
+void bondingBonded(uint8_t connection, uint8_t bonding)
+{
+  bond_connection_t *entry = find_connection(connection);
+
+  if (entry)
+    {
+      entry->bonding   = bonding;
+      entry->encrypted = true;
+    }
+} // bondingBonded()
+
+/**
+ * @brief Checks if a connection parameters event reports encryption resumed with a stored
+ *        bond. The stack does not send sl_bt_evt_sm_bonded_id in that case.
+ *
+ * @param params, the sl_bt_evt_connection_parameters_id event data
+ *
+ * @return true if the link is now encrypted with the keys of a known peer
+ */
+bool bondingEncryptionResumed(const sl_bt_evt_connection_parameters_t *params)
+{
+  bond_connection_t *entry = find_connection(params->connection);
+
+  if ((entry == NULL) || entry->encrypted || (entry->bonding == SL_BT_INVALID_BONDING_HANDLE))
+    return false;
+  if (params->security_mode == sl_bt_connection_mode1_level1)
+    return false;
+  entry->encrypted = true;
+  return true;
+} // bondingEncryptionResumed()
+
+/**
+ * @brief Handles a failed pairing or encryption. The bond is never deleted here, a peer
+ *        that claims to have lost its keys could be anyone. The user deletes bonds by
+ *        holding PB0 at reset (BONDING_CLEAR_WITH_PB0).
+ *
+ * @param connection, connection handle
+ * @param reason, sl_status_t reason from sl_bt_evt_sm_bonding_failed_id
+ *
+ * @return none
+ */
+void bondingFailed(uint8_t connection, uint16_t reason)
+{
+  bond_connection_t *entry = find_connection(connection);
+
+  if ((entry == NULL) || (entry->bonding == SL_BT_INVALID_BONDING_HANDLE))
+    return;
+
+  entry->encrypted = false;
+  if (reason == SL_STATUS_BT_CTRL_PIN_OR_KEY_MISSING)
+    LOG_INFO("Peer of bonding %d has no keys, bond kept, hold PB0 at reset to delete it", (int) entry->bonding);
+} // bondingFailed()
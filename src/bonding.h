@@ -0,0 +1,88 @@
+/*
+ * File name: bonding.h
+ * File description: This file declares the bonding policy APIs. Bonds are kept across
+ *                   disconnects and resets in a bounded, least recently used table, and a
+ *                   known peer resumes encryption with its stored LTK instead of pairing again.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 9 (BLE security)
+ *  [2] Silicon Labs Bluetooth API reference, Security Manager https://docs.silabs.com/bluetooth/3.2/group-sl-bt-sm
+ */
+#ifndef SRC_BONDING_H_
+#define SRC_BONDING_H_
+
+#include "app.h"
+
+// Size of the bond table in NVM, 1 to 32 (stack default 13)
+#define BONDING_MAX_COUNT          (4)
+// sl_bt_sm_store_bonding_configuration() policy: a new bond overwrites the bond used the longest time ago
+#define BONDING_POLICY_LRU         (2)
+// Holding PB0 down while the board resets deletes every bond
+#define BONDING_CLEAR_WITH_PB0     1
+// Connections tracked at the same time
+#define BONDING_MAX_CONNECTIONS    (4)
+
+/**
+ * @brief Sets up the bond table size and LRU replacement. Call from the boot event.
+ *        Deletes all bonds if PB0 is held down (BONDING_CLEAR_WITH_PB0).
+ *
+ * @param none
+ *
+ * @return none
+ */
+void bondingInit(void);
+
+/**
+ * @brief Records the bond of a new connection. A peer with a stored bond is asked to
+ *        encrypt right away, with the stored LTK, so no pairing or passkey is needed.
+ *
+ * @param connection, connection handle
+ * @param bonding, bonding handle from sl_bt_evt_connection_opened_id, SL_BT_INVALID_BONDING_HANDLE if none
+ *
+ * @return true if the peer is already bonded
+ */
+bool bondingConnectionOpened(uint8_t connection, uint8_t bonding);
+
+/**
+ * @brief Forgets the bond state of a closed connection, the bond itself stays in NVM.
+ *
+ * @param connection, connection handle
+ *
+ * @return none
+ */
+void bondingConnectionClosed(uint8_t connection);
+
+/**
+ * @brief Records the bonding handle of a pairing that just completed.
+ *
+ * @param connection, connection handle
+ * @param bonding, bonding handle from sl_bt_evt_sm_bonded_id
+ *
+ * @return none
+ */
+void bondingBonded(uint8_t connection, uint8_t bonding);
+
+/**
+ * @brief Checks if a connection parameters event reports encryption resumed with a stored
+ *        bond. The stack does not send sl_bt_evt_sm_bonded_id in that case.
+ *
+ * @param params, the sl_bt_evt_connection_parameters_id event data
+ *
+ * @return true if the link is now encrypted with the keys of a known peer
+ */
+bool bondingEncryptionResumed(const sl_bt_evt_connection_parameters_t *params);
+
+/**
+ * @brief Handles a failed pairing or encryption. The bond is never deleted here, a peer
+ *        that claims to have lost its keys could be anyone. The user deletes bonds by
+ *        holding PB0 at reset (BONDING_CLEAR_WITH_PB0).
+ *
+ * @param connection, connection handle
+ * @param reason, sl_status_t reason from sl_bt_evt_sm_bonding_failed_id
+ *
+ * @return none
+ */
+void bondingFailed(uint8_t connection, uint16_t reason);
+
+#endif /* SRC_BONDING_H_ */
@@ -0,0 +1,255 @@
+/*
+ * File name: broadcast.c
+ * File description: This file defines the connectionless broadcast APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 8 (scanning, advertising data)
+ *  [2] Bluetooth Core Specification Supplement v9, Part A, 1.3 (Flags), 1.4 (Manufacturer Specific Data)
+ *  [3] Silicon Labs Bluetooth API reference, Advertiser https://docs.silabs.com/bluetooth/3.2/group-sl-bt-advertiser
+ */
+
+#include "src/broadcast.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+// Advertising packet types of sl_bt_advertiser_set_data()
+#define ADV_PACKET    (0)
+#define SCAN_RESPONSE (1)
+
+/*
+ * Advertising data, 16 of the 31 legacy bytes:
+ *  flags: LE general discoverable, BR/EDR not supported
+ *  complete 16-bit UUID list: Health Thermometer, so the client's scan filter still matches
+ *  manufacturer data: company ID, format, temperature (int16, 0.01 C), sequence (uint16)
+ */
+#define MFG_OFFSET    (7 + 2) // manufacturer data payload, after the AD length and type bytes
+
+static uint8_t adv_data[] =
+{
+  0x02, 0x01, 0x06,
+  0x03, 0x03, 0x09, 0x18,
+  BROADCAST_DATA_LEN + 1, AD_TYPE_MANUFACTURER,
+  (uint8_t) BROADCAST_COMPANY_ID, (uint8_t) (BROADCAST_COMPANY_ID >> 8), BROADCAST_FORMAT,
+  0x00, 0x00,   // temperature
+  0x00, 0x00,   // sequence
+};
+
+static uint16_t sequence = 0;
+
+typedef struct
+{
+  bool                        in_use;
+  bd_addr                     address;
+  uint16_t                    last_sequence;
+  broadcast_sender_counters_t counters;
+} broadcast_sender_t;
+
+static broadcast_sender_t senders[BROADCAST_MAX_SENDERS];
+static uint32_t           last_report_ms = 0;
+
+/*
+ * @brief Writes the reading into the manufacturer data and hands the payload to the stack
+ * @param advertising_set, advertising set handle
+ * @param temperature_centi_c, temperature in 0.01 C
+ * @return none
+ */
+static void set_adv_data(uint8_t advertising_set, int16_t temperature_centi_c)
+{
+  uint8_t    *p = &adv_data[MFG_OFFSET + 3];
+  sl_status_t sc;
+
+  *p++ = (uint8_t) temperature_centi_c;
+  *p++ = (uint8_t) ((uint16_t) temperature_centi_c >> 8);
+  *p++ = (uint8_t) sequence;
+  *p++ = (uint8_t) (sequence >> 8);
+
+  sc = sl_bt_advertiser_set_data(advertising_set, ADV_PACKET, sizeof(adv_data), adv_data);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_advertiser_set_data() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+} // set_adv_data()
+
+/**
+ * @brief Server: builds the scan response (device name) and the first advertising
+ *        payload. Call from the boot event, after the advertising set is created.
+ *
+ * @param advertising_set, advertising set handle
+ *
+ * @return none
+ */
+void broadcastInit(uint8_t advertising_set)
+{
+  uint8_t     scan_rsp[31];
+  size_t      name_len = 0;
+  sl_status_t sc;
+
+  // Complete local name from the GATT database, as the stack's discoverable mode would send it
+  sc = sl_bt_gatt_server_read_attribute_value(gattdb_device_name, 0, sizeof(scan_rsp) - 2,
+                                              &name_len, &scan_rsp[2]);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_gatt_server_read_attribute_value() returned != 0 status=0x%04x", (unsigned int) sc);
+      name_len = 0;
+    }
+  scan_rsp[0] = (uint8_t) (name_len + 1);
+  scan_rsp[1] = AD_TYPE_NAME_COMPLETE;
+  sc = sl_bt_advertiser_set_data(advertising_set, SCAN_RESPONSE, name_len + 2, scan_rsp);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_advertiser_set_data() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+
+  sequence = 0;
+  set_adv_data(advertising_set, 0);
+} // broadcastInit()
+
+/**
+ * @brief Server: starts advertising the broadcast payload, connectable or not
+ *        depending on BROADCAST_CONNECTABLE.
+ *
+ * @param advertising_set, advertising set handle
+ *
+ * @return status of sl_bt_advertiser_start()
+ */
+sl_status_t broadcastStart(uint8_t advertising_set)
+{
+  return sl_bt_advertiser_start(advertising_set, sl_bt_advertiser_user_data,
+#if BROADCAST_CONNECTABLE
+                                sl_bt_advertiser_connectable_scannable);
+#else
+                                sl_bt_advertiser_scannable_non_connectable);
+#endif
+} // broadcastStart()
+
+/**
+ * @brief Server: puts a new reading into the advertising data. Takes effect on the next
+ *        advertising event, advertising does not need to be restarted.
+ *
+ * @param advertising_set, advertising set handle
+ * @param temperature_centi_c, temperature in 0.01 C
+ *
+ * @return none
+ */
+void broadcastUpdate(uint8_t advertising_set, int32_t temperature_centi_c)
+{
+  sequence++;
+  set_adv_data(advertising_set, (int16_t) temperature_centi_c);
+} // broadcastUpdate()
+
+/**
+ * @brief Client: decodes the reading in a scan report.
+ *
+ * @param report, the sl_bt_evt_scanner_scan_report_id event data
+ * @param reading, returns the reading
+ *
+ * @return true if the report carries a broadcast reading
+ */
+bool broadcastDecode(const sl_bt_evt_scanner_scan_report_t *report, broadcast_reading_t *reading)
+{
+  uint8_t        len;
+  const uint8_t *mfg = scanFilterFindAd(&report->data, AD_TYPE_MANUFACTURER, &len);
+
+  if ((mfg == NULL) || (len < BROADCAST_DATA_LEN))
+    return false;
+  if ((mfg[0] != (uint8_t) BROADCAST_COMPANY_ID) || (mfg[1] != (uint8_t) (BROADCAST_COMPANY_ID >> 8)) ||
+      (mfg[2] != BROADCAST_FORMAT))
+    return false;
+
+  reading->temperature_centi_c = (int16_t) (mfg[3] | (mfg[4] << 8));
+  reading->sequence            = (uint16_t) (mfg[5] | (mfg[6] << 8));
+  return true;
+} // broadcastDecode()
+
+/**
+ * @brief Client: decodes a scan report and updates the sender's delivery statistics.
+ *
+ * @param report, the sl_bt_evt_scanner_scan_report_id event data
+ * @param reading, returns the reading
+ *
+ * @return index of the sender (0 to BROADCAST_MAX_SENDERS - 1) if the report carries a new
+ *         reading, -1 for other reports, repeats of a reading and senders beyond the table
+ */
+int broadcastReceived(const sl_bt_evt_scanner_scan_report_t *report, broadcast_reading_t *reading)
+{
+  broadcast_sender_t *sender = NULL;
+  int                 i;
+
+  if (!broadcastDecode(report, reading))
+    return -1;
+
+  for (i = 0; i < BROADCAST_MAX_SENDERS; i++)
+    {
+      if (senders[i].in_use &&
+          (memcmp(senders[i].address.addr, report->address.addr, sizeof(report->address.addr)) == 0))
+        {
+          sender = &senders[i];
+          break;
+        }
+    }
+  if (sender == NULL)
+    {
+      for (i = 0; (i < BROADCAST_MAX_SENDERS) && senders[i].in_use; i++)
+        ;
+      if (i == BROADCAST_MAX_SENDERS)
+        return -1;
+      sender = &senders[i];
+      memset(sender, 0, sizeof(*sender));
+      sender->in_use        = true;
+      sender->address       = report->address;
+      sender->last_sequence = reading->sequence - 1; // first reading is not a gap
+    }
+
+  sender->counters.adverts++;
+  // The same reading is advertised on every advertising event until the next one
+  if (reading->sequence == sender->last_sequence)
+    return -1;
+  sender->counters.missed += (uint16_t) (reading->sequence - sender->last_sequence - 1);
+  sender->last_sequence    = reading->sequence;
+  sender->counters.readings++;
+  return i;
+} // broadcastReceived()
+
+/**
+ * @brief Client: returns a sender's delivery statistics.
+ *
+ * @param sender, index returned by broadcastReceived()
+ * @param counters, filled in
+ *
+ * @return false if no sender has that index
+ */
+bool broadcastSenderCounters(int sender, broadcast_sender_counters_t *counters)
+{
+  if ((sender < 0) || (sender >= BROADCAST_MAX_SENDERS) || !senders[sender].in_use)
+    return false;
+  *counters = senders[sender].counters;
+  return true;
+} // broadcastSenderCounters()
+
+/**
+ * @brief Client: logs each sender's readings, missed sequence numbers and adverts
+ *        received, every BROADCAST_REPORT_PERIOD_MS. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void broadcastReportIfDue(void)
+{
+  uint32_t now_ms = letimerMilliseconds();
+
+  if ((now_ms - last_report_ms) < BROADCAST_REPORT_PERIOD_MS)
+    return;
+  last_report_ms = now_ms;
+
+  for (int i = 0; i < BROADCAST_MAX_SENDERS; i++)
+    {
+      if (!senders[i].in_use)
+        continue;
+      LOG_INFO("Broadcast %02x%02x: %u readings, %u missed, %u adverts received",
+               senders[i].address.addr[1], senders[i].address.addr[0],
+               (unsigned int) senders[i].counters.readings, (unsigned int) senders[i].counters.missed,
+               (unsigned int) senders[i].counters.adverts);
+    }
+} // broadcastReportIfDue()
@@ -0,0 +1,121 @@
+/*
+ * File name: broadcast.h
+ * File description: This file declares the connectionless broadcast APIs. The server puts its
+ *                   latest temperature and a sequence counter into the advertising data, and
+ *                   updates it in place on every new reading. A client in scan only mode decodes
+ *                   the readings without ever opening a connection.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 8 (scanning, advertising data)
+ *  [2] Bluetooth Core Specification Supplement v9, Part A, 1.4 (Manufacturer Specific Data)
+ *  [3] Silicon Labs Bluetooth API reference, Advertiser https://docs.silabs.com/bluetooth/3.2/group-sl-bt-advertiser
+ */
+#ifndef SRC_BROADCAST_H_
+#define SRC_BROADCAST_H_
+
+#include "app.h"
+
+// Server: put the readings into the advertising data
+#define BROADCAST_ENABLE           1
+// Server: 1 keeps accepting connections while broadcasting, 0 broadcasts only (scannable, not connectable)
+#define BROADCAST_CONNECTABLE      1
+// Client: 1 decodes the broadcasts and never connects, for read only dashboards
+#define BROADCAST_SCAN_ONLY        0
+
+// Manufacturer specific data: company ID 0xFFFF (reserved for testing), format, temperature, sequence
+#define BROADCAST_COMPANY_ID       (0xffff)
+#define BROADCAST_FORMAT           (0x01)
+#define BROADCAST_DATA_LEN         (7)
+
+// Client: servers whose broadcasts are tracked, and how often the delivery statistics are logged
+#define BROADCAST_MAX_SENDERS      (4)
+#define BROADCAST_REPORT_PERIOD_MS (60000)
+
+typedef struct
+{
+  int16_t  temperature_centi_c;  // 0.01 degree C
+  uint16_t sequence;             // incremented on every new reading
+} broadcast_reading_t;
+
+// Client: delivery statistics of one sender
+typedef struct
+{
+  uint32_t readings;             // distinct sequence numbers received
+  uint32_t missed;               // sequence numbers skipped between them
+  uint32_t adverts;              // every report carrying a reading, repeats included
+} broadcast_sender_counters_t;
+
+/**
+ * @brief Server: builds the scan response (device name) and the first advertising
+ *        payload. Call from the boot event, after the advertising set is created.
+ *
+ * @param advertising_set, advertising set handle
+ *
+ * @return none
+ */
+void broadcastInit(uint8_t advertising_set);
+
+/**
+ * @brief Server: starts advertising the broadcast payload, connectable or not
+ *        depending on BROADCAST_CONNECTABLE.
+ *
+ * @param advertising_set, advertising set handle
+ *
+ * @return status of sl_bt_advertiser_start()
+ */
+sl_status_t broadcastStart(uint8_t advertising_set);
+
+/**
+ * @brief Server: puts a new reading into the advertising data. Takes effect on the next
+ *        advertising event, advertising does not need to be restarted.
+ *
+ * @param advertising_set, advertising set handle
+ * @param temperature_centi_c, temperature in 0.01 C
+ *
+ * @return none
+ */
+void broadcastUpdate(uint8_t advertising_set, int32_t temperature_centi_c);
+
+/**
+ * @brief Client: decodes the reading in a scan report.
+ *
+ * @param report, the sl_bt_evt_scanner_scan_report_id event data
+ * @param reading, returns the reading
+ *
+ * @return true if the report carries a broadcast reading
+ */
+bool broadcastDecode(const sl_bt_evt_scanner_scan_report_t *report, broadcast_reading_t *reading);
+
+/**
+ * @brief Client: decodes a scan report and updates the sender's delivery statistics.
+ *
+ * @param report, the sl_bt_evt_scanner_scan_report_id event data
+ * @param reading, returns the reading
+ *
+ * @return index of the sender (0 to BROADCAST_MAX_SENDERS - 1) if the report carries a new
+ *         reading, -1 for other reports, repeats of a reading and senders beyond the table
+ */
+int broadcastReceived(const sl_bt_evt_scanner_scan_report_t *report, broadcast_reading_t *reading);
+
+/**
+ * @brief Client: returns a sender's delivery statistics.
+ *
+ * @param sender, index returned by broadcastReceived()
+ * @param counters, filled in
+ *
+ * @return false if no sender has that index
+ */
+bool broadcastSenderCounters(int sender, broadcast_sender_counters_t *counters);
+
+/**
+ * @brief Client: logs each sender's readings, missed sequence numbers and adverts
+ *        received, every BROADCAST_REPORT_PERIOD_MS. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void broadcastReportIfDue(void);
+
+#endif /* SRC_BROADCAST_H_ */
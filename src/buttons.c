@@ -0,0 +1,214 @@
+/*
+ * File name: buttons.c
+ * File description: This file defines the PB0/PB1 debounce and gesture APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 8 (GPIO interrupts, buttons)
+ *  [2] Silicon Labs sleeptimer documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-sleeptimer
+ */
+
+#include "src/buttons.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+typedef struct
+{
+  GPIO_Port_TypeDef            port;
+  uint8_t                      pin;
+  uint32_t                     evt_pressed;
+  uint32_t                     evt_released;
+  uint32_t                     evt_long_press;
+  uint32_t                     evt_double_click;
+  const char                  *name;
+
+  bool                         pressed;            // debounced state
+  bool                         released_once;      // release_tick is valid
+  uint32_t                     release_tick;       // last accepted release, for double clicks
+  sl_sleeptimer_timer_handle_t debounce_timer;
+  sl_sleeptimer_timer_handle_t long_press_timer;
+
+  // Since boot
+  uint32_t                     edges;              // GPIO interrupts, bounce included
+  uint32_t                     transitions;        // accepted presses and releases
+  uint32_t                     long_presses;
+  uint32_t                     double_clicks;
+  uint32_t                     chords;
+} button_t;
+
+static button_t buttons[BUTTON_COUNT] =
+{
+  { .port = PB0_port, .pin = PB0_pin, .evt_pressed = evtPB0_pressed, .evt_released = evtPB0_released,
+    .evt_long_press = evtPB0_long_press, .evt_double_click = evtPB0_double_click, .name = "PB0" },
+  { .port = PB1_port, .pin = PB1_pin, .evt_pressed = evtPB1_pressed, .evt_released = evtPB1_released,
+    .evt_long_press = evtPB1_long_press, .evt_double_click = evtPB1_double_click, .name = "PB1" },
+};
+
+static uint32_t last_report_ms = 0;
+static uint32_t last_report_edges = 0;
+
+// Set by buttonsEdge() in the GPIO interrupt, logged from buttonsReportIfDue()
+static volatile uint32_t    restart_failures = 0;
+static volatile sl_status_t restart_status = SL_STATUS_OK;
+
+/*
+ * @brief Posts a long press if the button is still down. Sleeptimer callback, interrupt context.
+ * @param handle, the timer
+ * @param data, the button
+ * @return none
+ */
+static void long_press_timeout(sl_sleeptimer_timer_handle_t *handle, void *data)
+{
+  button_t *button = (button_t *) data;
+
+  (void) handle;
+  if (button->pressed)
+    {
+      button->long_presses++;
+      schedulerSetEventButtons(button->evt_long_press);
+    }
+} // long_press_timeout()
+
+/*
+ * @brief Accepts the button level once it has been stable for BUTTONS_DEBOUNCE_MS and
+ *        posts the press or release with the gestures it completes. Sleeptimer
+ *        callback, interrupt context.
+ * @param handle, the timer
+ * @param data, the button
+ * @return none
+ */
+static void debounce_timeout(sl_sleeptimer_timer_handle_t *handle, void *data)
+{
+  button_t *button  = (button_t *) data;
+  bool      pressed = (GPIO_PinInGet(button->port, button->pin) == 0); // 0=pressed, 1=released
+  uint32_t  now     = sl_sleeptimer_get_tick_count();
+  uint32_t  events;
+
+  (void) handle;
+  if (pressed == button->pressed)
+    return; // bounced back to where it was, nothing happened
+
+  button->pressed = pressed;
+  button->transitions++;
+  if (!pressed)
+    {
+      sl_sleeptimer_stop_timer(&button->long_press_timer);
+      button->released_once = true;
+      button->release_tick  = now;
+      schedulerSetEventButtons(button->evt_released);
+      return;
+    }
+
+  events = button->evt_pressed;
+  if (button->released_once &&
+      (sl_sleeptimer_tick_to_ms(now - button->release_tick) < BUTTONS_DOUBLE_CLICK_MS))
+    {
+      events |= button->evt_double_click;
+      button->double_clicks++;
+      button->released_once = false; // a third click starts over
+    }
+  // The other button is already down
+  if (buttons[0].pressed && buttons[1].pressed)
+    {
+      events |= evtPB_chord;
+      button->chords++;
+    }
+  sl_sleeptimer_start_timer_ms(&button->long_press_timer, BUTTONS_LONG_PRESS_MS,
+                               long_press_timeout, button, 0, 0);
+  schedulerSetEventButtons(events);
+} // debounce_timeout()
+
+/**
+ * @brief Reads the current button levels as the debounced state. Call from app_init(),
+ *        after gpioInit().
+ *
+ * @param none
+ *
+ * @return none
+ */
+void buttonsInit(void)
+{
+  for (int i = 0; i < BUTTON_COUNT; i++)
+    buttons[i].pressed = (GPIO_PinInGet(buttons[i].port, buttons[i].pin) == 0);
+} // buttonsInit()
+
+/**
+ * @brief Restarts the debounce of a button. Call from its GPIO interrupt on every edge.
+ *
+ * @param button, BUTTON_PB0 or BUTTON_PB1
+ *
+ * @return none
+ */
+void buttonsEdge(button_id_t button)
+{
+  sl_status_t sc;
+
+  if (button >= BUTTON_COUNT)
+    return;
+
+  buttons[button].edges++;
+  // Every bounce pushes the deadline out, only the last edge's level counts
+  sc = sl_sleeptimer_restart_timer_ms(&buttons[button].debounce_timer, BUTTONS_DEBOUNCE_MS,
+                                      debounce_timeout, &buttons[button], 0, 0);
+  if (sc != SL_STATUS_OK)
+    {
+      // Interrupt context, buttonsReportIfDue() logs it
+      restart_status = sc;
+      restart_failures++;
+    }
+} // buttonsEdge()
+
+/**
+ * @brief Returns the debounced state of a button.
+ *
+ * @param button, BUTTON_PB0 or BUTTON_PB1
+ *
+ * @return true if pressed
+ */
+bool buttonsPressed(button_id_t button)
+{
+  return (button < BUTTON_COUNT) && buttons[button].pressed;
+} // buttonsPressed()
+
+/**
+ * @brief Logs the raw edges, accepted presses and releases, spurious edges removed and
+ *        gestures of each button, every BUTTONS_REPORT_PERIOD_MS, and any debounce timer
+ *        buttonsEdge() failed to restart. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void buttonsReportIfDue(void)
+{
+  uint32_t now_ms = letimerMilliseconds();
+  uint32_t edges  = buttons[BUTTON_PB0].edges + buttons[BUTTON_PB1].edges;
+  uint32_t failures;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  failures = restart_failures;
+  restart_failures = 0;
+  CORE_EXIT_CRITICAL();
+  if (failures > 0)
+    {
+      LOG_ERROR("sl_sleeptimer_restart_timer_ms() returned != 0 status=0x%04x, %u times",
+                (unsigned int) restart_status, (unsigned int) failures);
+    }
+
+  if ((now_ms - last_report_ms) < BUTTONS_REPORT_PERIOD_MS)
+    return;
+  last_report_ms = now_ms;
+  if (edges == last_report_edges)
+    return; // nobody touched the buttons
+  last_report_edges = edges;
+
+  for (int i = 0; i < BUTTON_COUNT; i++)
+    {
+      LOG_INFO("%s: %u edges, %u presses/releases, %u spurious removed, %u long, %u double, %u chord",
+               buttons[i].name, (unsigned int) buttons[i].edges, (unsigned int) buttons[i].transitions,
+               (unsigned int) (buttons[i].edges - buttons[i].transitions),
+               (unsigned int) buttons[i].long_presses, (unsigned int) buttons[i].double_clicks,
+               (unsigned int) buttons[i].chords);
+    }
+} // buttonsReportIfDue()
@@ -0,0 +1,74 @@
+/*
+ * File name: buttons.h
+ * File description: This file declares the PB0/PB1 debounce and gesture APIs. The GPIO
+ *                   interrupts only restart a sleeptimer, a level is accepted once it has
+ *                   been stable for BUTTONS_DEBOUNCE_MS. Each accepted press or release is
+ *                   posted to the BT stack as one external signal, with the long press,
+ *                   double click and two button chord bits it completes.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 8 (GPIO interrupts, buttons)
+ *  [2] Silicon Labs sleeptimer documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-sleeptimer
+ */
+#ifndef SRC_BUTTONS_H_
+#define SRC_BUTTONS_H_
+
+#include "app.h"
+
+// A level must be stable this long to be accepted, longer than the contacts bounce
+#define BUTTONS_DEBOUNCE_MS         (20)
+// Held this long, a long press is posted while the button is still down
+#define BUTTONS_LONG_PRESS_MS       (1000)
+// A press within this long of the previous release of the same button is a double click
+#define BUTTONS_DOUBLE_CLICK_MS     (400)
+// How often the edge and gesture counters are logged
+#define BUTTONS_REPORT_PERIOD_MS    (60000)
+
+typedef enum
+{
+  BUTTON_PB0,
+  BUTTON_PB1,
+  BUTTON_COUNT
+} button_id_t;
+
+/**
+ * @brief Reads the current button levels as the debounced state. Call from app_init(),
+ *        after gpioInit().
+ *
+ * @param none
+ *
+ * @return none
+ */
+void buttonsInit(void);
+
+/**
+ * @brief Restarts the debounce of a button. Call from its GPIO interrupt on every edge.
+ *
+ * @param button, BUTTON_PB0 or BUTTON_PB1
+ *
+ * @return none
+ */
+void buttonsEdge(button_id_t button);
+
+/**
+ * @brief Returns the debounced state of a button.
+ *
+ * @param button, BUTTON_PB0 or BUTTON_PB1
+ *
+ * @return true if pressed
+ */
+bool buttonsPressed(button_id_t button);
+
+/**
+ * @brief Logs the raw edges, accepted presses and releases, spurious edges removed and
+ *        gestures of each button, every BUTTONS_REPORT_PERIOD_MS, and any debounce timer
+ *        buttonsEdge() failed to restart. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void buttonsReportIfDue(void);
+
+#endif /* SRC_BUTTONS_H_ */
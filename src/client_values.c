@@ -0,0 +1,294 @@
+/*
+ * File name: client_values.c
+ * File description: This file defines the client value pipeline APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] Silicon Labs Bluetooth API reference, GATT https://docs.silabs.com/bluetooth/3.2/group-sl-bt-gatt
+ *  [2] Bluetooth Health Thermometer Service v1.0, 3.1 (Temperature Measurement)
+ *  [3] ARM Cortex-M4 Technical Reference Manual, DWT CYCCNT https://developer.arm.com/documentation/100166/0001/Data-Watchpoint-and-Trace-Unit
+ */
+
+#include "src/client_values.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+#define RING_MASK (CLIENT_VALUES_RING_DEPTH - 1)
+
+typedef struct
+{
+  bool            in_use;
+  uint8_t         connection;
+  uint16_t        characteristic;
+  value_decoder_t decoder;
+} decoder_entry_t;
+
+static decoder_entry_t decoders[CLIENT_VALUES_MAX_DECODERS];
+
+// Free running indexes, a slot is index & RING_MASK
+static value_sample_t ring[CLIENT_VALUES_RING_DEPTH];
+static uint32_t       head = 0;
+static uint32_t       tail[VALUE_CONSUMER_COUNT];
+
+// Since boot
+static uint32_t decoded = 0;
+static uint32_t malformed = 0;
+static uint32_t unregistered = 0;
+static uint32_t lost[VALUE_CONSUMER_COUNT];
+static uint32_t timed = 0;
+static uint64_t total_cycles = 0;
+static uint32_t min_cycles = UINT32_MAX;
+static uint32_t max_cycles = 0;
+static uint32_t last_report_ms = 0;
+
+static const char *const consumer_names[VALUE_CONSUMER_COUNT] = { "display", "history" };
+
+/*
+ * @brief HTM Temperature Measurement: flags, 4 byte IEEE-11073 FLOAT, rest optional
+ * @param data, the value in the event
+ * @param len, its length
+ * @param sample, the ring slot
+ * @return false if too short
+ */
+static bool decode_temperature(const uint8_t *data, uint8_t len, value_sample_t *sample)
+{
+  if (len < 5)
+    return false;
+  sample->kind  = VALUE_TEMPERATURE;
+  sample->value = FLOAT_TO_INT32(data);
+  return true;
+} // decode_temperature()
+
+/*
+ * @brief button_state: flags, state
+ * @param data, the value in the event
+ * @param len, its length
+ * @param sample, the ring slot
+ * @return false if too short or not 0/1
+ */
+static bool decode_button(const uint8_t *data, uint8_t len, value_sample_t *sample)
+{
+  if ((len < 2) || (data[1] > 1))
+    return false;
+  sample->kind  = VALUE_BUTTON;
+  sample->value = data[1];
+  return true;
+} // decode_button()
+
+/*
+ * @brief Finds the decoder of a characteristic
+ * @param connection, the connection
+ * @param characteristic, the characteristic handle
+ * @return the entry, NULL if none
+ */
+static decoder_entry_t *find_decoder(uint8_t connection, uint16_t characteristic)
+{
+  for (int i = 0; i < CLIENT_VALUES_MAX_DECODERS; i++)
+    {
+      if (decoders[i].in_use && (decoders[i].connection == connection) &&
+          (decoders[i].characteristic == characteristic))
+        return &decoders[i];
+    }
+  return NULL;
+} // find_decoder()
+
+/**
+ * @brief Clears the decoders and the ring, and starts the DWT cycle counter used to time
+ *        the indications. Call once from the boot event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void clientValuesInit(void)
+{
+  memset(decoders, 0, sizeof(decoders));
+  head = 0;
+  memset(tail, 0, sizeof(tail));
+
+  cycleCounterInit();
+} // clientValuesInit()
+
+/**
+ * @brief Registers the HTM and button_state decoders of a server's discovered handles,
+ *        a handle already registered has its decoder replaced.
+ *
+ * @param server, the server
+ *
+ * @return none
+ */
+void clientValuesRegisterServer(const struct ble_server_s *server)
+{
+  if (server->htm_characteristic_handle != 0)
+    clientValuesRegister(server->connection, server->htm_characteristic_handle, decode_temperature);
+  if (server->button_characteristic_handle != 0)
+    clientValuesRegister(server->connection, server->button_characteristic_handle, decode_button);
+} // clientValuesRegisterServer()
+
+/**
+ * @brief Registers the decoder of one characteristic.
+ *
+ * @param connection, the connection the characteristic belongs to
+ * @param characteristic, the characteristic handle
+ * @param decoder, the decoder
+ *
+ * @return true if registered, false if the table is full
+ */
+bool clientValuesRegister(uint8_t connection, uint16_t characteristic, value_decoder_t decoder)
+{
+  decoder_entry_t *entry = find_decoder(connection, characteristic);
+
+  for (int i = 0; (entry == NULL) && (i < CLIENT_VALUES_MAX_DECODERS); i++)
+    entry = (decoders[i].in_use) ? NULL : &decoders[i];
+  if (entry == NULL)
+    {
+      LOG_ERROR("No free decoder for connection %d characteristic %d", (int) connection, (int) characteristic);
+      return false;
+    }
+  entry->in_use         = true;
+  entry->connection     = connection;
+  entry->characteristic = characteristic;
+  entry->decoder        = decoder;
+  return true;
+} // clientValuesRegister()
+
+/**
+ * @brief Drops the decoders of a connection. Call when it closes.
+ *
+ * @param connection, the connection
+ *
+ * @return none
+ */
+void clientValuesForget(uint8_t connection)
+{
+  for (int i = 0; i < CLIENT_VALUES_MAX_DECODERS; i++)
+    {
+      if (decoders[i].connection == connection)
+        decoders[i].in_use = false;
+    }
+} // clientValuesForget()
+
+/**
+ * @brief Decodes a characteristic value and stores the sample in the ring. When the ring
+ *        is full, a consumer that has not read the oldest sample loses it. A malformed
+ *        value is counted and leaves the ring as it was.
+ *
+ * @param value, the sl_bt_evt_gatt_characteristic_value_id event data
+ *
+ * @return true if a decoder is registered for the characteristic
+ */
+bool clientValuesDecode(const sl_bt_evt_gatt_characteristic_value_t *value)
+{
+  decoder_entry_t *entry = find_decoder(value->connection, value->characteristic);
+  value_sample_t   sample;
+
+  if (entry == NULL)
+    {
+      unregistered++;
+      return false;
+    }
+
+  // A malformed value leaves the ring as it was
+  sample.connection = value->connection;
+  sample.tick       = sl_sleeptimer_get_tick_count();
+  if (!entry->decoder(value->value.data, value->value.len, &sample))
+    {
+      malformed++;
+      return true;
+    }
+
+  for (int c = 0; c < VALUE_CONSUMER_COUNT; c++)
+    {
+      if ((head - tail[c]) >= CLIENT_VALUES_RING_DEPTH)
+        {
+          tail[c]++;
+          lost[c]++;
+        }
+    }
+  ring[head & RING_MASK] = sample;
+  decoded++;
+  head++;
+  return true;
+} // clientValuesDecode()
+
+/**
+ * @brief Returns the oldest sample a consumer has not read, it stays in the ring until
+ *        clientValuesNext().
+ *
+ * @param consumer, the consumer
+ *
+ * @return the sample, NULL if there is none
+ */
+const value_sample_t *clientValuesPeek(value_consumer_t consumer)
+{
+  if (tail[consumer] == head)
+    return NULL;
+  return &ring[tail[consumer] & RING_MASK];
+} // clientValuesPeek()
+
+/**
+ * @brief Moves a consumer to its next sample.
+ *
+ * @param consumer, the consumer
+ *
+ * @return none
+ */
+void clientValuesNext(value_consumer_t consumer)
+{
+  if (tail[consumer] != head)
+    tail[consumer]++;
+} // clientValuesNext()
+
+/**
+ * @brief Adds the cycles the client took on one indication, from the event to the
+ *        confirmation and the display.
+ *
+ * @param cycles, DWT cycles
+ *
+ * @return none
+ */
+void clientValuesTimed(uint32_t cycles)
+{
+  timed++;
+  total_cycles += cycles;
+  if (cycles < min_cycles)
+    min_cycles = cycles;
+  if (cycles > max_cycles)
+    max_cycles = cycles;
+} // clientValuesTimed()
+
+/**
+ * @brief Logs the indications, the samples published, dropped and lost by each consumer,
+ *        and the min/avg/max time per indication, every CLIENT_VALUES_REPORT_PERIOD_MS.
+ *        Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void clientValuesReportIfDue(void)
+{
+  uint32_t now_ms        = letimerMilliseconds();
+  uint32_t cycles_per_us = CMU_ClockFreqGet(cmuClock_CORE) / 1000000;
+
+  if ((now_ms - last_report_ms) < CLIENT_VALUES_REPORT_PERIOD_MS)
+    return;
+  last_report_ms = now_ms;
+
+  LOG_INFO("Client values: %u decoded, %u malformed, %u without a decoder",
+           (unsigned int) decoded, (unsigned int) malformed, (unsigned int) unregistered);
+  for (int c = 0; c < VALUE_CONSUMER_COUNT; c++)
+    {
+      LOG_INFO("Client values %s: %u behind, %u lost", consumer_names[c],
+               (unsigned int) (head - tail[c]), (unsigned int) lost[c]);
+    }
+  if ((timed > 0) && (cycles_per_us > 0))
+    {
+      LOG_INFO("Client values: %u indications, %u/%u/%u cycles min/avg/max (%u/%u/%u us)",
+               (unsigned int) timed, (unsigned int) min_cycles,
+               (unsigned int) (total_cycles / timed), (unsigned int) max_cycles,
+               (unsigned int) (min_cycles / cycles_per_us),
+               (unsigned int) ((total_cycles / timed) / cycles_per_us),
+               (unsigned int) (max_cycles / cycles_per_us));
+    }
+} // clientValuesReportIfDue()
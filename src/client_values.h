@@ -0,0 +1,151 @@
+/*
+ * File name: client_values.h
+ * File description: This file declares the client value pipeline APIs. A decoder is
+ *                   registered per (connection, characteristic handle) once discovery has
+ *                   the handles. An indication is decoded straight from the event buffer,
+ *                   the decoder gets a pointer and a length into it, into a typed sample
+ *                   that is stored once in a ring if it decodes. The display and the history
+ *                   read the ring in place, each with its own cursor. The time the client
+ *                   takes per indication is measured with the DWT cycle counter.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] Silicon Labs Bluetooth API reference, GATT https://docs.silabs.com/bluetooth/3.2/group-sl-bt-gatt
+ *  [2] Bluetooth Health Thermometer Service v1.0, 3.1 (Temperature Measurement)
+ *  [3] ARM Cortex-M4 Technical Reference Manual, DWT CYCCNT https://developer.arm.com/documentation/100166/0001/Data-Watchpoint-and-Trace-Unit
+ */
+#ifndef SRC_CLIENT_VALUES_H_
+#define SRC_CLIENT_VALUES_H_
+
+#include "app.h"
+
+// ble_server_t, src/ble.h includes app.h ahead of its typedefs
+struct ble_server_s;
+
+// Registered decoders, two characteristics per server
+#define CLIENT_VALUES_MAX_DECODERS    (2 * BLE_MAX_SERVERS)
+// Samples in the ring, a power of 2
+#define CLIENT_VALUES_RING_DEPTH      (16)
+// How often the pipeline counters are logged
+#define CLIENT_VALUES_REPORT_PERIOD_MS (600000)
+
+typedef enum
+{
+  VALUE_TEMPERATURE,           // HTM Temperature Measurement, value in degrees C
+  VALUE_BUTTON,                // button_state, value 1 pressed, 0 released
+} value_kind_t;
+
+typedef struct
+{
+  uint8_t  kind;               // value_kind_t
+  uint8_t  connection;
+  int32_t  value;
+  uint32_t tick;               // sl_sleeptimer tick count when received
+} value_sample_t;
+
+// Readers of the ring, each one sees every sample
+typedef enum
+{
+  VALUE_CONSUMER_DISPLAY,
+  VALUE_CONSUMER_HISTORY,
+  VALUE_CONSUMER_COUNT
+} value_consumer_t;
+
+/*
+ * A decoder reads the value where the stack left it and fills in the sample's kind and
+ * value. Returns false if the value is malformed, the sample is then not published.
+ */
+typedef bool (*value_decoder_t)(const uint8_t *data, uint8_t len, value_sample_t *sample);
+
+/**
+ * @brief Clears the decoders and the ring, and starts the DWT cycle counter used to time
+ *        the indications. Call once from the boot event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void clientValuesInit(void);
+
+/**
+ * @brief Registers the HTM and button_state decoders of a server's discovered handles,
+ *        a handle already registered has its decoder replaced.
+ *
+ * @param server, the server
+ *
+ * @return none
+ */
+void clientValuesRegisterServer(const struct ble_server_s *server);
+
+/**
+ * @brief Registers the decoder of one characteristic.
+ *
+ * @param connection, the connection the characteristic belongs to
+ * @param characteristic, the characteristic handle
+ * @param decoder, the decoder
+ *
+ * @return true if registered, false if the table is full
+ */
+bool clientValuesRegister(uint8_t connection, uint16_t characteristic, value_decoder_t decoder);
+
+/**
+ * @brief Drops the decoders of a connection. Call when it closes.
+ *
+ * @param connection, the connection
+ *
+ * @return none
+ */
+void clientValuesForget(uint8_t connection);
+
+/**
+ * @brief Decodes a characteristic value and stores the sample in the ring. When the ring
+ *        is full, a consumer that has not read the oldest sample loses it. A malformed
+ *        value is counted and leaves the ring as it was.
+ *
+ * @param value, the sl_bt_evt_gatt_characteristic_value_id event data
+ *
+ * @return true if a decoder is registered for the characteristic
+ */
+bool clientValuesDecode(const sl_bt_evt_gatt_characteristic_value_t *value);
+
+/**
+ * @brief Returns the oldest sample a consumer has not read, it stays in the ring until
+ *        clientValuesNext().
+ *
+ * @param consumer, the consumer
+ *
+ * @return the sample, NULL if there is none
+ */
+const value_sample_t *clientValuesPeek(value_consumer_t consumer);
+
+/**
+ * @brief Moves a consumer to its next sample.
+ *
+ * @param consumer, the consumer
+ *
+ * @return none
+ */
+void clientValuesNext(value_consumer_t consumer);
+
+/**
+ * @brief Adds the cycles the client took on one indication, from the event to the
+ *        confirmation and the display.
+ *
+ * @param cycles, DWT cycles
+ *
+ * @return none
+ */
+void clientValuesTimed(uint32_t cycles);
+
+/**
+ * @brief Logs the indications, the samples published, dropped and lost by each consumer,
+ *        and the min/avg/max time per indication, every CLIENT_VALUES_REPORT_PERIOD_MS.
+ *        Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void clientValuesReportIfDue(void);
+
+#endif /* SRC_CLIENT_VALUES_H_ */
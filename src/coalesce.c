@@ -0,0 +1,192 @@
+/*
+ * File name: coalesce.c
+ * File description: This file defines the wakeup coalescer APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] Silicon Labs power manager documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-power-manager
+ *  [2] Silicon Labs sleeptimer documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-sleeptimer
+ */
+
+#include "src/coalesce.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+static coalesce_job_t *jobs = NULL;
+static uint32_t last_report_ms = 0;
+static sl_power_manager_em_transition_event_handle_t em_event_handle;
+
+/*
+ * @brief Power manager callback on every wakeup, posts evtCoalesce if a job is due so it
+ *        runs in this wakeup. Runs with interrupts off.
+ * @param from, energy mode being left
+ * @param to, energy mode being entered
+ * @return none
+ */
+static void em_transition(sl_power_manager_em_t from, sl_power_manager_em_t to)
+{
+  uint32_t        now  = sl_sleeptimer_get_tick_count();
+  bool            post = false;
+  coalesce_job_t *job;
+
+  (void) from;
+  (void) to;
+  for (job = jobs; job != NULL; job = job->next)
+    {
+      if (job->pending && !job->signalled && ((int32_t) (now - job->earliest_tick) >= 0))
+        {
+          job->signalled = true;
+          post           = true;
+        }
+    }
+  if (post)
+    schedulerSetEventCoalesce();
+} // em_transition()
+
+static const sl_power_manager_em_transition_event_info_t em_event_info =
+{
+  .event_mask = SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM0,
+  .on_event   = em_transition,
+};
+
+/*
+ * @brief Nothing woke the MCU within the slack, wakes it for the job. Sleeptimer
+ *        callback, interrupt context.
+ * @param handle, the timer
+ * @param data, the job
+ * @return none
+ */
+static void deadline_timeout(sl_sleeptimer_timer_handle_t *handle, void *data)
+{
+  coalesce_job_t *job = (coalesce_job_t *) data;
+
+  (void) handle;
+  energyCountWakeup(WAKEUP_COALESCE);
+  job->signalled = true;
+  schedulerSetEventCoalesce();
+} // deadline_timeout()
+
+/**
+ * @brief Starts watching the wakeups. Call from app_init() before any job is scheduled.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void coalesceInit(void)
+{
+  sl_power_manager_subscribe_em_transition_event(&em_event_handle, &em_event_info);
+} // coalesceInit()
+
+/**
+ * @brief Runs a job no sooner than delay_us from now and no later than slack_ms after
+ *        that. A job already pending keeps its window, both requests are served by one run.
+ *
+ * @param job, the job
+ * @param delay_us, earliest time from now, in us
+ * @param slack_ms, how much later it may run, in ms
+ *
+ * @return none
+ */
+void coalesceSchedule(coalesce_job_t *job, uint32_t delay_us, uint32_t slack_ms)
+{
+  uint32_t    now   = sl_sleeptimer_get_tick_count();
+  uint32_t    hz    = sl_sleeptimer_get_timer_frequency();
+  uint32_t    delay = (uint32_t) (((uint64_t) delay_us * hz) / 1000000);
+  uint32_t    slack = (uint32_t) (((uint64_t) slack_ms * hz) / 1000);
+  sl_status_t sc;
+
+  if (!job->registered)
+    {
+      job->registered = true;
+      job->next       = jobs;
+      jobs            = job;
+    }
+  if (job->pending)
+    {
+      job->merged++;
+      return;
+    }
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL(); // em_transition() reads the job
+  job->earliest_tick = now + delay;
+  job->deadline_tick = now + delay + slack;
+  job->signalled     = (delay == 0); // due now, run it in this wakeup
+  job->deferred      = (delay != 0);
+  job->pending       = true;
+  CORE_EXIT_CRITICAL();
+
+  sc = sl_sleeptimer_restart_timer(&job->deadline_timer, delay + slack, deadline_timeout, job, 0, 0);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_sleeptimer_restart_timer() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+  if (delay == 0)
+    schedulerSetEventCoalesce();
+} // coalesceSchedule()
+
+/**
+ * @brief Runs the jobs that are due. Subscribe to sl_bt_evt_system_external_signal_id
+ *        and sl_bt_evt_system_boot_id.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void coalesceOnSignal(sl_bt_msg_t *evt)
+{
+  uint32_t        now;
+  coalesce_job_t *job;
+
+  // Signals posted before the boot event are lost, boot runs whatever is due
+  if ((SL_BT_MSG_ID(evt->header) == sl_bt_evt_system_external_signal_id) &&
+      !(evt->data.evt_system_external_signal.extsignals & evtCoalesce))
+    return;
+
+  now = sl_sleeptimer_get_tick_count();
+  for (job = jobs; job != NULL; job = job->next)
+    {
+      if (!job->pending || ((int32_t) (now - job->earliest_tick) < 0))
+        continue;
+
+      sl_sleeptimer_stop_timer(&job->deadline_timer);
+      // Before its deadline, some other wakeup let it run
+      if (job->deferred && ((int32_t) (now - job->deadline_tick) < 0))
+        job->shared++;
+      job->runs++;
+      job->pending   = false;
+      job->signalled = false;
+      job->run(); // may schedule the job again
+    }
+} // coalesceOnSignal()
+
+/**
+ * @brief Logs every job's runs, the wakeups they shared and the energy that saved, every
+ *        COALESCE_REPORT_PERIOD_MS. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void coalesceReportIfDue(void)
+{
+  uint32_t        now_ms = letimerMilliseconds();
+  uint32_t        shared = 0;
+  coalesce_job_t *job;
+
+  if ((now_ms - last_report_ms) < COALESCE_REPORT_PERIOD_MS)
+    return;
+  last_report_ms = now_ms;
+
+  for (job = jobs; job != NULL; job = job->next)
+    {
+      LOG_INFO("Coalesce %s: %u runs, %u in a shared wakeup, %u requests merged",
+               job->name, (unsigned int) job->runs, (unsigned int) job->shared, (unsigned int) job->merged);
+      shared += job->shared;
+    }
+  // uJ = nA * us * mV / 10^12
+  LOG_INFO("Coalesce: %u wakeups saved, %u/hr, ~%u uJ", (unsigned int) shared,
+           (unsigned int) ((now_ms > 0) ? (((uint64_t) shared * MS_PER_HOUR) / now_ms) : 0),
+           (unsigned int) (((uint64_t) shared * ENERGY_EM0_NA * COALESCE_WAKEUP_US * LINK_SUPPLY_MV) / 1000000000000ULL));
+} // coalesceReportIfDue()
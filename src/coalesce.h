@@ -0,0 +1,109 @@
+/*
+ * File name: coalesce.h
+ * File description: This file declares the wakeup coalescer APIs. Deferrable work (the
+ *                   Si7021 waits, LCD flushes) is scheduled with a delay and a slack. It
+ *                   runs in the first wakeup that is already happening once the delay has
+ *                   passed: a BT connection event, the sampler, a button. Only if nothing
+ *                   wakes the MCU before the slack runs out does its own sleeptimer wake it.
+ *                   Wakeups are seen through the power manager EM transition events.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] Silicon Labs power manager documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-power-manager
+ *  [2] Silicon Labs sleeptimer documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-sleeptimer
+ */
+#ifndef SRC_COALESCE_H_
+#define SRC_COALESCE_H_
+
+#include "app.h"
+
+// Set to 0 to time the Si7021 waits with LETIMER0 COMP1 again
+#ifndef COALESCE_SENSOR_WAITS
+#define COALESCE_SENSOR_WAITS       1
+#endif
+// Set to 0 to send every displayPrintf() to the LCD straight away
+#ifndef COALESCE_LCD_FLUSHES
+#define COALESCE_LCD_FLUSHES        1
+#endif
+// Set to 0 to toggle EXTCOMIN from the BT stack soft timer and the sl_memlcd sleeptimer,
+// not used with LCD_EXTCOMIN_HW_TOGGLE. The host harness builds all three on and all
+// three off (-DCOALESCE_SENSOR_WAITS=0 -DCOALESCE_LCD_FLUSHES=0 -DCOALESCE_LCD_EXTCOMIN=0).
+#ifndef COALESCE_LCD_EXTCOMIN
+#define COALESCE_LCD_EXTCOMIN       1
+#endif
+// Extra time the Si7021 power up and conversion waits may take
+#define COALESCE_SENSOR_SLACK_MS    (20)
+// How long after displayPrintf() the frame buffer may reach the LCD
+#define COALESCE_LCD_SLACK_MS       (50)
+// How much earlier than LCD_EXTCOMIN_PERIOD_MS EXTCOMIN may be toggled
+#define COALESCE_EXTCOMIN_SLACK_MS  (300)
+// EM0 time of a wakeup out of EM2 with nothing to do, for the energy saved estimate
+#define COALESCE_WAKEUP_US          (300)
+// How often the job counters are logged
+#define COALESCE_REPORT_PERIOD_MS   (600000)
+
+typedef struct coalesce_job
+{
+  const char                  *name;
+  void                       (*run)(void);
+
+  bool                         registered;      // in the list of jobs
+  volatile bool                pending;
+  volatile bool                signalled;       // evtCoalesce posted for it
+  bool                         deferred;        // scheduled with a delay, would have needed a wakeup
+  uint32_t                     earliest_tick;
+  uint32_t                     deadline_tick;
+  sl_sleeptimer_timer_handle_t deadline_timer;
+  // Since boot
+  uint32_t                     runs;
+  uint32_t                     shared;          // ran in a wakeup that was happening anyway
+  uint32_t                     merged;          // scheduled again while pending, one run for both
+
+  struct coalesce_job         *next;
+} coalesce_job_t;
+
+// Initializer, e.g. static coalesce_job_t job = COALESCE_JOB("lcd_flush", flush);
+#define COALESCE_JOB(job_name, job_run) { .name = (job_name), .run = (job_run) }
+
+/**
+ * @brief Starts watching the wakeups. Call from app_init() before any job is scheduled.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void coalesceInit(void);
+
+/**
+ * @brief Runs a job no sooner than delay_us from now and no later than slack_ms after
+ *        that. A job already pending keeps its window, both requests are served by one run.
+ *
+ * @param job, the job
+ * @param delay_us, earliest time from now, in us
+ * @param slack_ms, how much later it may run, in ms
+ *
+ * @return none
+ */
+void coalesceSchedule(coalesce_job_t *job, uint32_t delay_us, uint32_t slack_ms);
+
+/**
+ * @brief Runs the jobs that are due. Subscribe to sl_bt_evt_system_external_signal_id
+ *        and sl_bt_evt_system_boot_id.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void coalesceOnSignal(sl_bt_msg_t *evt);
+
+/**
+ * @brief Logs every job's runs, the wakeups they shared and the energy that saved, every
+ *        COALESCE_REPORT_PERIOD_MS. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void coalesceReportIfDue(void);
+
+#endif /* SRC_COALESCE_H_ */
@@ -0,0 +1,281 @@
+/*
+ * File name: conn_params.c
+ * File description: This file defines the connection parameter manager APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 6 (connection parameters)
+ *  [2] Bluetooth Core Specification v5.2, Vol 6, Part B, 4.5.1 Connection events, 4.5.2 Supervision timeout
+ *  [3] Silicon Labs Bluetooth API reference, Connection https://docs.silabs.com/bluetooth/3.2/group-sl-bt-connection
+ */
+
+#include "src/conn_params.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+typedef struct
+{
+  uint16_t    min_interval;
+  uint16_t    max_interval;
+  uint16_t    latency;
+  uint16_t    timeout;
+  const char *name;
+} conn_profile_params_t;
+
+static const conn_profile_params_t profiles[] =
+{
+  [CONN_PROFILE_FAST]   = { CONN_FAST_INTERVAL_MIN,   CONN_FAST_INTERVAL_MAX,   CONN_FAST_LATENCY,   CONN_FAST_TIMEOUT,   "fast"   },
+  [CONN_PROFILE_STEADY] = { CONN_STEADY_INTERVAL_MIN, CONN_STEADY_INTERVAL_MAX, CONN_STEADY_LATENCY, CONN_STEADY_TIMEOUT, "steady" },
+};
+
+typedef struct
+{
+  bool           in_use;
+  uint8_t        connection;
+  uint8_t        busy;            // CONN_BUSY_ bit mask
+  conn_profile_t requested;       // last profile asked for
+  uint32_t       queue_depth;     // last depth passed to connParamsUpdate()
+  uint32_t       opened_tick;     // sl_sleeptimer ticks
+  uint32_t       last_busy_tick;  // last time a busy condition held
+  // Parameters in use, from sl_bt_evt_connection_parameters_id
+  uint16_t       interval;        // 1.25 ms units, 0 until the first event
+  uint16_t       latency;
+  uint32_t       since_tick;      // time accounted up to
+  uint32_t       residue_us;      // accounted time short of a whole connection event
+  // Totals for the close report
+  uint64_t       fast_ticks;      // time at or below CONN_FAST_INTERVAL_MAX
+  uint64_t       relaxed_ticks;   // time above it
+  uint32_t       events;          // connection events this device attended
+  uint32_t       changes;         // parameter changes applied
+} conn_params_entry_t;
+
+static conn_params_entry_t entries[CONN_PARAMS_MAX_CONNECTIONS];
+
+/*
+ * @brief Finds the table entry of a connection
+ * @param connection, connection handle
+ * @return pointer to the entry, NULL if not tracked
+ */
+static conn_params_entry_t *find_entry(uint8_t connection)
+{
+  for (int i = 0; i < CONN_PARAMS_MAX_CONNECTIONS; i++)
+    {
+      if (entries[i].in_use && (entries[i].connection == connection))
+        return &entries[i];
+    }
+  return NULL;
+} // find_entry()
+
+/*
+ * @brief Milliseconds since a sleeptimer tick count
+ * @param tick, the earlier tick count
+ * @return elapsed ms
+ */
+static uint32_t ms_since(uint32_t tick)
+{
+  return sl_sleeptimer_tick_to_ms(sl_sleeptimer_get_tick_count() - tick);
+} // ms_since()
+
+/*
+ * @brief Adds the time since it was last called to the totals and the radio on time
+ * @param entry, the connection
+ * @return none
+ */
+static void account_time(conn_params_entry_t *entry)
+{
+  uint32_t now      = sl_sleeptimer_get_tick_count();
+  uint32_t elapsed  = now - entry->since_tick;
+  // The peripheral may sleep through `latency` events when it has nothing to send,
+  // the central attends every one
+  uint32_t event_us = (uint32_t) entry->interval * 1250 * (IsServerDevice() ? (entry->latency + 1) : 1);
+  uint64_t total_us;
+  uint32_t events;
+
+  entry->since_tick = now;
+  if (entry->interval == 0)
+    return; // no parameters event yet
+  if (entry->interval <= CONN_FAST_INTERVAL_MAX)
+    entry->fast_ticks += elapsed;
+  else
+    entry->relaxed_ticks += elapsed;
+  total_us          = ((uint64_t) elapsed * 1000000) / sl_sleeptimer_get_timer_frequency() + entry->residue_us;
+  events            = (uint32_t) (total_us / event_us);
+  entry->residue_us = (uint32_t) (total_us % event_us);
+  entry->events    += events;
+  energyAddRadioUs(events * CONN_PARAMS_EVENT_RADIO_US);
+} // account_time()
+
+/*
+ * @brief Asks the link layer for a profile, if it is not the one already requested
+ * @param entry, the connection
+ * @param profile, the profile
+ * @return none
+ */
+static void request_profile(conn_params_entry_t *entry, conn_profile_t profile)
+{
+  const conn_profile_params_t *p = &profiles[profile];
+  sl_status_t                  sc;
+
+  if (entry->requested == profile)
+    return;
+
+  sc = sl_bt_connection_set_parameters(entry->connection, p->min_interval, p->max_interval,
+                                       p->latency, p->timeout, 0, 4);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_connection_set_parameters() returned != 0 status=0x%04x", (unsigned int) sc);
+      return;
+    }
+  LOG_INFO("Conn %d: requesting %s parameters, busy=0x%02x queue=%u", (int) entry->connection,
+           p->name, (unsigned int) entry->busy, (unsigned int) entry->queue_depth);
+  entry->requested = profile;
+} // request_profile()
+
+/*
+ * @brief Picks the profile for the connection's busy reasons and queue depth
+ * @param entry, the connection
+ * @return none
+ */
+static void apply_policy(conn_params_entry_t *entry)
+{
+  if ((entry->busy & CONN_BUSY_SETUP) && (ms_since(entry->opened_tick) >= CONN_PARAMS_SETUP_MAX_MS))
+    entry->busy &= ~CONN_BUSY_SETUP;
+
+  if (entry->busy || (entry->queue_depth >= CONN_PARAMS_QUEUE_HIGH))
+    {
+      entry->last_busy_tick = sl_sleeptimer_get_tick_count();
+      request_profile(entry, CONN_PROFILE_FAST);
+      return;
+    }
+  // Relax only once the queue has drained and nothing was busy for a while
+  if (entry->queue_depth > CONN_PARAMS_QUEUE_LOW)
+    {
+      entry->last_busy_tick = sl_sleeptimer_get_tick_count();
+      return;
+    }
+  if (ms_since(entry->last_busy_tick) >= CONN_PARAMS_RELAX_DELAY_MS)
+    request_profile(entry, CONN_PROFILE_STEADY);
+} // apply_policy()
+
+/**
+ * @brief Starts tracking a new connection and asks for the fast profile, the
+ *        connection starts busy with CONN_BUSY_SETUP.
+ *
+ * @param connection, connection handle
+ *
+ * @return none
+ */
+void connParamsOpened(uint8_t connection)
+{
+  conn_params_entry_t *entry = NULL;
+
+  for (int i = 0; (i < CONN_PARAMS_MAX_CONNECTIONS) && (entry == NULL); i++)
+    {
+      if (!entries[i].in_use)
+        entry = &entries[i];
+    }
+  if (entry == NULL)
+    {
+      LOG_ERROR("connParamsOpened() no free entry for connection %d", (int) connection);
+      return;
+    }
+  memset(entry, 0, sizeof(*entry));
+  entry->in_use     = true;
+  entry->connection = connection;
+  entry->busy       = CONN_BUSY_SETUP;
+  entry->opened_tick    = sl_sleeptimer_get_tick_count();
+  entry->last_busy_tick = entry->opened_tick;
+  entry->since_tick     = entry->opened_tick;
+  apply_policy(entry);
+} // connParamsOpened()
+
+/**
+ * @brief Logs the time spent in each profile and the radio use estimate of a closed
+ *        connection, and stops tracking it.
+ *
+ * @param connection, connection handle
+ *
+ * @return none
+ */
+void connParamsClosed(uint8_t connection)
+{
+  conn_params_entry_t *entry = find_entry(connection);
+
+  if (entry == NULL)
+    return;
+  account_time(entry);
+  LOG_INFO("Conn %d: %u ms fast, %u ms relaxed, %u parameter changes, ~%u connection events, ~%u ms radio on",
+           (int) connection,
+           (unsigned int) ((entry->fast_ticks * 1000) / sl_sleeptimer_get_timer_frequency()),
+           (unsigned int) ((entry->relaxed_ticks * 1000) / sl_sleeptimer_get_timer_frequency()),
+           (unsigned int) entry->changes, (unsigned int) entry->events,
+           (unsigned int) (((uint64_t) entry->events * CONN_PARAMS_EVENT_RADIO_US) / 1000));
+  entry->in_use = false;
+} // connParamsClosed()
+
+/**
+ * @brief Sets or clears a busy reason of a connection and applies the policy.
+ *
+ * @param connection, connection handle
+ * @param reason, CONN_BUSY_SETUP or CONN_BUSY_PAIRING
+ * @param busy, true to set, false to clear
+ *
+ * @return none
+ */
+void connParamsSetBusy(uint8_t connection, uint8_t reason, bool busy)
+{
+  conn_params_entry_t *entry = find_entry(connection);
+
+  if (entry == NULL)
+    return;
+  if (busy)
+    entry->busy |= reason;
+  else
+    entry->busy &= ~reason;
+  apply_policy(entry);
+} // connParamsSetBusy()
+
+/**
+ * @brief Applies the policy with the current indication queue depth, and adds the
+ *        radio on time since the last call to the energy accounting. Call on the
+ *        LETIMER0 UF tick and whenever an indication is queued.
+ *
+ * @param connection, connection handle
+ * @param queue_depth, indications waiting on this connection, 0 on the client
+ *
+ * @return none
+ */
+void connParamsUpdate(uint8_t connection, uint32_t queue_depth)
+{
+  conn_params_entry_t *entry = find_entry(connection);
+
+  if (entry == NULL)
+    return;
+  entry->queue_depth = queue_depth;
+  account_time(entry);
+  apply_policy(entry);
+} // connParamsUpdate()
+
+/**
+ * @brief Records and logs the parameters the link layer actually applied.
+ *
+ * @param params, the sl_bt_evt_connection_parameters_id event data
+ *
+ * @return none
+ */
+void connParamsChanged(const sl_bt_evt_connection_parameters_t *params)
+{
+  conn_params_entry_t *entry = find_entry(params->connection);
+
+  if ((entry == NULL) || ((params->interval == entry->interval) && (params->latency == entry->latency)))
+    return; // also sent when only the security mode changes
+
+  account_time(entry);
+  entry->interval = params->interval;
+  entry->latency  = params->latency;
+  entry->changes++;
+  // interval * 1.25 ms, timeout * 10 ms
+  LOG_INFO("Conn %d: interval %u.%02u ms, latency %u, timeout %u ms", (int) params->connection,
+           (unsigned int) ((params->interval * 125) / 100), (unsigned int) ((params->interval * 125) % 100),
+           (unsigned int) params->latency, (unsigned int) (params->timeout * 10));
+} // connParamsChanged()
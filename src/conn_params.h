@@ -0,0 +1,110 @@
+/*
+ * File name: conn_params.h
+ * File description: This file declares the connection parameter manager APIs. Each connection
+ *                   asks for a short interval while it is busy (discovery and subscription after
+ *                   open, pairing, a backlog in the indication queue) and relaxes to a long
+ *                   interval with peripheral latency during steady 3 s sampling.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 6 (connection parameters)
+ *  [2] Bluetooth Core Specification v5.2, Vol 6, Part B, 4.5.1 Connection events, 4.5.2 Supervision timeout
+ *  [3] Silicon Labs Bluetooth API reference, Connection https://docs.silabs.com/bluetooth/3.2/group-sl-bt-connection
+ */
+#ifndef SRC_CONN_PARAMS_H_
+#define SRC_CONN_PARAMS_H_
+
+#include "app.h"
+
+/*
+ * Parameter profiles. Intervals in 1.25 ms units, timeouts in 10 ms units.
+ * The supervision timeout must be larger than (1 + latency) * max interval * 2.
+ */
+// Busy: 7.5 to 15 ms, no latency, 1 s timeout
+#define CONN_FAST_INTERVAL_MIN     (0x06)
+#define CONN_FAST_INTERVAL_MAX     (0x0c)
+#define CONN_FAST_LATENCY          (0)
+#define CONN_FAST_TIMEOUT          (100)
+// Steady sampling: 400 to 500 ms, the server may skip 4 events, 6 s timeout
+#define CONN_STEADY_INTERVAL_MIN   (0x140)
+#define CONN_STEADY_INTERVAL_MAX   (0x190)
+#define CONN_STEADY_LATENCY        (4)
+#define CONN_STEADY_TIMEOUT        (600)
+
+// Queue depth that forces the fast profile, and the depth it must drain to before relaxing
+#define CONN_PARAMS_QUEUE_HIGH     (2)
+#define CONN_PARAMS_QUEUE_LOW      (0)
+// Time without any busy condition before the connection relaxes
+#define CONN_PARAMS_RELAX_DELAY_MS (6000)
+// The setup after open is considered done after this long, even if the peer never subscribes
+#define CONN_PARAMS_SETUP_MAX_MS   (30000)
+// Estimated radio on time of one connection event, for the radio on estimate in the log
+#define CONN_PARAMS_EVENT_RADIO_US (800)
+
+// Connections tracked at the same time
+#define CONN_PARAMS_MAX_CONNECTIONS (4)
+
+// Reasons a connection needs the fast profile, combined in a bit mask
+#define CONN_BUSY_SETUP            (0x01) // discovery and CCCD writes after open
+#define CONN_BUSY_PAIRING          (0x02) // passkey shown, waiting for the bond
+
+typedef enum
+{
+  CONN_PROFILE_NONE,
+  CONN_PROFILE_FAST,
+  CONN_PROFILE_STEADY,
+} conn_profile_t;
+
+/**
+ * @brief Starts tracking a new connection and asks for the fast profile, the
+ *        connection starts busy with CONN_BUSY_SETUP.
+ *
+ * @param connection, connection handle
+ *
+ * @return none
+ */
+void connParamsOpened(uint8_t connection);
+
+/**
+ * @brief Logs the time spent in each profile and the radio use estimate of a closed
+ *        connection, and stops tracking it.
+ *
+ * @param connection, connection handle
+ *
+ * @return none
+ */
+void connParamsClosed(uint8_t connection);
+
+/**
+ * @brief Sets or clears a busy reason of a connection and applies the policy.
+ *
+ * @param connection, connection handle
+ * @param reason, CONN_BUSY_SETUP or CONN_BUSY_PAIRING
+ * @param busy, true to set, false to clear
+ *
+ * @return none
+ */
+void connParamsSetBusy(uint8_t connection, uint8_t reason, bool busy);
+
+/**
+ * @brief Applies the policy with the current indication queue depth, and adds the
+ *        radio on time since the last call to the energy accounting. Call on the
+ *        LETIMER0 UF tick and whenever an indication is queued.
+ *
+ * @param connection, connection handle
+ * @param queue_depth, indications waiting on this connection, 0 on the client
+ *
+ * @return none
+ */
+void connParamsUpdate(uint8_t connection, uint32_t queue_depth);
+
+/**
+ * @brief Records and logs the parameters the link layer actually applied.
+ *
+ * @param params, the sl_bt_evt_connection_parameters_id event data
+ *
+ * @return none
+ */
+void connParamsChanged(const sl_bt_evt_connection_parameters_t *params);
+
+#endif /* SRC_CONN_PARAMS_H_ */
@@ -0,0 +1,146 @@
+/*
+ * File name: em_token.c
+ * File description: This file defines the EM requirement token APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 3 (energy modes)
+ *  [2] Silicon Labs power manager documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-power-manager
+ */
+
+#include "src/em_token.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+static em_token_t *tokens = NULL;
+static volatile uint32_t sleeps = 0;
+static uint32_t last_report_ms = 0;
+static sl_power_manager_em_transition_event_handle_t em_event_handle;
+
+/*
+ * @brief Power manager callback, counts the sleeps. Runs with interrupts off.
+ * @param from, energy mode being left
+ * @param to, energy mode being entered
+ * @return none
+ */
+static void em_transition(sl_power_manager_em_t from, sl_power_manager_em_t to)
+{
+  (void) from;
+  (void) to;
+  sleeps++;
+} // em_transition()
+
+static const sl_power_manager_em_transition_event_info_t em_event_info =
+{
+  .event_mask = SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM1 | SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM2 |
+                SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM3,
+  .on_event   = em_transition,
+};
+
+/**
+ * @brief Starts counting sleeps for the leak detector. Call from app_init() before any
+ *        token is acquired.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void emTokenInit(void)
+{
+  sl_power_manager_subscribe_em_transition_event(&em_event_handle, &em_event_info);
+} // emTokenInit()
+
+/**
+ * @brief Adds the token's EM requirement. Logged and ignored if the token is already held.
+ *
+ * @param token, the token
+ *
+ * @return none
+ */
+void emTokenAcquire(em_token_t *token)
+{
+  if (!token->registered)
+    {
+      token->registered = true;
+      token->next       = tokens;
+      tokens            = token;
+    }
+  if (token->held)
+    {
+      token->errors++;
+      LOG_ERROR("EM token %s acquired twice, ignored", token->name);
+      return;
+    }
+
+  sl_power_manager_add_em_requirement(token->em);
+  token->held            = true;
+  token->leak_reported   = false;
+  token->acquired_tick   = sl_sleeptimer_get_tick_count();
+  token->acquired_sleeps = sleeps;
+  token->holds++;
+} // emTokenAcquire()
+
+/**
+ * @brief Removes the token's EM requirement. Logged and ignored if the token is not held.
+ *
+ * @param token, the token
+ *
+ * @return none
+ */
+void emTokenRelease(em_token_t *token)
+{
+  if (!token->held)
+    {
+      token->errors++;
+      LOG_ERROR("EM token %s released without being acquired, ignored", token->name);
+      return;
+    }
+
+  sl_power_manager_remove_em_requirement(token->em);
+  token->held        = false;
+  token->held_ticks += sl_sleeptimer_get_tick_count() - token->acquired_tick;
+} // emTokenRelease()
+
+/**
+ * @brief Flags transient tokens held across more than EM_TOKEN_LEAK_SLEEPS sleeps and
+ *        logs every token every EM_TOKEN_REPORT_PERIOD_MS. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void emTokenReportIfDue(void)
+{
+  uint32_t    now    = sl_sleeptimer_get_tick_count();
+  uint32_t    now_ms = letimerMilliseconds();
+  bool        due    = ((now_ms - last_report_ms) >= EM_TOKEN_REPORT_PERIOD_MS);
+  uint32_t    held_sleeps;
+  uint32_t    held_ms;
+  em_token_t *token;
+
+  if (due)
+    last_report_ms = now_ms;
+
+  for (token = tokens; token != NULL; token = token->next)
+    {
+      held_sleeps = token->held ? (sleeps - token->acquired_sleeps) : 0;
+      held_ms     = token->held ? sl_sleeptimer_tick_to_ms(now - token->acquired_tick) : 0;
+
+      if (token->held && !token->long_lived && !token->leak_reported &&
+          (held_sleeps > EM_TOKEN_LEAK_SLEEPS))
+        {
+          token->leak_reported = true;
+          LOG_ERROR("EM token %s leaked? EM%d held across %u sleeps, %u ms", token->name, (int) token->em,
+                    (unsigned int) held_sleeps, (unsigned int) held_ms);
+        }
+
+      if (due)
+        {
+          LOG_INFO("EM token %s: EM%d, %s %u ms/%u sleeps, %u holds, %u ms held in total, %u errors",
+                   token->name, (int) token->em, token->held ? "held" : "free",
+                   (unsigned int) held_ms, (unsigned int) held_sleeps, (unsigned int) token->holds,
+                   (unsigned int) ((token->held_ticks * 1000) / sl_sleeptimer_get_timer_frequency()),
+                   (unsigned int) token->errors);
+        }
+    }
+} // emTokenReportIfDue()
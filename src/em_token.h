@@ -0,0 +1,87 @@
+/*
+ * File name: em_token.h
+ * File description: This file declares the EM requirement token APIs. Each module holds
+ *                   its power manager requirement through a named token instead of calling
+ *                   sl_power_manager_add/remove_em_requirement() directly. A token is held at
+ *                   most once, so a second acquire or a release without an acquire is logged
+ *                   and ignored instead of pinning the chip in a higher energy mode. The
+ *                   tokens, who holds them and for how long, are logged periodically and a
+ *                   token held across more than EM_TOKEN_LEAK_SLEEPS sleeps is flagged.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 3 (energy modes)
+ *  [2] Silicon Labs power manager documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-power-manager
+ */
+#ifndef SRC_EM_TOKEN_H_
+#define SRC_EM_TOKEN_H_
+
+#include "app.h"
+
+// A transient token held across more sleeps than this is reported as a leak
+#define EM_TOKEN_LEAK_SLEEPS        (50)
+// How often the tokens are logged
+#define EM_TOKEN_REPORT_PERIOD_MS   (600000)
+
+typedef struct em_token
+{
+  const char            *name;
+  sl_power_manager_em_t  em;
+  bool                   long_lived;         // held for good on purpose, not a leak
+
+  bool                   registered;         // in the list of tokens
+  bool                   held;
+  bool                   leak_reported;      // once per hold
+  uint32_t               acquired_tick;
+  uint32_t               acquired_sleeps;
+  // Since boot
+  uint32_t               holds;
+  uint32_t               errors;             // double acquires and releases without acquire
+  uint64_t               held_ticks;         // completed holds
+
+  struct em_token       *next;
+} em_token_t;
+
+// Initializers for a token, e.g. static em_token_t token = EM_TOKEN("i2c", SL_POWER_MANAGER_EM1);
+#define EM_TOKEN(token_name, token_em) { .name = (token_name), .em = (token_em), .long_lived = false }
+#define EM_TOKEN_LONG_LIVED(token_name, token_em) { .name = (token_name), .em = (token_em), .long_lived = true }
+
+/**
+ * @brief Starts counting sleeps for the leak detector. Call from app_init() before any
+ *        token is acquired.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void emTokenInit(void);
+
+/**
+ * @brief Adds the token's EM requirement. Logged and ignored if the token is already held.
+ *
+ * @param token, the token
+ *
+ * @return none
+ */
+void emTokenAcquire(em_token_t *token);
+
+/**
+ * @brief Removes the token's EM requirement. Logged and ignored if the token is not held.
+ *
+ * @param token, the token
+ *
+ * @return none
+ */
+void emTokenRelease(em_token_t *token);
+
+/**
+ * @brief Flags transient tokens held across more than EM_TOKEN_LEAK_SLEEPS sleeps and
+ *        logs every token every EM_TOKEN_REPORT_PERIOD_MS. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void emTokenReportIfDue(void);
+
+#endif /* SRC_EM_TOKEN_H_ */
@@ -0,0 +1,301 @@
+/*
+ * File name: energy.c
+ * File description: This file defines the wakeup and energy accounting APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *    [1] ECEN5823 IOT Embedded Firmware lecture slides (energy modes, load power management)
+ *    [2] Silicon Labs AN0048 Energy Optimization https://www.silabs.com/documents/public/application-notes/AN0048.pdf
+ */
+
+#include "src/energy.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+static const char *wakeup_source_names[WAKEUP_SOURCE_COUNT] =
+{
+  "LETIMER0_UF",
+  "LETIMER0_COMP1",
+  "I2C0",
+  "GPIO",
+  "SOFT_TIMER",
+  "SAMPLER",
+  "COALESCE"
+};
+
+static volatile uint32_t wakeup_count[WAKEUP_SOURCE_COUNT];
+static uint32_t last_report_ms = 0;
+
+static const uint32_t em_current_na[ENERGY_EM_COUNT] =
+{
+  ENERGY_EM0_NA, ENERGY_EM1_NA, ENERGY_EM2_NA, ENERGY_EM3_NA
+};
+static const uint32_t load_current_na[ENERGY_LOAD_COUNT] =
+{
+  ENERGY_SI7021_CONVERSION_NA
+};
+
+// Energy mode residency, in sleeptimer ticks, updated on every power manager transition
+static uint64_t em_ticks[ENERGY_EM_COUNT];
+static uint32_t em_current = SL_POWER_MANAGER_EM0;
+static uint32_t em_since;
+static uint32_t em_transitions = 0;
+static uint32_t start_tick;
+static sl_power_manager_em_transition_event_handle_t em_event_handle;
+
+static uint64_t load_ticks[ENERGY_LOAD_COUNT];
+static uint32_t load_since[ENERGY_LOAD_COUNT];
+static bool     load_on[ENERGY_LOAD_COUNT];
+static uint64_t radio_us = 0;
+
+/*
+ * @brief Power manager callback, adds the time spent in the mode being left. Runs with
+ *        interrupts off, on the way into and out of sleep.
+ * @param from, energy mode being left
+ * @param to, energy mode being entered
+ * @return none
+ */
+static void em_transition(sl_power_manager_em_t from, sl_power_manager_em_t to)
+{
+  uint32_t now = sl_sleeptimer_get_tick_count();
+
+  if (from < ENERGY_EM_COUNT)
+    em_ticks[from] += (uint32_t) (now - em_since);
+  em_since   = now;
+  em_current = to;
+  em_transitions++;
+} // em_transition()
+
+static const sl_power_manager_em_transition_event_info_t em_event_info =
+{
+  .event_mask = SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM0 | SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM1 |
+                SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM2 | SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM3,
+  .on_event   = em_transition,
+};
+
+/**
+ * @brief Starts measuring the time spent in each energy mode. Call from app_init().
+ *
+ * @param none
+ *
+ * @return none
+ */
+void energyInit(void)
+{
+  start_tick = sl_sleeptimer_get_tick_count();
+  em_since   = start_tick;
+  sl_power_manager_subscribe_em_transition_event(&em_event_handle, &em_event_info);
+} // energyInit()
+
+/**
+ * @brief Starts counting the on time of a load.
+ *
+ * @param load, the load
+ *
+ * @return none
+ */
+void energyLoadOn(energy_load_t load)
+{
+  if ((load >= ENERGY_LOAD_COUNT) || load_on[load])
+    return;
+  load_on[load]    = true;
+  load_since[load] = sl_sleeptimer_get_tick_count();
+} // energyLoadOn()
+
+/**
+ * @brief Stops counting the on time of a load.
+ *
+ * @param load, the load
+ *
+ * @return none
+ */
+void energyLoadOff(energy_load_t load)
+{
+  if ((load >= ENERGY_LOAD_COUNT) || !load_on[load])
+    return;
+  load_on[load]     = false;
+  load_ticks[load] += (uint32_t) (sl_sleeptimer_get_tick_count() - load_since[load]);
+} // energyLoadOff()
+
+/**
+ * @brief Adds estimated radio on time, at LINK_RADIO_CURRENT_UA.
+ *
+ * @param us, radio on time in microseconds
+ *
+ * @return none
+ */
+void energyAddRadioUs(uint32_t us)
+{
+  radio_us += us;
+} // energyAddRadioUs()
+
+/*
+ * @brief Integrates the current model since boot
+ * @param elapsed_ms, returns the time integrated over
+ * @return charge in nA * ms
+ */
+static uint64_t charge_na_ms(uint64_t *elapsed_ms)
+{
+  uint32_t hz  = sl_sleeptimer_get_timer_frequency();
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  uint64_t ticks[ENERGY_EM_COUNT];
+  uint64_t charge = 0;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  memcpy(ticks, em_ticks, sizeof(ticks));
+  if (em_current < ENERGY_EM_COUNT)
+    ticks[em_current] += (uint32_t) (now - em_since); // the mode we are in, EM0
+  CORE_EXIT_CRITICAL();
+
+  *elapsed_ms = ((uint64_t) (uint32_t) (now - start_tick) * 1000) / hz;
+  for (int i = 0; i < ENERGY_EM_COUNT; i++)
+    charge += ((ticks[i] * 1000) / hz) * em_current_na[i];
+  for (int i = 0; i < ENERGY_LOAD_COUNT; i++)
+    charge += ((load_ticks[i] * 1000) / hz) * load_current_na[i];
+  charge += (radio_us / 1000) * ((uint64_t) LINK_RADIO_CURRENT_UA * 1000);
+  charge += *elapsed_ms * ENERGY_LCD_NA;
+  return charge;
+} // charge_na_ms()
+
+/**
+ * @brief Returns the average supply current since boot from the current model.
+ *
+ * @param none
+ *
+ * @return average current in nA
+ */
+uint32_t energyAverageNa(void)
+{
+  uint64_t elapsed_ms;
+  uint64_t charge = charge_na_ms(&elapsed_ms);
+
+  return (elapsed_ms == 0) ? 0 : (uint32_t) (charge / elapsed_ms);
+} // energyAverageNa()
+
+/**
+ * @brief Returns the energy per hour at the average current of energyAverageNa(), from
+ *        the LINK_SUPPLY_MV supply.
+ *
+ * @param none
+ *
+ * @return energy in mJ per hour
+ */
+uint32_t energyMilliJoulesPerHour(void)
+{
+  // mJ per hour = nA * mV * 3600 s / 10^9
+  return (uint32_t) (((uint64_t) energyAverageNa() * LINK_SUPPLY_MV * 3600) / 1000000000);
+} // energyMilliJoulesPerHour()
+
+/**
+ * @brief Counts one wakeup of the MCU caused by the given source. Safe to call from an ISR.
+ *
+ * @param source, the peripheral or stack timer that woke us up
+ *
+ * @return none
+ */
+void energyCountWakeup(wakeup_source_t source)
+{
+  if (source >= WAKEUP_SOURCE_COUNT)
+    return;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  wakeup_count[source]++;
+  CORE_EXIT_CRITICAL();
+} // energyCountWakeup()
+
+/**
+ * @brief Returns the number of wakeups counted for a source since boot.
+ *
+ * @param source, the wakeup source
+ *
+ * @return wakeup count
+ */
+uint32_t energyGetWakeups(wakeup_source_t source)
+{
+  if (source >= WAKEUP_SOURCE_COUNT)
+    return 0;
+  return wakeup_count[source];
+} // energyGetWakeups()
+
+/**
+ * @brief Extrapolates the wakeups counted for a source to a per hour rate.
+ *
+ * @param source, the wakeup source
+ *
+ * @return wakeups per hour, 0 before the first second of run time
+ */
+uint32_t energyWakeupsPerHour(wakeup_source_t source)
+{
+  uint32_t elapsed_ms = letimerMilliseconds();
+
+  if (elapsed_ms < 1000)
+    return 0;
+  // 64 bit intermediate, count * 3600000 overflows 32 bits after ~1200 wakeups
+  return (uint32_t)(((uint64_t) energyGetWakeups(source) * MS_PER_HOUR) / elapsed_ms);
+} // energyWakeupsPerHour()
+
+/**
+ * @brief Returns how many EXTCOMIN related wakeups per hour are removed by toggling
+ *        EXTCOMIN from LETIMER0 OUT0, or on wakeups that are already happening, instead
+ *        of from software timers.
+ *
+ * @param none
+ *
+ * @return wakeups removed per hour, 0 when EXTCOMIN runs on the software timers
+ */
+uint32_t energyExtcominWakeupsRemovedPerHour(void)
+{
+#if LCD_EXTCOMIN_HW_TOGGLE
+  uint32_t measured = energyWakeupsPerHour(WAKEUP_SOFT_TIMER);
+#elif COALESCE_LCD_EXTCOMIN
+  // Every coalescer deadline is taken as an EXTCOMIN toggle, the saving is a lower bound
+  uint32_t measured = energyWakeupsPerHour(WAKEUP_SOFT_TIMER) + energyWakeupsPerHour(WAKEUP_COALESCE);
+#endif
+#if LCD_EXTCOMIN_HW_TOGGLE || COALESCE_LCD_EXTCOMIN
+
+  // Anything still waking us on the soft timer is not a saving
+  if (measured >= EXTCOMIN_SW_WAKEUPS_PER_HOUR)
+    return 0;
+  return (EXTCOMIN_SW_WAKEUPS_PER_HOUR - measured);
+#else
+  return 0;
+#endif
+} // energyExtcominWakeupsRemovedPerHour()
+
+/**
+ * @brief Logs the wakeup accounting if ENERGY_REPORT_PERIOD_MS has elapsed since the last report.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void energyReportIfDue(void)
+{
+  uint32_t now_ms = letimerMilliseconds();
+
+  if ((now_ms - last_report_ms) < ENERGY_REPORT_PERIOD_MS)
+    return;
+  last_report_ms = now_ms;
+
+  for (int i = 0; i < WAKEUP_SOURCE_COUNT; i++)
+    {
+      LOG_INFO("Wakeups %s: %u total, %u/hr", wakeup_source_names[i],
+               (unsigned int) energyGetWakeups(i),
+               (unsigned int) energyWakeupsPerHour(i));
+    }
+  LOG_INFO("EXTCOMIN wakeups removed: %u/hr", (unsigned int) energyExtcominWakeupsRemovedPerHour());
+  {
+    uint32_t hz      = sl_sleeptimer_get_timer_frequency();
+    uint32_t avg_na  = energyAverageNa();
+
+    LOG_INFO("EM0 %u ms, EM1 %u ms, EM2 %u ms, EM3 %u ms, %u transitions, Si7021 %u ms, radio ~%u ms",
+             (unsigned int) ((em_ticks[0] * 1000) / hz), (unsigned int) ((em_ticks[1] * 1000) / hz),
+             (unsigned int) ((em_ticks[2] * 1000) / hz), (unsigned int) ((em_ticks[3] * 1000) / hz),
+             (unsigned int) em_transitions, (unsigned int) ((load_ticks[ENERGY_LOAD_SI7021] * 1000) / hz),
+             (unsigned int) (radio_us / 1000));
+    LOG_INFO("Model: average %u uA, %u mJ/hr", (unsigned int) (avg_na / 1000),
+             (unsigned int) energyMilliJoulesPerHour());
+  }
+} // energyReportIfDue()
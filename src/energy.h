@@ -0,0 +1,167 @@
+/*
+ * File name: energy.h
+ * File description: This file declares the wakeup and energy accounting APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *    [1] ECEN5823 IOT Embedded Firmware lecture slides (energy modes, load power management)
+ *    [2] Silicon Labs AN0048 Energy Optimization https://www.silabs.com/documents/public/application-notes/AN0048.pdf
+ *    [3] EFR32BG13 Blue Gecko SoC datasheet, Si7021-A20 datasheet, LS013B7DH03 datasheet
+ */
+
+#ifndef SRC_ENERGY_H_
+#define SRC_ENERGY_H_
+
+#include "app.h"
+
+// Sources that wake the MCU up out of EM2/EM3 and that we account for
+typedef enum
+{
+  WAKEUP_LETIMER0_UF,
+  WAKEUP_LETIMER0_COMP1,
+  WAKEUP_I2C0,
+  WAKEUP_GPIO,
+  WAKEUP_SOFT_TIMER,
+  WAKEUP_SAMPLER,           // src/sampler.c sleeptimer, in place of LETIMER0_UF
+  WAKEUP_COALESCE,          // src/coalesce.c deadline, nothing else woke the MCU in time
+  WAKEUP_SOURCE_COUNT
+} wakeup_source_t;
+
+// How often energyReportIfDue() prints the accounting to the VCOM port
+#define ENERGY_REPORT_PERIOD_MS (600000)
+
+#define MS_PER_HOUR (3600000UL)
+
+/*
+ * EXTCOMIN is toggled in software by the BT stack soft timer in displayInit() (1 s) and
+ * by the sl_memlcd driver's own sleeptimer at 2 x SL_MEMLCD_EXTCOMIN_FREQUENCY (60 Hz,
+ * ls013b7dh03/sl_memlcd_display.h). These are the wakeups LCD_EXTCOMIN_HW_TOGGLE removes.
+ */
+#define EXTCOMIN_SOFT_TIMER_PERIOD_MS  (1000)
+#define EXTCOMIN_MEMLCD_TOGGLES_PER_S  (2 * 60)
+#define EXTCOMIN_SW_WAKEUPS_PER_HOUR   ((MS_PER_HOUR / EXTCOMIN_SOFT_TIMER_PERIOD_MS) + \
+                                        (EXTCOMIN_MEMLCD_TOGGLES_PER_S * 3600UL))
+
+/*
+ * Current model, nA, EFR32BG13 datasheet at 38.4 MHz from flash, Si7021 and LS013B7DH03
+ * datasheets. Time in each energy mode is measured from the power manager transitions,
+ * switched loads from energyLoadOn()/Off(), radio time is estimated by src/conn_params.c.
+ */
+#define ENERGY_EM0_NA               (3340000)   // 87 uA/MHz
+#define ENERGY_EM1_NA               (1340000)   // 35 uA/MHz
+#define ENERGY_EM2_NA               (1400)      // full RAM retention, RTCC on LFXO
+#define ENERGY_EM3_NA               (1050)      // full RAM retention, ULFRCO
+#define ENERGY_SI7021_CONVERSION_NA (90000)     // temperature conversion
+#define ENERGY_LCD_NA               (4000)      // memory LCD static image, always on
+#define ENERGY_EM_COUNT             (4)         // EM0 to EM3
+
+// Loads switched on and off by the application
+typedef enum
+{
+  ENERGY_LOAD_SI7021,     // measurement command sent until the result is read
+  ENERGY_LOAD_COUNT
+} energy_load_t;
+
+/**
+ * @brief Starts measuring the time spent in each energy mode. Call from app_init().
+ *
+ * @param none
+ *
+ * @return none
+ */
+void energyInit(void);
+
+/**
+ * @brief Starts counting the on time of a load.
+ *
+ * @param load, the load
+ *
+ * @return none
+ */
+void energyLoadOn(energy_load_t load);
+
+/**
+ * @brief Stops counting the on time of a load.
+ *
+ * @param load, the load
+ *
+ * @return none
+ */
+void energyLoadOff(energy_load_t load);
+
+/**
+ * @brief Adds estimated radio on time, at LINK_RADIO_CURRENT_UA.
+ *
+ * @param us, radio on time in microseconds
+ *
+ * @return none
+ */
+void energyAddRadioUs(uint32_t us);
+
+/**
+ * @brief Returns the average supply current since boot from the current model.
+ *
+ * @param none
+ *
+ * @return average current in nA
+ */
+uint32_t energyAverageNa(void);
+
+/**
+ * @brief Returns the energy per hour at the average current of energyAverageNa(), from
+ *        the LINK_SUPPLY_MV supply.
+ *
+ * @param none
+ *
+ * @return energy in mJ per hour
+ */
+uint32_t energyMilliJoulesPerHour(void);
+
+/**
+ * @brief Counts one wakeup of the MCU caused by the given source. Safe to call from an ISR.
+ *
+ * @param source, the peripheral or stack timer that woke us up
+ *
+ * @return none
+ */
+void energyCountWakeup(wakeup_source_t source);
+
+/**
+ * @brief Returns the number of wakeups counted for a source since boot.
+ *
+ * @param source, the wakeup source
+ *
+ * @return wakeup count
+ */
+uint32_t energyGetWakeups(wakeup_source_t source);
+
+/**
+ * @brief Extrapolates the wakeups counted for a source to a per hour rate.
+ *
+ * @param source, the wakeup source
+ *
+ * @return wakeups per hour, 0 before the first second of run time
+ */
+uint32_t energyWakeupsPerHour(wakeup_source_t source);
+
+/**
+ * @brief Returns how many EXTCOMIN related wakeups per hour are removed by toggling
+ *        EXTCOMIN from LETIMER0 OUT0, or on wakeups that are already happening, instead
+ *        of from software timers.
+ *
+ * @param none
+ *
+ * @return wakeups removed per hour, 0 when EXTCOMIN runs on the software timers
+ */
+uint32_t energyExtcominWakeupsRemovedPerHour(void);
+
+/**
+ * @brief Logs the wakeup accounting if ENERGY_REPORT_PERIOD_MS has elapsed since the last report.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void energyReportIfDue(void);
+
+#endif /* SRC_ENERGY_H_ */
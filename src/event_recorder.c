@@ -0,0 +1,200 @@
+/*
+ * File name: event_recorder.c
+ * File description: This file defines the event recorder APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 5 (BT stack events)
+ *  [2] Silicon Labs sleeptimer documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-sleeptimer
+ */
+
+#include "src/event_recorder.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+#if EVENT_RECORDER_ENABLE
+
+#define RING_MASK (EVENT_RECORDER_BYTES - 1)
+
+static uint8_t  ring[EVENT_RECORDER_BYTES];
+static uint32_t rptr = 0;             // oldest record
+static uint32_t used = 0;             // bytes in the ring
+static uint32_t records = 0;          // records in the ring
+static uint32_t oldest_tick;          // tick of the oldest record
+static uint32_t last_tick;            // tick of the newest record
+
+// Since boot
+static uint32_t recorded = 0;
+static uint32_t dropped = 0;
+static uint32_t skipped = 0;
+
+/*
+ * @brief Reads the delta of the record at a ring position
+ * @param pos, ring position of the record
+ * @param delta, returns the delta
+ * @return bytes the delta takes
+ */
+static uint32_t read_delta(uint32_t pos, uint32_t *delta)
+{
+  uint32_t n = 0;
+  uint8_t  byte;
+
+  *delta = 0;
+  do
+    {
+      byte    = ring[(pos + n) & RING_MASK];
+      *delta |= (uint32_t) (byte & 0x7f) << (7 * n);
+      n++;
+    }
+  while (byte & 0x80);
+  return n;
+} // read_delta()
+
+/*
+ * @brief Returns the size of the record at a ring position
+ * @param pos, ring position of the record
+ * @return record size in bytes
+ */
+static uint32_t record_size(uint32_t pos)
+{
+  uint32_t delta;
+  uint32_t n = read_delta(pos, &delta);
+
+  return n + 3 + ring[(pos + n + 2) & RING_MASK];
+} // record_size()
+
+/*
+ * @brief Drops the oldest record
+ * @param none
+ * @return none
+ */
+static void drop_oldest(void)
+{
+  uint32_t size = record_size(rptr);
+  uint32_t delta;
+
+  rptr  = (rptr + size) & RING_MASK;
+  used -= size;
+  records--;
+  dropped++;
+  if (records > 0)
+    {
+      read_delta(rptr, &delta);
+      oldest_tick += delta;
+    }
+} // drop_oldest()
+
+/*
+ * @brief Appends one byte to the ring, room must have been made
+ * @param byte, the byte
+ * @return none
+ */
+static void put(uint8_t byte)
+{
+  ring[(rptr + used) & RING_MASK] = byte;
+  used++;
+} // put()
+
+/**
+ * @brief Records a BT stack event. Subscribe to every event (BLE_DISPATCH_ANY) ahead of
+ *        the other handlers. Dumps the ring on EVENT_RECORDER_DUMP_SIGNAL.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void eventRecorderRecord(sl_bt_msg_t *evt)
+{
+  uint32_t       id   = SL_BT_MSG_ID(evt->header);
+  uint32_t       now  = sl_sleeptimer_get_tick_count();
+  uint32_t       len  = SL_BT_MSG_LEN(evt->header);
+  const uint8_t *data = (const uint8_t *) &evt->data;
+  uint32_t       delta;
+  uint32_t       delta_bytes;
+  uint32_t       rest;
+
+#if EVENT_RECORDER_SKIP_SCAN
+  if (id == sl_bt_evt_scanner_scan_report_id)
+    {
+      skipped++;
+      return;
+    }
+#endif
+
+  if (len > EVENT_RECORDER_MAX_PAYLOAD)
+    len = EVENT_RECORDER_MAX_PAYLOAD;
+  delta = (records > 0) ? (now - last_tick) : 0;
+  for (delta_bytes = 1, rest = delta >> 7; rest != 0; rest >>= 7)
+    delta_bytes++;
+
+  while ((used + delta_bytes + 3 + len) > EVENT_RECORDER_BYTES)
+    drop_oldest();
+  if (records == 0)
+    oldest_tick = now;
+
+  do
+    {
+      put((uint8_t) ((delta & 0x7f) | ((delta > 0x7f) ? 0x80 : 0)));
+      delta >>= 7;
+    }
+  while (delta != 0);
+  put((uint8_t) (id >> 16));
+  put((uint8_t) (id >> 24));
+  put((uint8_t) len);
+  for (uint32_t i = 0; i < len; i++)
+    put(data[i]);
+
+  last_tick = now;
+  records++;
+  recorded++;
+
+  if ((id == sl_bt_evt_system_external_signal_id) &&
+      (evt->data.evt_system_external_signal.extsignals & EVENT_RECORDER_DUMP_SIGNAL))
+    eventRecorderDump();
+} // eventRecorderRecord()
+
+/**
+ * @brief Logs the ring, oldest record first, in the format above.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void eventRecorderDump(void)
+{
+  static const char hex[] = "0123456789abcdef";
+  char              line[2 * EVENT_RECORDER_MAX_PAYLOAD + 1];
+  uint32_t          pos = rptr;
+  uint32_t          delta;
+  uint32_t          n;
+  uint8_t           len;
+
+  LOG_INFO("rec start tick=%u hz=%u records=%u bytes=%u recorded=%u dropped=%u scan skipped=%u",
+           (unsigned int) oldest_tick, (unsigned int) sl_sleeptimer_get_timer_frequency(),
+           (unsigned int) records, (unsigned int) used, (unsigned int) recorded,
+           (unsigned int) dropped, (unsigned int) skipped);
+
+  for (uint32_t r = 0; r < records; r++)
+    {
+      n   = read_delta(pos, &delta);
+      len = ring[(pos + n + 2) & RING_MASK];
+      for (uint32_t i = 0; i < len; i++)
+        {
+          uint8_t byte = ring[(pos + n + 3 + i) & RING_MASK];
+
+          line[2 * i]     = hex[byte >> 4];
+          line[2 * i + 1] = hex[byte & 0x0f];
+        }
+      line[2 * len] = '\0';
+      LOG_INFO("rec +%u %02x%02x %s", (unsigned int) ((r == 0) ? 0 : delta),
+               ring[(pos + n) & RING_MASK], ring[(pos + n + 1) & RING_MASK], line);
+      pos = (pos + n + 3 + len) & RING_MASK;
+    }
+} // eventRecorderDump()
+
+#else
+
+void eventRecorderRecord(sl_bt_msg_t *evt) { (void) evt; }
+void eventRecorderDump(void) {}
+
+#endif // EVENT_RECORDER_ENABLE
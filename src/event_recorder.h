@@ -0,0 +1,60 @@
+/*
+ * File name: event_recorder.h
+ * File description: This file declares the event recorder APIs. Every BT stack event,
+ *                   sl_bt_external_signal() values (button, timer, I2C) included, is kept
+ *                   with its timestamp and payload in a compact binary RAM ring, so a trace of
+ *                   real traffic can be dumped and replayed against the handlers off target.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 5 (BT stack events)
+ *  [2] Silicon Labs sleeptimer documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-sleeptimer
+ */
+#ifndef SRC_EVENT_RECORDER_H_
+#define SRC_EVENT_RECORDER_H_
+
+#include "app.h"
+
+// Set to 0 to compile the recorder out, all APIs become empty
+#define EVENT_RECORDER_ENABLE         1
+// RAM ring size, a power of 2. The oldest records are dropped to make room.
+#define EVENT_RECORDER_BYTES          (2048)
+// Event payload bytes kept per record, the rest is cut off
+#define EVENT_RECORDER_MAX_PAYLOAD    (32)
+// Client scan reports arrive several times a second and would flush the ring, only count them
+#define EVENT_RECORDER_SKIP_SCAN      1
+// External signal that dumps the ring to the VCOM port
+#define EVENT_RECORDER_DUMP_SIGNAL    (evtPB1_long_press)
+
+/*
+ * Record format, records follow each other in the ring:
+ *   delta   1-5 bytes, sleeptimer ticks since the previous record, 7 bits per byte,
+ *           least significant first, bit 7 set on all but the last byte
+ *   class   1 byte, SL_BT_MSG_ID() bits 16-23
+ *   id      1 byte, SL_BT_MSG_ID() bits 24-31
+ *   len     1 byte, payload bytes that follow
+ *   payload len bytes of evt->data
+ * The dump prints the tick of the oldest record, then one line per record:
+ *   "rec +<delta> <class><id> <payload hex>"
+ */
+
+/**
+ * @brief Records a BT stack event. Subscribe to every event (BLE_DISPATCH_ANY) ahead of
+ *        the other handlers. Dumps the ring on EVENT_RECORDER_DUMP_SIGNAL.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void eventRecorderRecord(sl_bt_msg_t *evt);
+
+/**
+ * @brief Logs the ring, oldest record first, in the format above.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void eventRecorderDump(void);
+
+#endif /* SRC_EVENT_RECORDER_H_ */
@@ -0,0 +1,273 @@
+/*
+ * File name: gatt_batch.c
+ * File description: This file defines the client GATT read batching APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides weeks 8-9 (GATT procedures)
+ *  [2] Bluetooth Core Specification v5.2, Vol 3, Part F, 3.4.4.7 Read Multiple Request, 3.4.4.8 Read Multiple Response
+ *  [3] Silicon Labs Bluetooth API reference, GATT client https://docs.silabs.com/bluetooth/3.2/group-sl-bt-gatt
+ */
+
+#include "src/gatt_batch.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+typedef struct
+{
+  uint16_t              characteristic;
+  uint8_t               len;
+  gatt_batch_callback_t callback;
+} gatt_batch_read_t;
+
+typedef struct
+{
+  bool              in_use;
+  uint8_t           connection;
+  bool              submitted;       // procedures running, no more reads can be added
+  gatt_batch_read_t reads[GATT_BATCH_MAX_READS];
+  uint8_t           count;
+  uint8_t           next;            // first read of the procedure in flight
+  uint8_t           in_flight;       // reads in the procedure in flight
+  uint8_t           parsed;          // of those, the values received in full
+  uint8_t           procedures;      // procedures started for this batch
+  uint32_t          submitted_tick;  // sl_sleeptimer ticks
+} gatt_batch_entry_t;
+
+static gatt_batch_entry_t batches[GATT_BATCH_MAX_CONNECTIONS];
+
+// Since boot, for the round trips saved
+static uint32_t total_reads      = 0;
+static uint32_t total_procedures = 0;
+
+/*
+ * @brief Finds the batch of a connection
+ * @param connection, connection handle
+ * @return pointer to the entry, NULL if the connection has no batch
+ */
+static gatt_batch_entry_t *find_batch(uint8_t connection)
+{
+  for (int i = 0; i < GATT_BATCH_MAX_CONNECTIONS; i++)
+    {
+      if (batches[i].in_use && (batches[i].connection == connection))
+        return &batches[i];
+    }
+  return NULL;
+} // find_batch()
+
+/*
+ * @brief Starts one procedure for as many of the remaining reads as fit in one ATT response
+ * @param batch, the batch
+ * @return status of the GATT read command
+ */
+static sl_status_t start_procedure(gatt_batch_entry_t *batch)
+{
+  // Read Multiple Response carries at most ATT_MTU - 1 bytes of values
+  uint16_t    room = linkMaxAttPayload(batch->connection) + 2;
+  uint16_t    used = 0;
+  uint8_t     handles[GATT_BATCH_MAX_READS * 2];
+  uint8_t     n = 0;
+  sl_status_t sc;
+
+  while (((batch->next + n) < batch->count) && (GATT_BATCH_ENABLE || (n == 0)))
+    {
+      const gatt_batch_read_t *read = &batch->reads[batch->next + n];
+
+      if ((n > 0) && ((used + read->len) > room))
+        break;
+      handles[2 * n]     = (uint8_t) read->characteristic;
+      handles[2 * n + 1] = (uint8_t) (read->characteristic >> 8);
+      used += read->len;
+      n++;
+    }
+
+  // A Silicon Labs server answers a Read Multiple of one handle with Invalid PDU
+  if (n == 1)
+    {
+      sc = sl_bt_gatt_read_characteristic_value(batch->connection, batch->reads[batch->next].characteristic);
+      if (sc != SL_STATUS_OK)
+        {
+          LOG_ERROR("sl_bt_gatt_read_characteristic_value() returned != 0 status=0x%04x", (unsigned int) sc);
+          return sc;
+        }
+    }
+  else
+    {
+      sc = sl_bt_gatt_read_multiple_characteristic_values(batch->connection, 2 * n, handles);
+      if (sc != SL_STATUS_OK)
+        {
+          LOG_ERROR("sl_bt_gatt_read_multiple_characteristic_values() returned != 0 status=0x%04x", (unsigned int) sc);
+          return sc;
+        }
+    }
+  batch->in_flight = n;
+  batch->parsed    = 0;
+  batch->procedures++;
+  return SL_STATUS_OK;
+} // start_procedure()
+
+/**
+ * @brief Queues a characteristic read on a connection. Read Multiple responses are plain
+ *        concatenations, so every value must have a known fixed length.
+ *
+ * @param connection, connection handle
+ * @param characteristic, characteristic handle, 0 is ignored (not discovered)
+ * @param len, value length in bytes
+ * @param callback, called with the value when it arrives
+ *
+ * @return true if queued, false if the connection's batch is full or already submitted
+ */
+bool gattBatchAdd(uint8_t connection, uint16_t characteristic, uint8_t len, gatt_batch_callback_t callback)
+{
+  gatt_batch_entry_t *batch = find_batch(connection);
+
+  if (characteristic == 0)
+    return false;
+
+  for (int i = 0; (i < GATT_BATCH_MAX_CONNECTIONS) && (batch == NULL); i++)
+    {
+      if (!batches[i].in_use)
+        {
+          batch = &batches[i];
+          memset(batch, 0, sizeof(*batch));
+          batch->in_use     = true;
+          batch->connection = connection;
+        }
+    }
+  if ((batch == NULL) || batch->submitted || (batch->count == GATT_BATCH_MAX_READS))
+    return false;
+
+  batch->reads[batch->count].characteristic = characteristic;
+  batch->reads[batch->count].len            = len;
+  batch->reads[batch->count].callback       = callback;
+  batch->count++;
+  return true;
+} // gattBatchAdd()
+
+/**
+ * @brief Starts reading the queued characteristics of a connection. The procedures that
+ *        follow are started from gattBatchCompleted().
+ *
+ * @param connection, connection handle
+ *
+ * @return status of the first GATT read command, SL_STATUS_EMPTY if nothing is queued
+ */
+sl_status_t gattBatchSubmit(uint8_t connection)
+{
+  gatt_batch_entry_t *batch = find_batch(connection);
+  sl_status_t         sc;
+
+  if ((batch == NULL) || (batch->count == 0))
+    return SL_STATUS_EMPTY;
+  if (batch->submitted)
+    return SL_STATUS_IN_PROGRESS;
+
+  batch->submitted      = true;
+  batch->submitted_tick = sl_sleeptimer_get_tick_count();
+  sc = start_procedure(batch);
+  if (sc != SL_STATUS_OK)
+    batch->in_use = false; // e.g. another GATT procedure still running, queue again later
+  return sc;
+} // gattBatchSubmit()
+
+/**
+ * @brief Dispatches a read response or read multiple response to the callbacks.
+ *        Call from sl_bt_evt_gatt_characteristic_value_id.
+ *
+ * @param value, the event data
+ *
+ * @return true if the response belonged to a batch
+ */
+bool gattBatchValue(const sl_bt_evt_gatt_characteristic_value_t *value)
+{
+  gatt_batch_entry_t *batch = find_batch(value->connection);
+  uint16_t            offset = 0;
+  uint8_t             i;
+
+  if ((batch == NULL) || !batch->submitted || (batch->in_flight == 0))
+    return false;
+
+  if (value->att_opcode == sl_bt_gatt_read_response)
+    {
+      if ((batch->in_flight != 1) || (value->characteristic != batch->reads[batch->next].characteristic))
+        return false;
+    }
+  else if (value->att_opcode != sl_bt_gatt_read_multiple_response)
+    return false;
+
+  // Values come back concatenated in the order they were asked for, a response cut at
+  // ATT_MTU - 1 only delivers the values it holds in full, the others are asked again
+  for (i = 0; i < batch->in_flight; i++)
+    {
+      const gatt_batch_read_t *read = &batch->reads[batch->next + i];
+
+      if ((offset + read->len) > value->value.len)
+        break;
+      if (read->callback)
+        read->callback(batch->connection, read->characteristic, &value->value.data[offset], read->len);
+      offset += read->len;
+    }
+  batch->parsed = i;
+  return true;
+} // gattBatchValue()
+
+/**
+ * @brief Starts the next procedure of a batch, or logs the finished batch.
+ *        Call from sl_bt_evt_gatt_procedure_completed_id.
+ *
+ * @param completed, the event data
+ *
+ * @return true if the procedure belonged to a batch
+ */
+bool gattBatchCompleted(const sl_bt_evt_gatt_procedure_completed_t *completed)
+{
+  gatt_batch_entry_t *batch = find_batch(completed->connection);
+
+  if ((batch == NULL) || !batch->submitted || (batch->in_flight == 0))
+    return false;
+
+  if (completed->result != 0)
+    {
+      // e.g. 0x110F, a read needs encryption, the caller pairs and the batch can be asked again
+      LOG_INFO("Batch read on connection %d failed, result=0x%04x", (int) batch->connection,
+               (unsigned int) completed->result);
+      batch->in_use = false;
+      return true;
+    }
+
+  // Only past the values received, a response cut short leaves the rest for the next procedure
+  if (batch->parsed == 0)
+    {
+      LOG_ERROR("Batch read of handle %u on connection %d returned no value, skipped",
+                (unsigned int) batch->reads[batch->next].characteristic, (int) batch->connection);
+      batch->parsed = 1;
+    }
+  batch->next     += batch->parsed;
+  batch->in_flight = 0;
+  if ((batch->next < batch->count) && (start_procedure(batch) == SL_STATUS_OK))
+    return true;
+
+  total_reads      += batch->next;
+  total_procedures += batch->procedures;
+  LOG_INFO("Batch read on connection %d: %u reads in %u procedures, %u ms, %u round trips saved since boot",
+           (int) batch->connection, (unsigned int) batch->next, (unsigned int) batch->procedures,
+           (unsigned int) sl_sleeptimer_tick_to_ms(sl_sleeptimer_get_tick_count() - batch->submitted_tick),
+           (unsigned int) (total_reads - total_procedures));
+  batch->in_use = false;
+  return true;
+} // gattBatchCompleted()
+
+/**
+ * @brief Drops the batch of a closed connection.
+ *
+ * @param connection, connection handle
+ *
+ * @return none
+ */
+void gattBatchClosed(uint8_t connection)
+{
+  gatt_batch_entry_t *batch = find_batch(connection);
+
+  if (batch)
+    batch->in_use = false;
+} // gattBatchClosed()
@@ -0,0 +1,128 @@
+/*
+ * File name: gatt_cache.c
+ * File description: This file defines the client GATT handle cache APIs, the records live in
+ *                   the Bluetooth stack persistent store (sl_bt_nvm_*).
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides weeks 8-9
+ *  [2] Bluetooth Core Specification v5.2, Vol 3, Part G, 2.5.2 Attribute Caching (Database Hash)
+ *  [3] Silicon Labs Bluetooth API reference, NVM class https://docs.silabs.com/bluetooth/3.2/group-sl-bt-nvm
+ */
+
+#include "src/gatt_cache.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+static uint8_t next_victim = 0; // slot reused when all of them hold other servers
+
+/*
+ * @brief Reads one cache slot from NVM
+ * @param slot, slot index
+ * @param entry, returns the record
+ * @return true if the slot holds a valid record
+ */
+static bool load_slot(uint8_t slot, gatt_cache_entry_t *entry)
+{
+  size_t      len = 0;
+  sl_status_t sc;
+
+  sc = sl_bt_nvm_load(GATT_CACHE_NVM_KEY + slot, sizeof(*entry), &len, (uint8_t *) entry);
+  // An empty slot fails the load, that is the normal case and is not logged
+  if (sc != SL_STATUS_OK)
+    return false;
+  return (len == sizeof(*entry)) && (entry->version == GATT_CACHE_VERSION);
+} // load_slot()
+
+/*
+ * @brief Finds the slot holding a server's record
+ * @param server, address of the server
+ * @param entry, returns the record, may be NULL
+ * @return slot index, GATT_CACHE_SLOTS if not found
+ */
+static uint8_t find_slot(const bd_addr *server, gatt_cache_entry_t *entry)
+{
+  gatt_cache_entry_t record;
+
+  for (uint8_t slot = 0; slot < GATT_CACHE_SLOTS; slot++)
+    {
+      if (load_slot(slot, &record) && (memcmp(record.server.addr, server->addr, sizeof(server->addr)) == 0))
+        {
+          if (entry)
+            *entry = record;
+          return slot;
+        }
+    }
+  return GATT_CACHE_SLOTS;
+} // find_slot()
+
+/**
+ * @brief Looks up the cached handles of a server.
+ *
+ * @param server, address of the server
+ * @param entry, returns the cached record
+ *
+ * @return true if a record for this server was found
+ */
+bool gattCacheLoad(const bd_addr *server, gatt_cache_entry_t *entry)
+{
+  return (find_slot(server, entry) < GATT_CACHE_SLOTS);
+} // gattCacheLoad()
+
+/**
+ * @brief Stores the handles of a server, replacing its old record. When every slot
+ *        is taken by other servers the slots are reused round robin.
+ *
+ * @param entry, the record to store, entry->server selects the slot
+ *
+ * @return none
+ */
+void gattCacheSave(const gatt_cache_entry_t *entry)
+{
+  gatt_cache_entry_t record;
+  uint8_t            slot = find_slot(&entry->server, NULL);
+  sl_status_t        sc;
+
+  if (slot == GATT_CACHE_SLOTS)
+    {
+      for (slot = 0; slot < GATT_CACHE_SLOTS; slot++)
+        {
+          if (!load_slot(slot, &record))
+            break; // free slot
+        }
+      if (slot == GATT_CACHE_SLOTS)
+        {
+          slot        = next_victim;
+          next_victim = (next_victim + 1) % GATT_CACHE_SLOTS;
+        }
+    }
+
+  record         = *entry;
+  record.version = GATT_CACHE_VERSION;
+  sc = sl_bt_nvm_save(GATT_CACHE_NVM_KEY + slot, sizeof(record), (const uint8_t *) &record);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_nvm_save() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+} // gattCacheSave()
+
+/**
+ * @brief Drops the cached record of a server, e.g. after its database hash changed.
+ *
+ * @param server, address of the server
+ *
+ * @return none
+ */
+void gattCacheErase(const bd_addr *server)
+{
+  uint8_t     slot = find_slot(server, NULL);
+  sl_status_t sc;
+
+  if (slot == GATT_CACHE_SLOTS)
+    return;
+  sc = sl_bt_nvm_erase(GATT_CACHE_NVM_KEY + slot);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_nvm_erase() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+} // gattCacheErase()
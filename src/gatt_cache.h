@@ -0,0 +1,75 @@
+/*
+ * File name: gatt_cache.h
+ * File description: This file declares the client GATT handle cache APIs. Handles found by
+ *                   discovery are kept in NVM, keyed by server address and GATT database hash,
+ *                   so a reconnect to an unchanged server only has to read the hash.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides weeks 8-9
+ *  [2] Bluetooth Core Specification v5.2, Vol 3, Part G, 2.5.2 Attribute Caching (Database Hash)
+ *  [3] Silicon Labs Bluetooth API reference, NVM class https://docs.silabs.com/bluetooth/3.2/group-sl-bt-nvm
+ */
+#ifndef SRC_GATT_CACHE_H_
+#define SRC_GATT_CACHE_H_
+
+#include "app.h"
+
+// Set to 0 to run the full discovery on every connection. Both discovery modes
+// (DISCOVERY_SINGLE_PASS in src/scheduler.h) read the database hash for the cache.
+#ifndef GATT_CACHE_ENABLE
+#define GATT_CACHE_ENABLE     1
+#endif
+// sl_bt_nvm_save() user keys are 0x4000 to 0x407F, one key per cached server
+#define GATT_CACHE_NVM_KEY    (0x4000)
+#define GATT_CACHE_SLOTS      (4)
+// Bump when gatt_cache_entry_t changes so old records are ignored
+#define GATT_CACHE_VERSION    (2)
+
+#define GATT_DB_HASH_LEN      (16)
+
+// One cached server, 44 bytes (sl_bt_nvm_save() stores at most 56 per key)
+typedef struct
+{
+  uint8_t  version;
+  bd_addr  server;
+  uint8_t  db_hash[GATT_DB_HASH_LEN];
+  uint16_t db_hash_characteristic;
+  uint16_t htm_characteristic;
+  uint16_t button_characteristic;
+  uint16_t temperature_type_characteristic;
+  uint16_t measurement_interval_characteristic;
+  uint32_t htm_service;
+  uint32_t button_service;
+} gatt_cache_entry_t;
+
+/**
+ * @brief Looks up the cached handles of a server.
+ *
+ * @param server, address of the server
+ * @param entry, returns the cached record
+ *
+ * @return true if a record for this server was found
+ */
+bool gattCacheLoad(const bd_addr *server, gatt_cache_entry_t *entry);
+
+/**
+ * @brief Stores the handles of a server, replacing its old record. When every slot
+ *        is taken by other servers the slots are reused round robin.
+ *
+ * @param entry, the record to store, entry->server selects the slot
+ *
+ * @return none
+ */
+void gattCacheSave(const gatt_cache_entry_t *entry);
+
+/**
+ * @brief Drops the cached record of a server, e.g. after its database hash changed.
+ *
+ * @param server, address of the server
+ *
+ * @return none
+ */
+void gattCacheErase(const bd_addr *server);
+
+#endif /* SRC_GATT_CACHE_H_ */
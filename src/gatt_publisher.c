@@ -0,0 +1,236 @@
+/*
+ * File name: gatt_publisher.c
+ * File description: This file defines the server attribute publisher APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 5 (GATT server, indications)
+ *  [2] Silicon Labs Bluetooth API reference, GATT server https://docs.silabs.com/bluetooth/3.2/group-sl-bt-gatt-server
+ */
+
+#include "src/gatt_publisher.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+#if BUILD_INCLUDES_BLE_SERVER
+typedef struct
+{
+  uint16_t              characteristic;      // gattdb_* handle
+  uint16_t              cccd_flag;           // offsetof() the bool in ble_client_t set by the client's CCCD write
+  bool                  bonded_only;         // indicate only over a bonded link
+  bool                  indicate_unchanged;  // every value is a new sample, indicate it even if equal
+  publish_busy_policy_t busy;
+  const char           *name;
+} publisher_attribute_t;
+
+static const publisher_attribute_t attributes[] =
+{
+  { gattdb_temperature_measurement, offsetof(ble_client_t, ok_to_send_htm_indications), false, true,  PUBLISH_COALESCE, "HTM"    },
+  { gattdb_button_state,            offsetof(ble_client_t, ok_to_send_PB0_indications), true,  false, PUBLISH_QUEUE,    "button" },
+};
+
+#define PUBLISHER_ATTRIBUTE_COUNT (sizeof(attributes) / sizeof(attributes[0]))
+
+typedef struct
+{
+  bool                      valid;
+  uint8_t                   value[GATT_PUBLISHER_MAX_VALUE];  // last value written to the GATT database
+  uint8_t                   len;
+  gatt_publisher_counters_t counters;
+} publisher_state_t;
+
+static publisher_state_t states[PUBLISHER_ATTRIBUTE_COUNT];
+static uint32_t          last_report_ms = 0;
+
+// The client flag a table entry refers to
+#define CLIENT_FLAG(client, attribute) (*(bool *) ((uint8_t *) (client) + (attribute)->cccd_flag))
+
+/*
+ * @brief Finds a characteristic in the publisher table
+ * @param characteristic, gattdb_* handle
+ * @return its index, PUBLISHER_ATTRIBUTE_COUNT if it is not in the table
+ */
+static uint32_t find_attribute(uint16_t characteristic)
+{
+  uint32_t i;
+
+  for (i = 0; i < PUBLISHER_ATTRIBUTE_COUNT; i++)
+    {
+      if (attributes[i].characteristic == characteristic)
+        break;
+    }
+  return i;
+} // find_attribute()
+
+/*
+ * @brief Writes a value to the local GATT database through the cache
+ * @param attribute, the table entry
+ * @param state, its cache and counters
+ * @param value, len, the value
+ * @return true if the value differs from the cached one
+ */
+static bool write_through(const publisher_attribute_t *attribute, publisher_state_t *state,
+                          const uint8_t *value, uint8_t len)
+{
+  sl_status_t sc;
+
+  if (state->valid && (state->len == len) && (memcmp(state->value, value, len) == 0))
+    {
+      state->counters.writes_avoided++;
+      return false;
+    }
+
+  sc = sl_bt_gatt_server_write_attribute_value(attribute->characteristic, 0, len, value);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_gatt_server_write_attribute_value() %s returned != 0 status=0x%04x",
+                attribute->name, (unsigned int) sc);
+      state->valid = false; // write again next time
+      return true;
+    }
+  memcpy(state->value, value, len);
+  state->len   = len;
+  state->valid = true;
+  state->counters.writes++;
+  return true;
+} // write_through()
+
+/*
+ * @brief Sends an indication to a client, or applies the busy policy if one is in flight
+ * @param attribute, the table entry
+ * @param state, its counters
+ * @param client, the client
+ * @param indication, indication_len, the indication
+ * @return none
+ */
+static void indicate(const publisher_attribute_t *attribute, publisher_state_t *state, ble_client_t *client,
+                     uint8_t *indication, size_t indication_len)
+{
+  if (!client->indication_inflight)
+    {
+      if (ble_send_indication(client, attribute->characteristic, indication_len, indication))
+        state->counters.sent++;
+      return;
+    }
+
+  switch (attribute->busy)
+  {
+    case PUBLISH_COALESCE:
+      // The queued value is stale, overwrite it in place and keep its turn
+      if (replace_queue(&client->indication_queue, attribute->characteristic, indication_len, indication) == WRITE_SUCCESS)
+        {
+          state->counters.coalesced++;
+          break;
+        }
+      // nothing of ours queued, queue it
+      /* fall through */
+    case PUBLISH_QUEUE:
+      if (write_queue(&client->indication_queue, attribute->characteristic, indication_len, indication) != READ_SUCCESS)
+        {
+          LOG_ERROR("write_queue() connection %d %s queue full", (int) client->connection, attribute->name);
+          state->counters.dropped++;
+          break;
+        }
+      state->counters.queued++;
+      // A backlog builds up, drain it on a shorter interval
+      connParamsUpdate(client->connection, get_queue_depth(&client->indication_queue));
+      break;
+    case PUBLISH_DROP:
+    default:
+      state->counters.dropped++;
+      break;
+  }
+} // indicate()
+
+/**
+ * @brief Server: writes a value to the local GATT database, unless it equals the cached
+ *        last value, and indicates it to every subscribed client following the
+ *        characteristic's policy.
+ *
+ * @param characteristic, gattdb_* handle, must be in the publisher table
+ * @param value, value written to the GATT database
+ * @param len, value length, at most GATT_PUBLISHER_MAX_VALUE
+ * @param indication, indication payload (flags byte first), may differ from the stored value
+ * @param indication_len, indication length
+ *
+ * @return true if the value changed
+ */
+bool gattPublish(uint16_t characteristic, const uint8_t *value, uint8_t len,
+                 uint8_t *indication, size_t indication_len)
+{
+  ble_data_struct_t           *ble_data_ptr = get_ble_data_ptr();
+  const publisher_attribute_t *attribute;
+  publisher_state_t           *state;
+  bool                         changed;
+  uint32_t                     i = find_attribute(characteristic);
+
+  if ((i == PUBLISHER_ATTRIBUTE_COUNT) || (len > GATT_PUBLISHER_MAX_VALUE))
+    {
+      LOG_ERROR("gattPublish() handle %u not in the publisher table", (unsigned int) characteristic);
+      return false;
+    }
+  attribute = &attributes[i];
+  state     = &states[i];
+
+  changed = write_through(attribute, state, value, len);
+  if (!changed && !attribute->indicate_unchanged)
+    return false;
+
+  // One value, fanned out to every client that enabled this characteristic's indications
+  for (i = 0; i < BLE_MAX_CLIENTS; i++)
+    {
+      ble_client_t *client = &ble_data_ptr->clients[i];
+
+      if (!client->in_use || !CLIENT_FLAG(client, attribute))
+        continue;
+      if (attribute->bonded_only && !client->bonding_flag)
+        continue;
+      indicate(attribute, state, client, indication, indication_len);
+    }
+  return changed;
+} // gattPublish()
+
+/**
+ * @brief Server: returns a characteristic's write and indication counters.
+ *
+ * @param characteristic, gattdb_* handle
+ * @param counters, filled in
+ *
+ * @return false if the handle is not in the publisher table
+ */
+bool gattPublisherCounters(uint16_t characteristic, gatt_publisher_counters_t *counters)
+{
+  uint32_t i = find_attribute(characteristic);
+
+  if (i == PUBLISHER_ATTRIBUTE_COUNT)
+    return false;
+  *counters = states[i].counters;
+  return true;
+} // gattPublisherCounters()
+
+/**
+ * @brief Server: logs each characteristic's database writes, writes avoided and
+ *        indications sent, queued, coalesced and dropped, every
+ *        GATT_PUBLISHER_REPORT_PERIOD_MS. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void gattPublisherReportIfDue(void)
+{
+  uint32_t now_ms = letimerMilliseconds();
+
+  if ((now_ms - last_report_ms) < GATT_PUBLISHER_REPORT_PERIOD_MS)
+    return;
+  last_report_ms = now_ms;
+
+  for (uint32_t i = 0; i < PUBLISHER_ATTRIBUTE_COUNT; i++)
+    {
+      LOG_INFO("Publish %s: %u writes, %u avoided, indications %u sent %u queued %u coalesced %u dropped",
+               attributes[i].name, (unsigned int) states[i].counters.writes, (unsigned int) states[i].counters.writes_avoided,
+               (unsigned int) states[i].counters.sent, (unsigned int) states[i].counters.queued,
+               (unsigned int) states[i].counters.coalesced, (unsigned int) states[i].counters.dropped);
+    }
+} // gattPublisherReportIfDue()
+#endif
@@ -0,0 +1,80 @@
+/*
+ * File name: gatt_publisher.h
+ * File description: This file declares the server attribute publisher APIs. Every local
+ *                   GATT database update goes through one table keyed by gattdb_* handle:
+ *                   the last written value is cached so an unchanged value is not written
+ *                   again, and the per characteristic policy decides whether a client with an
+ *                   indication in flight gets the new value queued, coalesced or dropped.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 5 (GATT server, indications)
+ *  [2] Silicon Labs Bluetooth API reference, GATT server https://docs.silabs.com/bluetooth/3.2/group-sl-bt-gatt-server
+ */
+#ifndef SRC_GATT_PUBLISHER_H_
+#define SRC_GATT_PUBLISHER_H_
+
+#include "app.h"
+
+// Largest local GATT database value cached, HTM is written as a 4 byte int32
+#define GATT_PUBLISHER_MAX_VALUE         (4)
+// How often the write and indication counters are logged
+#define GATT_PUBLISHER_REPORT_PERIOD_MS  (60000)
+
+// What to do with a new value for a client whose previous indication is not confirmed yet
+typedef enum
+{
+  PUBLISH_QUEUE,     // every value matters (button press and release), queue it
+  PUBLISH_COALESCE,  // only the latest matters (a reading), replace the one already queued
+  PUBLISH_DROP,      // skip the busy client
+} publish_busy_policy_t;
+
+// Since boot, per characteristic
+typedef struct
+{
+  uint32_t writes;          // local GATT database writes
+  uint32_t writes_avoided;  // values equal to the cached one, not written
+  uint32_t sent;            // indications handed to the stack
+  uint32_t queued;
+  uint32_t coalesced;       // replaced the value already queued
+  uint32_t dropped;
+} gatt_publisher_counters_t;
+
+/**
+ * @brief Server: writes a value to the local GATT database, unless it equals the cached
+ *        last value, and indicates it to every subscribed client following the
+ *        characteristic's policy.
+ *
+ * @param characteristic, gattdb_* handle, must be in the publisher table
+ * @param value, value written to the GATT database
+ * @param len, value length, at most GATT_PUBLISHER_MAX_VALUE
+ * @param indication, indication payload (flags byte first), may differ from the stored value
+ * @param indication_len, indication length
+ *
+ * @return true if the value changed
+ */
+bool gattPublish(uint16_t characteristic, const uint8_t *value, uint8_t len,
+                 uint8_t *indication, size_t indication_len);
+
+/**
+ * @brief Server: returns a characteristic's write and indication counters.
+ *
+ * @param characteristic, gattdb_* handle
+ * @param counters, filled in
+ *
+ * @return false if the handle is not in the publisher table
+ */
+bool gattPublisherCounters(uint16_t characteristic, gatt_publisher_counters_t *counters);
+
+/**
+ * @brief Server: logs each characteristic's database writes, writes avoided and
+ *        indications sent, queued, coalesced and dropped, every
+ *        GATT_PUBLISHER_REPORT_PERIOD_MS. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void gattPublisherReportIfDue(void);
+
+#endif /* SRC_GATT_PUBLISHER_H_ */
@@ -69,12 +69,18 @@ void gpioInit()
   GPIO_IntDisable (0xFFFFFFFF);  // disable GPIO IRQs
   GPIO_IntClear   (0xFFFFFFFF);  // clear any previous, spurious IRQs
 
-  //DOS GPIO_PinModeSet(PB0_port, PB0_pin, gpioModeInputPullFilter, true);
+#if PB_GLITCH_FILTER
+  GPIO_PinModeSet(PB0_port, PB0_pin, gpioModeInputPullFilter, true);
+#else
   GPIO_PinModeSet(PB0_port, PB0_pin, gpioModeInput, true); // DOS
+#endif
   GPIO_ExtIntConfig (PB0_port, PB0_pin, PB0_pin, true, true, true);
 
-  //DOS GPIO_PinModeSet(PB1_port, PB1_pin, gpioModeInputPullFilter, true);
+#if PB_GLITCH_FILTER
+  GPIO_PinModeSet(PB1_port, PB1_pin, gpioModeInputPullFilter, true);
+#else
   GPIO_PinModeSet(PB1_port, PB1_pin, gpioModeInput, true);
+#endif
   GPIO_ExtIntConfig (PB1_port, PB1_pin, PB1_pin, true, true, true); // DOS
 
 
@@ -45,6 +45,9 @@
 #define PB0_pin 6 //[3]
 #define PB1_port (gpioPortF)
 #define PB1_pin 7
+// 1: PB0/PB1 inputs use the pin glitch filter (pull-up, filter), it removes spikes of a few
+// tens of ns only, bounce is removed by src/buttons.c. 0: plain inputs.
+#define PB_GLITCH_FILTER 1
 //Header files
 #include <stdbool.h>
 #include "em_gpio.h"
@@ -0,0 +1,137 @@
+/*
+ * File name: history.c
+ * File description: This file defines the client history APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 9 (client, indications)
+ */
+
+#include "src/history.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+typedef struct
+{
+  bool     in_use;
+  uint8_t  connection;
+  uint32_t temperatures;       // samples this period
+  int32_t  min_c;
+  int32_t  max_c;
+  int32_t  sum_c;
+  uint32_t presses;
+} history_entry_t;
+
+static history_entry_t history[BLE_MAX_SERVERS];
+static uint32_t        period_start_ms = 0;
+
+/*
+ * @brief Finds the entry of a connection, takes a free one for a new connection
+ * @param connection, the connection
+ * @return the entry, NULL if all are taken
+ */
+static history_entry_t *entry_of(uint8_t connection)
+{
+  history_entry_t *free_entry = NULL;
+
+  for (int i = 0; i < BLE_MAX_SERVERS; i++)
+    {
+      if (history[i].in_use && (history[i].connection == connection))
+        return &history[i];
+      if (!history[i].in_use && (free_entry == NULL))
+        free_entry = &history[i];
+    }
+  if (free_entry != NULL)
+    {
+      memset(free_entry, 0, sizeof(*free_entry));
+      free_entry->in_use     = true;
+      free_entry->connection = connection;
+    }
+  return free_entry;
+} // entry_of()
+
+/**
+ * @brief Clears the history. Call once from the boot event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void historyInit(void)
+{
+  memset(history, 0, sizeof(history));
+  period_start_ms = letimerMilliseconds();
+} // historyInit()
+
+/**
+ * @brief Reads the samples waiting in the client value ring into the history. Call from
+ *        the LETIMER0 UF event, the ring holds CLIENT_VALUES_RING_DEPTH samples.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void historyUpdate(void)
+{
+  const value_sample_t *sample;
+  history_entry_t      *entry;
+
+  while ((sample = clientValuesPeek(VALUE_CONSUMER_HISTORY)) != NULL)
+    {
+      entry = entry_of(sample->connection);
+      if (entry != NULL)
+        {
+          if (sample->kind == VALUE_TEMPERATURE)
+            {
+              if ((entry->temperatures == 0) || (sample->value < entry->min_c))
+                entry->min_c = sample->value;
+              if ((entry->temperatures == 0) || (sample->value > entry->max_c))
+                entry->max_c = sample->value;
+              entry->sum_c += sample->value;
+              entry->temperatures++;
+            }
+          else if ((sample->kind == VALUE_BUTTON) && (sample->value == 1))
+            {
+              entry->presses++;
+            }
+        }
+      clientValuesNext(VALUE_CONSUMER_HISTORY);
+    }
+} // historyUpdate()
+
+/**
+ * @brief Logs every server's temperature min/avg/max and button presses at the end of a
+ *        HISTORY_PERIOD_MS period and starts the next one. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void historyReportIfDue(void)
+{
+  uint32_t now_ms = letimerMilliseconds();
+
+  if ((now_ms - period_start_ms) < HISTORY_PERIOD_MS)
+    return;
+  period_start_ms = now_ms;
+
+  for (int i = 0; i < BLE_MAX_SERVERS; i++)
+    {
+      if (!history[i].in_use)
+        continue;
+      if (history[i].temperatures > 0)
+        {
+          LOG_INFO("History connection %d: %u samples, %d/%d/%d C min/avg/max, %u presses",
+                   (int) history[i].connection, (unsigned int) history[i].temperatures,
+                   (int) history[i].min_c, (int) (history[i].sum_c / (int32_t) history[i].temperatures),
+                   (int) history[i].max_c, (unsigned int) history[i].presses);
+        }
+      else
+        {
+          LOG_INFO("History connection %d: no samples, %u presses",
+                   (int) history[i].connection, (unsigned int) history[i].presses);
+        }
+      // A closed connection's entry is freed here, an open one starts again
+      history[i].in_use = false;
+    }
+} // historyReportIfDue()
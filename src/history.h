@@ -0,0 +1,49 @@
+/*
+ * File name: history.h
+ * File description: This file declares the client history APIs. The history reads the
+ *                   samples from the client value ring on the LETIMER0 tick, keeps the
+ *                   min/avg/max temperature and the button presses of every server over
+ *                   HISTORY_PERIOD_MS, and logs them at the end of the period.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 9 (client, indications)
+ */
+#ifndef SRC_HISTORY_H_
+#define SRC_HISTORY_H_
+
+#include "app.h"
+
+// Length of one history period, logged at its end
+#define HISTORY_PERIOD_MS          (60000)
+
+/**
+ * @brief Clears the history. Call once from the boot event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void historyInit(void);
+
+/**
+ * @brief Reads the samples waiting in the client value ring into the history. Call from
+ *        the LETIMER0 UF event, the ring holds CLIENT_VALUES_RING_DEPTH samples.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void historyUpdate(void);
+
+/**
+ * @brief Logs every server's temperature min/avg/max and button presses at the end of a
+ *        HISTORY_PERIOD_MS period and starts the next one. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void historyReportIfDue(void);
+
+#endif /* SRC_HISTORY_H_ */
@@ -102,4 +102,18 @@ int32_t read_temp_from_si7021(void)
   return temp;
 }
 
+/*
+ *  @brief Read temperature from the SI7021 sensor in hundredths of a degree C, the
+ *         resolution of the 14 bit conversion kept.
+ *  @param none
+ *  @return temperature in 0.01 C
+ */
+int32_t read_temp_centi_c_from_si7021(void)
+{
+  uint16_t swapped_read_data = ((read_data[0])<<8) | (read_data[1]);
+
+  // 175.72 * code / 65536 - 46.85, in 0.01 C
+  return (int32_t) (((uint32_t) swapped_read_data * 17572) / 65536) - 4685;
+}
+
 
@@ -54,4 +54,14 @@ void Read_I2C(void);
  *  @return none
  */
 int32_t read_temp_from_si7021(void);
+
+/*
+ *  @brief Read temperature from the SI7021 sensor in hundredths of a degree C, the
+ *         resolution of the 14 bit conversion kept.
+ *
+ *  @param none
+ *
+ *  @return temperature in 0.01 C
+ */
+int32_t read_temp_centi_c_from_si7021(void);
 #endif /* SRC_I2C_H_ */
@@ -28,16 +28,15 @@ void LETIMER0_IRQHandler(void)
 
   if(flag & LETIMER_IF_COMP1)
     {
+      energyCountWakeup(WAKEUP_LETIMER0_COMP1);
       schedulerSetEventCOMP1();
       LETIMER_IntDisable(LETIMER0,LETIMER_IEN_COMP1);
     }
   if(flag & LETIMER_IF_UF)
     {
+      energyCountWakeup(WAKEUP_LETIMER0_UF);
       schedulerSetEventUF();
-      CORE_DECLARE_IRQ_STATE;
-      CORE_ENTER_CRITICAL();
-      rollover_count++;
-      CORE_EXIT_CRITICAL();
+      letimerCountPeriod();
     }
 }
 
@@ -53,6 +52,7 @@ void I2C0_IRQHandler(void)
   I2C_TransferReturn_TypeDef transferStatus;
   transferStatus = I2C_Transfer(I2C0);
 
+  energyCountWakeup(WAKEUP_I2C0);
   if (transferStatus == i2cTransferDone)
     {
       schedulerSetEventTransferComplete();
@@ -86,27 +86,11 @@ void GPIO_EVEN_IRQHandler(void)
   ///flag = GPIO_IntGetEnabled() & 0x55555555; // mask off odd numbered bits 1,3,5... leaving 0,2,4...
 
   GPIO_IntClear(flag);
+  energyCountWakeup(WAKEUP_GPIO);
 
-  //DOS uint8_t button_state = GPIO_PinInGet(PB0_port, PB0_pin); // DOS 0=pressed, 1=released
-  uint32_t button_state = GPIO_PinInGet(PB0_port, PB0_pin); // DOS 0=pressed, 1=released
-
-  //LOG_INFO("EBS=%x", button_state);
-
-//  if (flag & (1 << PB0_pin))
-//    {
-      if (button_state)
-        {
-          //DOS ble_data_ptr->PB0_pressed = false; // DOS not pressed
-          schedulerSetEventPB0Released();
-          //LOG_INFO("PB0 release");
-        }
-      else
-        {
-          //DOS ble_data_ptr->PB0_pressed = true; // DOS is pressed
-          schedulerSetEventPB0Pressed();
-          //LOG_INFO("PB0 pressed");
-        }
-//    }
+  // Contact bounce gives a burst of edges, src/buttons.c posts the press or release once the level settles
+  if (flag & (1 << PB0_pin))
+    buttonsEdge(BUTTON_PB0);
 }
 
 
@@ -128,26 +112,10 @@ void GPIO_ODD_IRQHandler(void)
   //LOG_INFO("OddFlag=%x", flag);
 
   GPIO_IntClear(flag);
-
-  uint32_t button_state = GPIO_PinInGet(PB1_port, PB1_pin); // DOS 0=pressed, 1=released
-
-  //LOG_INFO("OBS=%x", button_state);
+  energyCountWakeup(WAKEUP_GPIO);
 
   if (flag & (1 << PB1_pin))
-    {
-      if (button_state)
-        {
-          //DOS ble_data_ptr->PB1_pressed = false; // DOS not pressed
-          schedulerSetEventPB1Released();
-          //LOG_INFO("PB1 release");
-        }
-      else
-        {
-          //DOS ble_data_ptr->PB1_pressed = true; // DOS is pressed
-          schedulerSetEventPB1Pressed();
-          //LOG_INFO("PB1 pressed");
-        }
-    }
+    buttonsEdge(BUTTON_PB1);
 }
 
 
@@ -164,3 +132,19 @@ uint32_t letimerMilliseconds(void)
 {
   return (rollover_count + ((LETIMER_CompareGet(LETIMER0, 0) - LETIMER_CounterGet(LETIMER0))/LETIMER_CompareGet(LETIMER0, 0)))*LETIMER_PERIOD_MS;
 }
+
+/**
+ * @brief Counts one sampling period for letimerMilliseconds(). Called on the LETIMER0 UF
+ *        interrupt, or on the src/sampler.c sleeptimer when it drives the sampling.
+ *
+ * @param none
+ *
+ * @returns none
+ */
+void letimerCountPeriod(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  rollover_count++;
+  CORE_EXIT_CRITICAL();
+} // letimerCountPeriod()
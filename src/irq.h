@@ -21,6 +21,16 @@
  */
 uint32_t letimerMilliseconds(void);
 
+/*
+ * @brief Counts one sampling period for letimerMilliseconds(). Called on the LETIMER0 UF
+ *        interrupt, or on the src/sampler.c sleeptimer when it drives the sampling.
+ *
+ * @param none
+ *
+ * @returns none
+ */
+void letimerCountPeriod(void);
+
 /*
  * @brief Interrupt service routine for LETIMER0 peripheral to drive LED0 based on interrupt flags of LETIMER0; COMP1 and UF.
  *
@@ -104,6 +104,43 @@ static struct display_data         *displayGetData() {
 	return &global_display_data;
 }
 
+/*
+ * @brief Sends the frame buffer to the memory LCD
+ * @param none
+ * @return none
+ */
+static void flush(void)
+{
+   EMSTATUS status = DMD_updateDisplay();
+
+   if (status != DMD_OK) {
+       LOG_ERROR("DMD_updateDisplay() returned non-zero error code=0x%04x", (unsigned int) status);
+   }
+} // flush()
+
+#if COALESCE_LCD_FLUSHES
+static coalesce_job_t flush_job = COALESCE_JOB("lcd_flush", flush);
+#endif
+
+#if !LCD_EXTCOMIN_HW_TOGGLE && COALESCE_LCD_EXTCOMIN
+/*
+ * @brief Toggles EXTCOMIN and schedules the next toggle, within the last
+ *        COALESCE_EXTCOMIN_SLACK_MS of LCD_EXTCOMIN_PERIOD_MS
+ * @param none
+ * @return none
+ */
+static void extcomin_toggle(void);
+
+static coalesce_job_t extcomin_job = COALESCE_JOB("lcd_extcomin", extcomin_toggle);
+
+static void extcomin_toggle(void)
+{
+  displayUpdate();
+  coalesceSchedule(&extcomin_job, (LCD_EXTCOMIN_PERIOD_MS - COALESCE_EXTCOMIN_SLACK_MS) * 1000,
+                   COALESCE_EXTCOMIN_SLACK_MS);
+} // extcomin_toggle()
+#endif
+
 
 
 // ****************************************************************
@@ -219,11 +256,12 @@ void displayPrintf(enum display_row row, const char *format, ...)
    }
 
 
-   // Update the data the LCD is displaying
-   status = DMD_updateDisplay();
-   if (status != DMD_OK) {
-       LOG_ERROR("DMD_updateDisplay() returned non-zero error code=0x%04x", (unsigned int) status);
-   }
+   // Update the data the LCD is displaying, once for all the rows printed in this wakeup
+#if COALESCE_LCD_FLUSHES
+   coalesceSchedule(&flush_job, 0, COALESCE_LCD_SLACK_MS);
+#else
+   flush();
+#endif
 
 } // displayPrintf()
 
@@ -312,6 +350,18 @@ void displayInit()
     // Students: Figure out what parameters to pass in to sl_bt_system_set_soft_timer() to
     //           set up a 1 second repeating soft timer and uncomment the following lines
 
+#if LCD_EXTCOMIN_HW_TOGGLE || COALESCE_LCD_EXTCOMIN
+    // LETIMER0 OUT0 toggles EXTCOMIN in hardware, see letimer0Init(), or the coalescer
+    // toggles it on a wakeup that is already happening. Stop the sl_memlcd sleeptimer that
+    // also toggles EXTCOMIN and don't start the BT stack soft timer.
+    status = DMD_sleep();
+    if (status != DMD_OK) {
+        LOG_ERROR("DMD_sleep() returned non-zero error code=0x%04x", (unsigned int) status);
+    }
+#if !LCD_EXTCOMIN_HW_TOGGLE
+    extcomin_toggle();
+#endif
+#else
 	  sl_status_t          timer_response;
 	  /* @param 1: time: 32768 = 1sec
 	   * @param 2: timer handle: 0-3 *timer handle values to be limited between 0-3!*
@@ -320,6 +370,7 @@ void displayInit()
 	  if (timer_response != SL_STATUS_OK) {
      LOG_ERROR("sl_bt_system_set_soft_timer() returned != 0 status=0x%04x\n\r", (unsigned int) timer_response);
     }
+#endif
 
 
 
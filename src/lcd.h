@@ -63,6 +63,17 @@ enum display_row {
 // The number of characters per row
 #define DISPLAY_ROW_LEN      20
 
+// Set to 1 to toggle the LCD EXTCOMIN input (PD13) in hardware from LETIMER0 OUT0 on
+// every LETIMER0 underflow, LETIMER0 then reloads every LCD_EXTCOMIN_PERIOD_MS. The BT
+// stack soft timer and the sl_memlcd sleeptimer toggle are then not started, so the core
+// does not wake up just to toggle EXTCOMIN.
+// Set to 0 to toggle EXTCOMIN in software through displayUpdate(), on a wakeup that is
+// already happening (COALESCE_LCD_EXTCOMIN, src/coalesce.h) or on the 1 second BT stack
+// soft timer.
+#define LCD_EXTCOMIN_HW_TOGGLE 0
+// EXTCOMIN is toggled at least this often
+#define LCD_EXTCOMIN_PERIOD_MS (1000)
+
 
 
 // function prototypes
@@ -0,0 +1,294 @@
+/*
+ * File name: link.c
+ * File description: This file defines the link upgrade APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 6 (connections, throughput)
+ *  [2] Bluetooth Core Specification v5.2, Vol 6, Part B, 2.1 Packet format, 2.4 Data channel PDU, 4.1.2 IFS
+ *  [3] Silicon Labs Bluetooth API reference, Connection https://docs.silabs.com/bluetooth/3.2/group-sl-bt-connection
+ */
+
+#include "src/link.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+#define LINK_DEFAULT_TXSIZE   (27)   // LL data payload before length update
+#define LINK_DEFAULT_MTU      (23)
+#define LINK_T_IFS_US         (150)  // inter frame space
+#define LINK_L2CAP_ATT_HDR    (4 + 3)
+#define LINK_KB               (1024)
+
+typedef struct
+{
+  bool     in_use;
+  uint8_t  connection;
+  uint8_t  phy;
+  bool     phy_requested;   // 2M asked for, waiting for sl_bt_evt_connection_phy_status_id
+  bool     encrypted;       // data PDUs carry a 4 byte MIC
+  uint16_t txsize;
+  uint16_t mtu;
+} link_entry_t;
+
+static link_entry_t links[LINK_MAX_CONNECTIONS];
+
+/*
+ * @brief Finds the table entry of a connection
+ * @param connection, connection handle
+ * @return pointer to the entry, NULL if not tracked
+ */
+static link_entry_t *find_link(uint8_t connection)
+{
+  for (int i = 0; i < LINK_MAX_CONNECTIONS; i++)
+    {
+      if (links[i].in_use && (links[i].connection == connection))
+        return &links[i];
+    }
+  return NULL;
+} // find_link()
+
+/*
+ * @brief Air time of one data channel PDU
+ * @param link, the connection (PHY, encryption)
+ * @param payload, LL payload bytes, 0 for an empty PDU
+ * @return air time in us
+ */
+static uint32_t pdu_airtime_us(const link_entry_t *link, uint16_t payload)
+{
+  // preamble (1 byte on 1M, 2 on 2M), access address, header, payload, MIC, CRC
+  uint32_t bytes = ((link->phy == LINK_PHY_2M) ? 2 : 1) + 4 + 2 + payload +
+                   ((link->encrypted && payload) ? 4 : 0) + 3;
+
+  return (link->phy == LINK_PHY_2M) ? (bytes * 4) : (bytes * 8);
+} // pdu_airtime_us()
+
+/*
+ * @brief Air time of one notification/indication, fragmented into LL PDUs, each answered
+ *        by an empty PDU from the peer
+ * @param link, the connection
+ * @param att_payload, ATT value bytes
+ * @return air time in us, inter frame spaces included
+ */
+static uint32_t att_airtime_us(const link_entry_t *link, uint16_t att_payload)
+{
+  uint32_t frame = att_payload + LINK_L2CAP_ATT_HDR;
+  uint32_t us    = 0;
+
+  while (frame)
+    {
+      uint16_t fragment = (frame > link->txsize) ? link->txsize : (uint16_t) frame;
+
+      us    += pdu_airtime_us(link, fragment) + LINK_T_IFS_US + pdu_airtime_us(link, 0) + LINK_T_IFS_US;
+      frame -= fragment;
+    }
+  return us;
+} // att_airtime_us()
+
+/*
+ * @brief Computes the airtime model of a link: best case throughput, and radio time and
+ *        energy to move one kilobyte of notification payload
+ * @param link, the connection
+ * @param model, filled in
+ * @return none
+ */
+static void compute_link_model(const link_entry_t *link, link_model_t *model)
+{
+  uint16_t att_payload = link->mtu - 3;
+  uint32_t us = (LINK_KB / att_payload) * att_airtime_us(link, att_payload);
+
+  if (LINK_KB % att_payload)
+    us += att_airtime_us(link, LINK_KB % att_payload);
+
+  model->phy       = link->phy;
+  model->txsize    = link->txsize;
+  model->mtu       = link->mtu;
+  model->kbps      = ((uint32_t) LINK_KB * 8 * 1000) / us;
+  model->us_per_kb = us;
+  model->uj_per_kb = (uint32_t) (((uint64_t) us * LINK_RADIO_CURRENT_UA * LINK_SUPPLY_MV) / 1000000000);
+} // compute_link_model()
+
+/*
+ * @brief Logs the airtime model of a link
+ * @param link, the connection
+ * @return none
+ */
+static void log_link_model(const link_entry_t *link)
+{
+  link_model_t model;
+
+  compute_link_model(link, &model);
+  LOG_INFO("Link %d: %s PHY, LL %u bytes, MTU %u: ~%u kbps, ~%u us and ~%u uJ radio per KB",
+           (int) link->connection, (model.phy == LINK_PHY_2M) ? "2M" : "1M",
+           (unsigned int) model.txsize, (unsigned int) model.mtu, (unsigned int) model.kbps,
+           (unsigned int) model.us_per_kb, (unsigned int) model.uj_per_kb);
+} // log_link_model()
+
+/**
+ * @brief Sets the largest ATT MTU the stack offers. Call from the boot event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void linkInit(void)
+{
+  uint16_t    max_mtu;
+  sl_status_t sc;
+
+  memset(links, 0, sizeof(links));
+  sc = sl_bt_gatt_set_max_mtu(LINK_MAX_MTU, &max_mtu);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_gatt_set_max_mtu() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+} // linkInit()
+
+/**
+ * @brief Starts tracking a new connection (1M PHY, 27 byte PDUs, MTU 23) and asks the
+ *        peer for the 2M PHY.
+ *
+ * @param connection, connection handle
+ *
+ * @return none
+ */
+void linkOpened(uint8_t connection)
+{
+  link_entry_t *link = NULL;
+  sl_status_t   sc;
+
+  for (int i = 0; (i < LINK_MAX_CONNECTIONS) && (link == NULL); i++)
+    {
+      if (!links[i].in_use)
+        link = &links[i];
+    }
+  if (link == NULL)
+    {
+      LOG_ERROR("linkOpened() no free entry for connection %d", (int) connection);
+      return;
+    }
+  memset(link, 0, sizeof(*link));
+  link->in_use     = true;
+  link->connection = connection;
+  link->phy        = LINK_PHY_1M;
+  link->txsize     = LINK_DEFAULT_TXSIZE;
+  link->mtu        = LINK_DEFAULT_MTU;
+
+#if LINK_PREFER_2M
+  // Prefer 2M, but accept whatever the peer asks for so a 1M only peer keeps the link
+  sc = sl_bt_connection_set_preferred_phy(connection, LINK_PHY_2M, 0xff);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_connection_set_preferred_phy() returned != 0 status=0x%04x", (unsigned int) sc);
+      return;
+    }
+  link->phy_requested = true;
+#else
+  (void) sc;
+#endif
+} // linkOpened()
+
+/**
+ * @brief Stops tracking a closed connection.
+ *
+ * @param connection, connection handle
+ *
+ * @return none
+ */
+void linkClosed(uint8_t connection)
+{
+  link_entry_t *link = find_link(connection);
+
+  if (link)
+    link->in_use = false;
+} // linkClosed()
+
+/**
+ * @brief Records the PHY chosen by the PHY update procedure. Staying on 1M after a 2M
+ *        request means the peer refused, the link keeps working on 1M.
+ *
+ * @param status, the sl_bt_evt_connection_phy_status_id event data
+ *
+ * @return none
+ */
+void linkPhyStatus(const sl_bt_evt_connection_phy_status_t *status)
+{
+  link_entry_t *link = find_link(status->connection);
+
+  if (link == NULL)
+    return;
+  if (link->phy_requested && (status->phy != LINK_PHY_2M))
+    LOG_INFO("Link %d: peer refused the 2M PHY, staying on 1M", (int) link->connection);
+  link->phy_requested = false;
+  link->phy           = status->phy;
+  log_link_model(link);
+} // linkPhyStatus()
+
+/**
+ * @brief Records the LL data length (txsize) negotiated by the stack.
+ *
+ * @param params, the sl_bt_evt_connection_parameters_id event data
+ *
+ * @return none
+ */
+void linkParameters(const sl_bt_evt_connection_parameters_t *params)
+{
+  link_entry_t *link = find_link(params->connection);
+  bool          encrypted = (params->security_mode != sl_bt_connection_mode1_level1);
+
+  if ((link == NULL) || ((link->txsize == params->txsize) && (link->encrypted == encrypted)))
+    return;
+  link->txsize    = params->txsize;
+  link->encrypted = encrypted;
+  log_link_model(link);
+} // linkParameters()
+
+/**
+ * @brief Records the ATT MTU agreed with the peer.
+ *
+ * @param exchanged, the sl_bt_evt_gatt_mtu_exchanged_id event data
+ *
+ * @return none
+ */
+void linkMtuExchanged(const sl_bt_evt_gatt_mtu_exchanged_t *exchanged)
+{
+  link_entry_t *link = find_link(exchanged->connection);
+
+  if (link == NULL)
+    return;
+  link->mtu = exchanged->mtu;
+  log_link_model(link);
+} // linkMtuExchanged()
+
+/**
+ * @brief Returns the largest payload of one notification or indication on a connection,
+ *        for bulk streams to size their chunks.
+ *
+ * @param connection, connection handle
+ *
+ * @return ATT MTU - 3, 20 if the connection is unknown
+ */
+uint16_t linkMaxAttPayload(uint8_t connection)
+{
+  link_entry_t *link = find_link(connection);
+
+  return (link) ? (link->mtu - 3) : (LINK_DEFAULT_MTU - 3);
+} // linkMaxAttPayload()
+
+/**
+ * @brief Returns the airtime model of a connection, as logged on each PHY, data length or
+ *        MTU change.
+ *
+ * @param connection, connection handle
+ * @param model, filled in
+ *
+ * @return true, false if the connection is unknown
+ */
+bool linkGetModel(uint8_t connection, link_model_t *model)
+{
+  link_entry_t *link = find_link(connection);
+
+  if (link == NULL)
+    return false;
+  compute_link_model(link, model);
+  return true;
+} // linkGetModel()
@@ -0,0 +1,123 @@
+/*
+ * File name: link.h
+ * File description: This file declares the link upgrade APIs. After a connection opens the
+ *                   link asks for the 2M PHY and the largest ATT MTU, falls back to 1M if the
+ *                   peer refuses, and logs an airtime model of the resulting link so bulk
+ *                   transfers can be sized in throughput and radio energy per kilobyte.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 6 (connections, throughput)
+ *  [2] Bluetooth Core Specification v5.2, Vol 6, Part B, 2.1 Packet format, 2.4 Data channel PDU, 4.1.2 IFS
+ *  [3] Silicon Labs Bluetooth API reference, Connection https://docs.silabs.com/bluetooth/3.2/group-sl-bt-connection
+ */
+#ifndef SRC_LINK_H_
+#define SRC_LINK_H_
+
+#include "app.h"
+
+// Ask for the 2M PHY after a connection opens, 0 stays on 1M
+#define LINK_PREFER_2M             1
+// Largest ATT MTU offered in the MTU exchange, 23 to 250
+#define LINK_MAX_MTU               (247)
+
+// PHY values of sl_bt_connection_set_preferred_phy() and sl_bt_evt_connection_phy_status_id
+#define LINK_PHY_1M                (0x01)
+#define LINK_PHY_2M                (0x02)
+
+// Airtime model, radio current (TX 0 dBm / RX, EFR32BG13 datasheet) and supply for the energy estimate
+#define LINK_RADIO_CURRENT_UA      (9500)
+#define LINK_SUPPLY_MV             (3300)
+
+// Connections tracked at the same time
+#define LINK_MAX_CONNECTIONS       (4)
+
+// Airtime model of a link, see linkGetModel()
+typedef struct
+{
+  uint8_t  phy;             // LINK_PHY_1M or LINK_PHY_2M
+  uint16_t txsize;          // LL data payload
+  uint16_t mtu;             // ATT MTU
+  uint32_t kbps;            // best case notification throughput
+  uint32_t us_per_kb;       // radio time to move 1 KB of notification payload
+  uint32_t uj_per_kb;       // radio energy to move 1 KB of notification payload
+} link_model_t;
+
+/**
+ * @brief Sets the largest ATT MTU the stack offers. Call from the boot event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void linkInit(void);
+
+/**
+ * @brief Starts tracking a new connection (1M PHY, 27 byte PDUs, MTU 23) and asks the
+ *        peer for the 2M PHY.
+ *
+ * @param connection, connection handle
+ *
+ * @return none
+ */
+void linkOpened(uint8_t connection);
+
+/**
+ * @brief Stops tracking a closed connection.
+ *
+ * @param connection, connection handle
+ *
+ * @return none
+ */
+void linkClosed(uint8_t connection);
+
+/**
+ * @brief Records the PHY chosen by the PHY update procedure. Staying on 1M after a 2M
+ *        request means the peer refused, the link keeps working on 1M.
+ *
+ * @param status, the sl_bt_evt_connection_phy_status_id event data
+ *
+ * @return none
+ */
+void linkPhyStatus(const sl_bt_evt_connection_phy_status_t *status);
+
+/**
+ * @brief Records the LL data length (txsize) negotiated by the stack.
+ *
+ * @param params, the sl_bt_evt_connection_parameters_id event data
+ *
+ * @return none
+ */
+void linkParameters(const sl_bt_evt_connection_parameters_t *params);
+
+/**
+ * @brief Records the ATT MTU agreed with the peer.
+ *
+ * @param exchanged, the sl_bt_evt_gatt_mtu_exchanged_id event data
+ *
+ * @return none
+ */
+void linkMtuExchanged(const sl_bt_evt_gatt_mtu_exchanged_t *exchanged);
+
+/**
+ * @brief Returns the largest payload of one notification or indication on a connection,
+ *        for bulk streams to size their chunks.
+ *
+ * @param connection, connection handle
+ *
+ * @return ATT MTU - 3, 20 if the connection is unknown
+ */
+uint16_t linkMaxAttPayload(uint8_t connection);
+
+/**
+ * @brief Returns the airtime model of a connection, as logged on each PHY, data length or
+ *        MTU change.
+ *
+ * @param connection, connection handle
+ * @param model, filled in
+ *
+ * @return true, false if the connection is unknown
+ */
+bool linkGetModel(uint8_t connection, link_model_t *model);
+
+#endif /* SRC_LINK_H_ */
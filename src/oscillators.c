@@ -11,7 +11,7 @@
 #include "em_cmu.h"
 
 /*
- * @brief This function configures the oscillator and clock settings according to the energy mode set.
+ * @brief This function configures the oscillator and clock settings of the boot power profile.
  *
  * @param none
  *
@@ -19,7 +19,19 @@
  */
 void oscInit(void)
 {
-  if(LOWEST_ENERGY_MODE != 3)
+  oscLetimerClockSelect(powerProfileGet() == POWER_PROFILE_PRECISE);
+} //init_osc()
+
+/*
+ * @brief Clocks LFA and LETIMER0 from the profile's oscillator, waits for it to be ready.
+ *
+ * @param lfxo, true for LFXO/4, false for ULFRCO
+ *
+ * @return none
+ */
+void oscLetimerClockSelect(bool lfxo)
+{
+  if(lfxo)
     {
       CMU_OscillatorEnable(cmuOsc_LFXO,true, true);
       CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_LFXO);
@@ -30,6 +42,7 @@ void oscInit(void)
     }
   else
     {
+      // The LFXO is left running, the BT stack sleep clock needs it
       CMU_OscillatorEnable(cmuOsc_ULFRCO,true, true);
       CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_ULFRCO);
       CMU_ClockEnable(cmuClock_LFA,true);
@@ -37,5 +50,21 @@ void oscInit(void)
       CMU_ClockEnable(cmuClock_LETIMER0,true);
 
     }
-} //init_osc()
+} // oscLetimerClockSelect()
 
+/*
+ * @brief Starts the profile's oscillator without waiting for it.
+ *
+ * @param lfxo, true for LFXO/4, false for ULFRCO
+ *
+ * @return true once the oscillator is ready
+ */
+bool oscLetimerClockReady(bool lfxo)
+{
+  if(lfxo)
+    {
+      CMU_OscillatorEnable(cmuOsc_LFXO, true, false);
+      return (CMU->STATUS & CMU_STATUS_LFXORDY) != 0;
+    }
+  return true; // the ULFRCO is always on
+} // oscLetimerClockReady()
@@ -30,4 +30,6 @@
  * @return none
  */
 void oscInit(void);
+void oscLetimerClockSelect(bool lfxo);
+bool oscLetimerClockReady(bool lfxo);
 #endif /* SRC_OSCILLATORS_H_ */
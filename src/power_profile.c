@@ -0,0 +1,224 @@
+/*
+ * File name: power_profile.c
+ * File description: This file defines the power profile APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 2-3 (oscillators, LETIMER0)
+ *  [2] EFR32BG13 datasheet, LFXO and ULFRCO characteristics https://www.silabs.com/documents/public/data-sheets/efr32bg13-datasheet.pdf
+ */
+
+#include "src/power_profile.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+typedef struct
+{
+  const char *name;
+  uint32_t    letimer_hz;    // after the prescaler
+  uint32_t    min_us;        // one tick
+  uint32_t    error_ppm;     // clock tolerance, datasheet
+  uint32_t    sleep_na;      // lowest energy mode current, src/energy.h model
+  int         lowest_em;
+} profile_info_t;
+
+static const profile_info_t profiles[POWER_PROFILE_COUNT] =
+{
+  // LFXO, board crystal tolerance
+  { "precise",   LFXO / LFXO_PRESCALER_VALUE,     EM_0TO2_MIN_US_VAL, 50,    ENERGY_EM2_NA, 2 },
+  // ULFRCO, 0.95 to 1.07 kHz over temperature and process
+  { "ultra-low", ULFRCO / ULFRCO_PRESCALER_VALUE, EM3_MIN_US_VAL,     70000, ENERGY_EM3_NA, 3 },
+};
+
+static power_profile_t current   = POWER_PROFILE_BOOT;
+static power_profile_t requested = POWER_PROFILE_BOOT;
+static uint32_t        switches  = 0;
+// Measured LETIMER0 clock of each profile, nominal until powerProfileCalibrate()
+static volatile uint32_t calibrated_hz[POWER_PROFILE_COUNT] =
+{
+  LFXO / LFXO_PRESCALER_VALUE,
+  ULFRCO / ULFRCO_PRESCALER_VALUE,
+};
+
+// The precise profile keeps the chip out of EM3, which would stop the LFXO
+static em_token_t em2_token = EM_TOKEN_LONG_LIVED("power_profile", SL_POWER_MANAGER_EM2);
+
+/*
+ * @brief Logs one profile's model
+ * @param profile, the profile
+ * @return none
+ */
+static void log_profile(power_profile_t profile)
+{
+  const profile_info_t *info = &profiles[profile];
+
+  // Timing error of a 1 s delay: clock tolerance plus up to one tick of rounding
+  LOG_INFO("Power profile %s%s: EM%d ~%u nA asleep, LETIMER0 %u Hz, %u us tick, 1 s delay error <= %u us",
+           info->name, (profile == current) ? " (in use)" : "", info->lowest_em,
+           (unsigned int) info->sleep_na, (unsigned int) info->letimer_hz, (unsigned int) info->min_us,
+           (unsigned int) (info->error_ppm + info->min_us));
+} // log_profile()
+
+/*
+ * @brief Moves LETIMER0 to the requested profile's clock and restarts it from the top.
+ *        The sampling period comes from the sleeptimer (SAMPLER_ON_SLEEPTIMER), so the
+ *        LETIMER0 count has no phase worth carrying over, and no COMP1 delay is in flight.
+ *        Without it, this runs just after the underflow and the period is only longer by
+ *        the event latency.
+ * @param none
+ * @return none
+ */
+static void apply_requested(void)
+{
+  uint32_t new_top;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  LETIMER_Enable(LETIMER0, false);
+  oscLetimerClockSelect(requested == POWER_PROFILE_PRECISE);
+  current = requested;
+  new_top = COMP0_LOAD;
+  LETIMER_CompareSet(LETIMER0, 0, new_top);
+  LETIMER_CounterSet(LETIMER0, new_top);
+  LETIMER_Enable(LETIMER0, true);
+  CORE_EXIT_CRITICAL();
+
+  if (current == POWER_PROFILE_PRECISE)
+    emTokenAcquire(&em2_token);
+  else
+    emTokenRelease(&em2_token);
+  switches++;
+  LOG_INFO("Power profile %s, switch %u", profiles[current].name, (unsigned int) switches);
+  log_profile(current);
+} // apply_requested()
+
+/**
+ * @brief Holds the boot profile's EM requirement and logs the energy and timing error
+ *        model of every profile. Call from app_init() after oscInit().
+ *
+ * @param none
+ *
+ * @return none
+ */
+void powerProfileInit(void)
+{
+  if (current == POWER_PROFILE_PRECISE)
+    emTokenAcquire(&em2_token);
+  for (int i = 0; i < POWER_PROFILE_COUNT; i++)
+    log_profile((power_profile_t) i);
+} // powerProfileInit()
+
+/**
+ * @brief Returns the profile in use.
+ *
+ * @param none
+ *
+ * @return the profile
+ */
+power_profile_t powerProfileGet(void)
+{
+  return current;
+} // powerProfileGet()
+
+/**
+ * @brief Requests a profile. Its oscillator is started now, the LETIMER0 clock and the
+ *        EM requirement change on the next underflow with the oscillator ready.
+ *
+ * @param profile, the profile
+ *
+ * @return none
+ */
+void powerProfileSet(power_profile_t profile)
+{
+  if (profile >= POWER_PROFILE_COUNT)
+    return;
+  requested = profile;
+  if (requested != current)
+    oscLetimerClockReady(requested == POWER_PROFILE_PRECISE); // LFXO takes a few hundred ms to start
+} // powerProfileSet()
+
+/**
+ * @brief Returns the LETIMER0 clock of the profile in use.
+ *
+ * @param none
+ *
+ * @return clock in Hz, after the prescaler, calibrated when a measurement was taken
+ */
+uint32_t powerProfileLetimerHz(void)
+{
+  return calibrated_hz[current];
+} // powerProfileLetimerHz()
+
+/**
+ * @brief Takes a measurement of the LETIMER0 clock of the profile in use, against the
+ *        LFXO clocked sleeptimer, for the tick conversions. Readings more than 10% off the
+ *        nominal clock are ignored. Interrupt safe.
+ *
+ * @param measured_hz, the measured clock in Hz, after the prescaler
+ *
+ * @return none
+ */
+void powerProfileCalibrate(uint32_t measured_hz)
+{
+  uint32_t nominal = profiles[current].letimer_hz;
+
+  if ((measured_hz < (nominal - nominal / 10)) || (measured_hz > (nominal + nominal / 10)))
+    return;
+  calibrated_hz[current] = measured_hz;
+} // powerProfileCalibrate()
+
+/**
+ * @brief Returns how far the calibrated LETIMER0 clock of the profile in use is from nominal.
+ *
+ * @param none
+ *
+ * @return error in ppm, positive when the clock runs fast
+ */
+int32_t powerProfileErrorPpm(void)
+{
+  int32_t nominal = (int32_t) profiles[current].letimer_hz;
+
+  return (int32_t) ((((int64_t) calibrated_hz[current] - nominal) * 1000000) / nominal);
+} // powerProfileErrorPpm()
+
+/**
+ * @brief Returns the shortest delay timerwaitUs_*() can time in the profile in use.
+ *
+ * @param none
+ *
+ * @return one LETIMER0 tick in us, rounded up
+ */
+uint32_t powerProfileMinUs(void)
+{
+  return profiles[current].min_us;
+} // powerProfileMinUs()
+
+/**
+ * @brief Applies a requested profile on the LETIMER0 underflow and toggles the profile
+ *        on POWER_PROFILE_TOGGLE_SIGNAL. Subscribe to sl_bt_evt_system_external_signal_id
+ *        ahead of temperature_state_machine(), no LETIMER0 delay is running at the underflow.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void powerProfileOnSignal(sl_bt_msg_t *evt)
+{
+  uint32_t signals = evt->data.evt_system_external_signal.extsignals;
+
+  if (signals & POWER_PROFILE_TOGGLE_SIGNAL)
+    {
+      powerProfileSet((requested == POWER_PROFILE_PRECISE) ? POWER_PROFILE_ULTRA_LOW : POWER_PROFILE_PRECISE);
+      LOG_INFO("Power profile %s requested", profiles[requested].name);
+    }
+
+  if ((signals & evtLETIMER0_UF) && (requested != current))
+    {
+      // A COMP1 delay in flight was timed in the old clock, try again next period
+      if (LETIMER0->IEN & LETIMER_IEN_COMP1)
+        return;
+      if (!oscLetimerClockReady(requested == POWER_PROFILE_PRECISE))
+        return;
+      apply_requested();
+    }
+} // powerProfileOnSignal()
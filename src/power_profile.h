@@ -0,0 +1,110 @@
+/*
+ * File name: power_profile.h
+ * File description: This file declares the power profile APIs. The profile decides, at
+ *                   run time, the LETIMER0 clock (LFXO/4 or ULFRCO), the tick constants
+ *                   derived from it and the lowest energy mode. LOWEST_ENERGY_MODE in app.h
+ *                   only picks the profile the device boots in. A switch is requested at
+ *                   any time and applied on the next sampling period, LETIMER0 then
+ *                   restarts from the top in the new clock.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 2-3 (oscillators, LETIMER0)
+ *  [2] EFR32BG13 datasheet, LFXO and ULFRCO characteristics https://www.silabs.com/documents/public/data-sheets/efr32bg13-datasheet.pdf
+ */
+#ifndef SRC_POWER_PROFILE_H_
+#define SRC_POWER_PROFILE_H_
+
+#include "app.h"
+
+typedef enum
+{
+  POWER_PROFILE_PRECISE,       // EM2, LETIMER0 on LFXO/4, 122 us ticks, crystal accuracy
+  POWER_PROFILE_ULTRA_LOW,     // EM3, LETIMER0 on ULFRCO, 1 ms ticks, RC accuracy
+  POWER_PROFILE_COUNT
+} power_profile_t;
+
+// Profile at reset
+#define POWER_PROFILE_BOOT          ((LOWEST_ENERGY_MODE == 3) ? POWER_PROFILE_ULTRA_LOW : POWER_PROFILE_PRECISE)
+// External signal that toggles between the two profiles
+#define POWER_PROFILE_TOGGLE_SIGNAL (evtPB0_long_press)
+
+/**
+ * @brief Holds the boot profile's EM requirement and logs the energy and timing error
+ *        model of every profile. Call from app_init() after oscInit().
+ *
+ * @param none
+ *
+ * @return none
+ */
+void powerProfileInit(void);
+
+/**
+ * @brief Returns the profile in use.
+ *
+ * @param none
+ *
+ * @return the profile
+ */
+power_profile_t powerProfileGet(void);
+
+/**
+ * @brief Requests a profile. Its oscillator is started now, the LETIMER0 clock and the
+ *        EM requirement change on the next underflow with the oscillator ready.
+ *
+ * @param profile, the profile
+ *
+ * @return none
+ */
+void powerProfileSet(power_profile_t profile);
+
+/**
+ * @brief Returns the LETIMER0 clock of the profile in use.
+ *
+ * @param none
+ *
+ * @return clock in Hz, after the prescaler, calibrated when a measurement was taken
+ */
+uint32_t powerProfileLetimerHz(void);
+
+/**
+ * @brief Takes a measurement of the LETIMER0 clock of the profile in use, against the
+ *        LFXO clocked sleeptimer, for the tick conversions. Readings more than 10% off the
+ *        nominal clock are ignored. Interrupt safe.
+ *
+ * @param measured_hz, the measured clock in Hz, after the prescaler
+ *
+ * @return none
+ */
+void powerProfileCalibrate(uint32_t measured_hz);
+
+/**
+ * @brief Returns how far the calibrated LETIMER0 clock of the profile in use is from nominal.
+ *
+ * @param none
+ *
+ * @return error in ppm, positive when the clock runs fast
+ */
+int32_t powerProfileErrorPpm(void);
+
+/**
+ * @brief Returns the shortest delay timerwaitUs_*() can time in the profile in use.
+ *
+ * @param none
+ *
+ * @return one LETIMER0 tick in us, rounded up
+ */
+uint32_t powerProfileMinUs(void);
+
+/**
+ * @brief Applies a requested profile on the LETIMER0 underflow and toggles the profile
+ *        on POWER_PROFILE_TOGGLE_SIGNAL. Subscribe to sl_bt_evt_system_external_signal_id
+ *        ahead of temperature_state_machine(), no LETIMER0 delay is running at the underflow.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void powerProfileOnSignal(sl_bt_msg_t *evt);
+
+#endif /* SRC_POWER_PROFILE_H_ */
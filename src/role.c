@@ -0,0 +1,188 @@
+/*
+ * File name: role.c
+ * File description: This file defines the device role APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 5 (BT stack events)
+ *  [2] Silicon Labs Bluetooth API reference, NVM class https://docs.silabs.com/bluetooth/3.2/group-sl-bt-nvm
+ */
+
+#include "src/role.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+static role_record_t role =
+{
+  .version        = ROLE_VERSION,
+  .is_server      = DEVICE_IS_BLE_SERVER,
+  .server_address = SERVER_BT_ADDRESS,
+};
+
+// Connection that wrote a new role, reset when it closes
+static bool    reset_pending = false;
+static uint8_t reset_connection;
+
+#ifdef gattdb_device_role
+/*
+ * @brief Shows the current role and server address in the device_role characteristic
+ * @param none
+ * @return none
+ */
+static void write_role_attribute(void)
+{
+  uint8_t     value[ROLE_VALUE_LEN];
+  sl_status_t sc;
+
+  value[0] = role.is_server;
+  memcpy(&value[1], role.server_address.addr, sizeof(role.server_address.addr));
+  sc = sl_bt_gatt_server_write_attribute_value(gattdb_device_role, 0, sizeof(value), value);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_gatt_server_write_attribute_value() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+} // write_role_attribute()
+#endif
+
+/**
+ * @brief Reads the role record from NVM, the build defaults (DEVICE_IS_BLE_SERVER,
+ *        SERVER_BT_ADDRESS) if there is none. With DEVICE_ROLE_RUNTIME, PB0 and PB1 held
+ *        down switch the role and save it. Call from the boot event, before the role's
+ *        handlers are subscribed.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void roleLoad(void)
+{
+  role_record_t record;
+  size_t        len = 0;
+  sl_status_t   sc;
+
+  sc = sl_bt_nvm_load(ROLE_NVM_KEY, sizeof(record), &len, (uint8_t *) &record);
+  if ((sc == SL_STATUS_OK) && (len == sizeof(record)) && (record.version == ROLE_VERSION))
+    role = record;
+
+#if DEVICE_ROLE_RUNTIME
+  if ((GPIO_PinInGet(PB0_port, PB0_pin) == 0) && (GPIO_PinInGet(PB1_port, PB1_pin) == 0))
+    {
+      // PB0 alone deletes the bondings too (BONDING_CLEAR_WITH_PB0), those of the old role are of no use
+      roleSave(!role.is_server, &role.server_address);
+      LOG_INFO("PB0+PB1 held at boot, role switched");
+    }
+#else
+  // Built for one role, only the server address comes from NVM
+  role.is_server = DEVICE_IS_BLE_SERVER;
+#endif
+
+  LOG_INFO("Role %s, server %02x:%02x:%02x:%02x:%02x:%02x", role.is_server ? "Server" : "Client",
+           role.server_address.addr[5], role.server_address.addr[4], role.server_address.addr[3],
+           role.server_address.addr[2], role.server_address.addr[1], role.server_address.addr[0]);
+#ifdef gattdb_device_role
+  write_role_attribute();
+#endif
+} // roleLoad()
+
+/**
+ * @brief Returns the role read by roleLoad(), always DEVICE_IS_BLE_SERVER without
+ *        DEVICE_ROLE_RUNTIME.
+ *
+ * @param none
+ *
+ * @return true for the server, false for the client
+ */
+bool roleIsServer(void)
+{
+  return (role.is_server != 0);
+} // roleIsServer()
+
+/**
+ * @brief Returns the address of the server the client connects to.
+ *
+ * @param none
+ *
+ * @return the address from NVM, SERVER_BT_ADDRESS if none was stored
+ */
+const bd_addr *roleServerAddress(void)
+{
+  return &role.server_address;
+} // roleServerAddress()
+
+/**
+ * @brief Stores a new role and server address. They are used from the next reset.
+ *
+ * @param is_server, true for the server, false for the client
+ * @param server_address, the server the client connects to
+ *
+ * @return true if saved
+ */
+bool roleSave(bool is_server, const bd_addr *server_address)
+{
+  role_record_t record;
+  sl_status_t   sc;
+
+  memset(&record, 0, sizeof(record));
+  record.version        = ROLE_VERSION;
+  record.is_server      = is_server;
+  record.server_address = *server_address;
+
+  sc = sl_bt_nvm_save(ROLE_NVM_KEY, sizeof(record), (const uint8_t *) &record);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_nvm_save() returned != 0 status=0x%04x", (unsigned int) sc);
+      return false;
+    }
+  role = record;
+  return true;
+} // roleSave()
+
+/**
+ * @brief Saves a role written to the device_role characteristic and resets into it
+ *        once the writer disconnects. Subscribe to sl_bt_evt_gatt_server_attribute_value_id.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void roleOnAttributeValue(sl_bt_msg_t *evt)
+{
+#ifdef gattdb_device_role
+  sl_bt_evt_gatt_server_attribute_value_t *written = &evt->data.evt_gatt_server_attribute_value;
+  bd_addr                                  address;
+
+  if (written->attribute != gattdb_device_role)
+    return;
+  if ((written->offset != 0) || (written->value.len != ROLE_VALUE_LEN) || (written->value.data[0] > 1))
+    {
+      LOG_ERROR("device_role write of %d bytes ignored", (int) written->value.len);
+      write_role_attribute(); // put the current role back
+      return;
+    }
+
+  memcpy(address.addr, &written->value.data[1], sizeof(address.addr));
+  if (roleSave(written->value.data[0], &address))
+    {
+      LOG_INFO("Role %s written by connection %d, reset when it closes",
+               written->value.data[0] ? "Server" : "Client", (int) written->connection);
+      reset_pending    = true;
+      reset_connection = written->connection;
+    }
+#else
+  (void) evt; // device_role is not in the GATT database
+#endif
+} // roleOnAttributeValue()
+
+/**
+ * @brief Resets into a role written over GATT once its connection closes.
+ *        Subscribe to sl_bt_evt_connection_closed_id.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void roleOnConnectionClosed(sl_bt_msg_t *evt)
+{
+  if (reset_pending && (evt->data.evt_connection_closed.connection == reset_connection))
+    sl_bt_system_reset(0);
+} // roleOnConnectionClosed()
@@ -0,0 +1,95 @@
+/*
+ * File name: role.h
+ * File description: This file declares the device role APIs. With DEVICE_ROLE_RUNTIME one
+ *                   image holds both the server and the client, and the role and the address
+ *                   of the server the client connects to are kept in NVM. The role is switched
+ *                   by holding PB0 and PB1 at reset, or written over the device_role
+ *                   characteristic by a bonded peer.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 5 (BT stack events)
+ *  [2] Silicon Labs Bluetooth API reference, NVM class https://docs.silabs.com/bluetooth/3.2/group-sl-bt-nvm
+ */
+#ifndef SRC_ROLE_H_
+#define SRC_ROLE_H_
+
+#include "app.h"
+
+// sl_bt_nvm_save() user key of the role record, clear of the GATT cache keys (src/gatt_cache.h)
+#define ROLE_NVM_KEY       (0x4010)
+// Bump when role_record_t changes so old records are ignored
+#define ROLE_VERSION       (1)
+// device_role characteristic value: role (1 server, 0 client), then the server bd_addr
+#define ROLE_VALUE_LEN     (7)
+
+// The role record, 8 bytes
+typedef struct
+{
+  uint8_t version;
+  uint8_t is_server;
+  bd_addr server_address;
+} role_record_t;
+
+/**
+ * @brief Reads the role record from NVM, the build defaults (DEVICE_IS_BLE_SERVER,
+ *        SERVER_BT_ADDRESS) if there is none. With DEVICE_ROLE_RUNTIME, PB0 and PB1 held
+ *        down switch the role and save it. Call from the boot event, before the role's
+ *        handlers are subscribed.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void roleLoad(void);
+
+/**
+ * @brief Returns the role read by roleLoad(), always DEVICE_IS_BLE_SERVER without
+ *        DEVICE_ROLE_RUNTIME.
+ *
+ * @param none
+ *
+ * @return true for the server, false for the client
+ */
+bool roleIsServer(void);
+
+/**
+ * @brief Returns the address of the server the client connects to.
+ *
+ * @param none
+ *
+ * @return the address from NVM, SERVER_BT_ADDRESS if none was stored
+ */
+const bd_addr *roleServerAddress(void);
+
+/**
+ * @brief Stores a new role and server address. They are used from the next reset.
+ *
+ * @param is_server, true for the server, false for the client
+ * @param server_address, the server the client connects to
+ *
+ * @return true if saved
+ */
+bool roleSave(bool is_server, const bd_addr *server_address);
+
+/**
+ * @brief Saves a role written to the device_role characteristic and resets into it
+ *        once the writer disconnects. Subscribe to sl_bt_evt_gatt_server_attribute_value_id.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void roleOnAttributeValue(sl_bt_msg_t *evt);
+
+/**
+ * @brief Resets into a role written over GATT once its connection closes.
+ *        Subscribe to sl_bt_evt_connection_closed_id.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void roleOnConnectionClosed(sl_bt_msg_t *evt);
+
+#endif /* SRC_ROLE_H_ */
@@ -0,0 +1,335 @@
+/*
+ * File name: sampler.c
+ * File description: This file defines the sampling period APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] Silicon Labs sleeptimer documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-sleeptimer
+ *  [2] Bluetooth Core Specification v5.2, Vol 6, Part B, 4.5.1 (connection events)
+ */
+
+#include "src/sampler.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+#if SAMPLER_ON_SLEEPTIMER
+
+static sl_sleeptimer_timer_handle_t timer;
+static uint32_t period_us = LETIMER_PERIOD_MS * 1000;
+
+// Open connections and the interval multiple each one allows, 0 if none within the slack
+typedef struct
+{
+  bool     in_use;
+  uint8_t  connection;
+  uint32_t period_us;
+} sampler_connection_t;
+
+static sampler_connection_t connections[SAMPLER_MAX_CONNECTIONS];
+// The connection the period follows, samples sit next to its events once phased
+static sampler_connection_t *anchor = NULL;
+static bool                  aligned = false;   // restarted right after an anchor event
+
+// Real time, from the sleeptimer
+static uint32_t last_tick;
+static uint64_t elapsed_ticks = 0;
+
+// LETIMER0 count at the previous sample, for the calibration
+static bool            have_last = false;
+static uint32_t        last_count;
+static uint32_t        last_top;
+static power_profile_t last_profile;
+static uint32_t        measured_hz = 0;
+
+// Since boot
+static volatile uint32_t samples = 0;
+static volatile uint32_t aligned_samples = 0;
+static volatile uint32_t corrections = 0;
+static volatile int32_t  drift_ms = 0;
+static volatile int32_t  max_drift_ms = 0;
+static uint32_t          last_report_ms = 0;
+
+/*
+ * @brief Measures the LETIMER0 clock over the sleeptimer ticks since the previous sample.
+ *        LETIMER0 wraps, the wraps are worked out from the clock it should run at.
+ * @param ticks, sleeptimer ticks since the previous sample
+ * @return none
+ */
+static void calibrate(uint32_t ticks)
+{
+  uint32_t        count   = LETIMER_CounterGet(LETIMER0);
+  uint32_t        top     = LETIMER_CompareGet(LETIMER0, 0);
+  power_profile_t profile = powerProfileGet();
+  uint32_t        st_hz   = sl_sleeptimer_get_timer_frequency();
+  uint32_t        modulus = top + 1; // counts top down to 0, then reloads
+  uint64_t        expected;
+  int32_t         diff;
+  uint64_t        counted;
+
+  if (have_last && (top == last_top) && (profile == last_profile) && (ticks > 0))
+    {
+      expected = ((uint64_t) powerProfileLetimerHz() * ticks) / st_hz;
+      // LETIMER0 ticks counted, modulo the reload, minus the expected ones folded into half a reload
+      diff = (int32_t) (((uint64_t) last_count + modulus - count + modulus - (expected % modulus)) % modulus);
+      if (diff > (int32_t) (modulus / 2))
+        diff -= (int32_t) modulus;
+      counted     = (uint64_t) ((int64_t) expected + diff);
+      measured_hz = (uint32_t) ((counted * st_hz) / ticks);
+      powerProfileCalibrate(measured_hz);
+    }
+
+  have_last    = true;
+  last_count   = count;
+  last_top     = top;
+  last_profile = profile;
+} // calibrate()
+
+/*
+ * @brief Posts the sampling period. Counts it for letimerMilliseconds(), once more or not
+ *        at all when the count is a period away from the sleeptimer. Sleeptimer callback,
+ *        interrupt context.
+ * @param handle, the timer
+ * @param data, unused
+ * @return none
+ */
+static void sample_tick(sl_sleeptimer_timer_handle_t *handle, void *data)
+{
+  uint32_t now   = sl_sleeptimer_get_tick_count();
+  uint32_t ticks = now - last_tick;
+  int64_t  real_ms;
+  int64_t  stamp_ms;
+  int      periods = 1;
+
+  (void) handle;
+  (void) data;
+  energyCountWakeup(WAKEUP_SAMPLER);
+  last_tick      = now;
+  elapsed_ticks += ticks;
+  samples++;
+  if (aligned)
+    aligned_samples++;
+
+  real_ms  = (int64_t) ((elapsed_ticks * 1000) / sl_sleeptimer_get_timer_frequency());
+  stamp_ms = (int64_t) letimerMilliseconds() + LETIMER_PERIOD_MS;
+  if ((real_ms - stamp_ms) >= LETIMER_PERIOD_MS)
+    periods = 2;
+  else if ((stamp_ms - real_ms) >= LETIMER_PERIOD_MS)
+    periods = 0;
+  if (periods != 1)
+    corrections++;
+  for (int i = 0; i < periods; i++)
+    letimerCountPeriod();
+
+  drift_ms = (int32_t) ((int64_t) letimerMilliseconds() - real_ms);
+  if (((drift_ms < 0) ? -drift_ms : drift_ms) > max_drift_ms)
+    max_drift_ms = (drift_ms < 0) ? -drift_ms : drift_ms;
+
+  calibrate(ticks);
+  schedulerSetEventUF();
+} // sample_tick()
+
+/*
+ * @brief Finds a connection's entry, or a free one
+ * @param connection, the connection
+ * @param add, take a free entry if it has none
+ * @return the entry, NULL if none
+ */
+static sampler_connection_t *find_connection(uint8_t connection, bool add)
+{
+  sampler_connection_t *free_entry = NULL;
+
+  for (int i = 0; i < SAMPLER_MAX_CONNECTIONS; i++)
+    {
+      if (connections[i].in_use && (connections[i].connection == connection))
+        return &connections[i];
+      if (!connections[i].in_use && (free_entry == NULL))
+        free_entry = &connections[i];
+    }
+  if (!add || (free_entry == NULL))
+    return NULL;
+  free_entry->in_use     = true;
+  free_entry->connection = connection;
+  free_entry->period_us  = 0;
+  return free_entry;
+} // find_connection()
+
+/*
+ * @brief The multiple of a connection interval closest to LETIMER_PERIOD_MS
+ * @param interval, the connection interval in 1.25 ms units
+ * @return the period in us, 0 if it is further than SAMPLER_ALIGN_SLACK_MS
+ */
+static uint32_t aligned_period_us(uint16_t interval)
+{
+  uint32_t interval_us = interval * 1250;
+  uint32_t intervals;
+  uint32_t us;
+
+  if (interval_us == 0)
+    return 0;
+  intervals = (LETIMER_PERIOD_MS * 1000 + interval_us / 2) / interval_us;
+  if (intervals == 0)
+    intervals = 1;
+  us = intervals * interval_us;
+  if ((us > (LETIMER_PERIOD_MS + SAMPLER_ALIGN_SLACK_MS) * 1000) ||
+      (us < (LETIMER_PERIOD_MS - SAMPLER_ALIGN_SLACK_MS) * 1000))
+    return 0;
+  return us;
+} // aligned_period_us()
+
+/*
+ * @brief Restarts the periodic timer now
+ * @param us, the period
+ * @return none
+ */
+static void restart(uint32_t us)
+{
+  uint32_t    ticks = (uint32_t) (((uint64_t) us * sl_sleeptimer_get_timer_frequency()) / 1000000);
+  sl_status_t sc;
+
+  period_us = us;
+  sc = sl_sleeptimer_restart_periodic_timer(&timer, ticks, sample_tick, NULL, 0, 0);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_sleeptimer_restart_periodic_timer() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+} // restart()
+
+/*
+ * @brief Moves the anchor to another open connection with a usable multiple after the
+ *        anchor closed or lost it. Its events have an unknown phase until its next
+ *        parameters event, the period already keeps samples at a fixed offset from them.
+ * @param none
+ * @return none
+ */
+static void pick_anchor(void)
+{
+  anchor  = NULL;
+  aligned = false;
+  for (int i = 0; i < SAMPLER_MAX_CONNECTIONS; i++)
+    {
+      if (connections[i].in_use && (connections[i].period_us != 0))
+        {
+          anchor = &connections[i];
+          break;
+        }
+    }
+  restart((anchor != NULL) ? anchor->period_us : LETIMER_PERIOD_MS * 1000);
+} // pick_anchor()
+
+/**
+ * @brief Starts the periodic timer. Call from app_init() after letimer0Init().
+ *
+ * @param none
+ *
+ * @return none
+ */
+void samplerInit(void)
+{
+  last_tick = sl_sleeptimer_get_tick_count();
+  restart(LETIMER_PERIOD_MS * 1000);
+} // samplerInit()
+
+/**
+ * @brief Aligns the period to a connection interval when a connection's parameters are
+ *        set, and to another open connection, or back to LETIMER_PERIOD_MS, when that
+ *        connection closes. With several connections the period follows one of them,
+ *        the anchor, the others are tracked to take over. Subscribe to
+ *        sl_bt_evt_connection_parameters_id and sl_bt_evt_connection_closed_id.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void samplerOnConnection(sl_bt_msg_t *evt)
+{
+  sampler_connection_t *entry;
+
+  switch (SL_BT_MSG_ID(evt->header))
+    {
+      case sl_bt_evt_connection_parameters_id:
+        entry = find_connection(evt->data.evt_connection_parameters.connection, true);
+        if (entry == NULL)
+          break;
+        entry->period_us = aligned_period_us(evt->data.evt_connection_parameters.interval);
+        if ((anchor != NULL) && (anchor != entry))
+          break; // the period follows another connection
+        if (entry->period_us == 0)
+          {
+            // No multiple close enough, another connection may have one
+            if (anchor == entry)
+              pick_anchor();
+            break;
+          }
+        // The event follows the connection event the parameters took effect on
+        anchor  = entry;
+        aligned = true;
+        restart(entry->period_us);
+        break;
+
+      case sl_bt_evt_connection_closed_id:
+        entry = find_connection(evt->data.evt_connection_closed.connection, false);
+        if (entry == NULL)
+          break;
+        entry->in_use = false;
+        if (anchor == entry)
+          pick_anchor();
+        break;
+
+      default:
+        break;
+    }
+} // samplerOnConnection()
+
+/**
+ * @brief Logs the samples, those aligned with connection events, the wakeups saved per
+ *        hour, the timestamp drift and the LETIMER0 clock calibration, every
+ *        SAMPLER_REPORT_PERIOD_MS. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void samplerReportIfDue(void)
+{
+  uint32_t now_ms  = letimerMilliseconds();
+  uint64_t real_ms = (elapsed_ticks * 1000) / sl_sleeptimer_get_timer_frequency();
+
+  if ((now_ms - last_report_ms) < SAMPLER_REPORT_PERIOD_MS)
+    return;
+  last_report_ms = now_ms;
+
+  // A sample next to a connection event shares its wakeup, on its own it is one more
+  LOG_INFO("Sampler: %u samples, %u with connection events (%u wakeups/hr saved), period %u us%s",
+           (unsigned int) samples, (unsigned int) aligned_samples,
+           (unsigned int) ((real_ms > 0) ? (((uint64_t) aligned_samples * MS_PER_HOUR) / real_ms) : 0),
+           (unsigned int) period_us, aligned ? " aligned" : "");
+  LOG_INFO("Sampler: timestamp drift %d ms, max %d ms, %u corrections, LETIMER0 %u Hz measured (%d ppm)",
+           (int) drift_ms, (int) max_drift_ms, (unsigned int) corrections,
+           (unsigned int) measured_hz, (int) powerProfileErrorPpm());
+} // samplerReportIfDue()
+
+/**
+ * @brief Returns the sampler counters. All 0 with SAMPLER_ON_SLEEPTIMER at 0.
+ *
+ * @param counters, filled in
+ *
+ * @return none
+ */
+void samplerGetCounters(sampler_counters_t *counters)
+{
+  counters->samples         = samples;
+  counters->aligned_samples = aligned_samples;
+  counters->corrections     = corrections;
+  counters->drift_ms        = drift_ms;
+  counters->max_drift_ms    = max_drift_ms;
+  counters->measured_hz     = measured_hz;
+} // samplerGetCounters()
+
+#else
+
+void samplerInit(void) {}
+void samplerOnConnection(sl_bt_msg_t *evt) { (void) evt; }
+void samplerReportIfDue(void) {}
+void samplerGetCounters(sampler_counters_t *counters) { memset(counters, 0, sizeof(*counters)); }
+
+#endif // SAMPLER_ON_SLEEPTIMER
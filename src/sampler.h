@@ -0,0 +1,90 @@
+/*
+ * File name: sampler.h
+ * File description: This file declares the sampling period APIs. The LETIMER_PERIOD_MS
+ *                   period that drives the measurements and reports (evtLETIMER0_UF) comes
+ *                   from an sl_sleeptimer periodic timer on the RTCC, the timer the BT stack
+ *                   and the LCD driver already wake up for, instead of the LETIMER0
+ *                   underflow interrupt. LETIMER0 keeps counting for the COMP1 delays and
+ *                   EXTCOMIN without waking the MCU. While connected, the period is rounded
+ *                   to a whole number of connection intervals and restarted at a connection
+ *                   parameters event so samples land next to connection events. With several
+ *                   connections, the period follows one of them until it closes. Each period
+ *                   also measures the LETIMER0 clock against the sleeptimer, which calibrates
+ *                   the ULFRCO, and keeps letimerMilliseconds() within a period of real time.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] Silicon Labs sleeptimer documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-sleeptimer
+ *  [2] Bluetooth Core Specification v5.2, Vol 6, Part B, 4.5.1 (connection events)
+ */
+#ifndef SRC_SAMPLER_H_
+#define SRC_SAMPLER_H_
+
+#include "app.h"
+
+// Set to 0 to go back to the LETIMER0 underflow interrupt. The host harness builds both
+// (-DSAMPLER_ON_SLEEPTIMER=0).
+#ifndef SAMPLER_ON_SLEEPTIMER
+#define SAMPLER_ON_SLEEPTIMER        1
+#endif
+// A connection interval multiple further than this from LETIMER_PERIOD_MS is not used
+#define SAMPLER_ALIGN_SLACK_MS       (300)
+// Connections whose intervals are tracked, the most the client or the server opens
+#define SAMPLER_MAX_CONNECTIONS      ((BLE_MAX_CLIENTS > BLE_MAX_SERVERS) ? BLE_MAX_CLIENTS : BLE_MAX_SERVERS)
+// How often the sampler counters are logged
+#define SAMPLER_REPORT_PERIOD_MS     (600000)
+
+// Sampler counters since boot, see samplerGetCounters()
+typedef struct
+{
+  uint32_t samples;
+  uint32_t aligned_samples;  // restarted right after an anchor connection event
+  uint32_t corrections;      // periods counted twice or not at all for letimerMilliseconds()
+  int32_t  drift_ms;         // letimerMilliseconds() less real time, at the last sample
+  int32_t  max_drift_ms;     // largest drift at a sample, its magnitude
+  uint32_t measured_hz;      // LETIMER0 clock measured against the sleeptimer, 0 until measured
+} sampler_counters_t;
+
+/**
+ * @brief Starts the periodic timer. Call from app_init() after letimer0Init().
+ *
+ * @param none
+ *
+ * @return none
+ */
+void samplerInit(void);
+
+/**
+ * @brief Aligns the period to a connection interval when a connection's parameters are
+ *        set, and to another open connection, or back to LETIMER_PERIOD_MS, when that
+ *        connection closes. With several connections the period follows one of them,
+ *        the anchor, the others are tracked to take over. Subscribe to
+ *        sl_bt_evt_connection_parameters_id and sl_bt_evt_connection_closed_id.
+ *
+ * @param evt, the BT stack event
+ *
+ * @return none
+ */
+void samplerOnConnection(sl_bt_msg_t *evt);
+
+/**
+ * @brief Logs the samples, those aligned with connection events, the wakeups saved per
+ *        hour, the timestamp drift and the LETIMER0 clock calibration, every
+ *        SAMPLER_REPORT_PERIOD_MS. Call from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void samplerReportIfDue(void);
+
+/**
+ * @brief Returns the sampler counters. All 0 with SAMPLER_ON_SLEEPTIMER at 0.
+ *
+ * @param counters, filled in
+ *
+ * @return none
+ */
+void samplerGetCounters(sampler_counters_t *counters);
+
+#endif /* SRC_SAMPLER_H_ */
@@ -0,0 +1,392 @@
+/*
+ * File name: scan_filter.c
+ * File description: This file defines the client scan filter APIs
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 8 (scanning, advertising data)
+ *  [2] Bluetooth Core Specification Supplement v9, Part A, 1.1-1.3 (AD types)
+ *  [3] Silicon Labs Bluetooth API reference, Scanner https://docs.silabs.com/bluetooth/3.2/group-sl-bt-scanner
+ *  [4] ARM Cortex-M4 Technical Reference Manual, DWT cycle counter
+ */
+
+#include "src/scan_filter.h"
+#include "em_device.h"
+#include "em_cmu.h"
+#include "sl_sleeptimer.h"
+#define INCLUDE_LOG_DEBUG 1
+#include "src/log.h"
+
+// Offset/length of each AD structure of interest in one report, 0 length = not present.
+// Built in one pass over the payload, then the criteria look their AD type up directly.
+typedef struct
+{
+  uint8_t offset[AD_TYPE_NAME_COMPLETE + 1];
+  uint8_t len[AD_TYPE_NAME_COMPLETE + 1];
+} ad_index_t;
+
+static uint64_t servers[SCAN_FILTER_MAX_SERVERS]; // 48-bit addresses, address type above them
+static uint8_t  server_count = 0;
+static uint8_t  service_uuid[16];
+static uint8_t  service_uuid_len = 0;
+static char     name_prefix[SCAN_FILTER_MAX_NAME_LEN + 1];
+static uint8_t  name_prefix_len = 0;
+
+static scan_filter_stats_t stats;
+static bool                scanning = false;
+static uint32_t            stage_start_ms;
+
+/*
+ * @brief Packs a Bluetooth address and its type into one word so they compare in a single
+ *        operation. A random address with the same 48 bits as a public one is another device.
+ * @param address, the address
+ * @param address_type, sl_bt_gap_address_type_t, an identity resolved from an RPA counts
+ *        as its public or random static type
+ * @return the address in the low 48 bits, public (0) or random (1) in bit 48
+ */
+static uint64_t addr48(const bd_addr *address, uint8_t address_type)
+{
+  uint64_t value = 0;
+
+  memcpy(&value, address->addr, sizeof(address->addr));
+  return value | ((uint64_t) (address_type & 0x01) << 48);
+} // addr48()
+
+/*
+ * @brief Indexes the AD structures of an advertising payload
+ * @param data, the payload
+ * @param index, returns the offset/length of each AD type of interest
+ * @return none
+ */
+static void ad_index_build(const uint8array *data, ad_index_t *index)
+{
+  uint8_t pos = 0;
+
+  memset(index, 0, sizeof(*index));
+  // Each AD structure: length (type + data), type, data
+  while ((pos + 1) < data->len)
+    {
+      uint8_t len  = data->data[pos];
+      uint8_t type = data->data[pos + 1];
+
+      if ((len == 0) || ((pos + 1 + len) > data->len))
+        break; // padding or a malformed structure, nothing more to use
+      if (type <= AD_TYPE_NAME_COMPLETE)
+        {
+          index->offset[type] = pos + 2;
+          index->len[type]    = len - 1;
+        }
+      pos += len + 1;
+    }
+} // ad_index_build()
+
+/*
+ * @brief Looks for the filter's service UUID in the UUID list AD structures
+ * @param data, the payload
+ * @param index, the payload's AD index
+ * @return true if listed
+ */
+static bool ad_has_service_uuid(const uint8array *data, const ad_index_t *index)
+{
+  uint8_t types[2];
+
+  if (service_uuid_len == 2)
+    {
+      types[0] = AD_TYPE_UUID16_INCOMPLETE;
+      types[1] = AD_TYPE_UUID16_COMPLETE;
+    }
+  else
+    {
+      types[0] = AD_TYPE_UUID128_INCOMPLETE;
+      types[1] = AD_TYPE_UUID128_COMPLETE;
+    }
+
+  for (int t = 0; t < 2; t++)
+    {
+      const uint8_t *list = &data->data[index->offset[types[t]]];
+
+      for (uint8_t i = 0; (i + service_uuid_len) <= index->len[types[t]]; i += service_uuid_len)
+        {
+          if (memcmp(&list[i], service_uuid, service_uuid_len) == 0)
+            return true;
+        }
+    }
+  return false;
+} // ad_has_service_uuid()
+
+/*
+ * @brief Checks the (short or complete) name AD structure against the filter's prefix
+ * @param data, the payload
+ * @param index, the payload's AD index
+ * @return true if the name starts with the prefix
+ */
+static bool ad_has_name_prefix(const uint8array *data, const ad_index_t *index)
+{
+  uint8_t type = (index->len[AD_TYPE_NAME_COMPLETE]) ? AD_TYPE_NAME_COMPLETE : AD_TYPE_NAME_SHORT;
+
+  return (index->len[type] >= name_prefix_len) &&
+         (memcmp(&data->data[index->offset[type]], name_prefix, name_prefix_len) == 0);
+} // ad_has_name_prefix()
+
+/*
+ * @brief Applies the scanner timing of a backoff stage and (re)starts scanning
+ * @param stage, backoff stage
+ * @return none
+ */
+static void scan_at_stage(uint8_t stage)
+{
+  sl_status_t sc;
+
+  if (scanning)
+    {
+      sc = sl_bt_scanner_stop();
+      if (sc != SL_STATUS_OK)
+        {
+          LOG_ERROR("sl_bt_scanner_stop() returned != 0 status=0x%04x", (unsigned int) sc);
+        }
+    }
+  // New timing only takes effect when scanning is (re)started
+  sc = sl_bt_scanner_set_timing(sl_bt_gap_1m_phy, SCAN_INTERVAL_STAGE0 << stage, SCAN_WINDOW);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_scanner_set_timing() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+  sc = sl_bt_scanner_start(sl_bt_gap_1m_phy, sl_bt_scanner_discover_generic);
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_scanner_start() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+  scanning       = (sc == SL_STATUS_OK);
+  stats.stage    = stage;
+  stage_start_ms = letimerMilliseconds();
+} // scan_at_stage()
+
+/**
+ * @brief Clears the filter and the statistics, and starts the DWT cycle counter used to
+ *        time the matcher. Call once from the boot event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void scanFilterInit(void)
+{
+  server_count     = 0;
+  service_uuid_len = 0;
+  name_prefix_len  = 0;
+  scanning         = false;
+  memset(&stats, 0, sizeof(stats));
+
+  cycleCounterInit();
+} // scanFilterInit()
+
+/**
+ * @brief Adds a server address to the set of targets.
+ *
+ * @param address, the server address
+ * @param address_type, its sl_bt_gap_address_type_t, reports of another type do not match
+ *
+ * @return true if added, false if the set is full
+ */
+bool scanFilterAddServer(const bd_addr *address, uint8_t address_type)
+{
+  if (server_count >= SCAN_FILTER_MAX_SERVERS)
+    return false;
+  servers[server_count++] = addr48(address, address_type);
+  return true;
+} // scanFilterAddServer()
+
+/**
+ * @brief Matches advertisers that list this service UUID. len 0 turns the criterion off.
+ *
+ * @param uuid, little endian UUID
+ * @param len, 2 or 16
+ *
+ * @return none
+ */
+void scanFilterSetServiceUuid(const uint8_t *uuid, uint8_t len)
+{
+  if ((len != 2) && (len != 16))
+    {
+      service_uuid_len = 0;
+      return;
+    }
+  memcpy(service_uuid, uuid, len);
+  service_uuid_len = len;
+} // scanFilterSetServiceUuid()
+
+/**
+ * @brief Matches advertisers whose (short or complete) name starts with prefix.
+ *        An empty string turns the criterion off.
+ *
+ * @param prefix, NUL terminated name prefix, at most SCAN_FILTER_MAX_NAME_LEN characters
+ *
+ * @return none
+ */
+void scanFilterSetNamePrefix(const char *prefix)
+{
+  size_t len = strlen(prefix);
+
+  if (len > SCAN_FILTER_MAX_NAME_LEN)
+    len = SCAN_FILTER_MAX_NAME_LEN;
+  memcpy(name_prefix, prefix, len);
+  name_prefix_len = (uint8_t) len;
+} // scanFilterSetNamePrefix()
+
+/**
+ * @brief Checks a scan report against the filter. The report must be connectable and
+ *        match at least one of the configured criteria (address set, service UUID, name).
+ *
+ * @param report, the sl_bt_evt_scanner_scan_report_id event data
+ *
+ * @return true on a match
+ */
+bool scanFilterMatch(const sl_bt_evt_scanner_scan_report_t *report)
+{
+  uint32_t   start = CYCLE_COUNT();
+  bool       match = false;
+  ad_index_t index;
+
+  stats.reports++;
+
+  // Bits 0..2: 000 connectable scannable undirected, 001 connectable undirected
+  if (((report->packet_type & 0x07) <= 0x01) && (report->address_type != 0xff))
+    {
+      uint64_t address = addr48(&report->address, report->address_type);
+
+      for (uint8_t i = 0; (i < server_count) && !match; i++)
+        match = (servers[i] == address);
+
+      if (!match && (service_uuid_len || name_prefix_len))
+        {
+          ad_index_build(&report->data, &index);
+          if (service_uuid_len)
+            match = ad_has_service_uuid(&report->data, &index);
+          if (!match && name_prefix_len)
+            match = ad_has_name_prefix(&report->data, &index);
+        }
+    }
+
+  if (match)
+    stats.matches++;
+  stats.match_cycles += (uint32_t) (CYCLE_COUNT() - start);
+  return match;
+} // scanFilterMatch()
+
+/**
+ * @brief Finds the first AD structure of a type in an advertising payload.
+ *
+ * @param data, the payload
+ * @param type, AD type
+ * @param len, returns the length of the AD data (type byte excluded)
+ *
+ * @return pointer to the AD data, NULL if not present
+ */
+const uint8_t *scanFilterFindAd(const uint8array *data, uint8_t type, uint8_t *len)
+{
+  uint8_t pos = 0;
+
+  // Same walk as ad_index_build(), for AD types outside the index
+  while ((pos + 1) < data->len)
+    {
+      uint8_t ad_len = data->data[pos];
+
+      if ((ad_len == 0) || ((pos + 1 + ad_len) > data->len))
+        break;
+      if (data->data[pos + 1] == type)
+        {
+          *len = ad_len - 1;
+          return &data->data[pos + 2];
+        }
+      pos += ad_len + 1;
+    }
+  return NULL;
+} // scanFilterFindAd()
+
+/**
+ * @brief Starts scanning at backoff stage 0 and restarts the time to connect measurement.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void scanFilterStartScan(void)
+{
+  stats.scan_start_tick    = sl_sleeptimer_get_tick_count();
+  stats.time_to_connect_ms = 0;
+  scan_at_stage(0);
+} // scanFilterStartScan()
+
+/**
+ * @brief Stops scanning, the target was found.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void scanFilterStopScan(void)
+{
+  sl_status_t sc;
+
+  if (!scanning)
+    return;
+  // Stop scanning for advertising devices
+  sc = sl_bt_scanner_stop();
+  if (sc != SL_STATUS_OK)
+    {
+      LOG_ERROR("sl_bt_scanner_stop() returned != 0 status=0x%04x", (unsigned int) sc);
+    }
+  scanning = false;
+} // scanFilterStopScan()
+
+/**
+ * @brief Records the scan on time to the connection and logs the statistics.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void scanFilterConnected(void)
+{
+  uint32_t cycles_per_ms = CMU_ClockFreqGet(cmuClock_CORE) / 1000;
+  // 64 bit intermediate, reports * cycles per ms overflows 32 bits quickly
+  uint32_t per_ms = (stats.match_cycles) ?
+                    (uint32_t) (((uint64_t) stats.reports * cycles_per_ms) / stats.match_cycles) : 0;
+
+  stats.time_to_connect_ms = sl_sleeptimer_tick_to_ms(sl_sleeptimer_get_tick_count() - stats.scan_start_tick);
+  LOG_INFO("Scan: connected %u ms after scan start (stage %u), %u reports, %u matched, %u reports/ms of CPU",
+           (unsigned int) stats.time_to_connect_ms, (unsigned int) stats.stage,
+           (unsigned int) stats.reports, (unsigned int) stats.matches, (unsigned int) per_ms);
+} // scanFilterConnected()
+
+/**
+ * @brief Steps the scan duty cycle down when no target has been seen for
+ *        SCAN_BACKOFF_PERIOD_MS. Call periodically, from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void scanFilterTick(void)
+{
+  if (!scanning || (stats.stage >= (SCAN_BACKOFF_STAGES - 1)))
+    return;
+  if ((letimerMilliseconds() - stage_start_ms) < SCAN_BACKOFF_PERIOD_MS)
+    return;
+
+  scan_at_stage(stats.stage + 1);
+  LOG_INFO("Scan: no target, backing off to interval %u ms",
+           (unsigned int) (((SCAN_INTERVAL_STAGE0 << stats.stage) * 5) / 8));
+} // scanFilterTick()
+
+/**
+ * @brief Returns the scan filter statistics.
+ *
+ * @param none
+ *
+ * @return pointer to the statistics
+ */
+const scan_filter_stats_t *scanFilterGetStats(void)
+{
+  return &stats;
+} // scanFilterGetStats()
@@ -0,0 +1,161 @@
+/*
+ * File name: scan_filter.h
+ * File description: This file declares the client scan filter APIs. Scan reports are matched
+ *                   against a set of server addresses and address types (one 64-bit compare
+ *                   each), a service UUID or a device name prefix, without any allocation,
+ *                   and the scan duty cycle is backed off while no target is seen.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] ECEN5823 IOT Embedded Firmware lecture slides week 8 (scanning, advertising data)
+ *  [2] Bluetooth Core Specification Supplement v9, Part A, 1.1-1.3 (AD types)
+ *  [3] Silicon Labs Bluetooth API reference, Scanner https://docs.silabs.com/bluetooth/3.2/group-sl-bt-scanner
+ */
+#ifndef SRC_SCAN_FILTER_H_
+#define SRC_SCAN_FILTER_H_
+
+#include "app.h"
+
+// Number of server addresses the filter can hold
+#define SCAN_FILTER_MAX_SERVERS    (4)
+// Longest name prefix accepted by scanFilterSetNamePrefix()
+#define SCAN_FILTER_MAX_NAME_LEN   (16)
+
+// AD types used by the matcher, Core Specification Supplement Part A
+#define AD_TYPE_FLAGS              (0x01)
+#define AD_TYPE_UUID16_INCOMPLETE  (0x02)
+#define AD_TYPE_UUID16_COMPLETE    (0x03)
+#define AD_TYPE_UUID128_INCOMPLETE (0x06)
+#define AD_TYPE_UUID128_COMPLETE   (0x07)
+#define AD_TYPE_NAME_SHORT         (0x08)
+#define AD_TYPE_NAME_COMPLETE      (0x09)
+#define AD_TYPE_MANUFACTURER       (0xff)
+
+/*
+ * Scan duty cycle backoff. While nothing matches, the scanner steps down one stage every
+ * SCAN_BACKOFF_PERIOD_MS. Stage 0 is the original 50 ms interval / 25 ms window (50 % duty),
+ * each later stage doubles the interval with the same window. Intervals in 0.625 ms units.
+ */
+#define SCAN_BACKOFF_PERIOD_MS     (30000)
+#define SCAN_BACKOFF_STAGES        (4)
+#define SCAN_WINDOW                (0x28)
+#define SCAN_INTERVAL_STAGE0       (0x50)
+
+typedef struct
+{
+  uint32_t reports;              // scan reports seen
+  uint32_t matches;              // reports that matched the filter
+  uint64_t match_cycles;         // CPU cycles spent in scanFilterMatch()
+  uint32_t scan_start_tick;      // sleeptimer tick the current scan started
+  uint32_t time_to_connect_ms;   // last scan start -> connection opened, 0 if not connected yet
+  uint8_t  stage;                // current backoff stage
+} scan_filter_stats_t;
+
+/**
+ * @brief Clears the filter and the statistics, and starts the DWT cycle counter used to
+ *        time the matcher. Call once from the boot event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void scanFilterInit(void);
+
+/**
+ * @brief Adds a server address to the set of targets.
+ *
+ * @param address, the server address
+ * @param address_type, its sl_bt_gap_address_type_t, reports of another type do not match
+ *
+ * @return true if added, false if the set is full
+ */
+bool scanFilterAddServer(const bd_addr *address, uint8_t address_type);
+
+/**
+ * @brief Matches advertisers that list this service UUID. len 0 turns the criterion off.
+ *
+ * @param uuid, little endian UUID
+ * @param len, 2 or 16
+ *
+ * @return none
+ */
+void scanFilterSetServiceUuid(const uint8_t *uuid, uint8_t len);
+
+/**
+ * @brief Matches advertisers whose (short or complete) name starts with prefix.
+ *        An empty string turns the criterion off.
+ *
+ * @param prefix, NUL terminated name prefix, at most SCAN_FILTER_MAX_NAME_LEN characters
+ *
+ * @return none
+ */
+void scanFilterSetNamePrefix(const char *prefix);
+
+/**
+ * @brief Checks a scan report against the filter. The report must be connectable and
+ *        match at least one of the configured criteria (address set, service UUID, name).
+ *
+ * @param report, the sl_bt_evt_scanner_scan_report_id event data
+ *
+ * @return true on a match
+ */
+bool scanFilterMatch(const sl_bt_evt_scanner_scan_report_t *report);
+
+/**
+ * @brief Finds the first AD structure of a type in an advertising payload.
+ *
+ * @param data, the payload
+ * @param type, AD type
+ * @param len, returns the length of the AD data (type byte excluded)
+ *
+ * @return pointer to the AD data, NULL if not present
+ */
+const uint8_t *scanFilterFindAd(const uint8array *data, uint8_t type, uint8_t *len);
+
+/**
+ * @brief Starts scanning at backoff stage 0 and restarts the time to connect measurement.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void scanFilterStartScan(void);
+
+/**
+ * @brief Stops scanning, the target was found.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void scanFilterStopScan(void);
+
+/**
+ * @brief Records the scan on time to the connection and logs the statistics.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void scanFilterConnected(void);
+
+/**
+ * @brief Steps the scan duty cycle down when no target has been seen for
+ *        SCAN_BACKOFF_PERIOD_MS. Call periodically, from the LETIMER0 UF event.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void scanFilterTick(void);
+
+/**
+ * @brief Returns the scan filter statistics.
+ *
+ * @param none
+ *
+ * @return pointer to the statistics
+ */
+const scan_filter_stats_t *scanFilterGetStats(void);
+
+#endif /* SRC_SCAN_FILTER_H_ */
@@ -36,7 +36,12 @@ typedef enum
   CHARACTERISTICS_DISCOVERED,
   SET_BUTTON_INDICATIONS,
   INDICATION_ENABLED,
-  WAIT_FOR_CLOSE
+  WAIT_FOR_CLOSE,
+  ALL_SERVICES_DISCOVERED,           // DISCOVERY_SINGLE_PASS
+  SERVICE_CHARACTERISTICS_DISCOVERED, // DISCOVERY_SINGLE_PASS
+  READ_CACHED_HASH,                  // GATT_CACHE_ENABLE, reconnect to a cached server
+  DISCOVER_GATT_SERVICE,             // GATT_CACHE_ENABLE, after a discovery by UUID
+  READ_DATABASE_HASH                 // GATT_CACHE_ENABLE, after a full discovery
 }Client_State_t; //States for discovery state machine
 
 
@@ -61,6 +66,21 @@ void schedulerSetEventUF(void)
 
 }
 
+/**
+ * @brief Sets the coalesced work due flag in the scheduler. Interrupt safe.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void schedulerSetEventCoalesce(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL(); // enter critical, turn off interrupts in NVIC
+  sl_bt_external_signal(evtCoalesce);
+  CORE_EXIT_CRITICAL(); // exit critical, re-enable interrupts in NVIC
+} // schedulerSetEventCoalesce()
+
 /**
  * @brief Sets the LETIMER0 COMP1 event flag in the scheduler.
  *
@@ -161,6 +181,23 @@ void schedulerSetEventPB1Released(void)
   CORE_EXIT_CRITICAL(); // exit critical, re-enable interrupts in NVIC
 }
 
+/**
+ *  @brief Sets debounced button flags in the scheduler, a press or release and the
+ *         gestures it completes, in one external signal
+ *
+ *  @param events, evtPB* flags
+ *
+ *  @return none
+ */
+void schedulerSetEventButtons(uint32_t events)
+{
+  CORE_DECLARE_IRQ_STATE;
+  // set event
+  CORE_ENTER_CRITICAL(); // enter critical, turn off interrupts in NVIC
+  sl_bt_external_signal(events);
+  CORE_EXIT_CRITICAL(); // exit critical, re-enable interrupts in NVIC
+}
+
 /**
  * @brief Retrieves the next pending event and clears the event
  *
@@ -226,7 +263,40 @@ uint32_t getNextEvent(void)
  *
  * @returns none
  */
-#if (DEVICE_IS_BLE_SERVER == 1)
+#if BUILD_INCLUDES_BLE_SERVER
+// EM1 keeps the I2C clock running for the duration of each transfer
+static em_token_t i2c_em_token = EM_TOKEN("si7021_i2c", SL_POWER_MANAGER_EM1);
+
+#if COALESCE_SENSOR_WAITS
+/*
+ * @brief End of a Si7021 wait, posted as the LETIMER0 COMP1 event it replaces
+ * @param none
+ * @return none
+ */
+static void sensor_wait_done(void)
+{
+  schedulerSetEventCOMP1();
+} // sensor_wait_done()
+
+static coalesce_job_t sensor_wait_job = COALESCE_JOB("si7021_wait", sensor_wait_done);
+#endif
+
+/*
+ * @brief Waits at least us for the Si7021, then posts evtLETIMER0_COMP1. With
+ *        COALESCE_SENSOR_WAITS the end of the wait rides on the next wakeup within
+ *        COALESCE_SENSOR_SLACK_MS instead of waking the MCU on its own.
+ * @param us, the wait
+ * @return none
+ */
+static void sensor_wait(uint32_t us)
+{
+#if COALESCE_SENSOR_WAITS
+  coalesceSchedule(&sensor_wait_job, us, COALESCE_SENSOR_SLACK_MS);
+#else
+  timerwaitUs_interrupt(us);
+#endif
+} // sensor_wait()
+
 void temperature_state_machine(sl_bt_msg_t *evt)
 {
   Server_State_t currentState;
@@ -240,23 +310,24 @@ void temperature_state_machine(sl_bt_msg_t *evt)
           // LOG_INFO("Entered Idle state\n\r");
           nextState = IDLE; //default
           // Transition to WAIT_FOR_STABILIZE when LETIMER0_UF event occurs
-          if(evt->data.evt_system_external_signal.extsignals == evtLETIMER0_UF)
+          if(evt->data.evt_system_external_signal.extsignals & evtLETIMER0_UF)
             {
               nextState = WAIT_FOR_STABILIZE;
               // Enable the si7021 sensor and wait for stabilization
               //si7021SetOn(); /*Enabled in displayInit() for A6*
-              timerwaitUs_interrupt(80000);
+              sensor_wait(80000);
             }
           break;
         case WAIT_FOR_STABILIZE:
           //LOG_INFO("Entered wait_statbilize state\n\r");
           nextState = WAIT_FOR_STABILIZE; //default
           // Transition to I2C_WRITE when LETIMER0_COMP1 event occurs
-          if(evt->data.evt_system_external_signal.extsignals == evtLETIMER0_COMP1)
+          if(evt->data.evt_system_external_signal.extsignals & evtLETIMER0_COMP1)
             {
               nextState = I2C_WRITE;
               // Add EM1 requirement and write to I2C
-              sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+              emTokenAcquire(&i2c_em_token);
+              energyLoadOn(ENERGY_LOAD_SI7021);
               Write_I2C(0xF3);
 
             }
@@ -265,24 +336,24 @@ void temperature_state_machine(sl_bt_msg_t *evt)
           //LOG_INFO("Entered Write state\n\r");
           nextState = I2C_WRITE; //default
           // Transition to WAIT_FOR_CONVERSION when I2C_Transfer_Complete event occurs
-          if(evt->data.evt_system_external_signal.extsignals == evtI2C_Transfer_Complete)
+          if(evt->data.evt_system_external_signal.extsignals & evtI2C_Transfer_Complete)
             {
               nextState = WAIT_FOR_CONVERSION;
               // Disable I2C interrupt and remove EM1 requirement, then wait for conversion
               NVIC_DisableIRQ(I2C0_IRQn);
-              sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
-              timerwaitUs_interrupt(10800);
+              emTokenRelease(&i2c_em_token);
+              sensor_wait(10800);
             }
           break;
         case WAIT_FOR_CONVERSION:
           //LOG_INFO("Entered wait_conversion state\n\r");
           nextState = WAIT_FOR_CONVERSION; //default
           // Transition to I2C_READ when LETIMER0_COMP1 event occurs
-          if(evt->data.evt_system_external_signal.extsignals == evtLETIMER0_COMP1)
+          if(evt->data.evt_system_external_signal.extsignals & evtLETIMER0_COMP1)
             {
               nextState = I2C_READ;
               // Add EM1 requirement and read from I2C
-              sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+              emTokenAcquire(&i2c_em_token);
               Read_I2C();
             }
           break;
@@ -290,24 +361,345 @@ void temperature_state_machine(sl_bt_msg_t *evt)
           //LOG_INFO("Entered Read state\n\r");
           nextState = I2C_READ; //default
           // Transition to IDLE when I2C_Transfer_Complete event occurs
-          if(evt->data.evt_system_external_signal.extsignals == evtI2C_Transfer_Complete)
+          if(evt->data.evt_system_external_signal.extsignals & evtI2C_Transfer_Complete)
             {
               nextState = IDLE;
               // Disable I2C interrupt, remove EM1 requirement, turn off si7021 sensor,
               // and read temperature from si7021
               NVIC_DisableIRQ(I2C0_IRQn);
-              sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+              emTokenRelease(&i2c_em_token);
               //si7021SetOff();
+              energyLoadOff(ENERGY_LOAD_SI7021);
               ble_write_temp_from_si7021();
             }
           break;
       }
     }
 }
+#endif
 
+#if BUILD_INCLUDES_BLE_CLIENT
+// One discovery state machine instance per connected server
+typedef struct
+{
+  Client_State_t     state;
+  uint8_t            service_index;   // DISCOVERY_SINGLE_PASS, next discovery table service
+  uint8_t            gatt_procedures; // procedures issued before indications flow
+#if GATT_CACHE_ENABLE
+  gatt_cache_entry_t cache_entry;
+  bool               db_hash_valid;   // hash read back matches cache_entry / was read
+  uint8_t            db_hash[GATT_DB_HASH_LEN];
+#endif
+} discovery_context_t;
+
+static discovery_context_t discovery_contexts[BLE_MAX_SERVERS];
+
+#if DISCOVERY_SINGLE_PASS
+/*
+ * @brief Starts characteristic discovery for the next discovery table service that was found
+ *
+ * @param server, the server being discovered
+ * @param service_index, in: first table index to try, out: index after the one started
+ *
+ * @returns true if a discovery was started, false when no services are left
+ */
+static bool discover_next_service_characteristics(ble_server_t *server, uint8_t *service_index)
+{
+  uint8_t                     count;
+  const gatt_service_entry_t *services = get_discovery_service_table(&count);
+  sl_status_t                 sc;
+
+  while (*service_index < count)
+    {
+      uint32_t service = DISCOVERED_SERVICE(server, &services[*service_index]);
+      (*service_index)++;
+      // Its Database Hash is read by UUID once the indications are enabled
+      if (services[*service_index - 1].offset == offsetof(ble_server_t, gatt_service_handle))
+        continue;
+      if (service == 0)
+        {
+          LOG_ERROR("Service %d not found on the server", (int) (*service_index - 1));
+          continue;
+        }
+      // All characteristics of the service, matched against the table in client_on_gatt_characteristic()
+      sc = sl_bt_gatt_discover_characteristics(server->connection, service);
+      if(sc != SL_STATUS_OK) {
+          LOG_ERROR("sl_bt_gatt_discover_characteristics() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
+          continue;
+      }
+      return true;
+    }
+  return false;
+} // discover_next_service_characteristics()
+#endif
+
+/*
+ * @brief Starts the full GATT discovery of the server
+ *
+ * @param server, the server to discover
+ *
+ * @returns the state that waits for the first discovery procedure
+ */
+static Client_State_t start_full_discovery(ble_server_t *server)
+{
+  sl_status_t sc;
+
+  clear_discovered_handles(server);
+#if DISCOVERY_SINGLE_PASS
+  // One pass over all primary services, the table in ble.c picks out the ones we need
+  sc = sl_bt_gatt_discover_primary_services(server->connection);
+  if(sc != SL_STATUS_OK) {
+      LOG_ERROR("sl_bt_gatt_discover_primary_services() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
+  }
+  return ALL_SERVICES_DISCOVERED;
 #else
+  uint8_t ServiceUUID[2] = {0x09,0x18};
+  // Discover primary services with health thermometer service UUID.
+  sc = sl_bt_gatt_discover_primary_services_by_uuid(server->connection,
+                                                    sizeof(ServiceUUID),
+                                                    (const uint8_t*)ServiceUUID);
+  if(sc != SL_STATUS_OK) {
+      LOG_ERROR("sl_bt_gatt_discover_primary_services_by_uuid() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
+  }
+  return DISCOVER_BUTTON_SERVICE;
+#endif
+} // start_full_discovery()
+
+/*
+ * @brief Enables indications on a characteristic, one of the two CCCD writes
+ *
+ * @param server, the server
+ * @param characteristic, HTM or button_state characteristic handle
+ *
+ * @returns true if the write was issued, a GATT procedure completed event follows.
+ *          false if the server does not have the characteristic or the write failed.
+ */
+static bool enable_indications(ble_server_t *server, uint16_t characteristic)
+{
+  sl_status_t sc;
+
+  // The handles are known by now, from discovery or the cache
+  clientValuesRegisterServer(server);
+  if (characteristic == 0)
+    return false; // not found on this server
+
+  sc = sl_bt_gatt_set_characteristic_notification(server->connection,
+                                                  characteristic,
+                                                  sl_bt_gatt_indication); // sl_bt_gatt_disable sl_bt_gatt_indication
+  if(sc != SL_STATUS_OK) {
+      LOG_ERROR("sl_bt_gatt_set_characteristic_notification() returned != 0 status=0x%04x\n\r", (unsigned int) sc);
+      return false;
+  }
+  return true;
+} // enable_indications()
+
+#if GATT_CACHE_ENABLE
+/*
+ * @brief Reads the database hash of the Generic Attribute service by UUID, the response
+ *        also carries the handle of the Database Hash characteristic
+ *
+ * @param server, the server
+ *
+ * @returns READ_DATABASE_HASH, or WAIT_FOR_CLOSE if the read could not be started
+ */
+static Client_State_t read_database_hash(ble_server_t *server)
+{
+  uint8_t     DatabaseHashUUID[2] = {0x2a, 0x2b};
+  sl_status_t sc;
+
+  sc = sl_bt_gatt_read_characteristic_value_by_uuid(server->connection,
+                                                    server->gatt_service_handle,
+                                                    sizeof(DatabaseHashUUID),
+                                                    (const uint8_t*)DatabaseHashUUID);
+  if(sc != SL_STATUS_OK) {
+      LOG_ERROR("sl_bt_gatt_read_characteristic_value_by_uuid() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
+      return WAIT_FOR_CLOSE;
+  }
+  return READ_DATABASE_HASH;
+} // read_database_hash()
+
+/*
+ * @brief Starts the database hash read after a full discovery, finding the Generic
+ *        Attribute service first when the discovery did not (discovery by UUID)
+ *
+ * @param server, the server
+ *
+ * @returns the next state
+ */
+static Client_State_t start_database_hash(ble_server_t *server)
+{
+  uint8_t     GattServiceUUID[2] = {0x01, 0x18};
+  sl_status_t sc;
+
+  if (server->gatt_service_handle != 0)
+    return read_database_hash(server);
+  sc = sl_bt_gatt_discover_primary_services_by_uuid(server->connection,
+                                                    sizeof(GattServiceUUID),
+                                                    (const uint8_t*)GattServiceUUID);
+  if(sc != SL_STATUS_OK) {
+      LOG_ERROR("sl_bt_gatt_discover_primary_services_by_uuid() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
+      return WAIT_FOR_CLOSE;
+  }
+  return DISCOVER_GATT_SERVICE;
+} // start_database_hash()
+#endif
+
+/*
+ * @brief Ends discovery on a server once its indications are enabled. After a full
+ *        discovery the database hash is read next for the cache, it does not hold up
+ *        the first indication.
+ *
+ * @param server, the server
+ * @param ctx, its discovery instance
+ *
+ * @returns the next state
+ */
+static Client_State_t discovery_done(ble_server_t *server, discovery_context_t *ctx)
+{
+  connParamsSetBusy(server->connection, CONN_BUSY_SETUP, false);
+  displayPrintf(DISPLAY_ROW_CONNECTION, "Handling indications");
+  LOG_INFO("Discovery done on connection %d, %u ms after open, %d GATT procedures",
+           (int) server->connection, (unsigned int) bleTraceMsSinceOpen(server->connection),
+           (int) ctx->gatt_procedures);
+#if GATT_CACHE_ENABLE
+  // db_hash_valid is only set here for handles restored from the cache
+  if (!ctx->db_hash_valid)
+    return start_database_hash(server);
+#endif
+  return WAIT_FOR_CLOSE;
+} // discovery_done()
+
+/*
+ * @brief Enables button_state indications, or ends discovery if there is nothing to enable
+ *
+ * @param server, the server
+ * @param ctx, its discovery instance
+ *
+ * @returns the next state
+ */
+static Client_State_t enable_button_indications(ble_server_t *server, discovery_context_t *ctx)
+{
+  if (enable_indications(server, server->button_characteristic_handle))
+    {
+      ctx->gatt_procedures++;
+      return INDICATION_ENABLED;
+    }
+  return discovery_done(server, ctx);
+} // enable_button_indications()
+
+/*
+ * @brief Enables HTM indications, or goes on to the button_state ones if the server
+ *        has no HTM characteristic
+ *
+ * @param server, the server
+ * @param ctx, its discovery instance
+ *
+ * @returns the next state
+ */
+static Client_State_t enable_htm_indications(ble_server_t *server, discovery_context_t *ctx)
+{
+  if (enable_indications(server, server->htm_characteristic_handle))
+    {
+      ctx->gatt_procedures++;
+      return SET_BUTTON_INDICATIONS;
+    }
+  return enable_button_indications(server, ctx);
+} // enable_htm_indications()
+
+#if GATT_CACHE_ENABLE
+/*
+ * @brief Copies the cached handles into the server's data
+ *
+ * @param server, the server
+ * @param entry, the cache record of the server
+ *
+ * @returns none
+ */
+static void restore_cached_handles(ble_server_t *server, const gatt_cache_entry_t *entry)
+{
+  server->htm_service_handle            = entry->htm_service;
+  server->htm_characteristic_handle     = entry->htm_characteristic;
+  server->button_service_handle         = entry->button_service;
+  server->button_characteristic_handle  = entry->button_characteristic;
+  server->db_hash_characteristic_handle = entry->db_hash_characteristic;
+  server->temperature_type_handle       = entry->temperature_type_characteristic;
+  server->measurement_interval_handle   = entry->measurement_interval_characteristic;
+} // restore_cached_handles()
+
+/*
+ * @brief Saves the handles found by a full discovery, keyed by server address and database hash
+ *
+ * @param server, the server
+ * @param db_hash, the database hash read from the server
+ *
+ * @returns none
+ */
+static void save_discovered_handles(const ble_server_t *server, const uint8_t *db_hash)
+{
+  gatt_cache_entry_t entry;
+
+  memset(&entry, 0, sizeof(entry));
+  entry.server                 = server->address;
+  memcpy(entry.db_hash, db_hash, GATT_DB_HASH_LEN);
+  entry.db_hash_characteristic = server->db_hash_characteristic_handle;
+  entry.htm_service            = server->htm_service_handle;
+  entry.htm_characteristic     = server->htm_characteristic_handle;
+  entry.button_service         = server->button_service_handle;
+  entry.button_characteristic  = server->button_characteristic_handle;
+  entry.temperature_type_characteristic     = server->temperature_type_handle;
+  entry.measurement_interval_characteristic = server->measurement_interval_handle;
+  gattCacheSave(&entry);
+} // save_discovered_handles()
+
+/*
+ * @brief Checks if an event is the read response carrying the database hash
+ *
+ * @param evt, Pointer to the Bluetooth event message
+ * @param att_opcode, sl_bt_gatt_read_response for a read by handle,
+ *                    sl_bt_gatt_read_by_type_response for a read by UUID
+ *
+ * @returns true if evt holds the full database hash
+ */
+static bool is_db_hash_read_response(sl_bt_msg_t *evt, uint8_t att_opcode)
+{
+  return (SL_BT_MSG_ID(evt->header) == sl_bt_evt_gatt_characteristic_value_id) &&
+         (evt->data.evt_gatt_characteristic_value.att_opcode == att_opcode) &&
+         (evt->data.evt_gatt_characteristic_value.value.len == GATT_DB_HASH_LEN);
+} // is_db_hash_read_response()
+#endif
+
+/*
+ * @brief Returns the connection a discovery related event belongs to
+ *
+ * @param evt, Pointer to the Bluetooth event message
+ * @param connection, returns the connection handle
+ *
+ * @returns false for events the discovery state machine does not use
+ */
+static bool event_connection(sl_bt_msg_t *evt, uint8_t *connection)
+{
+  switch (SL_BT_MSG_ID(evt->header))
+  {
+    case sl_bt_evt_connection_opened_id:
+      *connection = evt->data.evt_connection_opened.connection;
+      return true;
+    case sl_bt_evt_connection_closed_id:
+      *connection = evt->data.evt_connection_closed.connection;
+      return true;
+    case sl_bt_evt_gatt_procedure_completed_id:
+      *connection = evt->data.evt_gatt_procedure_completed.connection;
+      return true;
+    case sl_bt_evt_gatt_characteristic_value_id:
+      *connection = evt->data.evt_gatt_characteristic_value.connection;
+      return true;
+    default:
+      return false;
+  }
+} // event_connection()
+
 /**
- * @brief This function implements a state machine to handle BLE service discovery
+ * @brief This function implements a state machine to handle BLE service discovery.
+ *        Each connected server runs its own instance, selected by the event's connection.
  *
  * @param evt Pointer to the Bluetooth event message.
  *
@@ -315,76 +707,184 @@ void temperature_state_machine(sl_bt_msg_t *evt)
  */
 void discovery_state_machine(sl_bt_msg_t *evt)
 {
-  ble_data_struct_t *ble_data_ptr     = get_ble_data_ptr();
-
-         Client_State_t currentState;
-  static Client_State_t nextState     = IDLE_CLIENT;
+  ble_data_struct_t   *ble_data_ptr = get_ble_data_ptr();
+  ble_server_t        *server;
+  discovery_context_t *ctx;
+  uint8_t              connection;
+  Client_State_t       currentState;
 
   sl_status_t sc = SL_STATUS_OK;
 
+  if (!event_connection(evt, &connection))
+    return;
+  // ble.c has already freed the server of a closed connection, and a new connection
+  // restarts its instance below, so a close needs no handling here
+  server = get_server_by_connection(connection);
+  if (server == NULL)
+    return;
+  ctx = &discovery_contexts[server - &ble_data_ptr->servers[0]];
 
-  currentState = nextState;
+  if (SL_BT_MSG_ID(evt->header) == sl_bt_evt_connection_opened_id)
+    ctx->state = IDLE_CLIENT;
+
+  currentState = ctx->state;
 
   switch(currentState)
   {
     case IDLE_CLIENT:
       //DOS - No this was done in open_id event!!! ble_data_ptr->connection_handle = evt->data.evt_connection_opened.connection;
-      nextState = IDLE_CLIENT;  //default state
+      ctx->state = IDLE_CLIENT;  //default state
 
       // Check if a connection has been opened.
       if(SL_BT_MSG_ID(evt->header) == sl_bt_evt_connection_opened_id)
         {
-          uint8_t ServiceUUID[2] = {0x09,0x18};
-          // Discover primary services with health thermometer service UUID.
-          sc = sl_bt_gatt_discover_primary_services_by_uuid(ble_data_ptr->connection_handle,
-                                                            sizeof(ServiceUUID),
-                                                            (const uint8_t*)ServiceUUID);
-          if(sc != SL_STATUS_OK) {
-              LOG_ERROR("sl_bt_gatt_discover_primary_services_by_uuid() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
-          }
-          nextState = DISCOVER_BUTTON_SERVICE;
+          ctx->gatt_procedures = 1;
+#if GATT_CACHE_ENABLE
+          // Known server: read only the database hash, the handles are reused if it is unchanged
+          ctx->db_hash_valid = false;
+          if (gattCacheLoad(&server->address, &ctx->cache_entry))
+            {
+              sc = sl_bt_gatt_read_characteristic_value(server->connection,
+                                                        ctx->cache_entry.db_hash_characteristic);
+              if(sc == SL_STATUS_OK) {
+                  ctx->state = READ_CACHED_HASH;
+                  break;
+              }
+              LOG_ERROR("sl_bt_gatt_read_characteristic_value() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
+            }
+#endif
+          ctx->state = start_full_discovery(server);
+        }
+      break;
+
+#if GATT_CACHE_ENABLE
+    case READ_CACHED_HASH:
+      ctx->state = READ_CACHED_HASH;  //default state
+      if (is_db_hash_read_response(evt, sl_bt_gatt_read_response) &&
+          (evt->data.evt_gatt_characteristic_value.characteristic == ctx->cache_entry.db_hash_characteristic))
+        ctx->db_hash_valid = (memcmp(evt->data.evt_gatt_characteristic_value.value.data,
+                                     ctx->cache_entry.db_hash, GATT_DB_HASH_LEN) == 0);
+
+      // Check if a GATT procedure has been completed (database hash read)
+      if(SL_BT_MSG_ID(evt->header) == sl_bt_evt_gatt_procedure_completed_id)
+        {
+          if ((evt->data.evt_gatt_procedure_completed.result == 0) && ctx->db_hash_valid)
+            {
+              restore_cached_handles(server, &ctx->cache_entry);
+              bleTraceSetScenarioKind(server->connection, BLE_SCENARIO_CACHED_RECONNECT);
+              ctx->state = enable_htm_indications(server, ctx);
+              break;
+            }
+          // The server's database changed (or the read failed), forget it and discover again
+          LOG_INFO("GATT cache miss, database hash changed");
+          gattCacheErase(&server->address);
+          ctx->db_hash_valid = false;
+          ctx->gatt_procedures++;
+          ctx->state = start_full_discovery(server);
+        }
+      break;
+
+    case DISCOVER_GATT_SERVICE:
+      ctx->state = DISCOVER_GATT_SERVICE;  //default state
+      // Check if a GATT procedure has been completed (discover Generic Attribute service)
+      if(SL_BT_MSG_ID(evt->header) == sl_bt_evt_gatt_procedure_completed_id)
+        ctx->state = (server->gatt_service_handle != 0) ? read_database_hash(server) : WAIT_FOR_CLOSE;
+      break;
+
+    case READ_DATABASE_HASH:
+      ctx->state = READ_DATABASE_HASH;  //default state
+      // The read by UUID response names the Database Hash characteristic, cached for the reconnects
+      if (is_db_hash_read_response(evt, sl_bt_gatt_read_by_type_response))
+        {
+          server->db_hash_characteristic_handle = evt->data.evt_gatt_characteristic_value.characteristic;
+          memcpy(ctx->db_hash, evt->data.evt_gatt_characteristic_value.value.data, GATT_DB_HASH_LEN);
+          ctx->db_hash_valid = true;
+        }
+
+      // Check if a GATT procedure has been completed (database hash read)
+      if(SL_BT_MSG_ID(evt->header) == sl_bt_evt_gatt_procedure_completed_id)
+        {
+          if (ctx->db_hash_valid)
+            save_discovered_handles(server, ctx->db_hash);
+          ctx->state = WAIT_FOR_CLOSE;
+        }
+      break;
+#endif
+
+#if DISCOVERY_SINGLE_PASS
+    case ALL_SERVICES_DISCOVERED:
+      ctx->state = ALL_SERVICES_DISCOVERED;  //default state
+      // Check if a GATT procedure has been completed (discover all primary services)
+      if(SL_BT_MSG_ID(evt->header) == sl_bt_evt_gatt_procedure_completed_id)
+        {
+          ctx->service_index = 0;
+          if (discover_next_service_characteristics(server, &ctx->service_index))
+            {
+              ctx->gatt_procedures++;
+              ctx->state = SERVICE_CHARACTERISTICS_DISCOVERED;
+            }
+          else
+            ctx->state = WAIT_FOR_CLOSE; // nothing we can use on this server
         }
       break;
 
+    case SERVICE_CHARACTERISTICS_DISCOVERED:
+      ctx->state = SERVICE_CHARACTERISTICS_DISCOVERED;  //default state
+      // Check if a GATT procedure has been completed (characteristics of one service)
+      if(SL_BT_MSG_ID(evt->header) == sl_bt_evt_gatt_procedure_completed_id)
+        {
+          if (discover_next_service_characteristics(server, &ctx->service_index))
+            {
+              ctx->gatt_procedures++;
+              break;
+            }
+          // All services done, enable HTM indications
+          ctx->state = enable_htm_indications(server, ctx);
+        }
+      break;
+#endif
+
     case DISCOVER_BUTTON_SERVICE:
-      nextState = DISCOVER_BUTTON_SERVICE;  //default state
+      ctx->state = DISCOVER_BUTTON_SERVICE;  //default state
 
       // Check if a GATT procedure has been completed (discover htm service)
       if(SL_BT_MSG_ID(evt->header) == sl_bt_evt_gatt_procedure_completed_id)
         {
           uint8_t Button_ServiceUUID[16] = {0x89, 0x62, 0x13, 0x2d, 0x2a, 0x65, 0xec, 0x87, 0x3e, 0x43, 0xc8, 0x38, 0x01, 0x00, 0x00, 0x00};
           // Discover primary services with button service UUID.
-          sc = sl_bt_gatt_discover_primary_services_by_uuid(ble_data_ptr->connection_handle,
+          sc = sl_bt_gatt_discover_primary_services_by_uuid(server->connection,
                                                             sizeof(Button_ServiceUUID),
                                                             (const uint8_t*)Button_ServiceUUID);
           if(sc != SL_STATUS_OK) {
               LOG_ERROR("sl_bt_gatt_discover_primary_services_by_uuid() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
           }
-          nextState = SERVICES_DISCOVERED;
+          ctx->gatt_procedures++;
+          ctx->state = SERVICES_DISCOVERED;
         }
       break;
 
 
     case SERVICES_DISCOVERED:
-      nextState = SERVICES_DISCOVERED;  //default state
+      ctx->state = SERVICES_DISCOVERED;  //default state
       // Check if a GATT procedure has been completed (service discovery in this case).
       if(SL_BT_MSG_ID(evt->header) == sl_bt_evt_gatt_procedure_completed_id)
         {
           uint8_t CharacteristicUUID[2] = {0x1c, 0x2a}; //[2]
           // Discover characteristics for health thermometer UUID within the previously discovered service.
-          sc = sl_bt_gatt_discover_characteristics_by_uuid(ble_data_ptr->connection_handle,
-                                                           ble_data_ptr->htm_service_handle,
+          sc = sl_bt_gatt_discover_characteristics_by_uuid(server->connection,
+                                                           server->htm_service_handle,
                                                            sizeof(CharacteristicUUID),
                                                            (const uint8_t*)CharacteristicUUID);
           if(sc != SL_STATUS_OK) {
               LOG_ERROR("sl_bt_gatt_discover_characteristics_by_uuid() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
           }
-          nextState = DISCOVER_BUTTON_CHARACTERISTICS;
+          ctx->gatt_procedures++;
+          ctx->state = DISCOVER_BUTTON_CHARACTERISTICS;
         }
       break;
 
     case DISCOVER_BUTTON_CHARACTERISTICS:
-      nextState = DISCOVER_BUTTON_CHARACTERISTICS;  //default state
+      ctx->state = DISCOVER_BUTTON_CHARACTERISTICS;  //default state
 
 
       // Check if a GATT procedure has been completed (discover htm characteristics)
@@ -392,66 +892,54 @@ void discovery_state_machine(sl_bt_msg_t *evt)
         {
           uint8_t Button_CharacteristicUUID[16] = {0x89, 0x62, 0x13, 0x2d, 0x2a, 0x65, 0xec, 0x87, 0x3e, 0x43, 0xc8, 0x38, 0x02, 0x00, 0x00, 0x00};
           // Discover primary services with button service UUID.
-          sc = sl_bt_gatt_discover_characteristics_by_uuid(ble_data_ptr->connection_handle,
-                                                           ble_data_ptr->button_service_handle,
+          sc = sl_bt_gatt_discover_characteristics_by_uuid(server->connection,
+                                                           server->button_service_handle,
                                                            sizeof(Button_CharacteristicUUID),
                                                            (const uint8_t*)Button_CharacteristicUUID);
           if(sc != SL_STATUS_OK) {
               LOG_ERROR("sl_bt_gatt_discover_characteristics_by_uuid() returned != 0 status=0x%04x\n\r", (unsigned int)sc);
           }
-          nextState = CHARACTERISTICS_DISCOVERED;
+          ctx->gatt_procedures++;
+          ctx->state = CHARACTERISTICS_DISCOVERED;
         }
       break;
 
     case CHARACTERISTICS_DISCOVERED:
-      nextState = CHARACTERISTICS_DISCOVERED;  //default state
+      ctx->state = CHARACTERISTICS_DISCOVERED;  //default state
       // Check if a GATT procedure has been completed (button characteristic discovery in this case).
       if(SL_BT_MSG_ID(evt->header) == sl_bt_evt_gatt_procedure_completed_id)
         {
           // Enable indications for HTM char.
           //LOG_INFO("Enabling HTM indications");
-          sc = sl_bt_gatt_set_characteristic_notification(ble_data_ptr->connection_handle,
-                                                          ble_data_ptr->htm_characteristic_handle,
-                                                          sl_bt_gatt_indication); // sl_bt_gatt_disable sl_bt_gatt_indication
-          if(sc != SL_STATUS_OK) {
-              LOG_ERROR("sl_bt_gatt_set_characteristic_notification() returned != 0 status=0x%04x\n\r", (unsigned int) sc);
-          }
-          nextState = SET_BUTTON_INDICATIONS;
+          ctx->state = enable_htm_indications(server, ctx);
         }
       break;
 
     case SET_BUTTON_INDICATIONS:
-      nextState = SET_BUTTON_INDICATIONS; //default state
+      ctx->state = SET_BUTTON_INDICATIONS; //default state
       // Check if a GATT procedure has been completed (send htm indications).
       if(SL_BT_MSG_ID(evt->header) == sl_bt_evt_gatt_procedure_completed_id)
         {
           // Enable indications for button_state char.
           //LOG_INFO("Enabling BTN indications");
-          sc = sl_bt_gatt_set_characteristic_notification(ble_data_ptr->connection_handle,
-                                                          ble_data_ptr->button_characteristic_handle,
-                                                          sl_bt_gatt_indication);
-          if(sc != SL_STATUS_OK) {
-              LOG_ERROR("sl_bt_gatt_set_characteristic_notification() returned != 0 status=0x%04x\n\r", (unsigned int) sc);
-          }
-          nextState = INDICATION_ENABLED;
+          ctx->state = enable_button_indications(server, ctx);
         }
       break;
 
     case INDICATION_ENABLED:
-      nextState = INDICATION_ENABLED;  //default state
+      ctx->state = INDICATION_ENABLED;  //default state
       // Check if a GATT procedure has been completed (indication setup in this case).
       if(SL_BT_MSG_ID(evt->header) == sl_bt_evt_gatt_procedure_completed_id)
-        {
-          nextState = WAIT_FOR_CLOSE;
-          displayPrintf(DISPLAY_ROW_CONNECTION, "Handling indications");
-        }
+        ctx->state = discovery_done(server, ctx);
       break;
 
     case WAIT_FOR_CLOSE:
-      nextState = WAIT_FOR_CLOSE; //default state
-      // Check if the connection has been closed.
-      if(SL_BT_MSG_ID(evt->header) == sl_bt_evt_connection_closed_id)
-        nextState = IDLE_CLIENT;
+      ctx->state = WAIT_FOR_CLOSE; //default state
+      // The next sl_bt_evt_connection_opened_id for this slot restarts the instance
+      break;
+
+    default: // states of a discovery mode that is compiled out
+      ctx->state = IDLE_CLIENT;
       break;
 
   } // switch
@@ -462,4 +950,3 @@ void discovery_state_machine(sl_bt_msg_t *evt)
 
 
 
-
@@ -15,18 +15,37 @@
 #include "em_core.h"
 #include "app.h"
 enum {
-  evtLETIMER0_UF           = 0b0000001,
-  evtLETIMER0_COMP1        = 0b0000010,
-  evtI2C_Transfer_Complete = 0b0000100,
-  evtPB0_pressed           = 0b0001000,
-  evtPB0_released          = 0b0010000,
-  evtPB1_pressed           = 0b0100000,
-  evtPB1_released          = 0b1000000
+  evtLETIMER0_UF           = 0b0000000000001,
+  evtLETIMER0_COMP1        = 0b0000000000010,
+  evtI2C_Transfer_Complete = 0b0000000000100,
+  evtPB0_pressed           = 0b0000000001000,
+  evtPB0_released          = 0b0000000010000,
+  evtPB1_pressed           = 0b0000000100000,
+  evtPB1_released          = 0b0000001000000,
+  // Button gestures (src/buttons.h), set together with the press they complete
+  evtPB0_long_press        = 0b0000010000000,
+  evtPB0_double_click      = 0b0000100000000,
+  evtPB1_long_press        = 0b0001000000000,
+  evtPB1_double_click      = 0b0010000000000,
+  evtPB_chord              = 0b0100000000000, // both buttons down
+  evtCoalesce              = 0b1000000000000  // deferred work is due (src/coalesce.h)
 };
 
 #define CLEAR_EVENT 0
 #define MY_STATES 5
 
+// Client GATT discovery mode.
+// 1: single pass, one sl_bt_gatt_discover_primary_services() for all services, then one
+//    characteristic discovery per service in the discovery table, then the CCCD writes.
+//    The Generic Attribute service's characteristics are not discovered, its Database
+//    Hash is read by UUID after the CCCD writes (GATT_CACHE_ENABLE).
+// 0: discover each service and each characteristic by UUID, one procedure at a time.
+// The stack runs one GATT procedure per connection at a time, so the two CCCD writes
+// stay serialized in both modes. The host harness builds both (-DDISCOVERY_SINGLE_PASS=0).
+#ifndef DISCOVERY_SINGLE_PASS
+#define DISCOVERY_SINGLE_PASS 1
+#endif
+
 
 
 /**
@@ -38,6 +57,15 @@ enum {
  */
 void schedulerSetEventUF(void);
 
+/**
+ * @brief Sets the coalesced work due flag in the scheduler. Interrupt safe.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void schedulerSetEventCoalesce(void);
+
 /**
  * @brief Sets the LETIMER0 COMP1 event flag in the scheduler.
  *
@@ -91,6 +119,17 @@ void schedulerSetEventPB1Pressed(void);
  *  @return none
  */
 void schedulerSetEventPB0Released(void);
+
+/**
+ *  @brief Sets debounced button flags in the scheduler, a press or release and the
+ *         gestures it completes, in one external signal
+ *
+ *  @param events, evtPB* flags
+ *
+ *  @return none
+ */
+void schedulerSetEventButtons(uint32_t events);
+
 /*
  * @brief Retrieves the next pending event and clears the event
  *
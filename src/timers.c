@@ -13,6 +13,10 @@
 #include "src/log.h"
 #include <src/timers.h>
 
+#if LCD_EXTCOMIN_HW_TOGGLE && !SAMPLER_ON_SLEEPTIMER
+#error "LCD_EXTCOMIN_HW_TOGGLE reloads LETIMER0 every LCD_EXTCOMIN_PERIOD_MS, the LETIMER_PERIOD_MS sampling needs SAMPLER_ON_SLEEPTIMER"
+#endif
+
 /*
  * @brief Initializes the LETIMER0 peripheral with the specified configuration.
  *
@@ -31,7 +35,11 @@ void letimer0Init()
           false, // bufTop; don't load COMP1 into COMP0 when REP0==0
           0, // out0Pol; 0 default output pin value
           0, // out1Pol; 0 default output pin value
+#if LCD_EXTCOMIN_HW_TOGGLE
+          letimerUFOAToggle, // ufoa0; toggle OUT0 (LCD EXTCOMIN) on underflow
+#else
           letimerUFOANone, // ufoa0; no underflow output action
+#endif
           letimerUFOANone, // ufoa1; no underflow output action
           letimerRepeatFree, // repMode; free running mode i.e. load & go forever
           0 // COMP0(top) Value, I calculate this below
@@ -42,9 +50,18 @@ void letimer0Init()
   LETIMER_CompareSet(LETIMER0, 0, COMP0_LOAD);
   // calculate and load COMP1
   //LETIMER_CompareSet(LETIMER0, 1, COMP1_LOAD);
+#if LCD_EXTCOMIN_HW_TOGGLE
+  // OUT0 actions are only taken while REP0 != 0, REP0 is not decremented in free mode
+  LETIMER_RepeatSet(LETIMER0, 0, 1);
+  // Route OUT0 to PD13 (DISP_EXTCOMIN), LETIM0_OUT0 location 21 on EFR32BG13
+  LETIMER0->ROUTELOC0 = LETIMER_ROUTELOC0_OUT0LOC_LOC21;
+  LETIMER0->ROUTEPEN  = LETIMER_ROUTEPEN_OUT0PEN;
+#endif
   // Clear all IRQ flags in the LETIMER0 IF status register
   LETIMER_IntClear (LETIMER0, 0xFFFFFFFF); // punch them all down
+#if !SAMPLER_ON_SLEEPTIMER
   LETIMER_IntEnable (LETIMER0, LETIMER_IEN_UF); // Make sure you have defined the ISR routine LETIMER0_IRQHandler()
+#endif
   // Enable the timer to starting counting down, set LETIMER0_CMD[START] bit, see LETIMER0_STATUS[RUNNING] bit
   LETIMER_Enable (LETIMER0, true);
 } //letimer0Init()
@@ -64,23 +81,21 @@ void timerwaitUs_polled(uint32_t us)
       LOG_ERROR("Requested us delay is over the range. Clamped to max value: 8e6us\r\n");
       us = MAX_US_VAL;
     }
-  if(LOWEST_ENERGY_MODE == 3 && us< EM3_MIN_US_VAL)
+  // The target must be reached within one LETIMER0 reload
+  if (us >= LETIMER_RELOAD_MS * 1000)
     {
-      LOG_ERROR("Requested us delay is under the range. Clamped to min value: 1000us\r\n");
-      us = EM3_MIN_US_VAL;
+      LOG_ERROR("Requested us delay is over the LETIMER0 reload. Clamped to %uus\r\n", (unsigned int) (LETIMER_RELOAD_MS * 1000 - 1));
+      us = LETIMER_RELOAD_MS * 1000 - 1;
     }
-  if(LOWEST_ENERGY_MODE != 3 && us< EM_0TO2_MIN_US_VAL)
+  if(us < powerProfileMinUs())
     {
-      LOG_ERROR("Requested us delay is under the range. Clamped to min value: 123us\r\n");
-      us = EM_0TO2_MIN_US_VAL;
+      LOG_ERROR("Requested us delay is under the range. Clamped to min value: %uus\r\n", (unsigned int) powerProfileMinUs());
+      us = powerProfileMinUs();
     }
 
   uint32_t needed_ticks, current_tick, target_tick;
   // Calculate the number of timer ticks needed for the specified delay.
-  if(LOWEST_ENERGY_MODE == 3)
-    needed_ticks = us/ULFRCO;
-  else if(LOWEST_ENERGY_MODE != 3)
-    needed_ticks = PRESCALER_LFXO * us/LFXO;
+  needed_ticks = (uint32_t) (((uint64_t) us * ACTUAL_CLK_FREQ) / 1000000);
   current_tick = LETIMER_CounterGet(LETIMER0);
   // If time remaining is greater than current tick, count down from COMP0_LOAD.
   // Otherwise, count down from the current tick.
@@ -105,22 +120,20 @@ void timerwaitUs_interrupt(uint32_t us)
       LOG_ERROR("Requested us delay is over the range. Clamped to max value: 8e6us\r\n");
       us = MAX_US_VAL;
     }
-  if(LOWEST_ENERGY_MODE == 3 && us< EM3_MIN_US_VAL)
+  // The target must be reached within one LETIMER0 reload
+  if (us >= LETIMER_RELOAD_MS * 1000)
     {
-      LOG_ERROR("Requested us delay is under the range. Clamped to min value: 1000us\r\n");
-      us = EM3_MIN_US_VAL;
+      LOG_ERROR("Requested us delay is over the LETIMER0 reload. Clamped to %uus\r\n", (unsigned int) (LETIMER_RELOAD_MS * 1000 - 1));
+      us = LETIMER_RELOAD_MS * 1000 - 1;
     }
-  if(LOWEST_ENERGY_MODE != 3 && us< EM_0TO2_MIN_US_VAL)
+  if(us < powerProfileMinUs())
     {
-      LOG_ERROR("Requested us delay is under the range. Clamped to min value: 123us\r\n");
-      us = EM_0TO2_MIN_US_VAL;
+      LOG_ERROR("Requested us delay is under the range. Clamped to min value: %uus\r\n", (unsigned int) powerProfileMinUs());
+      us = powerProfileMinUs();
     }
 
   uint32_t needed_ticks, current_tick, target_tick;
-  if(LOWEST_ENERGY_MODE == 3)
-    needed_ticks = us/ULFRCO;
-  else if(LOWEST_ENERGY_MODE != 3)
-    needed_ticks = PRESCALER_LFXO * us * 10e3/LFXO;
+  needed_ticks = (uint32_t) (((uint64_t) us * ACTUAL_CLK_FREQ) / 1000000);
   current_tick = LETIMER_CounterGet(LETIMER0);
   // If time remaining is greater than current tick, count down from COMP0_LOAD.
   // Otherwise, count down from the current tick.
@@ -134,3 +147,17 @@ void timerwaitUs_interrupt(uint32_t us)
   letimer = LETIMER0;
   letimer->IEN |= LETIMER_IEN_COMP1;
 }
+
+/*
+ * @brief Starts the DWT cycle counter used to time code paths. Each module that times
+ *        with CYCLE_COUNT() calls it once, more calls do no harm.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void cycleCounterInit(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+} // cycleCounterInit()
@@ -38,13 +38,21 @@
 
 #define LETIMER_PERIOD_MS (3000)
 
-#if LOWEST_ENERGY_MODE == 3
-#define ACTUAL_CLK_FREQ 1000/ULFRCO_PRESCALER_VALUE
-#elif LOWEST_ENERGY_MODE !=3
-#define ACTUAL_CLK_FREQ 32768/LFXO_PRESCALER_VALUE
+// LETIMER0 clock of the power profile in use, src/power_profile.h
+#define ACTUAL_CLK_FREQ (powerProfileLetimerHz())
+
+/*
+ * LETIMER0 reload. With LCD_EXTCOMIN_HW_TOGGLE, OUT0 toggles EXTCOMIN on every underflow
+ * so LETIMER0 reloads every LCD_EXTCOMIN_PERIOD_MS, the sampling period then comes from
+ * the sleeptimer (SAMPLER_ON_SLEEPTIMER). src/lcd.h is included ahead of this file by app.h.
+ */
+#if LCD_EXTCOMIN_HW_TOGGLE
+#define LETIMER_RELOAD_MS (LCD_EXTCOMIN_PERIOD_MS)
+#else
+#define LETIMER_RELOAD_MS (LETIMER_PERIOD_MS)
 #endif
 
-#define COMP0_LOAD ((LETIMER_PERIOD_MS*ACTUAL_CLK_FREQ)/1000)
+#define COMP0_LOAD ((LETIMER_RELOAD_MS*ACTUAL_CLK_FREQ)/1000)
 
 /*
  * @brief Initializes the LETIMER0 peripheral with the specified configuration.
@@ -73,5 +81,21 @@ void timerwaitUs_polled(uint32_t us);
  */
 void timerwaitUs_interrupt(uint32_t us);
 
+// Core clock cycles, read after cycleCounterInit(), wraps every 2^32 cycles. The host
+// harness builds the benchmarks with its own clock, -D'CYCLE_COUNT()=hostCycleCount()'
+#ifndef CYCLE_COUNT
+#define CYCLE_COUNT() (DWT->CYCCNT)
+#endif
+
+/*
+ * @brief Starts the DWT cycle counter used to time code paths. Each module that times
+ *        with CYCLE_COUNT() calls it once, more calls do no harm.
+ *
+ * @param none
+ *
+ * @return none
+ */
+void cycleCounterInit(void);
+
 
 #endif /* SRC_TIMERS_H_ */
@@ -0,0 +1,25 @@
+/*
+ * File name: bench.c
+ * File description: This file runs the benchmark suite of src/bench.c on the host: the
+ *                   firmware is built with BENCH_ENABLE, the pairing crypto in the mbedtls C
+ *                   code, and CYCLE_COUNT() reading hostCycleCount(), so cycles are host time
+ *                   in HOST_CORE_HZ cycles. The suite runs from the boot event and its JSON
+ *                   lines are printed with the rest of the firmware log, "make bench" keeps
+ *                   only the JSON. The LCD cases time the host stubs of the LCD driver.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+int main(void)
+{
+  sl_bt_msg_t evt = { 0 };
+
+  hostReset(); // buttons up, PB0+PB1 held at boot would switch the role
+  app_init();
+  hostLogTo(stdout);
+  hostEvent(sl_bt_evt_system_boot_id, &evt);
+  hostLogTo(NULL);
+  return 0;
+} // main()
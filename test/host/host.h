@@ -0,0 +1,485 @@
+/*
+ * File name: host.h
+ * File description: This file declares the host harness APIs. The firmware (app.c and
+ *                   the sources in src) is built for Linux against the Gecko SDK headers,
+ *                   with the sl_bt, sl_sleeptimer, emlib and driver functions replaced by
+ *                   the stubs in test/host/stubs. The stubs log every sl_bt
+ *                   command, run the sleeptimer callbacks on a virtual clock and keep the
+ *                   peripheral registers in plain memory, so a test drives the firmware
+ *                   with BT events, pin levels and time and checks what it asked of the stack.
+ *                   hostRun() also runs the connections a test opened with hostLinkOpen()
+ *                   (indications are confirmed, parameter requests applied, radio time
+ *                   counted) and completes the I2C transfers to a model Si7021. For the
+ *                   client role, the peers added with hostPeerAdd() advertise, take the
+ *                   connections the firmware opens and serve its GATT procedures.
+ *                   With HOST_TRACE set in the environment (make V=1), every command and
+ *                   the firmware log are printed with the virtual time.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] Silicon Labs Bluetooth API reference https://docs.silabs.com/bluetooth/3.2/
+ *  [2] Silicon Labs sleeptimer documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-sleeptimer
+ */
+#ifndef TEST_HOST_HOST_H_
+#define TEST_HOST_HOST_H_
+
+#include <stdio.h>
+#include "app.h"
+
+// Sleeptimer clock, the LFXO on the board
+#define HOST_SLEEPTIMER_HZ    (32768)
+// ULFRCO of the model, 4.3% fast, in the 0.95 to 1.07 kHz of the datasheet
+#define HOST_ULFRCO_HZ        (1043)
+// EM0 time of a wakeup with nothing else to do, as COALESCE_WAKEUP_US
+#define HOST_WAKEUP_US        (300)
+// Core clock returned by CMU_ClockFreqGet(), also the DWT cycles per second
+#define HOST_CORE_HZ          (38400000)
+// Bytes of a command's payload kept in the call log
+#define HOST_BT_DATA_MAX      (32)
+
+// One sl_bt command the firmware called
+typedef struct
+{
+  const char *api;                    // function name, e.g. "sl_bt_gatt_server_send_indication"
+  uint32_t    args[4];                // integer arguments, in order
+  uint8_t     data[HOST_BT_DATA_MAX]; // payload, if the command has one
+  size_t      len;
+} host_bt_call_t;
+
+// One connection run by hostRun(), from the server's side
+typedef struct
+{
+  uint32_t events;        // connection events on the central's grid
+  uint32_t attended;      // events the server woke up for, the others were skipped (latency)
+  uint32_t lost;          // attended events whose packet from the central was lost
+  uint64_t radio_us;      // radio on time of the server
+  uint32_t indications;   // indications accepted from the firmware
+  uint32_t confirmations; // confirmations the central sent back
+  uint16_t interval;      // current parameters, interval in 1.25 ms units
+  uint16_t latency;
+  uint8_t  phy;           // sl_bt_gap_phy_1m, or sl_bt_gap_phy_2m once the firmware asked for it
+} host_link_stats_t;
+
+// The server's advertising set run by hostRun()
+typedef struct
+{
+  uint32_t events;        // advertising events, a PDU on each primary channel
+  uint64_t radio_us;      // radio on time of the advertising events
+} host_adv_stats_t;
+
+// One peer server run by hostRun(), see hostPeerAdd()
+typedef struct
+{
+  uint8_t  connection;          // last connection the firmware opened to it
+  uint32_t reports;             // advertising reports the firmware's scanner received
+  uint64_t connected_us;        // hostRun() time the last connection opened
+  uint64_t subscribed_us;       // last CCCD write answered
+  uint64_t first_indication_us; // first HTM indication sent on the last connection
+  uint32_t procedures;          // GATT procedures of the firmware completed
+  uint32_t round_trips;         // ATT requests answered, the MTU exchange included
+  uint32_t samples;             // HTM readings taken while subscribed
+  uint32_t indications;         // indications sent, HTM and button_state
+  uint32_t confirmations;       // confirmed by the firmware
+  uint64_t latency_sum_us;      // reading to confirmation
+  uint64_t latency_max_us;
+  uint64_t handler_cycles_sum;  // hostCycleCount() spent in sl_bt_on_event() per indication
+  uint32_t handler_cycles_max;
+  uint64_t security_us;         // sl_bt_sm_increase_security() on the last connection, 0 if none
+  uint64_t encrypted_us;        // link encrypted on the last connection, 0 if it is not
+  uint32_t security_round_trips; // SMP and LL encryption round trips, the wait for the passkey not included
+  uint64_t passkey_wait_us;     // sl_bt_evt_sm_confirm_passkey_id to sl_bt_sm_passkey_confirm(), last pairing
+  uint32_t pairings;            // pairings completed, each stored a bond on both sides
+} host_peer_stats_t;
+
+// The MCU's wakeups since hostReset()
+typedef struct
+{
+  uint32_t wakeups;  // out of EM1 to EM3, one that starts while the MCU is awake is not counted
+  uint32_t shared;   // started while the MCU was awake for another, no wakeup of their own
+  uint64_t awake_us; // EM0 time, HOST_WAKEUP_US per wakeup or a connection event's radio time
+} host_wakeup_stats_t;
+
+/**
+ * @brief Maps the peripheral and core register ranges as plain memory. Called once
+ *        before main(), register reads return what was last written there.
+ */
+void hostInit(void);
+
+/**
+ * @brief Starts a test over: clears the call log, the signals, the pending timers and the
+ *        forced statuses, sets the clock to 0 and drives every GPIO input high (buttons up).
+ *        Module state in the firmware is not reset.
+ */
+void hostReset(void);
+
+// Virtual clock
+
+/**
+ * @brief Moves the sleeptimer clock forward, running every timer callback that falls due
+ *        on the way, at its own tick, in order.
+ *
+ * @param ticks, sleeptimer ticks
+ */
+void hostAdvanceTicks(uint32_t ticks);
+
+/**
+ * @brief Moves the sleeptimer clock forward, see hostAdvanceTicks().
+ *
+ * @param ms, milliseconds
+ */
+void hostAdvanceMs(uint32_t ms);
+
+/**
+ * @brief Moves the sleeptimer clock to a point in time, see hostAdvanceTicks().
+ *
+ * @param us, microseconds since hostReset(), not before the current time
+ */
+void hostAdvanceToUs(uint64_t us);
+
+/**
+ * @brief Returns the sleeptimer clock.
+ *
+ * @return ticks since hostReset()
+ */
+uint32_t hostNowTicks(void);
+
+// GPIO
+
+/**
+ * @brief Sets the level GPIO_PinInGet() reads on a pin.
+ *
+ * @param port, the port
+ * @param pin, the pin
+ * @param level, 0 or 1
+ */
+void hostSetPin(GPIO_Port_TypeDef port, unsigned int pin, unsigned int level);
+
+/**
+ * @brief Sets a pin and raises its external interrupt: the flag is set and the pin's
+ *        GPIO_EVEN_IRQHandler() or GPIO_ODD_IRQHandler() runs, as on an edge.
+ *
+ * @param port, the port
+ * @param pin, the pin, also the interrupt number
+ * @param level, 0 or 1
+ */
+void hostPinEdge(GPIO_Port_TypeDef port, unsigned int pin, unsigned int level);
+
+// sl_bt commands and events
+
+/**
+ * @brief Returns how many times a command was called since hostReset().
+ *
+ * @param api, the function name
+ *
+ * @return the count
+ */
+uint32_t hostBtCount(const char *api);
+
+/**
+ * @brief Returns the last call of a command.
+ *
+ * @param api, the function name
+ *
+ * @return the call, NULL if it was not called since hostReset()
+ */
+const host_bt_call_t *hostBtLast(const char *api);
+
+/**
+ * @brief Also writes every sl_bt command to a file, one line each as HOST_TRACE prints it.
+ *
+ * @param file, the file, NULL to stop
+ */
+void hostBtJournalTo(FILE *file);
+
+/**
+ * @brief Makes the next call of a command return a status, SL_STATUS_OK otherwise.
+ *
+ * @param api, the function name
+ * @param status, the status
+ */
+void hostBtFailNext(const char *api, sl_status_t status);
+
+/**
+ * @brief Returns how many times a signal bit was posted with sl_bt_external_signal()
+ *        since hostReset().
+ *
+ * @param signal, one evt* bit
+ *
+ * @return the count
+ */
+uint32_t hostSignalCount(uint32_t signal);
+
+/**
+ * @brief Returns the signals posted and not delivered yet, and forgets them.
+ *
+ * @return the evt* bits
+ */
+uint32_t hostTakeSignals(void);
+
+/**
+ * @brief Delivers the pending signals to sl_bt_on_event() as one
+ *        sl_bt_evt_system_external_signal event, as the stack does.
+ *
+ * @return the evt* bits delivered, 0 if none was pending
+ */
+uint32_t hostDeliverSignals(void);
+
+/**
+ * @brief Hands a BT event to the firmware through sl_bt_on_event().
+ *
+ * @param id, sl_bt_evt_*_id
+ * @param evt, the event, its header (id and payload length) is filled in here
+ */
+void hostEvent(uint32_t id, sl_bt_msg_t *evt);
+
+// Connections and the run loop
+
+/**
+ * @brief Runs the firmware for a while as the board would: the clock moves in steps of at
+ *        most 1 ms, and after each step the I2C transfer in flight completes, the posted
+ *        signals are delivered and the connection events that fell due run.
+ *
+ * @param ms, milliseconds
+ */
+void hostRun(uint32_t ms);
+
+/**
+ * @brief A central connects: sends the firmware sl_bt_evt_connection_opened_id (not
+ *        bonded) and sl_bt_evt_connection_parameters_id, and hostRun() runs the connection
+ *        events from one interval on.
+ *
+ * @param connection, the handle, not 0
+ * @param interval, 1.25 ms units
+ * @param latency, peripheral latency in events
+ * @param loss_percent, share of the events whose packet from the central is lost
+ */
+void hostLinkOpen(uint8_t connection, uint16_t interval, uint16_t latency, uint8_t loss_percent);
+
+/**
+ * @brief The central disconnects: sends the firmware sl_bt_evt_connection_closed_id.
+ *
+ * @param connection, the handle
+ */
+void hostLinkClose(uint8_t connection);
+
+/**
+ * @brief The central writes a CCCD: sends the firmware
+ *        sl_bt_evt_gatt_server_characteristic_status_id with sl_bt_gatt_server_client_config.
+ *
+ * @param connection, the handle
+ * @param characteristic, the characteristic, gattdb_*
+ * @param flags, sl_bt_gatt_indication, sl_bt_gatt_disable, ...
+ */
+void hostLinkSubscribe(uint8_t connection, uint16_t characteristic, uint16_t flags);
+
+/**
+ * @brief Makes the centrals that connect from now on reject the firmware's parameter
+ *        requests, their connections keep the parameters they were opened with.
+ *
+ * @param hold, true to reject, false to accept (after hostReset())
+ */
+void hostLinkHoldParameters(bool hold);
+
+/**
+ * @brief Makes the centrals that connect from now on refuse the firmware's 2M PHY
+ *        request, their connections stay on 1M and the firmware is told so in
+ *        sl_bt_evt_connection_phy_status_id.
+ *
+ * @param hold, true to refuse, false to accept (after hostReset())
+ */
+void hostLinkHoldPhy(bool hold);
+
+/**
+ * @brief Returns the advertising events of the server's advertising set since
+ *        hostReset(). The stack stops the set when a central connects, the firmware
+ *        starts it again.
+ *
+ * @return the counts
+ */
+const host_adv_stats_t *hostAdvertiserStats(void);
+
+/**
+ * @brief Returns what happened on a connection since it was opened.
+ *
+ * @param connection, the handle
+ *
+ * @return the counts, NULL if the connection is not open
+ */
+const host_link_stats_t *hostLinkStats(uint8_t connection);
+
+// Peer servers, for the client role
+
+/**
+ * @brief Adds a thermometer server that advertises the Health Thermometer service. The
+ *        firmware's sl_bt_connection_open() connects to it at its next advertising event,
+ *        and hostRun() runs the connection with the firmware as the central: the peer
+ *        answers the firmware's GATT procedures from the server's database
+ *        (autogen/gatt_db.c) one ATT round trip per connection event, and indicates
+ *        25 C every 3 s once subscribed. button_state needs an encrypted link: the
+ *        firmware's sl_bt_sm_increase_security() pairs with LE Secure Connections numeric
+ *        comparison, or resumes encryption if both sides kept the bond of an earlier
+ *        pairing. See stubs/peer_stub.c.
+ *
+ * @param address, the peer's public address
+ *
+ * @return the peer, -1 if there is no room
+ */
+int hostPeerAdd(const bd_addr *address);
+
+/**
+ * @brief Sets a peer's button_state, indicated if the firmware subscribed.
+ *
+ * @param peer, the peer
+ * @param pressed, the state
+ */
+void hostPeerButton(int peer, bool pressed);
+
+/**
+ * @brief Returns what happened on a peer since it was added.
+ *
+ * @param peer, the peer
+ *
+ * @return the counts, NULL if there is no such peer
+ */
+const host_peer_stats_t *hostPeerStats(int peer);
+
+// Energy modes and LETIMER0
+
+/**
+ * @brief Returns the mode the MCU sleeps in between wakeups, the lowest the firmware's EM
+ *        requirements allow. The power manager transition subscribers see every wakeup.
+ *
+ * @return SL_POWER_MANAGER_EM1 to SL_POWER_MANAGER_EM3
+ */
+sl_power_manager_em_t hostSleepEm(void);
+
+/**
+ * @brief Calls the power manager transition subscribers. A wakeup goes from hostSleepEm()
+ *        to SL_POWER_MANAGER_EM0 and back once the firmware returns.
+ *
+ * @param from, the mode left
+ * @param to, the mode entered
+ */
+void hostEmTransition(sl_power_manager_em_t from, sl_power_manager_em_t to);
+
+/**
+ * @brief Returns the MCU's wakeups since hostReset(): sleeptimer callbacks, LETIMER0,
+ *        GPIO and I2C interrupts and the connection events the device attends.
+ *
+ * @return the counts
+ */
+const host_wakeup_stats_t *hostWakeups(void);
+
+/**
+ * @brief Returns the clock LETIMER0 really counts at: the LFA clock the firmware selected,
+ *        the LFXO or the ULFRCO at HOST_ULFRCO_HZ, over its prescaler.
+ *
+ * @return clock in Hz
+ */
+uint32_t hostLetimerHz(void);
+
+// I2C
+
+/**
+ * @brief Sets the temperature the model Si7021 reads back, 25 C after hostReset().
+ *
+ * @param celsius, the temperature
+ */
+void hostSi7021Set(float celsius);
+
+/**
+ * @brief Returns how many I2C transfers the firmware started since hostReset().
+ *
+ * @return the count
+ */
+uint32_t hostI2cTransfers(void);
+
+/**
+ * @brief Completes the I2C transfer in flight: a read gets the Si7021 reading and
+ *        I2C0_IRQHandler() runs as on the last byte. hostRun() calls it every step.
+ *
+ * @return true if a transfer was in flight
+ */
+bool hostI2cComplete(void);
+
+// Benchmarks
+
+/**
+ * @brief Returns the host's monotonic clock in HOST_CORE_HZ cycles. CYCLE_COUNT() in the
+ *        benchmark build, see bench.c.
+ *
+ * @return the cycles, wrapping every 2^32
+ */
+uint32_t hostCycleCount(void);
+
+// Firmware log
+
+/**
+ * @brief Also writes the firmware log (LOG_INFO() and friends) to a file.
+ *
+ * @param file, the file, NULL to stop
+ */
+void hostLogTo(FILE *file);
+
+// Checks
+
+extern int host_checks;
+extern int host_failures;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    host_checks++;                                                             \
+    if (!(cond)) {                                                             \
+      host_failures++;                                                         \
+      printf("%s:%d: %s: CHECK(%s) failed\n", __FILE__, __LINE__, __func__, #cond); \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                         \
+  do {                                                                         \
+    long long a_ = (long long) (a), b_ = (long long) (b);                      \
+    host_checks++;                                                             \
+    if (a_ != b_) {                                                            \
+      host_failures++;                                                         \
+      printf("%s:%d: %s: %s == %lld, expected %s == %lld\n", __FILE__, __LINE__, __func__, \
+             #a, a_, #b, b_);                                                  \
+    }                                                                          \
+  } while (0)
+
+// Runs one test from a fresh hostReset()
+#define RUN(test)                                                              \
+  do {                                                                         \
+    int failures_ = host_failures;                                             \
+    hostReset();                                                               \
+    test();                                                                    \
+    printf("%-48s %s\n", #test, (host_failures == failures_) ? "ok" : "FAILED"); \
+  } while (0)
+
+// Runs one test from a board reset: in a child process, so the firmware's module state and
+// timers start over, app_init() and the boot event run before the test
+#define RUN_BOOTED(test)                                                       \
+  do {                                                                         \
+    int failures_ = hostRunBooted(test);                                       \
+    printf("%-48s %s\n", #test, (failures_ == 0) ? "ok" : "FAILED");           \
+  } while (0)
+
+/**
+ * @brief Runs a test in a child process after hostReset(), app_init() and
+ *        sl_bt_evt_system_boot_id, and adds its checks to the totals. See RUN_BOOTED().
+ *
+ * @param test, the test
+ *
+ * @return the failed checks of the test
+ */
+int hostRunBooted(void (*test)(void));
+
+/**
+ * @brief Prints the check totals.
+ *
+ * @param name, the test program
+ *
+ * @return the exit status, 0 if every check passed
+ */
+int hostSummary(const char *name);
+
+#endif /* TEST_HOST_HOST_H_ */
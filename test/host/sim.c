@@ -0,0 +1,174 @@
+/*
+ * File name: sim.c
+ * File description: This file runs a scenario on the host, "make sim SCENARIO=file". A
+ *                   scenario is an event recorder dump (src/event_recorder.h), as the board
+ *                   logs it to the VCOM port or as in scenarios/. Each record is handed to
+ *                   sl_bt_on_event() at its recorded time, as test_replay.c does, and printed
+ *                   as one line of the timeline. At the end the modelled average current and
+ *                   the energy per hour of src/energy.c over the scenario are printed.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// The events the firmware handles, see sl_bt_on_event() and the state machines
+static const struct
+{
+  uint32_t    id;
+  const char *name;
+} event_names[] =
+{
+  { sl_bt_evt_system_boot_id,                      "system_boot" },
+  { sl_bt_evt_system_external_signal_id,           "external_signal" },
+  { sl_bt_evt_system_soft_timer_id,                "soft_timer" },
+  { sl_bt_evt_connection_opened_id,                "connection_opened" },
+  { sl_bt_evt_connection_parameters_id,            "connection_parameters" },
+  { sl_bt_evt_connection_phy_status_id,            "connection_phy_status" },
+  { sl_bt_evt_connection_closed_id,                "connection_closed" },
+  { sl_bt_evt_scanner_scan_report_id,              "scan_report" },
+  { sl_bt_evt_sm_confirm_bonding_id,               "sm_confirm_bonding" },
+  { sl_bt_evt_sm_confirm_passkey_id,               "sm_confirm_passkey" },
+  { sl_bt_evt_sm_bonded_id,                        "sm_bonded" },
+  { sl_bt_evt_sm_bonding_failed_id,                "sm_bonding_failed" },
+  { sl_bt_evt_gatt_mtu_exchanged_id,               "gatt_mtu_exchanged" },
+  { sl_bt_evt_gatt_service_id,                     "gatt_service" },
+  { sl_bt_evt_gatt_characteristic_id,              "gatt_characteristic" },
+  { sl_bt_evt_gatt_characteristic_value_id,        "gatt_characteristic_value" },
+  { sl_bt_evt_gatt_procedure_completed_id,         "gatt_procedure_completed" },
+  { sl_bt_evt_gatt_server_attribute_value_id,      "gatt_server_attribute_value" },
+  { sl_bt_evt_gatt_server_characteristic_status_id, "gatt_server_characteristic_status" },
+  { sl_bt_evt_gatt_server_indication_timeout_id,   "gatt_server_indication_timeout" },
+};
+
+// The evt* bits of src/scheduler.h, in bit order
+static const char *signal_names[] =
+{
+  "LETIMER0_UF", "LETIMER0_COMP1", "I2C_Transfer_Complete", "PB0_pressed", "PB0_released",
+  "PB1_pressed", "PB1_released", "PB0_long_press", "PB0_double_click", "PB1_long_press",
+  "PB1_double_click", "PB_chord", "Coalesce",
+};
+
+/*
+ * @brief Prints what one record is: the event, and the signals or the non-zero payload
+ * @param id, sl_bt_evt_*_id
+ * @param evt, the event's fields
+ * @param len, bytes of the fields that were recorded
+ * @return none
+ */
+static void print_event(uint32_t id, const sl_bt_msg_t *evt, size_t len)
+{
+  const uint8_t *data = (const uint8_t *) &evt->data;
+  const char    *name = NULL;
+
+  for (size_t i = 0; i < (sizeof(event_names) / sizeof(event_names[0])); i++)
+    {
+      if (event_names[i].id == id)
+        name = event_names[i].name;
+    }
+  if (name != NULL)
+    printf(" %s", name);
+  else
+    printf(" evt 0x%08x", (unsigned int) id);
+
+  if (id == sl_bt_evt_system_external_signal_id)
+    {
+      for (size_t bit = 0; bit < 32; bit++)
+        {
+          if ((evt->data.evt_system_external_signal.extsignals & (1UL << bit)) == 0)
+            continue;
+          if (bit < (sizeof(signal_names) / sizeof(signal_names[0])))
+            printf(" %s", signal_names[bit]);
+          else
+            printf(" 0x%lx", 1UL << bit);
+        }
+      return;
+    }
+  while ((len > 0) && (data[len - 1] == 0))
+    len--;
+  if (len > 0)
+    printf(" ");
+  for (size_t i = 0; i < len; i++)
+    printf("%02x", data[i]);
+} // print_event()
+
+int main(int argc, char *argv[])
+{
+  FILE     *scenario;
+  char      line[256];
+  uint32_t  records = 0;
+  uint32_t  dropped = 0;
+  uint32_t  elapsed_ms;
+
+  if (argc != 2)
+    {
+      fprintf(stderr, "usage: %s scenario\n", argv[0]);
+      return 2;
+    }
+  scenario = fopen(argv[1], "r");
+  if (scenario == NULL)
+    {
+      perror(argv[1]);
+      return 2;
+    }
+
+  hostReset();
+  app_init();
+  printf("%s\n", argv[1]);
+  while (fgets(line, sizeof(line), scenario) != NULL)
+    {
+      const char   *rec = strstr(line, "rec ");
+      unsigned int  tick;
+      unsigned int  delta;
+      unsigned int  class_id;
+      unsigned int  record_dropped;
+      char          payload[2 * EVENT_RECORDER_MAX_PAYLOAD + 1] = "";
+      size_t        len = 0;
+      uint32_t      id;
+      sl_bt_msg_t   evt;
+
+      if ((line[0] == '#') || (rec == NULL))
+        continue;
+      if (sscanf(rec, "rec start tick=%u hz=%*u records=%*u bytes=%*u recorded=%*u dropped=%u",
+                 &tick, &record_dropped) == 2)
+        {
+          dropped = record_dropped;
+          hostAdvanceTicks(tick - hostNowTicks());
+          continue;
+        }
+      if (sscanf(rec, "rec +%u %4x %64s", &delta, &class_id, payload) < 2)
+        continue;
+
+      memset(&evt, 0, sizeof(evt));
+      for (; (2 * len + 1) < strlen(payload); len++)
+        {
+          unsigned int byte;
+
+          sscanf(&payload[2 * len], "%2x", &byte);
+          ((uint8_t *) &evt.data)[len] = (uint8_t) byte;
+        }
+      // The timers run on the way, the signals they post are in the scenario
+      hostAdvanceTicks(delta);
+      id = ((class_id >> 8) << 16) | ((class_id & 0xff) << 24) | 0xa0;
+      if ((id == sl_bt_evt_system_external_signal_id) &&
+          (evt.data.evt_system_external_signal.extsignals & evtI2C_Transfer_Complete))
+        (void) hostI2cComplete(); // the Si7021 reading, the signal is in the scenario
+      (void) hostTakeSignals();
+      printf("%10.1f ms", (hostNowTicks() * 1000.0) / HOST_SLEEPTIMER_HZ);
+      print_event(id, &evt, len);
+      printf("\n");
+      // The stack's interrupt wakes the MCU for the event, it sleeps again after
+      hostEmTransition(hostSleepEm(), SL_POWER_MANAGER_EM0);
+      hostEvent(id, &evt);
+      hostEmTransition(SL_POWER_MANAGER_EM0, hostSleepEm());
+      records++;
+    }
+  fclose(scenario);
+
+  elapsed_ms = (uint32_t) (((uint64_t) hostNowTicks() * 1000) / HOST_SLEEPTIMER_HZ);
+  printf("%u events over %u ms, %u dropped by the recorder\n", (unsigned int) records,
+         (unsigned int) elapsed_ms, (unsigned int) dropped);
+  printf("energy model: average %u nA, %u mJ/hr\n", (unsigned int) energyAverageNa(),
+         (unsigned int) energyMilliJoulesPerHour());
+  return (records > 0) ? 0 : 1;
+} // main()
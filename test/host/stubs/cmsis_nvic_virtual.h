@@ -0,0 +1,30 @@
+/*
+ * File name: cmsis_nvic_virtual.h
+ * File description: This file maps the CMSIS NVIC functions for the host build, included
+ *                   by core_cm4.h with CMSIS_NVIC_VIRTUAL defined. They are the CMSIS ones
+ *                   on the register memory of platform_stub.c, NVIC_DisableIRQ() aside: the
+ *                   CMSIS one ends with the Cortex-M dsb/isb barriers.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] CMSIS-Core, NVIC functions, CMSIS_NVIC_VIRTUAL https://arm-software.github.io/CMSIS_5/Core/html/group__NVIC__gr.html
+ */
+#ifndef TEST_HOST_STUBS_CMSIS_NVIC_VIRTUAL_H_
+#define TEST_HOST_STUBS_CMSIS_NVIC_VIRTUAL_H_
+
+// platform_stub.c, clears the enable bit without the barriers
+void hostNvicDisableIRQ(IRQn_Type IRQn);
+
+#define NVIC_SetPriorityGrouping    __NVIC_SetPriorityGrouping
+#define NVIC_GetPriorityGrouping    __NVIC_GetPriorityGrouping
+#define NVIC_EnableIRQ              __NVIC_EnableIRQ
+#define NVIC_GetEnableIRQ           __NVIC_GetEnableIRQ
+#define NVIC_DisableIRQ             hostNvicDisableIRQ
+#define NVIC_GetPendingIRQ          __NVIC_GetPendingIRQ
+#define NVIC_SetPendingIRQ          __NVIC_SetPendingIRQ
+#define NVIC_ClearPendingIRQ        __NVIC_ClearPendingIRQ
+#define NVIC_GetActive              __NVIC_GetActive
+#define NVIC_SetPriority            __NVIC_SetPriority
+#define NVIC_GetPriority            __NVIC_GetPriority
+
+#endif /* TEST_HOST_STUBS_CMSIS_NVIC_VIRTUAL_H_ */
@@ -0,0 +1,16 @@
+/*
+ * File name: host_cycles.h
+ * File description: This file declares the host clock CYCLE_COUNT() reads in the benchmark
+ *                   build, it is included ahead of every firmware source (-include), which
+ *                   do not include host.h. See hostCycleCount() in host.h.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+#ifndef TEST_HOST_STUBS_HOST_CYCLES_H_
+#define TEST_HOST_STUBS_HOST_CYCLES_H_
+
+#include <stdint.h>
+
+uint32_t hostCycleCount(void);
+
+#endif /* TEST_HOST_STUBS_HOST_CYCLES_H_ */
@@ -0,0 +1,639 @@
+/*
+ * File name: link_stub.c
+ * File description: This file defines the host model of the connections the firmware serves
+ *                   and the loop that runs the firmware on it. A test opens a connection as a
+ *                   central would, and the central then runs its connection events on the
+ *                   interval grid: an indication goes out at the next event the server
+ *                   attends, and the central confirms it at the event after that. Idle, the
+ *                   server skips up to the peripheral latency in events, it attends every
+ *                   event while data is pending. A lost event delays the exchange by one
+ *                   interval. A parameter request applies LINK_UPDATE_EVENTS events later with
+ *                   its longest interval, unless the central holds its parameters, and a 2M
+ *                   PHY request likewise unless the central holds the 1M PHY. The radio on
+ *                   time of the server is added up per connection from the packets it
+ *                   exchanges, on the PHY of the connection. On the connections a client build opens to the peers of
+ *                   peer_stub.c the firmware is the central: it attends every event, and the
+ *                   peer runs its side of the event. The server's advertising set runs its
+ *                   advertising events on its interval, one PDU on each of the three
+ *                   primary channels, each followed by a listen for a scan or connect
+ *                   request. Only its radio on time is counted, the MCU is not woken.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] Bluetooth Core Specification v5.2, Vol 6, Part B, 2.1 Packet format, 4.5.1 Connection events,
+ *      4.2 Advertising state, 4.5.5 Connection parameter update, 5.1.10 PHY update procedure
+ *  [2] Bluetooth Core Specification v5.2, Vol 3, Part F, 3.4.7.2 Handle Value Indication
+ *  [3] Silicon Labs Bluetooth API reference https://docs.silabs.com/bluetooth/3.2/
+ */
+
+#include "host.h"
+#include "stubs.h"
+
+// Connections modelled at the same time
+#define LINK_MAX              (8)
+// Longest step of hostRun(), the firmware sees signals and I2C completions at least this often
+#define LINK_RUN_STEP_US      (1000)
+// Connection events between a parameter request and the instant it applies
+#define LINK_UPDATE_EVENTS    (6)
+// Supervision timeout of a new connection, 10 ms units
+#define LINK_OPEN_TIMEOUT     (600)
+// Interval of a connection the firmware opens before it sets default parameters, 30 ms
+#define LINK_DEFAULT_INTERVAL (24)
+// LL payload of one data PDU, the firmware is told the same in the parameters event
+#define LINK_TXSIZE           (27)
+// 1M PHY: preamble, access address, header and CRC bytes around the payload, 8 us a byte.
+// The 2M PHY has a 2 byte preamble and sends a byte in 4 us.
+#define LINK_PDU_OVERHEAD     (10)
+#define LINK_US_PER_BYTE      (8)
+#define LINK_2M_US_PER_BYTE   (4)
+// Inter frame space, and the radio ramp up plus receive window widening of each event
+#define LINK_T_IFS_US         (150)
+#define LINK_WAKEUP_US        (150)
+// L2CAP header and ATT opcode plus handle of an indication, the confirmation is the opcode
+#define LINK_L2CAP_HEADER     (4)
+#define LINK_ATT_HVI_HEADER   (3)
+#define LINK_ATT_HVC_LEN      (1)
+// Advertising: the primary channels, the AdvA of each PDU, and the listen after a PDU of a
+// scannable or connectable set, the inter frame space and an access address long
+#define LINK_ADV_CHANNELS     (3)
+#define LINK_ADV_ADDRESS_LEN  (6)
+#define LINK_ADV_LISTEN_US    (LINK_T_IFS_US + (5 * LINK_US_PER_BYTE))
+// Advertising interval before sl_bt_advertiser_set_timing(), 100 ms in 0.625 ms units
+#define LINK_ADV_INTERVAL     (160)
+
+typedef struct
+{
+  bool              in_use;
+  uint8_t           connection;
+  bool              central;           // opened by the firmware, to a peer
+  uint16_t          interval;          // 1.25 ms units
+  uint16_t          latency;
+  uint16_t          timeout;           // 10 ms units
+  uint8_t           loss_percent;
+  uint32_t          random;            // loss generator state
+  uint64_t          next_event_us;     // anchor of the next connection event
+  uint16_t          skipped;           // idle events skipped in a row
+  uint16_t          characteristic;    // indication in flight
+  size_t            indication_len;    // waiting to go out, 0 if none
+  bool              confirmation_due;  // sent, the central confirms at its next event
+  bool              closing;           // sl_bt_connection_close() called
+  bool              hold_parameters;   // the central rejects parameter requests
+  uint8_t           security_mode;     // sl_bt_connection_security_t
+  uint8_t           phy;               // sl_bt_gap_phy_1m or sl_bt_gap_phy_2m
+  bool              hold_phy;          // the central refuses the 2M PHY
+  uint16_t          phy_events;        // events until the PHY update applies, 0 if none
+  uint8_t           update_phy;
+  uint16_t          update_events;     // events until the requested parameters apply, 0 if none
+  uint16_t          update_interval;
+  uint16_t          update_latency;
+  uint16_t          update_timeout;
+  host_link_stats_t stats;
+} link_t;
+
+static link_t   links[LINK_MAX];
+// The server's advertising set
+static struct
+{
+  bool             running;
+  bool             listens;            // scannable or connectable
+  uint32_t         interval;           // 0.625 ms units
+  size_t           data_len;           // advertising data bytes
+  uint64_t         next_event_us;
+  host_adv_stats_t stats;
+} advertiser;
+static uint64_t run_us = 0; // hostRun() time, finer than the sleeptimer tick
+static bool     hold_parameters = false; // hostLinkHoldParameters()
+static bool     hold_phy = false;        // hostLinkHoldPhy()
+// sl_bt_connection_set_default_parameters(), for the connections the firmware opens
+static uint16_t default_interval = LINK_DEFAULT_INTERVAL;
+static uint16_t default_latency  = 0;
+static uint16_t default_timeout  = LINK_OPEN_TIMEOUT;
+
+/*
+ * @brief Finds the model of a connection
+ * @param connection, the handle, 0 for a free slot
+ * @return the link, NULL if none
+ */
+static link_t *find_link(uint8_t connection)
+{
+  for (int i = 0; i < LINK_MAX; i++)
+    {
+      if ((connection == 0) ? !links[i].in_use : (links[i].in_use && (links[i].connection == connection)))
+        return &links[i];
+    }
+  return NULL;
+} // find_link()
+
+/*
+ * @brief Brings the hostRun() time up to the sleeptimer clock, a test may have advanced it
+ * @param none
+ * @return none
+ */
+static void sync_clock(void)
+{
+  uint64_t clock_us = ((uint64_t) hostNowTicks() * 1000000) / HOST_SLEEPTIMER_HZ;
+
+  if (run_us < clock_us)
+    run_us = clock_us;
+} // sync_clock()
+
+/*
+ * @brief Airtime of LL PDUs carrying an L2CAP payload, split in LINK_TXSIZE fragments
+ * @param link, the connection, its PHY
+ * @param len, the L2CAP payload with its header, 0 for an empty PDU
+ * @param fragments, out: PDUs needed, may be NULL
+ * @return the airtime in us
+ */
+static uint32_t pdu_us(const link_t *link, size_t len, uint32_t *fragments)
+{
+  uint32_t count = (len == 0) ? 1 : (uint32_t) ((len + LINK_TXSIZE - 1) / LINK_TXSIZE);
+
+  if (fragments != NULL)
+    *fragments = count;
+  if (link->phy == sl_bt_gap_phy_2m)
+    return (uint32_t) ((count * (LINK_PDU_OVERHEAD + 1)) + len) * LINK_2M_US_PER_BYTE;
+  return (uint32_t) ((count * LINK_PDU_OVERHEAD) + len) * LINK_US_PER_BYTE;
+} // pdu_us()
+
+/*
+ * @brief Draws whether the central's packet of this event is lost
+ * @param link, the connection
+ * @return true if lost
+ */
+static bool lost(link_t *link)
+{
+  if (link->loss_percent == 0)
+    return false;
+  link->random = (link->random * 1103515245u) + 12345u;
+  return ((link->random >> 16) % 100) < link->loss_percent;
+} // lost()
+
+/*
+ * @brief Sends the firmware a connection's parameters, with LINK_TXSIZE
+ * @param link, the connection
+ * @return none
+ */
+static void deliver_parameters(const link_t *link)
+{
+  sl_bt_msg_t evt = { 0 };
+
+  evt.data.evt_connection_parameters.connection = link->connection;
+  evt.data.evt_connection_parameters.interval   = link->interval;
+  evt.data.evt_connection_parameters.latency    = link->latency;
+  evt.data.evt_connection_parameters.timeout    = link->timeout;
+  evt.data.evt_connection_parameters.security_mode = link->security_mode;
+  evt.data.evt_connection_parameters.txsize     = LINK_TXSIZE;
+  hostEvent(sl_bt_evt_connection_parameters_id, &evt);
+} // deliver_parameters()
+
+/*
+ * @brief Sends the firmware the PHY a connection is on, after a PHY update
+ * @param link, the connection
+ * @return none
+ */
+static void deliver_phy_status(const link_t *link)
+{
+  sl_bt_msg_t evt = { 0 };
+
+  evt.data.evt_connection_phy_status.connection = link->connection;
+  evt.data.evt_connection_phy_status.phy        = link->phy;
+  hostEvent(sl_bt_evt_connection_phy_status_id, &evt);
+} // deliver_phy_status()
+
+/*
+ * @brief Sends the firmware the end of a connection and frees its model
+ * @param link, the connection
+ * @param reason, the close reason
+ * @return none
+ */
+static void deliver_closed(link_t *link, uint16_t reason)
+{
+  sl_bt_msg_t evt = { 0 };
+
+  link->in_use = false;
+  if (link->central)
+    hostPeerClosed(link->connection);
+  evt.data.evt_connection_closed.connection = link->connection;
+  evt.data.evt_connection_closed.reason     = reason;
+  hostEvent(sl_bt_evt_connection_closed_id, &evt);
+} // deliver_closed()
+
+/*
+ * @brief Runs one connection event at the link's anchor and moves the anchor
+ * @param link, the connection
+ * @return none
+ */
+static void link_event(link_t *link)
+{
+  bool     pending = (link->indication_len > 0) || link->confirmation_due || link->closing;
+  uint32_t fragments;
+
+  link->stats.events++;
+  // The parameters apply from the instant on
+  if ((link->update_events > 0) && (--link->update_events == 0))
+    {
+      link->interval = link->update_interval;
+      link->latency  = link->update_latency;
+      link->timeout  = link->update_timeout;
+      deliver_parameters(link);
+    }
+  if ((link->phy_events > 0) && (--link->phy_events == 0))
+    {
+      link->phy = link->update_phy;
+      deliver_phy_status(link);
+    }
+  link->next_event_us += (uint64_t) link->interval * 1250;
+
+  // Peripheral latency, idle events may be skipped, the central attends them all
+  if (!link->central && !pending && (link->skipped < link->latency))
+    {
+      link->skipped++;
+      return;
+    }
+  link->skipped = 0;
+  link->stats.attended++;
+  // The device wakes for the event, hostRun() puts it back to sleep after the radio time
+  hostEmTransition(hostSleepEm(), SL_POWER_MANAGER_EM0);
+  link->stats.radio_us += LINK_WAKEUP_US;
+  if (lost(link))
+    {
+      // Listened through the receive window, nothing came
+      link->stats.lost++;
+      link->stats.radio_us += pdu_us(link, 0, NULL);
+      return;
+    }
+  // The central's packet, the server's answer
+  link->stats.radio_us += pdu_us(link, 0, NULL) + LINK_T_IFS_US + pdu_us(link, 0, NULL);
+
+  if (link->closing)
+    {
+      deliver_closed(link, SL_STATUS_BT_CTRL_CONNECTION_TERMINATED_BY_LOCAL_HOST);
+      return;
+    }
+  if (link->central)
+    {
+      // The peer's side of the event, its ATT PDUs ride on the packet pair
+      uint32_t bytes = hostPeerLinkEvent(link->connection);
+
+      if (bytes > 0)
+        link->stats.radio_us += pdu_us(link, LINK_L2CAP_HEADER + bytes, NULL) - pdu_us(link, 0, NULL);
+      return;
+    }
+  if (link->confirmation_due)
+    {
+      sl_bt_msg_t evt = { 0 };
+
+      link->confirmation_due = false;
+      link->stats.radio_us  += pdu_us(link, LINK_L2CAP_HEADER + LINK_ATT_HVC_LEN, NULL) - pdu_us(link, 0, NULL);
+      link->stats.confirmations++;
+      evt.data.evt_gatt_server_characteristic_status.connection     = link->connection;
+      evt.data.evt_gatt_server_characteristic_status.characteristic = link->characteristic;
+      evt.data.evt_gatt_server_characteristic_status.status_flags   = sl_bt_gatt_server_confirmation;
+      hostEvent(sl_bt_evt_gatt_server_characteristic_status_id, &evt);
+    }
+  else if (link->indication_len > 0)
+    {
+      // The answer carries the indication, more fragments take a packet pair each
+      link->stats.radio_us += pdu_us(link, LINK_L2CAP_HEADER + LINK_ATT_HVI_HEADER + link->indication_len, &fragments)
+                              - pdu_us(link, 0, NULL);
+      link->stats.radio_us += (fragments - 1) * (LINK_T_IFS_US + pdu_us(link, 0, NULL) + LINK_T_IFS_US);
+      link->indication_len   = 0;
+      link->confirmation_due = true;
+    }
+} // link_event()
+
+/*
+ * @brief Runs one advertising event of the server's set and moves its anchor
+ * @param none
+ * @return none
+ */
+static void advertising_event(void)
+{
+  uint32_t pdu = (uint32_t) (LINK_PDU_OVERHEAD + LINK_ADV_ADDRESS_LEN + advertiser.data_len) * LINK_US_PER_BYTE;
+
+  advertiser.next_event_us += (uint64_t) advertiser.interval * 625;
+  advertiser.stats.events++;
+  advertiser.stats.radio_us += LINK_WAKEUP_US + (LINK_ADV_CHANNELS * pdu);
+  if (advertiser.listens)
+    advertiser.stats.radio_us += LINK_ADV_CHANNELS * LINK_ADV_LISTEN_US;
+} // advertising_event()
+
+/**
+ * @brief Forgets every connection. Called from hostReset().
+ */
+void hostLinkReset(void)
+{
+  memset(links, 0, sizeof(links));
+  run_us           = 0;
+  hold_parameters  = false;
+  hold_phy         = false;
+  default_interval = LINK_DEFAULT_INTERVAL;
+  default_latency  = 0;
+  default_timeout  = LINK_OPEN_TIMEOUT;
+  memset(&advertiser, 0, sizeof(advertiser));
+  advertiser.interval = LINK_ADV_INTERVAL;
+  hostPeerReset();
+} // hostLinkReset()
+
+/**
+ * @brief Takes an indication the firmware sent on a connection, to go out at the next
+ *        event. Called from sl_bt_gatt_server_send_indication().
+ *
+ * @param connection, characteristic, len, the indication
+ *
+ * @return SL_STATUS_OK, SL_STATUS_IN_PROGRESS if one is not confirmed yet (ATT allows
+ *         one at a time), SL_STATUS_OK too for a connection the model does not run
+ */
+sl_status_t hostLinkIndication(uint8_t connection, uint16_t characteristic, size_t len)
+{
+  link_t *link = find_link(connection);
+
+  if (link == NULL)
+    return SL_STATUS_OK;
+  if ((link->indication_len > 0) || link->confirmation_due)
+    return SL_STATUS_IN_PROGRESS;
+  link->characteristic = characteristic;
+  link->indication_len = (len == 0) ? 1 : len;
+  link->stats.indications++;
+  return SL_STATUS_OK;
+} // hostLinkIndication()
+
+/**
+ * @brief Takes a parameter request of the firmware, the central accepts it with the longest
+ *        interval. Called from sl_bt_connection_set_parameters().
+ *
+ * @param connection, max_interval, latency, timeout, the request
+ */
+void hostLinkSetParameters(uint8_t connection, uint16_t max_interval, uint16_t latency, uint16_t timeout)
+{
+  link_t *link = find_link(connection);
+
+  if ((link == NULL) || link->hold_parameters)
+    return;
+  link->update_events   = LINK_UPDATE_EVENTS;
+  link->update_interval = max_interval;
+  link->update_latency  = latency;
+  link->update_timeout  = timeout;
+} // hostLinkSetParameters()
+
+/**
+ * @brief Takes a PHY request of the firmware. The central moves to 2M if it is preferred,
+ *        or answers that the connection stays on 1M if it holds the 1M PHY. Called from
+ *        sl_bt_connection_set_preferred_phy().
+ *
+ * @param connection, the connection
+ * @param preferred_phy, sl_bt_gap_phy_* bits
+ */
+void hostLinkSetPreferredPhy(uint8_t connection, uint8_t preferred_phy)
+{
+  link_t *link = find_link(connection);
+
+  if (link == NULL)
+    return;
+  link->phy_events = LINK_UPDATE_EVENTS;
+  link->update_phy = ((preferred_phy & sl_bt_gap_phy_2m) && !link->hold_phy) ? sl_bt_gap_phy_2m : sl_bt_gap_phy_1m;
+} // hostLinkSetPreferredPhy()
+
+/**
+ * @brief Closes a connection from the firmware side at its next event. Called from
+ *        sl_bt_connection_close().
+ *
+ * @param connection, the connection
+ */
+void hostLinkLocalClose(uint8_t connection)
+{
+  link_t *link = find_link(connection);
+
+  if (link != NULL)
+    link->closing = true;
+} // hostLinkLocalClose()
+
+/**
+ * @brief Records the parameters of the connections the firmware opens. Called from
+ *        sl_bt_connection_set_default_parameters().
+ *
+ * @param max_interval, latency, timeout, the parameters, the longest interval is used
+ */
+void hostLinkDefaultParameters(uint16_t max_interval, uint16_t latency, uint16_t timeout)
+{
+  default_interval = max_interval;
+  default_latency  = latency;
+  default_timeout  = timeout;
+} // hostLinkDefaultParameters()
+
+/**
+ * @brief Records the advertising interval of the server's set. Called from
+ *        sl_bt_advertiser_set_timing().
+ *
+ * @param interval_max, 0.625 ms units, the longest interval is used
+ */
+void hostLinkAdvertiserTiming(uint32_t interval_max)
+{
+  advertiser.interval = interval_max;
+} // hostLinkAdvertiserTiming()
+
+/**
+ * @brief Records the length of the server's advertising data. Called from
+ *        sl_bt_advertiser_set_data().
+ *
+ * @param packet_type, 0 for the advertising packets, 1 for the scan response
+ * @param len, bytes of data
+ */
+void hostLinkAdvertiserData(uint8_t packet_type, size_t len)
+{
+  if (packet_type == 0)
+    advertiser.data_len = len;
+} // hostLinkAdvertiserData()
+
+/**
+ * @brief Starts the advertising events of the server's set, the first one an interval
+ *        from now. Called from sl_bt_advertiser_start().
+ *
+ * @param connect, sl_bt_advertiser_connectable_scannable, ...
+ */
+void hostLinkAdvertiserStart(uint8_t connect)
+{
+  sync_clock();
+  advertiser.running       = true;
+  advertiser.listens       = (connect != sl_bt_advertiser_non_connectable);
+  advertiser.next_event_us = run_us + ((uint64_t) advertiser.interval * 625);
+} // hostLinkAdvertiserStart()
+
+/*
+ * @brief Starts the model of a new connection
+ * @param connection, the handle
+ * @param interval, latency, timeout, its parameters
+ * @return the link, NULL if LINK_MAX are open
+ */
+static link_t *open_link(uint8_t connection, uint16_t interval, uint16_t latency, uint16_t timeout)
+{
+  link_t *link = find_link(0);
+
+  if (link == NULL)
+    return NULL;
+  sync_clock();
+  memset(link, 0, sizeof(*link));
+  link->in_use          = true;
+  link->connection      = connection;
+  link->interval        = interval;
+  link->latency         = latency;
+  link->timeout         = timeout;
+  link->hold_parameters = hold_parameters;
+  link->hold_phy        = hold_phy;
+  link->phy             = sl_bt_gap_phy_1m;
+  link->random          = connection;
+  link->next_event_us   = run_us + ((uint64_t) interval * 1250);
+  return link;
+} // open_link()
+
+/**
+ * @brief Opens the connection the firmware asked a peer for, on the default parameters:
+ *        sends the firmware sl_bt_evt_connection_opened_id (master) and
+ *        sl_bt_evt_connection_parameters_id. Called from peer_stub.c.
+ *
+ * @param connection, the handle sl_bt_connection_open() returned
+ * @param address, the peer
+ * @param bonding, the stack's bond with the peer, 0xFF if none
+ */
+void hostLinkOpenCentral(uint8_t connection, const bd_addr *address, uint8_t bonding)
+{
+  link_t     *link = open_link(connection, default_interval, default_latency, default_timeout);
+  sl_bt_msg_t evt  = { 0 };
+
+  if (link == NULL)
+    return;
+  link->central = true;
+  evt.data.evt_connection_opened.connection = connection;
+  evt.data.evt_connection_opened.master     = 1; // the firmware is the central
+  evt.data.evt_connection_opened.bonding    = bonding;
+  evt.data.evt_connection_opened.address    = *address;
+  hostEvent(sl_bt_evt_connection_opened_id, &evt);
+  deliver_parameters(link);
+} // hostLinkOpenCentral()
+
+/**
+ * @brief Encrypts a connection, the stack tells the firmware in
+ *        sl_bt_evt_connection_parameters_id. Called from peer_stub.c.
+ *
+ * @param connection, the handle
+ * @param security_mode, sl_bt_connection_security_t
+ */
+void hostLinkEncrypted(uint8_t connection, uint8_t security_mode)
+{
+  link_t *link = find_link(connection);
+
+  if (link == NULL)
+    return;
+  link->security_mode = security_mode;
+  deliver_parameters(link);
+} // hostLinkEncrypted()
+
+void hostLinkOpen(uint8_t connection, uint16_t interval, uint16_t latency, uint8_t loss_percent)
+{
+  link_t     *link = open_link(connection, interval, latency, LINK_OPEN_TIMEOUT);
+  sl_bt_msg_t evt  = { 0 };
+
+  if (link == NULL)
+    return;
+  link->loss_percent = loss_percent;
+  // The central connected to the advertising set, the stack stops it
+  advertiser.running = false;
+
+  evt.data.evt_connection_opened.connection   = connection;
+  evt.data.evt_connection_opened.master       = 0; // the firmware is the peripheral
+  evt.data.evt_connection_opened.bonding      = 0xFF; // not bonded
+  evt.data.evt_connection_opened.address.addr[0] = connection;
+  hostEvent(sl_bt_evt_connection_opened_id, &evt);
+  deliver_parameters(link);
+} // hostLinkOpen()
+
+void hostLinkClose(uint8_t connection)
+{
+  link_t *link = find_link(connection);
+
+  if (link != NULL)
+    deliver_closed(link, SL_STATUS_BT_CTRL_REMOTE_USER_TERMINATED);
+} // hostLinkClose()
+
+void hostLinkSubscribe(uint8_t connection, uint16_t characteristic, uint16_t flags)
+{
+  sl_bt_msg_t evt = { 0 };
+
+  evt.data.evt_gatt_server_characteristic_status.connection          = connection;
+  evt.data.evt_gatt_server_characteristic_status.characteristic      = characteristic;
+  evt.data.evt_gatt_server_characteristic_status.status_flags        = sl_bt_gatt_server_client_config;
+  evt.data.evt_gatt_server_characteristic_status.client_config_flags = flags;
+  hostEvent(sl_bt_evt_gatt_server_characteristic_status_id, &evt);
+} // hostLinkSubscribe()
+
+void hostLinkHoldParameters(bool hold)
+{
+  hold_parameters = hold;
+} // hostLinkHoldParameters()
+
+const host_adv_stats_t *hostAdvertiserStats(void)
+{
+  return &advertiser.stats;
+} // hostAdvertiserStats()
+
+void hostLinkHoldPhy(bool hold)
+{
+  hold_phy = hold;
+} // hostLinkHoldPhy()
+
+const host_link_stats_t *hostLinkStats(uint8_t connection)
+{
+  link_t *link = find_link(connection);
+
+  if (link == NULL)
+    return NULL;
+  link->stats.interval = link->interval;
+  link->stats.latency  = link->latency;
+  link->stats.phy      = link->phy;
+  return &link->stats;
+} // hostLinkStats()
+
+void hostRun(uint32_t ms)
+{
+  uint64_t end;
+
+  sync_clock();
+  end = run_us + ((uint64_t) ms * 1000);
+  do
+    {
+      uint64_t next = run_us + LINK_RUN_STEP_US;
+
+      if (next > end)
+        next = end;
+      for (int i = 0; i < LINK_MAX; i++)
+        {
+          if (links[i].in_use && (links[i].next_event_us < next))
+            next = links[i].next_event_us;
+        }
+      if (advertiser.running && (advertiser.next_event_us < next))
+        next = advertiser.next_event_us;
+      hostAdvanceToUs(next);
+      run_us = next;
+      hostI2cComplete();
+      hostDeliverSignals();
+      hostPeerAdvance(run_us);
+      if (advertiser.running && (advertiser.next_event_us <= run_us))
+        advertising_event();
+      for (int i = 0; i < LINK_MAX; i++)
+        {
+          uint32_t attended = links[i].stats.attended;
+          uint64_t radio_us = links[i].stats.radio_us;
+
+          if (!links[i].in_use || (links[i].next_event_us > run_us))
+            continue;
+          link_event(&links[i]);
+          if (links[i].stats.attended != attended)
+            {
+              hostStayAwake((uint32_t) (links[i].stats.radio_us - radio_us));
+              hostEmTransition(SL_POWER_MANAGER_EM0, hostSleepEm());
+            }
+        }
+      hostDeliverSignals();
+    }
+  while (run_us < end);
+} // hostRun()
@@ -0,0 +1,1027 @@
+/*
+ * File name: peer_stub.c
+ * File description: This file defines the host model of the thermometer servers a client
+ *                   build connects to. A peer advertises the Health Thermometer service every
+ *                   PEER_ADV_INTERVAL_US plus advDelay, and is seen when an event falls in the
+ *                   firmware's scan window. sl_bt_connection_open() connects at the peer's
+ *                   next advertising event, and the connection then runs on the model of
+ *                   link_stub.c with the firmware as the central. The peer serves the GATT
+ *                   database of autogen/gatt_db.c: every GATT procedure of the firmware is
+ *                   split in the ATT requests the stack would send for the exchanged MTU, a
+ *                   request goes out at the next connection event and its response comes at
+ *                   the event after. Once the HTM CCCD is written the peer indicates its
+ *                   reading at once and then every PEER_SAMPLE_MS, one indication waiting for
+ *                   its confirmation at a time. button_state is read and indicated on an
+ *                   encrypted link only. sl_bt_sm_increase_security() pairs with LE Secure
+ *                   Connections numeric comparison, one SMP round trip per event and the
+ *                   passkey confirmed by the firmware, or resumes encryption with the LTK
+ *                   when the stack and the peer kept the bond of an earlier pairing.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] Bluetooth Core Specification v5.2, Vol 3, Part G, 4.4 Primary Service Discovery,
+ *      4.6 Characteristic Discovery, 4.8 Characteristic Value Read
+ *  [2] Bluetooth Core Specification v5.2, Vol 3, Part F, 3.4 Attribute Protocol PDUs
+ *  [3] Silicon Labs Bluetooth API reference https://docs.silabs.com/bluetooth/3.2/
+ *  [4] Bluetooth Core Specification v5.2, Vol 3, Part H, 2.3.5.6.2 LE Secure Connections
+ *      numeric comparison, and Vol 6, Part B, 5.1.3 Encryption procedure
+ */
+
+#include "host.h"
+#include "stubs.h"
+
+// Peers modelled at the same time
+#define PEER_MAX               (4)
+// Advertising interval of a peer, the server firmware's 250 ms, and the first advertising
+// event of peer i at (i + 1) * PEER_ADV_OFFSET_US
+#define PEER_ADV_INTERVAL_US   (250000)
+#define PEER_ADV_OFFSET_US     (37000)
+// advDelay, the pseudo random 0 to 10 ms added to every advertising interval
+#define PEER_ADV_DELAY_MAX_US  (10000)
+// The peer's HTM sample period, the server firmware's LETIMER period
+#define PEER_SAMPLE_MS         (3000)
+// ATT MTU before the exchange, and the largest the peer accepts
+#define PEER_DEFAULT_MTU       (23)
+#define PEER_MAX_MTU           (247)
+// Read By Group Type / Read By Type go on until this handle, Not Found ends them earlier
+#define PEER_LAST_HANDLE       (0xffff)
+// Readings the peer indicates, in millidegrees, the IEEE-11073 FLOAT the server sends
+#define PEER_CELSIUS_MILLI     (25000)
+#define PEER_FLOAT_EXPONENT    (0xfd)
+// Largest value one response carries here, the database hash
+#define PEER_VALUE_MAX         (16)
+// SMP and LL round trips of a pairing before the numeric comparison: Pairing Request and
+// Response, Public Keys, Pairing Confirm, Pairing Random
+#define PEER_PAIRING_ROUND_TRIPS  (4)
+// After the user's confirmation: DHKey Check, the encryption start and the key distribution
+#define PEER_DHKEY_ROUND_TRIPS    (1)
+#define PEER_KEYS_ROUND_TRIPS     (1)
+// Encryption start with a stored LTK: LL_ENC_REQ/RSP, then LL_START_ENC_REQ/RSP
+#define PEER_ENCRYPT_ROUND_TRIPS  (2)
+// Bytes of one security round trip both ways, two Pairing Random PDUs
+#define PEER_SECURITY_BYTES       (34)
+// Passkey of the numeric comparison, the same on both sides
+#define PEER_PASSKEY              (123456)
+
+typedef enum
+{
+  PEER_PLAIN,          // not encrypted
+  PEER_PAIRING,        // up to the numeric comparison
+  PEER_PASSKEY_WAIT,   // sl_bt_evt_sm_confirm_passkey_id sent, waiting for the firmware
+  PEER_PAIRING_END,    // DHKey Check, encryption start and key distribution
+  PEER_RESUMING,       // encryption start with the stored LTK
+  PEER_ENCRYPTED,
+} peer_security_t;
+
+typedef struct
+{
+  uint16_t       start;
+  uint16_t       end;
+  uint8_t        uuid_len;
+  const uint8_t *uuid;
+} peer_service_t;
+
+typedef struct
+{
+  uint16_t       declaration;
+  uint16_t       value;
+  uint8_t        properties;
+  uint8_t        uuid_len;
+  const uint8_t *uuid;
+} peer_characteristic_t;
+
+typedef struct
+{
+  bool     running;      // a procedure of the firmware is in progress
+  bool     sent;         // its next request went out, the response comes at the next event
+  uint8_t  kind;         // host_peer_request_t
+  uint16_t cursor;       // first handle the next request asks about
+  uint16_t end;          // last handle of the range
+  uint16_t handle;       // characteristic read or CCCD written
+  uint16_t flags;        // CCCD value
+  uint8_t  uuid[16];     // by UUID discoveries
+  uint8_t  uuid_len;
+  uint8_t  handles[16];  // Read Multiple, little endian handles
+  uint8_t  handles_len;
+} peer_procedure_t;
+
+typedef struct
+{
+  bool              in_use;
+  bd_addr           address;
+  uint64_t          next_adv_us;        // next advertising event while not connected
+  uint32_t          random;             // advDelay generator state
+  bool              connecting;         // sl_bt_connection_open() called, opened at the next advertising event
+  uint8_t           connection;         // 0 while not connected
+  uint16_t          mtu;
+  bool              mtu_sent;           // exchange request out, it runs before the firmware's requests
+  bool              mtu_done;
+  peer_procedure_t  procedure;
+  uint16_t          cccd_htm;           // CCCD values the firmware wrote
+  uint16_t          cccd_button;
+  uint8_t           button;             // button_state value
+  uint64_t          next_sample_us;     // next HTM reading while subscribed
+  bool              htm_pending;        // reading waiting for the next event
+  uint64_t          htm_sampled_us;
+  bool              button_pending;
+  bool              awaiting_confirmation;
+  uint64_t          indicated_sampled_us; // sample time of the indication in flight
+  bool              confirmation_due;   // the firmware confirmed, sent at the next event
+  uint8_t           bonding;            // the stack's bond with the peer, 0xFF if none, the peer keeps its side
+  uint8_t           security;           // peer_security_t
+  uint8_t           security_steps;     // round trips left in this step
+  bool              security_sent;      // its PDU went out, the answer comes at the next event
+  uint64_t          passkey_us;         // sl_bt_evt_sm_confirm_passkey_id sent
+  host_peer_stats_t stats;
+} peer_t;
+
+// Generic Attribute, Generic Access, Device Information, Health Thermometer, button, role, OTA
+static const uint8_t uuid_gatt[]        = { 0x01, 0x18 };
+static const uint8_t uuid_gap[]         = { 0x00, 0x18 };
+static const uint8_t uuid_device_info[] = { 0x0a, 0x18 };
+static const uint8_t uuid_htm[]         = { 0x09, 0x18 };
+static const uint8_t uuid_button_svc[]  = { 0x89, 0x62, 0x13, 0x2d, 0x2a, 0x65, 0xec, 0x87, 0x3e, 0x43, 0xc8, 0x38, 0x01, 0x00, 0x00, 0x00 };
+static const uint8_t uuid_role_svc[]    = { 0x89, 0x62, 0x13, 0x2d, 0x2a, 0x65, 0xec, 0x87, 0x3e, 0x43, 0xc8, 0x38, 0x03, 0x00, 0x00, 0x00 };
+static const uint8_t uuid_ota_svc[]     = { 0xf0, 0x19, 0x21, 0xb4, 0x47, 0x8f, 0xa4, 0xbf, 0xa1, 0x4f, 0x63, 0xfd, 0xee, 0xd6, 0x14, 0x1d };
+static const uint8_t uuid_service_changed[] = { 0x05, 0x2a };
+static const uint8_t uuid_db_hash[]         = { 0x2a, 0x2b };
+static const uint8_t uuid_client_features[] = { 0x29, 0x2b };
+static const uint8_t uuid_device_name[]     = { 0x00, 0x2a };
+static const uint8_t uuid_appearance[]      = { 0x01, 0x2a };
+static const uint8_t uuid_manufacturer[]    = { 0x29, 0x2a };
+static const uint8_t uuid_system_id[]       = { 0x23, 0x2a };
+static const uint8_t uuid_measurement[]     = { 0x1c, 0x2a };
+static const uint8_t uuid_temperature_type[] = { 0x1d, 0x2a };
+static const uint8_t uuid_intermediate[]    = { 0x1e, 0x2a };
+static const uint8_t uuid_interval[]        = { 0x21, 0x2a };
+static const uint8_t uuid_button_state[]    = { 0x89, 0x62, 0x13, 0x2d, 0x2a, 0x65, 0xec, 0x87, 0x3e, 0x43, 0xc8, 0x38, 0x02, 0x00, 0x00, 0x00 };
+static const uint8_t uuid_device_role[]     = { 0x89, 0x62, 0x13, 0x2d, 0x2a, 0x65, 0xec, 0x87, 0x3e, 0x43, 0xc8, 0x38, 0x04, 0x00, 0x00, 0x00 };
+static const uint8_t uuid_ota_control[]     = { 0x63, 0x60, 0x32, 0xe0, 0x37, 0x5e, 0xa4, 0x88, 0x53, 0x4e, 0x6d, 0xfb, 0x64, 0x35, 0xbf, 0xf7 };
+
+// The server firmware's database, autogen/gatt_db.c
+static const peer_service_t services[] =
+{
+  { 0x01, 0x08, sizeof(uuid_gatt),        uuid_gatt        },
+  { 0x09, 0x0d, sizeof(uuid_gap),         uuid_gap         },
+  { 0x0e, 0x12, sizeof(uuid_device_info), uuid_device_info },
+  { 0x13, 0x1e, sizeof(uuid_htm),         uuid_htm         },
+  { 0x1f, 0x22, sizeof(uuid_button_svc),  uuid_button_svc  },
+  { 0x23, 0x25, sizeof(uuid_role_svc),    uuid_role_svc    },
+  { 0x26, 0x28, sizeof(uuid_ota_svc),     uuid_ota_svc     },
+};
+
+static const peer_characteristic_t characteristics[] =
+{
+  { 0x02, gattdb_service_changed_char,      0x20, sizeof(uuid_service_changed),  uuid_service_changed  },
+  { 0x05, gattdb_database_hash,             0x02, sizeof(uuid_db_hash),          uuid_db_hash          },
+  { 0x07, gattdb_client_support_features,   0x0a, sizeof(uuid_client_features),  uuid_client_features  },
+  { 0x0a, gattdb_device_name,               0x0a, sizeof(uuid_device_name),      uuid_device_name      },
+  { 0x0c, 0x0d,                             0x02, sizeof(uuid_appearance),       uuid_appearance       },
+  { 0x0f, gattdb_manufacturer_name_string,  0x02, sizeof(uuid_manufacturer),     uuid_manufacturer     },
+  { 0x11, gattdb_system_id,                 0x02, sizeof(uuid_system_id),        uuid_system_id        },
+  { 0x14, gattdb_temperature_measurement,   0x20, sizeof(uuid_measurement),      uuid_measurement      },
+  { 0x17, gattdb_temperature_type,          0x02, sizeof(uuid_temperature_type), uuid_temperature_type },
+  { 0x19, gattdb_intermediate_temperature,  0x10, sizeof(uuid_intermediate),     uuid_intermediate     },
+  { 0x1c, gattdb_measurement_interval,      0x02, sizeof(uuid_interval),         uuid_interval         },
+  { 0x20, gattdb_button_state,              0x22, sizeof(uuid_button_state),     uuid_button_state     },
+  { 0x24, gattdb_device_role,               0x0a, sizeof(uuid_device_role),      uuid_device_role      },
+  { 0x27, gattdb_ota_control,               0x08, sizeof(uuid_ota_control),      uuid_ota_control      },
+};
+
+#define SERVICE_COUNT        (sizeof(services) / sizeof(services[0]))
+#define CHARACTERISTIC_COUNT (sizeof(characteristics) / sizeof(characteristics[0]))
+
+static peer_t   peers[PEER_MAX];
+static bool     scanning      = false;
+static uint32_t scan_interval_us = 0;   // sl_bt_scanner_set_timing()
+static uint32_t scan_window_us   = 0;
+static uint16_t max_mtu       = PEER_DEFAULT_MTU; // sl_bt_gatt_set_max_mtu()
+static uint64_t now_us        = 0;      // hostRun() time of the last hostPeerAdvance()
+
+/*
+ * @brief Finds the peer of a connection
+ * @param connection, the handle
+ * @return the peer, NULL if the connection is not to a peer
+ */
+static peer_t *find_peer(uint8_t connection)
+{
+  for (int i = 0; i < PEER_MAX; i++)
+    {
+      if (peers[i].in_use && (peers[i].connection == connection) && (connection != 0))
+        return &peers[i];
+    }
+  return NULL;
+} // find_peer()
+
+/*
+ * @brief Reads a characteristic value of the peer's database
+ * @param peer, the peer
+ * @param handle, the value handle
+ * @param value, out: the value, PEER_VALUE_MAX bytes
+ * @return the value length, 0 for handles the model does not hold
+ */
+static uint8_t read_value(const peer_t *peer, uint16_t handle, uint8_t *value)
+{
+  switch (handle)
+  {
+    case gattdb_database_hash:
+      // Same database on every peer, so the same hash
+      for (uint8_t i = 0; i < GATT_DB_HASH_LEN; i++)
+        value[i] = (uint8_t) (0xd0 + i);
+      return GATT_DB_HASH_LEN;
+    case gattdb_temperature_type:
+      value[0] = 2; // body
+      return 1;
+    case gattdb_measurement_interval:
+      value[0] = PEER_SAMPLE_MS / 1000;
+      value[1] = 0;
+      return 2;
+    case gattdb_button_state:
+      value[0] = peer->button;
+      return 1;
+    default:
+      return 0;
+  }
+} // read_value()
+
+/*
+ * @brief Sends the firmware the end of its GATT procedure
+ * @param peer, the peer
+ * @param result, 0 or the ATT error as sl_status_t
+ * @return none
+ */
+static void deliver_completed(peer_t *peer, uint16_t result)
+{
+  sl_bt_msg_t evt = { 0 };
+
+  peer->procedure.running = false;
+  peer->stats.procedures++;
+  evt.data.evt_gatt_procedure_completed.connection = peer->connection;
+  evt.data.evt_gatt_procedure_completed.result     = result;
+  hostEvent(sl_bt_evt_gatt_procedure_completed_id, &evt);
+} // deliver_completed()
+
+/*
+ * @brief Sends the firmware one characteristic value, a response or an indication
+ * @param peer, the peer
+ * @param characteristic, the handle, 0 for a Read Multiple response
+ * @param opcode, sl_bt_gatt_att_opcode_t
+ * @param value, len, the value
+ * @return none
+ */
+static void deliver_value(peer_t *peer, uint16_t characteristic, uint8_t opcode, const uint8_t *value, uint8_t len)
+{
+  sl_bt_msg_t evt = { 0 };
+
+  evt.data.evt_gatt_characteristic_value.connection     = peer->connection;
+  evt.data.evt_gatt_characteristic_value.characteristic = characteristic;
+  evt.data.evt_gatt_characteristic_value.att_opcode     = opcode;
+  evt.data.evt_gatt_characteristic_value.value.len      = len;
+  memcpy(evt.data.evt_gatt_characteristic_value.value.data, value, len);
+  hostEvent(sl_bt_evt_gatt_characteristic_value_id, &evt);
+} // deliver_value()
+
+/*
+ * @brief Checks if the firmware may read a characteristic on the peer's link, button_state
+ *        needs encryption ("bonded" in the GATT configuration)
+ * @param peer, the peer
+ * @param handle, the value handle
+ * @return true if readable
+ */
+static bool readable(const peer_t *peer, uint16_t handle)
+{
+  return (handle != gattdb_button_state) || (peer->security == PEER_ENCRYPTED);
+} // readable()
+
+/*
+ * @brief One Read By Group Type (all primary services) or Find By Type Value (by UUID)
+ *        response, the services from the cursor on that fit in the MTU
+ * @param peer, the peer
+ * @return the ATT bytes of the response
+ */
+static uint32_t respond_services(peer_t *peer)
+{
+  peer_procedure_t *p     = &peer->procedure;
+  bool              by_uuid = (p->kind == HOST_PEER_DISCOVER_SERVICES_BY_UUID);
+  uint32_t          used  = 0;
+  uint8_t           entry_len = 0;
+
+  for (uint32_t i = 0; i < SERVICE_COUNT; i++)
+    {
+      const peer_service_t *service = &services[i];
+      sl_bt_msg_t           evt     = { 0 };
+
+      if ((service->start < p->cursor) ||
+          (by_uuid && ((service->uuid_len != p->uuid_len) || memcmp(service->uuid, p->uuid, p->uuid_len))))
+        continue;
+      // Handle range and the UUID, the entries of one response all have the same length
+      if (entry_len == 0)
+        entry_len = by_uuid ? 4 : (uint8_t) (4 + service->uuid_len);
+      else if (!by_uuid && (entry_len != (4 + service->uuid_len)))
+        break;
+      if ((2 + used + entry_len) > peer->mtu)
+        break;
+      used     += entry_len;
+      p->cursor = service->end + 1;
+      evt.data.evt_gatt_service.connection = peer->connection;
+      evt.data.evt_gatt_service.service    = service->start;
+      evt.data.evt_gatt_service.uuid.len   = service->uuid_len;
+      memcpy(evt.data.evt_gatt_service.uuid.data, service->uuid, service->uuid_len);
+      hostEvent(sl_bt_evt_gatt_service_id, &evt);
+    }
+  // An empty response is the Attribute Not Found error that ends the procedure
+  if ((used == 0) || (p->cursor > PEER_LAST_HANDLE))
+    {
+      deliver_completed(peer, 0);
+      return 5;
+    }
+  return 2 + used;
+} // respond_services()
+
+/*
+ * @brief One Read By Type response for characteristic declarations, those from the cursor
+ *        on in the service's range that fit in the MTU. The by UUID discovery reads the
+ *        same declarations and only reports the matching ones.
+ * @param peer, the peer
+ * @return the ATT bytes of the response
+ */
+static uint32_t respond_characteristics(peer_t *peer)
+{
+  peer_procedure_t *p       = &peer->procedure;
+  bool              by_uuid = (p->kind == HOST_PEER_DISCOVER_CHARACTERISTICS_BY_UUID);
+  uint32_t          used    = 0;
+  uint8_t           entry_len = 0;
+
+  for (uint32_t i = 0; i < CHARACTERISTIC_COUNT; i++)
+    {
+      const peer_characteristic_t *c   = &characteristics[i];
+      sl_bt_msg_t                  evt = { 0 };
+
+      if ((c->declaration < p->cursor) || (c->declaration > p->end))
+        continue;
+      // Declaration handle, properties, value handle and UUID
+      if (entry_len == 0)
+        entry_len = (uint8_t) (5 + c->uuid_len);
+      else if (entry_len != (5 + c->uuid_len))
+        break;
+      if ((2 + used + entry_len) > peer->mtu)
+        break;
+      used     += entry_len;
+      p->cursor = c->value + 1;
+      if (by_uuid && ((c->uuid_len != p->uuid_len) || memcmp(c->uuid, p->uuid, p->uuid_len)))
+        continue;
+      evt.data.evt_gatt_characteristic.connection     = peer->connection;
+      evt.data.evt_gatt_characteristic.characteristic = c->value;
+      evt.data.evt_gatt_characteristic.properties     = c->properties;
+      evt.data.evt_gatt_characteristic.uuid.len       = c->uuid_len;
+      memcpy(evt.data.evt_gatt_characteristic.uuid.data, c->uuid, c->uuid_len);
+      hostEvent(sl_bt_evt_gatt_characteristic_id, &evt);
+    }
+  if ((used == 0) || (p->cursor > p->end))
+    {
+      deliver_completed(peer, 0);
+      return (used == 0) ? 5 : (2 + used);
+    }
+  return 2 + used;
+} // respond_characteristics()
+
+/*
+ * @brief Answers the request of the firmware's procedure that went out at the last event
+ * @param peer, the peer
+ * @return the ATT bytes of the response
+ */
+static uint32_t respond(peer_t *peer)
+{
+  peer_procedure_t *p = &peer->procedure;
+  uint8_t           value[PEER_VALUE_MAX * 4];
+  uint8_t           len = 0;
+
+  peer->stats.round_trips++;
+  switch (p->kind)
+  {
+    case HOST_PEER_DISCOVER_SERVICES:
+    case HOST_PEER_DISCOVER_SERVICES_BY_UUID:
+      return respond_services(peer);
+
+    case HOST_PEER_DISCOVER_CHARACTERISTICS:
+    case HOST_PEER_DISCOVER_CHARACTERISTICS_BY_UUID:
+      return respond_characteristics(peer);
+
+    case HOST_PEER_WRITE_CCCD:
+      if (p->handle == gattdb_temperature_measurement)
+        {
+          peer->cccd_htm = p->flags;
+          if (p->flags & sl_bt_gatt_indication)
+            {
+              // The current reading at once, the next ones on the sample period
+              peer->htm_pending    = true;
+              peer->htm_sampled_us = now_us;
+              peer->stats.samples++;
+              peer->next_sample_us = now_us + ((uint64_t) PEER_SAMPLE_MS * 1000);
+            }
+        }
+      else if (p->handle == gattdb_button_state)
+        peer->cccd_button = p->flags;
+      peer->stats.subscribed_us = now_us;
+      deliver_completed(peer, 0);
+      return 1;
+
+    case HOST_PEER_READ:
+      if (!readable(peer, p->handle))
+        {
+          deliver_completed(peer, SL_STATUS_BT_ATT_INSUFFICIENT_ENCRYPTION);
+          return 5;
+        }
+      len = read_value(peer, p->handle, value);
+      deliver_value(peer, p->handle, sl_bt_gatt_read_response, value, len);
+      deliver_completed(peer, 0);
+      return 1 + len;
+
+    case HOST_PEER_READ_BY_UUID:
+      // One Read By Type request over the service's range, the first match answers
+      for (uint32_t i = 0; i < CHARACTERISTIC_COUNT; i++)
+        {
+          const peer_characteristic_t *c = &characteristics[i];
+
+          if ((c->declaration < p->cursor) || (c->declaration > p->end) ||
+              (c->uuid_len != p->uuid_len) || memcmp(c->uuid, p->uuid, p->uuid_len))
+            continue;
+          if (!readable(peer, c->value))
+            {
+              deliver_completed(peer, SL_STATUS_BT_ATT_INSUFFICIENT_ENCRYPTION);
+              return 5;
+            }
+          len = read_value(peer, c->value, value);
+          deliver_value(peer, c->value, sl_bt_gatt_read_by_type_response, value, len);
+          deliver_completed(peer, 0);
+          // Opcode, length, then the handle and value pair
+          return 4 + len;
+        }
+      deliver_completed(peer, SL_STATUS_BT_ATT_ATT_NOT_FOUND);
+      return 5;
+
+    default: // HOST_PEER_READ_MULTIPLE, the values concatenated, cut at ATT_MTU - 1
+      for (uint8_t i = 0; (i + 1) < p->handles_len; i += 2)
+        {
+          if (!readable(peer, (uint16_t) (p->handles[i] | (p->handles[i + 1] << 8))))
+            {
+              deliver_completed(peer, SL_STATUS_BT_ATT_INSUFFICIENT_ENCRYPTION);
+              return 5;
+            }
+        }
+      for (uint8_t i = 0; (i + 1) < p->handles_len; i += 2)
+        {
+          uint8_t one[PEER_VALUE_MAX];
+          uint8_t n = read_value(peer, (uint16_t) (p->handles[i] | (p->handles[i + 1] << 8)), one);
+
+          if ((len + n) > (peer->mtu - 1))
+            n = (uint8_t) ((peer->mtu - 1) - len);
+          memcpy(&value[len], one, n);
+          len += n;
+        }
+      deliver_value(peer, 0, sl_bt_gatt_read_multiple_response, value, len);
+      deliver_completed(peer, 0);
+      return 1 + len;
+  }
+} // respond()
+
+/*
+ * @brief Indicates the pending reading or button state, the HTM reading first
+ * @param peer, the peer
+ * @return the ATT bytes of the indication, 0 if none went out
+ */
+static uint32_t indicate(peer_t *peer)
+{
+  uint8_t  value[5];
+  uint8_t  len;
+  uint32_t start;
+  uint32_t cycles;
+
+  if (peer->awaiting_confirmation)
+    return 0;
+  if (peer->htm_pending && (peer->cccd_htm & sl_bt_gatt_indication))
+    {
+      uint32_t milli = PEER_CELSIUS_MILLI;
+
+      value[0] = 0; // flags, Celsius
+      value[1] = (uint8_t) milli;
+      value[2] = (uint8_t) (milli >> 8);
+      value[3] = (uint8_t) (milli >> 16);
+      value[4] = PEER_FLOAT_EXPONENT;
+      peer->htm_pending          = false;
+      peer->indicated_sampled_us = peer->htm_sampled_us;
+      peer->awaiting_confirmation = true;
+      if (peer->stats.first_indication_us == 0)
+        peer->stats.first_indication_us = now_us;
+      peer->stats.indications++;
+      len   = 5;
+      start = hostCycleCount();
+      deliver_value(peer, gattdb_temperature_measurement, sl_bt_gatt_handle_value_indication, value, len);
+    }
+  else if (peer->button_pending && (peer->cccd_button & sl_bt_gatt_indication) && (peer->security == PEER_ENCRYPTED))
+    {
+      value[0] = 0; // flags
+      value[1] = peer->button;
+      peer->button_pending        = false;
+      peer->indicated_sampled_us  = now_us;
+      peer->awaiting_confirmation = true;
+      peer->stats.indications++;
+      len   = 2;
+      start = hostCycleCount();
+      deliver_value(peer, gattdb_button_state, sl_bt_gatt_handle_value_indication, value, len);
+    }
+  else
+    return 0;
+
+  // The firmware's event handling: decode, confirm, hand on to the consumers
+  cycles = hostCycleCount() - start;
+  peer->stats.handler_cycles_sum += cycles;
+  if (cycles > peer->stats.handler_cycles_max)
+    peer->stats.handler_cycles_max = cycles;
+  // Opcode and handle, then the value
+  return 3 + len;
+} // indicate()
+
+/*
+ * @brief Runs the security step of a connection event: the answer to the PDU of the last
+ *        event, then the next PDU. The end of a step tells the firmware what it brought.
+ * @param peer, the peer
+ * @return the bytes both sides sent, 0 if no security procedure is running
+ */
+static uint32_t secure(peer_t *peer)
+{
+  sl_bt_msg_t evt = { 0 };
+
+  if ((peer->security != PEER_PAIRING) && (peer->security != PEER_PAIRING_END) && (peer->security != PEER_RESUMING))
+    return 0;
+  if (!peer->security_sent)
+    {
+      peer->security_sent = true;
+      return PEER_SECURITY_BYTES / 2;
+    }
+  peer->security_sent = false;
+  peer->stats.security_round_trips++;
+  if (--peer->security_steps > 0)
+    {
+      peer->security_sent = true;
+      return PEER_SECURITY_BYTES;
+    }
+
+  switch (peer->security)
+  {
+    case PEER_PAIRING:
+      // Both sides show the passkey, the peer's user has confirmed
+      peer->security   = PEER_PASSKEY_WAIT;
+      peer->passkey_us = now_us;
+      evt.data.evt_sm_confirm_passkey.connection = peer->connection;
+      evt.data.evt_sm_confirm_passkey.passkey    = PEER_PASSKEY;
+      hostEvent(sl_bt_evt_sm_confirm_passkey_id, &evt);
+      break;
+
+    case PEER_PAIRING_END:
+      peer->security = PEER_ENCRYPTED;
+      peer->bonding  = (uint8_t) (peer - peers);
+      peer->stats.encrypted_us = now_us;
+      peer->stats.pairings++;
+      hostLinkEncrypted(peer->connection, sl_bt_connection_mode1_level4);
+      evt.data.evt_sm_bonded.connection    = peer->connection;
+      evt.data.evt_sm_bonded.bonding       = peer->bonding;
+      evt.data.evt_sm_bonded.security_mode = sl_bt_connection_mode1_level4;
+      hostEvent(sl_bt_evt_sm_bonded_id, &evt);
+      break;
+
+    default: // PEER_RESUMING, no sl_bt_evt_sm_bonded_id for it
+      peer->security = PEER_ENCRYPTED;
+      peer->stats.encrypted_us = now_us;
+      hostLinkEncrypted(peer->connection, sl_bt_connection_mode1_level4);
+      break;
+  }
+  return PEER_SECURITY_BYTES / 2;
+} // secure()
+
+/*
+ * @brief Opens the connection the firmware asked for at the peer's advertising event
+ * @param peer, the peer
+ * @return none
+ */
+static void open_connection(peer_t *peer)
+{
+  peer->connecting = false;
+  peer->mtu        = PEER_DEFAULT_MTU;
+  peer->mtu_sent   = false;
+  peer->mtu_done   = false;
+  memset(&peer->procedure, 0, sizeof(peer->procedure));
+  peer->cccd_htm    = 0;
+  peer->cccd_button = 0;
+  peer->htm_pending = false;
+  peer->button_pending        = false;
+  peer->awaiting_confirmation = false;
+  peer->confirmation_due      = false;
+  peer->stats.connected_us    = now_us;
+  peer->stats.first_indication_us = 0;
+  peer->stats.connection      = peer->connection;
+  peer->security              = PEER_PLAIN;
+  peer->security_sent         = false;
+  peer->stats.security_us     = 0;
+  peer->stats.encrypted_us    = 0;
+  hostLinkOpenCentral(peer->connection, &peer->address, peer->bonding);
+} // open_connection()
+
+/*
+ * @brief Sends the firmware an advertising report of the peer if the scanner hears it
+ * @param peer, the peer
+ * @return none
+ */
+static void advertise(peer_t *peer)
+{
+  // Flags, LE General Discoverable and no BR/EDR, and the Health Thermometer service
+  static const uint8_t adv[] = { 0x02, 0x01, 0x06, 0x03, 0x03, 0x09, 0x18 };
+  sl_bt_msg_t          evt   = { 0 };
+
+  if (peer->connecting)
+    {
+      open_connection(peer);
+      return;
+    }
+  if (!scanning || (scan_interval_us == 0) || ((now_us % scan_interval_us) >= scan_window_us))
+    return;
+  peer->stats.reports++;
+  evt.data.evt_scanner_scan_report.packet_type  = 0; // connectable scannable undirected
+  evt.data.evt_scanner_scan_report.address      = peer->address;
+  evt.data.evt_scanner_scan_report.address_type = 0; // public
+  evt.data.evt_scanner_scan_report.bonding      = 0xff;
+  evt.data.evt_scanner_scan_report.primary_phy  = sl_bt_gap_1m_phy;
+  evt.data.evt_scanner_scan_report.rssi         = -50;
+  evt.data.evt_scanner_scan_report.channel      = 37;
+  evt.data.evt_scanner_scan_report.data.len     = sizeof(adv);
+  memcpy(evt.data.evt_scanner_scan_report.data.data, adv, sizeof(adv));
+  hostEvent(sl_bt_evt_scanner_scan_report_id, &evt);
+} // advertise()
+
+/**
+ * @brief Forgets every peer and the scanner settings. Called from hostReset().
+ */
+void hostPeerReset(void)
+{
+  memset(peers, 0, sizeof(peers));
+  scanning         = false;
+  scan_interval_us = 0;
+  scan_window_us   = 0;
+  max_mtu          = PEER_DEFAULT_MTU;
+  now_us           = 0;
+} // hostPeerReset()
+
+/**
+ * @brief Records the scan timing. Called from sl_bt_scanner_set_timing().
+ *
+ * @param interval, window, 0.625 ms units
+ */
+void hostPeerScanTiming(uint16_t interval, uint16_t window)
+{
+  scan_interval_us = (uint32_t) interval * 625;
+  scan_window_us   = (uint32_t) window * 625;
+} // hostPeerScanTiming()
+
+/**
+ * @brief Starts or stops the scanner. Called from sl_bt_scanner_start() and _stop().
+ *
+ * @param on, true if scanning
+ */
+void hostPeerScanning(bool on)
+{
+  scanning = on;
+} // hostPeerScanning()
+
+/**
+ * @brief Records the largest ATT MTU the firmware accepts. Called from sl_bt_gatt_set_max_mtu().
+ *
+ * @param mtu, the MTU
+ */
+void hostPeerMaxMtu(uint16_t mtu)
+{
+  max_mtu = mtu;
+} // hostPeerMaxMtu()
+
+/**
+ * @brief Connects to a peer at its next advertising event. Called from sl_bt_connection_open().
+ *
+ * @param address, the peer
+ * @param connection, the handle the command returned
+ *
+ * @return SL_STATUS_OK, SL_STATUS_OK too for an address that is not a peer (it never connects)
+ */
+sl_status_t hostPeerConnect(bd_addr address, uint8_t connection)
+{
+  for (int i = 0; i < PEER_MAX; i++)
+    {
+      peer_t *peer = &peers[i];
+
+      if (peer->in_use && (peer->connection == 0) && !memcmp(&peer->address, &address, sizeof(address)))
+        {
+          peer->connecting = true;
+          peer->connection = connection;
+          return SL_STATUS_OK;
+        }
+    }
+  return SL_STATUS_OK;
+} // hostPeerConnect()
+
+/**
+ * @brief Starts a GATT procedure of the firmware on a peer. Called from the sl_bt_gatt
+ *        client commands.
+ *
+ * @param connection, the connection
+ * @param kind, host_peer_request_t
+ * @param handle, the service or characteristic handle
+ * @param flags, the CCCD value of HOST_PEER_WRITE_CCCD
+ * @param data, len, the UUID of a by UUID discovery or the handles of a Read Multiple
+ *
+ * @return SL_STATUS_OK, SL_STATUS_INVALID_STATE while a procedure is in progress, as the
+ *         stack answers, SL_STATUS_OK for connections that are not to a peer
+ */
+sl_status_t hostPeerRequest(uint8_t connection, uint8_t kind, uint32_t handle, uint16_t flags,
+                            const uint8_t *data, size_t len)
+{
+  peer_t           *peer = find_peer(connection);
+  peer_procedure_t *p;
+
+  if (peer == NULL)
+    return SL_STATUS_OK;
+  p = &peer->procedure;
+  if (p->running)
+    return SL_STATUS_INVALID_STATE;
+  memset(p, 0, sizeof(*p));
+  p->running = true;
+  p->kind    = kind;
+  p->cursor  = 1;
+  p->end     = PEER_LAST_HANDLE;
+  p->handle  = (uint16_t) handle;
+  p->flags   = flags;
+  if ((kind == HOST_PEER_DISCOVER_CHARACTERISTICS) || (kind == HOST_PEER_DISCOVER_CHARACTERISTICS_BY_UUID) ||
+      (kind == HOST_PEER_READ_BY_UUID))
+    {
+      for (uint32_t i = 0; i < SERVICE_COUNT; i++)
+        {
+          if (services[i].start == handle)
+            {
+              p->cursor = services[i].start;
+              p->end    = services[i].end;
+            }
+        }
+    }
+  if (kind == HOST_PEER_READ_MULTIPLE)
+    {
+      p->handles_len = (uint8_t) ((len > sizeof(p->handles)) ? sizeof(p->handles) : len);
+      memcpy(p->handles, data, p->handles_len);
+    }
+  else if ((data != NULL) && (len <= sizeof(p->uuid)))
+    {
+      p->uuid_len = (uint8_t) len;
+      memcpy(p->uuid, data, len);
+    }
+  return SL_STATUS_OK;
+} // hostPeerRequest()
+
+/**
+ * @brief Takes the firmware's confirmation of an indication, sent at the next event.
+ *        Called from sl_bt_gatt_send_characteristic_confirmation().
+ *
+ * @param connection, the connection
+ */
+void hostPeerConfirmation(uint8_t connection)
+{
+  peer_t *peer = find_peer(connection);
+
+  if ((peer != NULL) && peer->awaiting_confirmation)
+    peer->confirmation_due = true;
+} // hostPeerConfirmation()
+
+/**
+ * @brief Starts the pairing of a peer, or the encryption with its stored LTK. Called from
+ *        sl_bt_sm_increase_security().
+ *
+ * @param connection, the connection
+ *
+ * @return SL_STATUS_OK, also while the link is being secured or is already encrypted, and
+ *         for connections that are not to a peer
+ */
+sl_status_t hostPeerIncreaseSecurity(uint8_t connection)
+{
+  peer_t *peer = find_peer(connection);
+
+  if ((peer == NULL) || (peer->security != PEER_PLAIN))
+    return SL_STATUS_OK;
+  peer->stats.security_us = now_us;
+  peer->security_sent     = false;
+  if (peer->bonding != 0xFF)
+    {
+      peer->security       = PEER_RESUMING;
+      peer->security_steps = PEER_ENCRYPT_ROUND_TRIPS;
+    }
+  else
+    {
+      peer->security       = PEER_PAIRING;
+      peer->security_steps = PEER_PAIRING_ROUND_TRIPS;
+    }
+  return SL_STATUS_OK;
+} // hostPeerIncreaseSecurity()
+
+/**
+ * @brief Takes the user's answer to the numeric comparison. Called from
+ *        sl_bt_sm_passkey_confirm().
+ *
+ * @param connection, the connection
+ * @param confirm, 1 if the passkeys match
+ *
+ * @return SL_STATUS_OK, SL_STATUS_INVALID_STATE if no passkey is waiting
+ */
+sl_status_t hostPeerPasskeyConfirm(uint8_t connection, uint8_t confirm)
+{
+  peer_t     *peer = find_peer(connection);
+  sl_bt_msg_t evt  = { 0 };
+
+  if (peer == NULL)
+    return SL_STATUS_OK;
+  if (peer->security != PEER_PASSKEY_WAIT)
+    return SL_STATUS_INVALID_STATE;
+  peer->stats.passkey_wait_us = now_us - peer->passkey_us;
+  if (confirm)
+    {
+      peer->security       = PEER_PAIRING_END;
+      peer->security_steps = PEER_DHKEY_ROUND_TRIPS + PEER_ENCRYPT_ROUND_TRIPS + PEER_KEYS_ROUND_TRIPS;
+      peer->security_sent  = false;
+      return SL_STATUS_OK;
+    }
+  peer->security = PEER_PLAIN;
+  evt.data.evt_sm_bonding_failed.connection = connection;
+  evt.data.evt_sm_bonding_failed.reason     = SL_STATUS_BT_SMP_NUMERIC_COMPARISON_FAILED;
+  hostEvent(sl_bt_evt_sm_bonding_failed_id, &evt);
+  return SL_STATUS_OK;
+} // hostPeerPasskeyConfirm()
+
+/**
+ * @brief Forgets the stack's bonds, the peers keep theirs. Called from
+ *        sl_bt_sm_delete_bondings().
+ */
+void hostPeerDeleteBondings(void)
+{
+  for (int i = 0; i < PEER_MAX; i++)
+    peers[i].bonding = 0xFF;
+} // hostPeerDeleteBondings()
+
+/**
+ * @brief Runs one connection event of a peer's connection: the confirmation, the security
+ *        step, the response to the request of the last event and the next request, then
+ *        an indication.
+ *        Called from the link model at every event that is not lost.
+ *
+ * @param connection, the connection
+ *
+ * @return the ATT bytes both sides sent, 0 if the event was empty
+ */
+uint32_t hostPeerLinkEvent(uint8_t connection)
+{
+  peer_t           *peer = find_peer(connection);
+  peer_procedure_t *p;
+  uint32_t          bytes = 0;
+
+  if (peer == NULL)
+    return 0;
+  p = &peer->procedure;
+
+  if (peer->confirmation_due)
+    {
+      uint64_t latency_us = now_us - peer->indicated_sampled_us;
+
+      peer->confirmation_due      = false;
+      peer->awaiting_confirmation = false;
+      peer->stats.confirmations++;
+      peer->stats.latency_sum_us += latency_us;
+      if (latency_us > peer->stats.latency_max_us)
+        peer->stats.latency_max_us = latency_us;
+      bytes += 1;
+    }
+
+  // SMP and the LL encryption run beside ATT
+  bytes += secure(peer);
+
+  // The stack exchanges the MTU first, the firmware's procedures wait for it
+  if (!peer->mtu_done)
+    {
+      if (!peer->mtu_sent)
+        {
+          peer->mtu_sent = true;
+          return bytes + 3;
+        }
+      {
+        sl_bt_msg_t evt = { 0 };
+
+        peer->mtu_done = true;
+        peer->mtu      = (max_mtu < PEER_MAX_MTU) ? max_mtu : PEER_MAX_MTU;
+        peer->stats.round_trips++;
+        evt.data.evt_gatt_mtu_exchanged.connection = connection;
+        evt.data.evt_gatt_mtu_exchanged.mtu        = peer->mtu;
+        hostEvent(sl_bt_evt_gatt_mtu_exchanged_id, &evt);
+        bytes += 3;
+      }
+    }
+
+  if (p->running && p->sent)
+    {
+      p->sent = false;
+      bytes  += respond(peer);
+    }
+  // The request of a procedure that goes on or was started since the last event
+  if (p->running && !p->sent)
+    {
+      p->sent = true;
+      bytes  += 7;
+    }
+  return bytes + indicate(peer);
+} // hostPeerLinkEvent()
+
+/**
+ * @brief Forgets a peer's connection, it advertises again. Called from the link model.
+ *
+ * @param connection, the connection
+ */
+void hostPeerClosed(uint8_t connection)
+{
+  peer_t *peer = find_peer(connection);
+
+  if (peer == NULL)
+    return;
+  peer->connection  = 0;
+  peer->next_adv_us = now_us + PEER_ADV_INTERVAL_US;
+} // hostPeerClosed()
+
+/**
+ * @brief Moves the peers to a point in time: advertising events and HTM samples.
+ *        Called from hostRun() at every step.
+ *
+ * @param us, hostRun() time
+ */
+void hostPeerAdvance(uint64_t us)
+{
+  now_us = us;
+  for (int i = 0; i < PEER_MAX; i++)
+    {
+      peer_t *peer = &peers[i];
+
+      if (!peer->in_use)
+        continue;
+      if ((peer->connection == 0) || peer->connecting)
+        {
+          if (peer->next_adv_us <= now_us)
+            {
+              peer->random       = (peer->random * 1103515245u) + 12345u;
+              peer->next_adv_us += PEER_ADV_INTERVAL_US + ((peer->random >> 8) % (PEER_ADV_DELAY_MAX_US + 1));
+              advertise(peer);
+            }
+          continue;
+        }
+      if ((peer->cccd_htm & sl_bt_gatt_indication) && (peer->next_sample_us <= now_us))
+        {
+          // A reading not indicated yet is replaced by the new one
+          peer->next_sample_us += (uint64_t) PEER_SAMPLE_MS * 1000;
+          peer->htm_pending     = true;
+          peer->htm_sampled_us  = now_us;
+          peer->stats.samples++;
+        }
+    }
+} // hostPeerAdvance()
+
+int hostPeerAdd(const bd_addr *address)
+{
+  for (int i = 0; i < PEER_MAX; i++)
+    {
+      peer_t *peer = &peers[i];
+
+      if (peer->in_use)
+        continue;
+      memset(peer, 0, sizeof(*peer));
+      peer->in_use      = true;
+      peer->address     = *address;
+      peer->random      = (uint32_t) (i + 1);
+      peer->bonding     = 0xFF;
+      peer->button      = 0;
+      peer->next_adv_us = now_us + ((uint64_t) (i + 1) * PEER_ADV_OFFSET_US);
+      return i;
+    }
+  return -1;
+} // hostPeerAdd()
+
+void hostPeerButton(int peer, bool pressed)
+{
+  if ((peer < 0) || (peer >= PEER_MAX) || !peers[peer].in_use)
+    return;
+  peers[peer].button         = pressed ? 1 : 0;
+  peers[peer].button_pending = true;
+} // hostPeerButton()
+
+const host_peer_stats_t *hostPeerStats(int peer)
+{
+  if ((peer < 0) || (peer >= PEER_MAX) || !peers[peer].in_use)
+    return NULL;
+  return &peers[peer].stats;
+} // hostPeerStats()
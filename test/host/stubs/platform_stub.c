@@ -0,0 +1,694 @@
+/*
+ * File name: platform_stub.c
+ * File description: This file defines the host stand-ins of the platform below the
+ *                   firmware: the peripheral and core register ranges are mapped as plain
+ *                   memory, so the inline emlib accessors (GPIO_PinInGet(), DWT->CYCCNT)
+ *                   read what was last written there; the emlib, CORE, DMD/GLIB functions
+ *                   do nothing or keep a value, DMD_init() starts the memlcd driver's
+ *                   EXTCOMIN toggle on the sleeptimer until DMD_sleep(); LETIMER0 counts on the virtual clock from
+ *                   the LFA clock the CMU selects (the LFXO, or the ULFRCO at
+ *                   HOST_ULFRCO_HZ) and its prescaler; the power manager keeps the EM
+ *                   requirements, the MCU sleeps in the lowest mode they allow; an I2C transfer
+ *                   completes from hostRun() against a model Si7021; the firmware log is
+ *                   printed with HOST_TRACE.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] EFR32xG13 Reference Manual, memory map https://www.silabs.com/documents/public/reference-manuals/efr32xg13-rm.pdf
+ *  [2] ARM Cortex-M4 Technical Reference Manual, system address map
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "glib.h"
+#include "dmd.h"
+#include "host.h"
+#include "stubs.h"
+
+// Peripherals with their bit-band, bit clear and bit set aliases, then the core private
+// peripherals (DWT, NVIC, SCB). An alias write lands in its own memory, not the register.
+#define PERIPHERAL_BASE   (PER_MEM_BASE)
+#define PERIPHERAL_SIZE   (0x08000000UL)
+#define CORE_BASE         (0xE0000000UL)
+#define CORE_SIZE         (0x00100000UL)
+
+// The input registers are read-only to the firmware, the harness writes them
+#define HOST_REG(reg)     (*(volatile uint32_t *) &(reg))
+// BUS_RegBitRead() (GPIO_PinInGet()) reads a bit through its bit-band alias word
+#define HOST_BITBAND(reg, bit) \
+  (*(volatile uint32_t *) (BITBAND_PER_BASE + (((uintptr_t) &(reg) - PER_MEM_BASE) * 32) + ((bit) * 4)))
+
+// Power manager transition subscribers
+#define EM_HANDLES_MAX    (8)
+// Si7021 reading after hostReset()
+#define SI7021_DEFAULT_C  (25.0f)
+
+int host_checks   = 0;
+int host_failures = 0;
+
+static sl_power_manager_em_transition_event_handle_t *em_handles[EM_HANDLES_MAX];
+static uint32_t                                       em_requirements[SL_POWER_MANAGER_EM3]; // EM1, EM2 held
+static host_wakeup_stats_t                            wakeup_stats;
+static uint64_t                                       awake_until_us; // end of the wakeup in progress
+static uint32_t                                       letimer_compare[2];
+static uint32_t                                       letimer_counter;         // at letimer_since
+static uint32_t                                       letimer_since;           // sleeptimer tick
+static bool                                           letimer_running = false;
+static bool                                           letimer_lfxo    = true;  // LFA clock, else ULFRCO
+static uint32_t                                       letimer_div     = 1;
+static I2C_TransferSeq_TypeDef                       *i2c_transfer = NULL; // started, not completed
+static uint32_t                                       i2c_transfers;
+static uint16_t                                       si7021_raw;
+static FILE                                          *log_file = NULL; // hostLogTo()
+static sl_sleeptimer_timer_handle_t                   memlcd_toggle;   // the memlcd driver's EXTCOMIN timer
+
+// Written by the firmware (app_log.c), printed with HOST_TRACE
+sl_iostream_t *app_log_iostream = NULL;
+const GLIB_Font_t GLIB_FontNarrow6x8;
+
+/*
+ * @brief Maps one register range as zeroed memory at its own address
+ * @param base, size, the range
+ * @return none, exits if the range is taken
+ */
+static void map_registers(uintptr_t base, size_t size)
+{
+  void *mapped = mmap((void *) base, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE | MAP_NORESERVE, -1, 0);
+
+  if (mapped != (void *) base)
+    {
+      fprintf(stderr, "platform_stub: cannot map the registers at 0x%08lx\n", (unsigned long) base);
+      exit(2);
+    }
+} // map_registers()
+
+/*
+ * @brief LETIMER0 clock ticks from sleeptimer tick 0 to a tick, the sleeptimer is the
+ *        LFXO so the LFXO clock keeps its phase
+ * @param tick, the sleeptimer tick
+ * @return the LETIMER0 ticks
+ */
+static uint64_t letimer_ticks_at(uint32_t tick)
+{
+  return ((uint64_t) tick * hostLetimerHz()) / HOST_SLEEPTIMER_HZ;
+} // letimer_ticks_at()
+
+/*
+ * @brief The LETIMER0 count now: down from the count at letimer_since to 0, then from
+ *        COMP0 again (comp0Top)
+ * @param none
+ * @return the count
+ */
+static uint32_t letimer_count(void)
+{
+  uint64_t top = letimer_compare[0];
+  uint64_t elapsed;
+
+  if (!letimer_running)
+    return letimer_counter;
+  elapsed = letimer_ticks_at(hostNowTicks()) - letimer_ticks_at(letimer_since);
+  if (elapsed <= letimer_counter)
+    return letimer_counter - (uint32_t) elapsed;
+  return (uint32_t) (top - ((elapsed - letimer_counter - 1) % (top + 1)));
+} // letimer_count()
+
+/*
+ * @brief The first LETIMER0 tick after now that an event repeating every reload falls on
+ * @param first, a tick it falls on
+ * @param now, the current tick
+ * @return the tick
+ */
+static uint64_t letimer_next(uint64_t first, uint64_t now)
+{
+  uint64_t period = (uint64_t) letimer_compare[0] + 1;
+
+  if (first <= now)
+    first += (((now - first) / period) + 1) * period;
+  return first;
+} // letimer_next()
+
+/*
+ * @brief Keeps the count reached so far, before LETIMER0 stops or changes clock
+ * @param none
+ * @return none
+ */
+static void letimer_rebase(void)
+{
+  letimer_counter = letimer_count();
+  letimer_since   = hostNowTicks();
+} // letimer_rebase()
+
+/*
+ * @brief Counts a wakeup out of the sleep mode, for HOST_WAKEUP_US. One that starts while
+ *        the MCU is still awake for another shares it.
+ * @param none
+ * @return none
+ */
+static void wake(void)
+{
+  uint64_t now_us = ((uint64_t) hostNowTicks() * 1000000) / HOST_SLEEPTIMER_HZ;
+
+  if (now_us < awake_until_us)
+    {
+      wakeup_stats.shared++;
+      return;
+    }
+  wakeup_stats.wakeups++;
+  wakeup_stats.awake_us += HOST_WAKEUP_US;
+  awake_until_us = now_us + HOST_WAKEUP_US;
+} // wake()
+
+/*
+ * Harness
+ */
+
+__attribute__((constructor)) void hostInit(void)
+{
+  map_registers(PERIPHERAL_BASE, PERIPHERAL_SIZE);
+  map_registers(CORE_BASE, CORE_SIZE);
+} // hostInit()
+
+void hostReset(void)
+{
+  hostBtReset();
+  hostSleeptimerReset();
+  hostLinkReset();
+  // Pulled up, the buttons are not pressed
+  for (int port = 0; port < (int) (sizeof(GPIO->P) / sizeof(GPIO->P[0])); port++)
+    {
+      for (unsigned int pin = 0; pin < 16; pin++)
+        hostSetPin((GPIO_Port_TypeDef) port, pin, 1);
+    }
+  HOST_REG(GPIO->IF) = 0;
+  HOST_REG(CMU->STATUS) = 0;
+  memset(em_requirements, 0, sizeof(em_requirements));
+  memset(&wakeup_stats, 0, sizeof(wakeup_stats));
+  awake_until_us  = 0;
+  letimer_counter = 0;
+  letimer_since   = 0;
+  letimer_running = false;
+  letimer_lfxo    = true;
+  letimer_div     = 1;
+  HOST_REG(LETIMER0->IEN) = 0;
+  HOST_REG(LETIMER0->IF)  = 0;
+  i2c_transfer  = NULL;
+  i2c_transfers = 0;
+  hostSi7021Set(SI7021_DEFAULT_C);
+} // hostReset()
+
+void hostSetPin(GPIO_Port_TypeDef port, unsigned int pin, unsigned int level)
+{
+  if (level)
+    HOST_REG(GPIO->P[port].DIN) |= (1u << pin);
+  else
+    HOST_REG(GPIO->P[port].DIN) &= ~(1u << pin);
+  HOST_BITBAND(GPIO->P[port].DIN, pin) = (level != 0);
+} // hostSetPin()
+
+void hostPinEdge(GPIO_Port_TypeDef port, unsigned int pin, unsigned int level)
+{
+  void GPIO_EVEN_IRQHandler(void);
+  void GPIO_ODD_IRQHandler(void);
+
+  hostSetPin(port, pin, level);
+  if (!(GPIO->IEN & (1u << pin)))
+    return; // interrupt not enabled
+  HOST_REG(GPIO->IF) |= (1u << pin);
+  hostEmTransition(hostSleepEm(), SL_POWER_MANAGER_EM0);
+  if (pin & 1)
+    GPIO_ODD_IRQHandler();
+  else
+    GPIO_EVEN_IRQHandler();
+  hostEmTransition(SL_POWER_MANAGER_EM0, hostSleepEm());
+  HOST_REG(GPIO->IF) &= ~(1u << pin); // GPIO_IntClear() wrote IFC, plain memory keeps IF
+} // hostPinEdge()
+
+void hostSi7021Set(float celsius)
+{
+  // Inverse of the conversion in read_temp_from_si7021(), Si7021 datasheet 5.1.2, rounded
+  // up as the firmware truncates to whole degrees
+  si7021_raw = (uint16_t) ceilf(((celsius + 46.85f) * 65536.0f) / 175.72f);
+} // hostSi7021Set()
+
+uint32_t hostI2cTransfers(void)
+{
+  return i2c_transfers;
+} // hostI2cTransfers()
+
+/**
+ * @brief Completes the I2C transfer in flight: a read gets the Si7021 reading, MSB
+ *        first, and I2C0_IRQHandler() runs as on the last byte. Called from hostRun().
+ *
+ * @return true if a transfer was in flight
+ */
+bool hostI2cComplete(void)
+{
+  void I2C0_IRQHandler(void);
+
+  if (i2c_transfer == NULL)
+    return false;
+  if ((i2c_transfer->flags & I2C_FLAG_READ) && (i2c_transfer->buf[0].len >= 2))
+    {
+      i2c_transfer->buf[0].data[0] = (uint8_t) (si7021_raw >> 8);
+      i2c_transfer->buf[0].data[1] = (uint8_t) si7021_raw;
+    }
+  i2c_transfer = NULL;
+  hostEmTransition(hostSleepEm(), SL_POWER_MANAGER_EM0);
+  I2C0_IRQHandler();
+  hostEmTransition(SL_POWER_MANAGER_EM0, hostSleepEm());
+  return true;
+} // hostI2cComplete()
+
+void hostLogTo(FILE *file)
+{
+  log_file = file;
+} // hostLogTo()
+
+void hostEmTransition(sl_power_manager_em_t from, sl_power_manager_em_t to)
+{
+  // ENTERING_EMn is bit 2n, LEAVING_EMn bit 2n+1
+  uint32_t events = (1u << (2 * to)) | (1u << (2 * from + 1));
+
+  if ((to == SL_POWER_MANAGER_EM0) && (from != SL_POWER_MANAGER_EM0))
+    wake();
+  for (int i = 0; i < EM_HANDLES_MAX; i++)
+    {
+      if ((em_handles[i] != NULL) && (em_handles[i]->info->event_mask & events))
+        em_handles[i]->info->on_event(from, to);
+    }
+} // hostEmTransition()
+
+sl_power_manager_em_t hostSleepEm(void)
+{
+  if (em_requirements[SL_POWER_MANAGER_EM1] > 0)
+    return SL_POWER_MANAGER_EM1;
+  if (em_requirements[SL_POWER_MANAGER_EM2] > 0)
+    return SL_POWER_MANAGER_EM2;
+  return SL_POWER_MANAGER_EM3;
+} // hostSleepEm()
+
+/**
+ * @brief Keeps the MCU in EM0 for awake_us from now, longer than a wakeup with nothing else
+ *        to do. Called from hostRun() for the radio time of a connection event.
+ *
+ * @param awake_us, the EM0 time it needs
+ *
+ * @return none
+ */
+void hostStayAwake(uint32_t awake_us)
+{
+  uint64_t until = ((uint64_t) hostNowTicks() * 1000000) / HOST_SLEEPTIMER_HZ + awake_us;
+
+  if (until > awake_until_us)
+    {
+      wakeup_stats.awake_us += until - awake_until_us;
+      awake_until_us = until;
+    }
+} // hostStayAwake()
+
+const host_wakeup_stats_t *hostWakeups(void)
+{
+  return &wakeup_stats;
+} // hostWakeups()
+
+/**
+ * @brief Returns the sleeptimer tick of the next enabled LETIMER0 interrupt, the underflow
+ *        or the COMP1 match, and its flags. The ones at or before the current tick have
+ *        been run. Called from hostAdvanceTicks().
+ *
+ * @param tick, out: the tick
+ *
+ * @return the LETIMER_IF_* flags, 0 if no interrupt is enabled
+ */
+uint32_t hostLetimerNextInterrupt(uint64_t *tick)
+{
+  uint64_t hz    = hostLetimerHz();
+  uint64_t at    = letimer_ticks_at(letimer_since);
+  uint64_t now   = letimer_ticks_at(hostNowTicks());
+  uint64_t next  = UINT64_MAX;
+  uint32_t flags = 0;
+  uint64_t due[2];
+
+  if (!letimer_running)
+    return 0;
+  // The count reaches 0 then reloads, an underflow every top + 1 ticks from there
+  due[0] = letimer_next(at + letimer_counter + 1, now);
+  // The count reaches COMP1 once a reload
+  if (letimer_compare[1] <= letimer_counter)
+    due[1] = letimer_next(at + (letimer_counter - letimer_compare[1]), now);
+  else
+    due[1] = letimer_next(at + letimer_counter + 1 + (letimer_compare[0] - letimer_compare[1]), now);
+
+  if (LETIMER0->IEN & LETIMER_IEN_UF)
+    {
+      next  = due[0];
+      flags = LETIMER_IF_UF;
+    }
+  if ((LETIMER0->IEN & LETIMER_IEN_COMP1) && (letimer_compare[1] <= letimer_compare[0]) && (due[1] <= next))
+    {
+      flags = (due[1] == next) ? (flags | LETIMER_IF_COMP1) : LETIMER_IF_COMP1;
+      next  = due[1];
+    }
+  if (flags != 0)
+    *tick = ((next * HOST_SLEEPTIMER_HZ) + hz - 1) / hz;
+  return flags;
+} // hostLetimerNextInterrupt()
+
+/**
+ * @brief Runs LETIMER0_IRQHandler() out of the sleep mode. Called from hostAdvanceTicks()
+ *        at the tick hostLetimerNextInterrupt() returned.
+ *
+ * @param flags, its LETIMER_IF_* flags
+ *
+ * @return none
+ */
+void hostLetimerInterrupt(uint32_t flags)
+{
+  void LETIMER0_IRQHandler(void);
+
+  HOST_REG(LETIMER0->IF) |= flags;
+  hostEmTransition(hostSleepEm(), SL_POWER_MANAGER_EM0);
+  LETIMER0_IRQHandler();
+  hostEmTransition(SL_POWER_MANAGER_EM0, hostSleepEm());
+  HOST_REG(LETIMER0->IF) &= ~flags; // LETIMER_IntClear() wrote IFC
+} // hostLetimerInterrupt()
+
+uint32_t hostLetimerHz(void)
+{
+  return (letimer_lfxo ? HOST_SLEEPTIMER_HZ : HOST_ULFRCO_HZ) / letimer_div;
+} // hostLetimerHz()
+
+uint32_t hostCycleCount(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t) ((((uint64_t) now.tv_sec * 1000000000u) + (uint64_t) now.tv_nsec) * (HOST_CORE_HZ / 1000000) / 1000);
+} // hostCycleCount()
+
+int hostRunBooted(void (*test)(void))
+{
+  int   counts[2] = { 0, 1 }; // checks, failures, one failure if the child dies
+  int   fds[2];
+  pid_t child;
+
+  if (pipe(fds) != 0)
+    return 1;
+  fflush(stdout);
+  child = fork();
+  if (child == 0)
+    {
+      sl_bt_msg_t evt = { 0 };
+
+      close(fds[0]);
+      host_checks   = 0;
+      host_failures = 0;
+      hostReset(); // buttons up, PB0+PB1 held at boot would switch the role
+      app_init();
+      hostEvent(sl_bt_evt_system_boot_id, &evt);
+      test();
+      counts[0] = host_checks;
+      counts[1] = host_failures;
+      fflush(stdout);
+      _exit((write(fds[1], counts, sizeof(counts)) == sizeof(counts)) ? 0 : 1);
+    }
+  close(fds[1]);
+  if ((child < 0) || (read(fds[0], counts, sizeof(counts)) != sizeof(counts)))
+    {
+      counts[0] = 0;
+      counts[1] = 1;
+    }
+  close(fds[0]);
+  if (child > 0)
+    waitpid(child, NULL, 0);
+  host_checks   += counts[0];
+  host_failures += counts[1];
+  return counts[1];
+} // hostRunBooted()
+
+int hostSummary(const char *name)
+{
+  printf("%s: %d checks, %d failed\n", name, host_checks, host_failures);
+  return (host_failures == 0) ? 0 : 1;
+} // hostSummary()
+
+/*
+ * CMSIS
+ */
+
+void hostNvicDisableIRQ(IRQn_Type IRQn)
+{
+  NVIC->ICER[((uint32_t) IRQn) >> 5] = (1UL << (((uint32_t) IRQn) & 0x1FUL));
+} // hostNvicDisableIRQ()
+
+uint32_t SystemCoreClockGet(void)
+{
+  return HOST_CORE_HZ;
+} // SystemCoreClockGet()
+
+/*
+ * emlib
+ */
+
+CORE_irqState_t CORE_EnterCritical(void)                                    { return 0; }
+void CORE_ExitCritical(CORE_irqState_t irqState)                            { (void) irqState; }
+
+uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock)                          { (void) clock; return HOST_CORE_HZ; }
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable)                  { (void) clock; (void) enable; }
+
+void CMU_ClockDivSet(CMU_Clock_TypeDef clock, CMU_ClkDiv_TypeDef div)
+{
+  if ((clock != cmuClock_LETIMER0) || (div == 0))
+    return;
+  letimer_rebase();
+  letimer_div = div;
+} // CMU_ClockDivSet()
+
+void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref)
+{
+  if (clock != cmuClock_LFA)
+    return;
+  letimer_rebase();
+  letimer_lfxo = (ref == cmuSelect_LFXO);
+} // CMU_ClockSelectSet()
+
+void CMU_OscillatorEnable(CMU_Osc_TypeDef osc, bool enable, bool wait)
+{
+  (void) wait;
+  // The LFXO is the sleeptimer's clock, it is already running
+  if ((osc == cmuOsc_LFXO) && enable)
+    HOST_REG(CMU->STATUS) |= CMU_STATUS_LFXORDY;
+} // CMU_OscillatorEnable()
+
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out)
+{
+  (void) port;
+  (void) pin;
+  (void) mode;
+  (void) out; // DIN keeps the level the test set, buttons up after hostReset()
+} // GPIO_PinModeSet()
+
+void GPIO_DriveStrengthSet(GPIO_Port_TypeDef port, GPIO_DriveStrength_TypeDef strength)
+{
+  (void) port;
+  (void) strength;
+} // GPIO_DriveStrengthSet()
+
+void GPIO_ExtIntConfig(GPIO_Port_TypeDef port, unsigned int pin, unsigned int intNo, bool risingEdge,
+                       bool fallingEdge, bool enable)
+{
+  (void) port;
+  (void) pin;
+  (void) risingEdge;
+  (void) fallingEdge;
+  if (enable)
+    GPIO->IEN |= (1u << intNo);
+  else
+    GPIO->IEN &= ~(1u << intNo);
+} // GPIO_ExtIntConfig()
+
+void LETIMER_Init(LETIMER_TypeDef *letimer, const LETIMER_Init_TypeDef *init) { (void) letimer; (void) init; }
+
+void LETIMER_Enable(LETIMER_TypeDef *letimer, bool enable)
+{
+  (void) letimer;
+  letimer_rebase();
+  letimer_running = enable;
+} // LETIMER_Enable()
+
+void LETIMER_CompareSet(LETIMER_TypeDef *letimer, unsigned int comp, uint32_t value)
+{
+  (void) letimer;
+  if (comp == 0)
+    letimer_rebase(); // the reloads so far used the old top
+  letimer_compare[comp & 1] = value;
+} // LETIMER_CompareSet()
+
+uint32_t LETIMER_CompareGet(LETIMER_TypeDef *letimer, unsigned int comp)
+{
+  (void) letimer;
+  // letimerMilliseconds() divides by COMP0, never let it be 0
+  return ((comp == 0) && (letimer_compare[0] == 0)) ? 1 : letimer_compare[comp & 1];
+} // LETIMER_CompareGet()
+
+void LETIMER_CounterSet(LETIMER_TypeDef *letimer, uint32_t value)
+{
+  (void) letimer;
+  letimer_counter = value;
+  letimer_since   = hostNowTicks();
+} // LETIMER_CounterSet()
+
+uint32_t LETIMER_CounterGet(LETIMER_TypeDef *letimer)
+{
+  (void) letimer;
+  return letimer_count();
+} // LETIMER_CounterGet()
+
+void I2CSPM_Init(I2CSPM_Init_TypeDef *init)
+{
+  (void) init;
+} // I2CSPM_Init()
+
+I2C_TransferReturn_TypeDef I2C_TransferInit(I2C_TypeDef *i2c, I2C_TransferSeq_TypeDef *seq)
+{
+  (void) i2c;
+  i2c_transfer = seq; // completed by hostI2cComplete()
+  i2c_transfers++;
+  return i2cTransferInProgress;
+} // I2C_TransferInit()
+
+I2C_TransferReturn_TypeDef I2C_Transfer(I2C_TypeDef *i2c)
+{
+  (void) i2c;
+  return i2cTransferDone;
+} // I2C_Transfer()
+
+/*
+ * LCD
+ */
+
+/*
+ * @brief The memlcd driver's EXTCOMIN toggle, a wakeup that does nothing else here
+ * @param handle, data, unused
+ * @return none
+ */
+static void memlcd_toggled(sl_sleeptimer_timer_handle_t *handle, void *data)
+{
+  (void) handle;
+  (void) data;
+} // memlcd_toggled()
+
+EMSTATUS DMD_init(DMD_InitConfig *initConfig)
+{
+  (void) initConfig;
+  // The driver toggles EXTCOMIN on its own sleeptimer until DMD_sleep()
+  sl_sleeptimer_start_periodic_timer(&memlcd_toggle, HOST_SLEEPTIMER_HZ / EXTCOMIN_MEMLCD_TOGGLES_PER_S,
+                                     memlcd_toggled, NULL, 0, 0);
+  return DMD_OK;
+} // DMD_init()
+
+EMSTATUS DMD_sleep(void)
+{
+  sl_sleeptimer_stop_timer(&memlcd_toggle);
+  return DMD_OK;
+} // DMD_sleep()
+
+EMSTATUS DMD_updateDisplay(void)                                  { return DMD_OK; }
+EMSTATUS GLIB_contextInit(GLIB_Context_t *pContext)               { (void) pContext; return GLIB_OK; }
+EMSTATUS GLIB_clear(GLIB_Context_t *pContext)                     { (void) pContext; return GLIB_OK; }
+EMSTATUS GLIB_setFont(GLIB_Context_t *pContext, GLIB_Font_t *pFont) { (void) pContext; (void) pFont; return GLIB_OK; }
+
+EMSTATUS GLIB_drawStringOnLine(GLIB_Context_t *pContext, const char *pString, uint8_t line, GLIB_Align_t align,
+                               int32_t xOffset, int32_t yOffset, bool opaque)
+{
+  (void) pContext;
+  (void) align;
+  (void) xOffset;
+  (void) yOffset;
+  (void) opaque;
+  if (getenv("HOST_TRACE") != NULL)
+    printf("%10u lcd %2u \"%s\"\n", (unsigned int) hostNowTicks(), (unsigned int) line, pString);
+  return GLIB_OK;
+} // GLIB_drawStringOnLine()
+
+/*
+ * Power manager
+ */
+
+void sl_power_manager_subscribe_em_transition_event(sl_power_manager_em_transition_event_handle_t *event_handle,
+                                                    const sl_power_manager_em_transition_event_info_t *event_info)
+{
+  event_handle->info = (sl_power_manager_em_transition_event_info_t *) event_info;
+  for (int i = 0; i < EM_HANDLES_MAX; i++)
+    {
+      if ((em_handles[i] == NULL) || (em_handles[i] == event_handle))
+        {
+          em_handles[i] = event_handle;
+          return;
+        }
+    }
+  fprintf(stderr, "platform_stub: more than %d EM transition subscribers\n", EM_HANDLES_MAX);
+  abort();
+} // sl_power_manager_subscribe_em_transition_event()
+
+void sli_power_manager_update_em_requirement(sl_power_manager_em_t em, bool add)
+{
+  if ((em != SL_POWER_MANAGER_EM1) && (em != SL_POWER_MANAGER_EM2))
+    return;
+  if (add)
+    em_requirements[em]++;
+  else if (em_requirements[em] > 0)
+    em_requirements[em]--;
+} // sli_power_manager_update_em_requirement()
+
+/*
+ * Memory, the mbedtls allocator of the benchmark build
+ */
+
+void *sl_calloc(size_t item_count, size_t size)
+{
+  return calloc(item_count, size);
+} // sl_calloc()
+
+void sl_free(void *ptr)
+{
+  free(ptr);
+} // sl_free()
+
+/*
+ * Log
+ */
+
+void _app_log_time()    {}
+void _app_log_counter() {}
+
+sl_status_t sl_iostream_printf(sl_iostream_t *stream, const char *format, ...)
+{
+  va_list args;
+
+  (void) stream;
+  if (getenv("HOST_TRACE") != NULL)
+    {
+      va_start(args, format);
+      vprintf(format, args);
+      va_end(args);
+    }
+  if (log_file != NULL)
+    {
+      va_start(args, format);
+      vfprintf(log_file, format, args);
+      va_end(args);
+    }
+  return SL_STATUS_OK;
+} // sl_iostream_printf()
+
+int32_t sl_status_get_string_n(sl_status_t status, char *buffer, uint32_t buffer_length)
+{
+  return snprintf(buffer, buffer_length, "0x%04x", (unsigned int) status);
+} // sl_status_get_string_n()
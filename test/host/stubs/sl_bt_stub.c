@@ -0,0 +1,663 @@
+/*
+ * File name: sl_bt_stub.c
+ * File description: This file defines the host stand-ins of the sl_bt commands the
+ *                   firmware calls. Each command is counted and its last call kept for the
+ *                   tests, and returns SL_STATUS_OK unless hostBtFailNext() asked otherwise.
+ *                   The NVM and the local GATT database are kept in memory so a value
+ *                   written can be read back. External signals are collected until
+ *                   hostDeliverSignals() hands them to sl_bt_on_event(). Soft timers run
+ *                   on the sleeptimer and deliver their event when they lapse. The connection,
+ *                   scanner, GATT client and Security Manager commands are also passed to
+ *                   the link and peer models, link_stub.c and peer_stub.c.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] Silicon Labs Bluetooth API reference https://docs.silabs.com/bluetooth/3.2/
+ */
+
+#include <stdlib.h>
+#include "host.h"
+#include "stubs.h"
+
+// Distinct commands the firmware calls
+#define API_MAX       (64)
+// NVM keys and local attributes kept
+#define STORE_MAX     (32)
+#define STORE_VALUE   (64)
+// Soft timer handles, sl_bt_system_set_soft_timer()
+#define SOFT_TIMER_MAX (4)
+
+typedef struct
+{
+  const char     *api;
+  uint32_t        count;
+  host_bt_call_t  last;
+  bool            fail_pending;
+  sl_status_t     fail_status;
+} api_entry_t;
+
+typedef struct
+{
+  bool     in_use;
+  uint16_t key;
+  uint8_t  value[STORE_VALUE];
+  size_t   len;
+} store_entry_t;
+
+static api_entry_t   apis[API_MAX];
+static store_entry_t nvm[STORE_MAX];        // kept across hostReset(), as NVM is across resets
+static store_entry_t attributes[STORE_MAX];
+static uint32_t      pending_signals = 0;
+static uint32_t      signal_counts[32];
+static uint8_t       next_connection = 1;
+static FILE         *journal = NULL;       // hostBtJournalTo()
+static sl_sleeptimer_timer_handle_t soft_timers[SOFT_TIMER_MAX]; // the stack's soft timers run on the sleeptimer
+
+void sl_bt_on_event(sl_bt_msg_t *evt);
+
+/*
+ * @brief Finds a command's entry, adds it on first use
+ * @param api, the function name
+ * @return the entry
+ */
+static api_entry_t *find_api(const char *api)
+{
+  for (int i = 0; i < API_MAX; i++)
+    {
+      if (apis[i].api == NULL)
+        {
+          apis[i].api = api;
+          return &apis[i];
+        }
+      if (strcmp(apis[i].api, api) == 0)
+        return &apis[i];
+    }
+  fprintf(stderr, "sl_bt_stub: more than %d commands, raise API_MAX\n", API_MAX);
+  abort();
+} // find_api()
+
+/*
+ * @brief Prints one command as a line, with the virtual time
+ * @param file, where to
+ * @param call, the command
+ * @return none
+ */
+static void print_call(FILE *file, const host_bt_call_t *call)
+{
+  fprintf(file, "%10u bt %s(%u, %u, %u, %u)", (unsigned int) hostNowTicks(), call->api,
+          (unsigned int) call->args[0], (unsigned int) call->args[1], (unsigned int) call->args[2],
+          (unsigned int) call->args[3]);
+  for (size_t i = 0; (i < call->len) && (i < HOST_BT_DATA_MAX); i++)
+    fprintf(file, " %02x", call->data[i]);
+  fprintf(file, "\n");
+} // print_call()
+
+/*
+ * @brief Logs one command and returns its status
+ * @param api, the function name
+ * @param a0, a1, a2, a3, integer arguments, 0 if unused
+ * @param data, len, payload, NULL if none
+ * @return SL_STATUS_OK, or the status set by hostBtFailNext()
+ */
+static sl_status_t log_call(const char *api, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3,
+                            const void *data, size_t len)
+{
+  api_entry_t *entry = find_api(api);
+
+  entry->count++;
+  memset(&entry->last, 0, sizeof(entry->last));
+  entry->last.api     = api;
+  entry->last.args[0] = a0;
+  entry->last.args[1] = a1;
+  entry->last.args[2] = a2;
+  entry->last.args[3] = a3;
+  entry->last.len     = len;
+  if (data != NULL)
+    memcpy(entry->last.data, data, (len < HOST_BT_DATA_MAX) ? len : HOST_BT_DATA_MAX);
+
+  if (getenv("HOST_TRACE") != NULL)
+    print_call(stdout, &entry->last);
+  if (journal != NULL)
+    print_call(journal, &entry->last);
+
+  if (entry->fail_pending)
+    {
+      entry->fail_pending = false;
+      return entry->fail_status;
+    }
+  return SL_STATUS_OK;
+} // log_call()
+
+/*
+ * @brief Finds a stored value, adds it if asked to
+ * @param store, the NVM or the attributes
+ * @param key, NVM key or attribute handle
+ * @param add, take a free entry if the key has none
+ * @return the entry, NULL if none
+ */
+static store_entry_t *find_store(store_entry_t *store, uint16_t key, bool add)
+{
+  store_entry_t *free_entry = NULL;
+
+  for (int i = 0; i < STORE_MAX; i++)
+    {
+      if (store[i].in_use && (store[i].key == key))
+        return &store[i];
+      if (!store[i].in_use && (free_entry == NULL))
+        free_entry = &store[i];
+    }
+  if (!add || (free_entry == NULL))
+    return NULL;
+  free_entry->in_use = true;
+  free_entry->key    = key;
+  free_entry->len    = 0;
+  return free_entry;
+} // find_store()
+
+/*
+ * @brief Stores a value
+ * @param store, the NVM or the attributes
+ * @param key, NVM key or attribute handle
+ * @param offset, where the value starts
+ * @param value, len, the value
+ * @return SL_STATUS_OK, SL_STATUS_NO_MORE_RESOURCE if it does not fit
+ */
+static sl_status_t store_value(store_entry_t *store, uint16_t key, size_t offset, const uint8_t *value, size_t len)
+{
+  store_entry_t *entry = find_store(store, key, true);
+
+  if ((entry == NULL) || ((offset + len) > STORE_VALUE))
+    return SL_STATUS_NO_MORE_RESOURCE;
+  memcpy(&entry->value[offset], value, len);
+  if ((offset + len) > entry->len)
+    entry->len = offset + len;
+  return SL_STATUS_OK;
+} // store_value()
+
+/*
+ * @brief Reads a stored value
+ * @param store, the NVM or the attributes
+ * @param key, NVM key or attribute handle
+ * @param offset, first byte
+ * @param max_value_size, value_len, value, as in the sl_bt read commands
+ * @return SL_STATUS_OK, not_found if the key was never written
+ */
+static sl_status_t load_value(store_entry_t *store, uint16_t key, size_t offset, size_t max_value_size,
+                              size_t *value_len, uint8_t *value, sl_status_t not_found)
+{
+  store_entry_t *entry = find_store(store, key, false);
+  size_t         len;
+
+  if (entry == NULL)
+    return not_found;
+  len = (offset < entry->len) ? (entry->len - offset) : 0;
+  if (len > max_value_size)
+    len = max_value_size;
+  memcpy(value, &entry->value[offset], len);
+  *value_len = len;
+  return SL_STATUS_OK;
+} // load_value()
+
+/*
+ * Harness
+ */
+
+/**
+ * @brief Clears the command counts, forced statuses, signals and local attributes.
+ *        Called from hostReset().
+ */
+void hostBtReset(void)
+{
+  memset(apis, 0, sizeof(apis));
+  memset(attributes, 0, sizeof(attributes));
+  memset(signal_counts, 0, sizeof(signal_counts));
+  pending_signals = 0;
+  next_connection = 1;
+} // hostBtReset()
+
+uint32_t hostBtCount(const char *api)
+{
+  return find_api(api)->count;
+} // hostBtCount()
+
+const host_bt_call_t *hostBtLast(const char *api)
+{
+  api_entry_t *entry = find_api(api);
+
+  return (entry->count > 0) ? &entry->last : NULL;
+} // hostBtLast()
+
+void hostBtJournalTo(FILE *file)
+{
+  journal = file;
+} // hostBtJournalTo()
+
+void hostBtFailNext(const char *api, sl_status_t status)
+{
+  api_entry_t *entry = find_api(api);
+
+  entry->fail_pending = true;
+  entry->fail_status  = status;
+} // hostBtFailNext()
+
+uint32_t hostSignalCount(uint32_t signal)
+{
+  for (int i = 0; i < 32; i++)
+    {
+      if (signal == (1u << i))
+        return signal_counts[i];
+    }
+  return 0;
+} // hostSignalCount()
+
+uint32_t hostTakeSignals(void)
+{
+  uint32_t signals = pending_signals;
+
+  pending_signals = 0;
+  return signals;
+} // hostTakeSignals()
+
+uint32_t hostDeliverSignals(void)
+{
+  sl_bt_msg_t evt;
+  uint32_t    signals = hostTakeSignals();
+
+  if (signals == 0)
+    return 0;
+  memset(&evt, 0, sizeof(evt));
+  evt.data.evt_system_external_signal.extsignals = signals;
+  hostEvent(sl_bt_evt_system_external_signal_id, &evt);
+  return signals;
+} // hostDeliverSignals()
+
+void hostEvent(uint32_t id, sl_bt_msg_t *evt)
+{
+  uint32_t len = sizeof(evt->data); // the stack sends the event's own fields only
+
+  // Payload length in bits 8-15, its bits 8-10 in bits 0-2, see SL_BGAPI_MSG_LEN()
+  evt->header = id | ((len & 0xff) << 8) | ((len >> 8) & 0x7);
+  if (getenv("HOST_TRACE") != NULL)
+    printf("%10u evt 0x%08x\n", (unsigned int) hostNowTicks(), (unsigned int) id);
+  sl_bt_on_event(evt);
+} // hostEvent()
+
+/*
+ * @brief Sleeptimer callback of a soft timer, delivers its event
+ * @param handle, the sleeptimer
+ * @param data, the soft timer's handle
+ * @return none
+ */
+static void soft_timer_lapsed(sl_sleeptimer_timer_handle_t *handle, void *data)
+{
+  sl_bt_msg_t evt;
+
+  (void) handle;
+  memset(&evt, 0, sizeof(evt));
+  evt.data.evt_system_soft_timer.handle = (uint8_t) (uintptr_t) data;
+  hostEvent(sl_bt_evt_system_soft_timer_id, &evt);
+} // soft_timer_lapsed()
+
+/*
+ * sl_bt commands
+ */
+
+void sl_bt_external_signal(uint32_t signals)
+{
+  pending_signals |= signals;
+  for (int i = 0; i < 32; i++)
+    {
+      if (signals & (1u << i))
+        signal_counts[i]++;
+    }
+} // sl_bt_external_signal()
+
+void sl_bt_system_reset(uint8_t dfu)
+{
+  log_call(__func__, dfu, 0, 0, 0, NULL, 0);
+} // sl_bt_system_reset()
+
+sl_status_t sl_bt_system_get_identity_address(bd_addr *address, uint8_t *type)
+{
+  static const bd_addr identity = { { 0x01, 0x00, 0x00, 0x57, 0x0b, 0x00 } };
+
+  *address = identity;
+  *type    = 0;
+  return log_call(__func__, 0, 0, 0, 0, NULL, 0);
+} // sl_bt_system_get_identity_address()
+
+sl_status_t sl_bt_system_set_soft_timer(uint32_t time, uint8_t handle, uint8_t single_shot)
+{
+  sl_sleeptimer_timer_handle_t *timer = &soft_timers[handle % SOFT_TIMER_MAX];
+
+  // time 0 stops the timer, its ticks are the sleeptimer's 32768 Hz
+  sl_sleeptimer_stop_timer(timer);
+  if (time > 0)
+    {
+      if (single_shot)
+        sl_sleeptimer_start_timer(timer, time, soft_timer_lapsed, (void *) (uintptr_t) handle, 0, 0);
+      else
+        sl_sleeptimer_start_periodic_timer(timer, time, soft_timer_lapsed, (void *) (uintptr_t) handle, 0, 0);
+    }
+  return log_call(__func__, time, handle, single_shot, 0, NULL, 0);
+} // sl_bt_system_set_soft_timer()
+
+sl_status_t sl_bt_advertiser_create_set(uint8_t *handle)
+{
+  *handle = 0;
+  return log_call(__func__, 0, 0, 0, 0, NULL, 0);
+} // sl_bt_advertiser_create_set()
+
+sl_status_t sl_bt_advertiser_set_data(uint8_t handle, uint8_t packet_type, size_t adv_data_len, const uint8_t *adv_data)
+{
+  sl_status_t sc = log_call(__func__, handle, packet_type, 0, 0, adv_data, adv_data_len);
+
+  if (sc == SL_STATUS_OK)
+    hostLinkAdvertiserData(packet_type, adv_data_len);
+  return sc;
+} // sl_bt_advertiser_set_data()
+
+sl_status_t sl_bt_advertiser_set_timing(uint8_t handle, uint32_t interval_min, uint32_t interval_max,
+                                        uint16_t duration, uint8_t maxevents)
+{
+  sl_status_t sc = log_call(__func__, handle, interval_min, interval_max, duration | ((uint32_t) maxevents << 16), NULL, 0);
+
+  if (sc == SL_STATUS_OK)
+    hostLinkAdvertiserTiming(interval_max);
+  return sc;
+} // sl_bt_advertiser_set_timing()
+
+sl_status_t sl_bt_advertiser_start(uint8_t handle, uint8_t discover, uint8_t connect)
+{
+  sl_status_t sc = log_call(__func__, handle, discover, connect, 0, NULL, 0);
+
+  if (sc == SL_STATUS_OK)
+    hostLinkAdvertiserStart(connect);
+  return sc;
+} // sl_bt_advertiser_start()
+
+sl_status_t sl_bt_scanner_set_mode(uint8_t phys, uint8_t scan_mode)
+{
+  return log_call(__func__, phys, scan_mode, 0, 0, NULL, 0);
+} // sl_bt_scanner_set_mode()
+
+sl_status_t sl_bt_scanner_set_timing(uint8_t phys, uint16_t scan_interval, uint16_t scan_window)
+{
+  sl_status_t sc = log_call(__func__, phys, scan_interval, scan_window, 0, NULL, 0);
+
+  if (sc == SL_STATUS_OK)
+    hostPeerScanTiming(scan_interval, scan_window);
+  return sc;
+} // sl_bt_scanner_set_timing()
+
+sl_status_t sl_bt_scanner_start(uint8_t scanning_phy, uint8_t discover_mode)
+{
+  sl_status_t sc = log_call(__func__, scanning_phy, discover_mode, 0, 0, NULL, 0);
+
+  if (sc == SL_STATUS_OK)
+    hostPeerScanning(true);
+  return sc;
+} // sl_bt_scanner_start()
+
+sl_status_t sl_bt_scanner_stop()
+{
+  sl_status_t sc = log_call(__func__, 0, 0, 0, 0, NULL, 0);
+
+  if (sc == SL_STATUS_OK)
+    hostPeerScanning(false);
+  return sc;
+} // sl_bt_scanner_stop()
+
+sl_status_t sl_bt_connection_open(bd_addr address, uint8_t address_type, uint8_t initiating_phy, uint8_t *connection)
+{
+  sl_status_t sc;
+
+  *connection = next_connection++;
+  sc = log_call(__func__, address_type, initiating_phy, *connection, 0, address.addr, sizeof(address.addr));
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return hostPeerConnect(address, *connection);
+} // sl_bt_connection_open()
+
+sl_status_t sl_bt_connection_close(uint8_t connection)
+{
+  sl_status_t sc = log_call(__func__, connection, 0, 0, 0, NULL, 0);
+
+  if (sc == SL_STATUS_OK)
+    hostLinkLocalClose(connection);
+  return sc;
+} // sl_bt_connection_close()
+
+sl_status_t sl_bt_connection_set_default_parameters(uint16_t min_interval, uint16_t max_interval, uint16_t latency,
+                                                    uint16_t timeout, uint16_t min_ce_length, uint16_t max_ce_length)
+{
+  sl_status_t sc;
+
+  (void) min_ce_length;
+  (void) max_ce_length;
+  sc = log_call(__func__, min_interval, max_interval, latency, timeout, NULL, 0);
+  if (sc == SL_STATUS_OK)
+    hostLinkDefaultParameters(max_interval, latency, timeout);
+  return sc;
+} // sl_bt_connection_set_default_parameters()
+
+sl_status_t sl_bt_connection_set_parameters(uint8_t connection, uint16_t min_interval, uint16_t max_interval,
+                                            uint16_t latency, uint16_t timeout, uint16_t min_ce_length,
+                                            uint16_t max_ce_length)
+{
+  sl_status_t sc;
+
+  (void) min_ce_length;
+  (void) max_ce_length;
+  sc = log_call(__func__, connection, min_interval | ((uint32_t) max_interval << 16), latency, timeout, NULL, 0);
+  if (sc == SL_STATUS_OK)
+    hostLinkSetParameters(connection, max_interval, latency, timeout);
+  return sc;
+} // sl_bt_connection_set_parameters()
+
+sl_status_t sl_bt_connection_set_preferred_phy(uint8_t connection, uint8_t preferred_phy, uint8_t accepted_phy)
+{
+  sl_status_t sc = log_call(__func__, connection, preferred_phy, accepted_phy, 0, NULL, 0);
+
+  if (sc == SL_STATUS_OK)
+    hostLinkSetPreferredPhy(connection, preferred_phy);
+  return sc;
+} // sl_bt_connection_set_preferred_phy()
+
+sl_status_t sl_bt_gatt_set_max_mtu(uint16_t max_mtu, uint16_t *max_mtu_out)
+{
+  sl_status_t sc = log_call(__func__, max_mtu, 0, 0, 0, NULL, 0);
+
+  *max_mtu_out = max_mtu;
+  if (sc == SL_STATUS_OK)
+    hostPeerMaxMtu(max_mtu);
+  return sc;
+} // sl_bt_gatt_set_max_mtu()
+
+sl_status_t sl_bt_gatt_discover_primary_services(uint8_t connection)
+{
+  sl_status_t sc = log_call(__func__, connection, 0, 0, 0, NULL, 0);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return hostPeerRequest(connection, HOST_PEER_DISCOVER_SERVICES, 0, 0, NULL, 0);
+} // sl_bt_gatt_discover_primary_services()
+
+sl_status_t sl_bt_gatt_discover_primary_services_by_uuid(uint8_t connection, size_t uuid_len, const uint8_t *uuid)
+{
+  sl_status_t sc = log_call(__func__, connection, 0, 0, 0, uuid, uuid_len);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return hostPeerRequest(connection, HOST_PEER_DISCOVER_SERVICES_BY_UUID, 0, 0, uuid, uuid_len);
+} // sl_bt_gatt_discover_primary_services_by_uuid()
+
+sl_status_t sl_bt_gatt_discover_characteristics(uint8_t connection, uint32_t service)
+{
+  sl_status_t sc = log_call(__func__, connection, service, 0, 0, NULL, 0);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return hostPeerRequest(connection, HOST_PEER_DISCOVER_CHARACTERISTICS, service, 0, NULL, 0);
+} // sl_bt_gatt_discover_characteristics()
+
+sl_status_t sl_bt_gatt_discover_characteristics_by_uuid(uint8_t connection, uint32_t service, size_t uuid_len,
+                                                        const uint8_t *uuid)
+{
+  sl_status_t sc = log_call(__func__, connection, service, 0, 0, uuid, uuid_len);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return hostPeerRequest(connection, HOST_PEER_DISCOVER_CHARACTERISTICS_BY_UUID, service, 0, uuid, uuid_len);
+} // sl_bt_gatt_discover_characteristics_by_uuid()
+
+sl_status_t sl_bt_gatt_discover_descriptors(uint8_t connection, uint16_t characteristic)
+{
+  return log_call(__func__, connection, characteristic, 0, 0, NULL, 0);
+} // sl_bt_gatt_discover_descriptors()
+
+sl_status_t sl_bt_gatt_set_characteristic_notification(uint8_t connection, uint16_t characteristic, uint8_t flags)
+{
+  sl_status_t sc = log_call(__func__, connection, characteristic, flags, 0, NULL, 0);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return hostPeerRequest(connection, HOST_PEER_WRITE_CCCD, characteristic, flags, NULL, 0);
+} // sl_bt_gatt_set_characteristic_notification()
+
+sl_status_t sl_bt_gatt_read_characteristic_value(uint8_t connection, uint16_t characteristic)
+{
+  sl_status_t sc = log_call(__func__, connection, characteristic, 0, 0, NULL, 0);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return hostPeerRequest(connection, HOST_PEER_READ, characteristic, 0, NULL, 0);
+} // sl_bt_gatt_read_characteristic_value()
+
+sl_status_t sl_bt_gatt_read_characteristic_value_by_uuid(uint8_t connection, uint32_t service, size_t uuid_len,
+                                                         const uint8_t *uuid)
+{
+  sl_status_t sc = log_call(__func__, connection, service, 0, 0, uuid, uuid_len);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return hostPeerRequest(connection, HOST_PEER_READ_BY_UUID, service, 0, uuid, uuid_len);
+} // sl_bt_gatt_read_characteristic_value_by_uuid()
+
+sl_status_t sl_bt_gatt_read_multiple_characteristic_values(uint8_t connection, size_t characteristic_list_len,
+                                                           const uint8_t *characteristic_list)
+{
+  sl_status_t sc = log_call(__func__, connection, 0, 0, 0, characteristic_list, characteristic_list_len);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return hostPeerRequest(connection, HOST_PEER_READ_MULTIPLE, 0, 0, characteristic_list, characteristic_list_len);
+} // sl_bt_gatt_read_multiple_characteristic_values()
+
+sl_status_t sl_bt_gatt_send_characteristic_confirmation(uint8_t connection)
+{
+  sl_status_t sc = log_call(__func__, connection, 0, 0, 0, NULL, 0);
+
+  if (sc == SL_STATUS_OK)
+    hostPeerConfirmation(connection);
+  return sc;
+} // sl_bt_gatt_send_characteristic_confirmation()
+
+sl_status_t sl_bt_gatt_server_write_attribute_value(uint16_t attribute, uint16_t offset, size_t value_len,
+                                                    const uint8_t *value)
+{
+  sl_status_t sc = log_call(__func__, attribute, offset, 0, 0, value, value_len);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return store_value(attributes, attribute, offset, value, value_len);
+} // sl_bt_gatt_server_write_attribute_value()
+
+sl_status_t sl_bt_gatt_server_read_attribute_value(uint16_t attribute, uint16_t offset, size_t max_value_size,
+                                                   size_t *value_len, uint8_t *value)
+{
+  sl_status_t sc = log_call(__func__, attribute, offset, 0, 0, NULL, 0);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return load_value(attributes, attribute, offset, max_value_size, value_len, value, SL_STATUS_BT_ATT_INVALID_HANDLE);
+} // sl_bt_gatt_server_read_attribute_value()
+
+sl_status_t sl_bt_gatt_server_send_indication(uint8_t connection, uint16_t characteristic, size_t value_len,
+                                              const uint8_t *value)
+{
+  sl_status_t sc = log_call(__func__, connection, characteristic, 0, 0, value, value_len);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return hostLinkIndication(connection, characteristic, value_len);
+} // sl_bt_gatt_server_send_indication()
+
+sl_status_t sl_bt_nvm_save(uint16_t key, size_t value_len, const uint8_t *value)
+{
+  sl_status_t sc = log_call(__func__, key, 0, 0, 0, value, value_len);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return store_value(nvm, key, 0, value, value_len);
+} // sl_bt_nvm_save()
+
+sl_status_t sl_bt_nvm_load(uint16_t key, size_t max_value_size, size_t *value_len, uint8_t *value)
+{
+  sl_status_t sc = log_call(__func__, key, 0, 0, 0, NULL, 0);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return load_value(nvm, key, 0, max_value_size, value_len, value, SL_STATUS_BT_PS_KEY_NOT_FOUND);
+} // sl_bt_nvm_load()
+
+sl_status_t sl_bt_nvm_erase(uint16_t key)
+{
+  store_entry_t *entry = find_store(nvm, key, false);
+
+  if (entry != NULL)
+    entry->in_use = false;
+  return log_call(__func__, key, 0, 0, 0, NULL, 0);
+} // sl_bt_nvm_erase()
+
+sl_status_t sl_bt_sm_configure(uint8_t flags, uint8_t io_capabilities)
+{
+  return log_call(__func__, flags, io_capabilities, 0, 0, NULL, 0);
+} // sl_bt_sm_configure()
+
+sl_status_t sl_bt_sm_store_bonding_configuration(uint8_t max_bonding_count, uint8_t policy_flags)
+{
+  return log_call(__func__, max_bonding_count, policy_flags, 0, 0, NULL, 0);
+} // sl_bt_sm_store_bonding_configuration()
+
+sl_status_t sl_bt_sm_delete_bondings()
+{
+  sl_status_t sc = log_call(__func__, 0, 0, 0, 0, NULL, 0);
+
+  if (sc == SL_STATUS_OK)
+    hostPeerDeleteBondings();
+  return sc;
+} // sl_bt_sm_delete_bondings()
+
+sl_status_t sl_bt_sm_increase_security(uint8_t connection)
+{
+  sl_status_t sc = log_call(__func__, connection, 0, 0, 0, NULL, 0);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return hostPeerIncreaseSecurity(connection);
+} // sl_bt_sm_increase_security()
+
+sl_status_t sl_bt_sm_bonding_confirm(uint8_t connection, uint8_t confirm)
+{
+  return log_call(__func__, connection, confirm, 0, 0, NULL, 0);
+} // sl_bt_sm_bonding_confirm()
+
+sl_status_t sl_bt_sm_passkey_confirm(uint8_t connection, uint8_t confirm)
+{
+  sl_status_t sc = log_call(__func__, connection, confirm, 0, 0, NULL, 0);
+
+  if (sc != SL_STATUS_OK)
+    return sc;
+  return hostPeerPasskeyConfirm(connection, confirm);
+} // sl_bt_sm_passkey_confirm()
@@ -0,0 +1,232 @@
+/*
+ * File name: sleeptimer_stub.c
+ * File description: This file defines the host sl_sleeptimer, a virtual clock at
+ *                   HOST_SLEEPTIMER_HZ that only moves when a test advances it. The timers
+ *                   started by the firmware run their callbacks at their own tick while the
+ *                   clock is advanced, one shots once and periodic ones every period, in the
+ *                   order they fall due, with the LETIMER0 underflow and COMP1 interrupts
+ *                   when they are enabled. Tick and ms conversions round as the SDK does.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ * Reference:
+ *  [1] Silicon Labs sleeptimer documentation https://docs.silabs.com/gecko-platform/3.2/service/api/group-sleeptimer
+ *  [2] gecko_sdk_3.2.3/platform/service/sleeptimer/src/sl_sleeptimer.c (conversions)
+ */
+
+#include <stdlib.h>
+#include "host.h"
+#include "stubs.h"
+
+// Timers running at the same time
+#define TIMER_MAX (32)
+
+typedef struct
+{
+  sl_sleeptimer_timer_handle_t *handle;   // NULL if the slot is free
+  uint64_t                      due;      // tick the callback runs at
+} running_timer_t;
+
+static running_timer_t timers[TIMER_MAX];
+static uint64_t        now = 0;
+
+/*
+ * @brief Finds the slot of a running timer
+ * @param handle, the timer
+ * @return the slot, NULL if it is not running
+ */
+static running_timer_t *find_timer(const sl_sleeptimer_timer_handle_t *handle)
+{
+  for (int i = 0; i < TIMER_MAX; i++)
+    {
+      if (timers[i].handle == handle)
+        return &timers[i];
+    }
+  return NULL;
+} // find_timer()
+
+/*
+ * @brief Starts a timer, replacing it if it runs
+ * @param handle, timeout, callback, callback_data, the timer
+ * @param periodic, true to restart it after every callback
+ * @return SL_STATUS_OK, SL_STATUS_NO_MORE_RESOURCE if TIMER_MAX timers run
+ */
+static sl_status_t start(sl_sleeptimer_timer_handle_t *handle, uint32_t timeout,
+                         sl_sleeptimer_timer_callback_t callback, void *callback_data, bool periodic)
+{
+  running_timer_t *slot = find_timer(handle);
+
+  if (slot == NULL)
+    slot = find_timer(NULL);
+  if (slot == NULL)
+    return SL_STATUS_NO_MORE_RESOURCE;
+  handle->callback         = callback;
+  handle->callback_data    = callback_data;
+  handle->timeout_periodic = periodic ? timeout : 0;
+  slot->handle = handle;
+  slot->due    = now + timeout;
+  return SL_STATUS_OK;
+} // start()
+
+/**
+ * @brief Stops every timer and sets the clock to 0. Called from hostReset().
+ */
+void hostSleeptimerReset(void)
+{
+  memset(timers, 0, sizeof(timers));
+  now = 0;
+} // hostSleeptimerReset()
+
+void hostAdvanceTicks(uint32_t ticks)
+{
+  uint64_t end = now + ticks;
+
+  for (;;)
+    {
+      running_timer_t              *next = NULL;
+      sl_sleeptimer_timer_handle_t *handle;
+      uint64_t                      letimer_due;
+      uint32_t                      flags;
+
+      for (int i = 0; i < TIMER_MAX; i++)
+        {
+          if ((timers[i].handle != NULL) && (timers[i].due <= end) && ((next == NULL) || (timers[i].due < next->due)))
+            next = &timers[i];
+        }
+      // The LETIMER0 interrupts the firmware enabled
+      flags = hostLetimerNextInterrupt(&letimer_due);
+      if ((flags != 0) && (letimer_due <= end) && ((next == NULL) || (letimer_due < next->due)))
+        {
+          now = letimer_due;
+          hostLetimerInterrupt(flags);
+          continue;
+        }
+      if (next == NULL)
+        break;
+
+      handle = next->handle;
+      now    = next->due;
+      if (handle->timeout_periodic != 0)
+        next->due += handle->timeout_periodic;
+      else
+        next->handle = NULL;
+      // The callback may restart or stop this timer or others
+      hostEmTransition(hostSleepEm(), SL_POWER_MANAGER_EM0);
+      handle->callback(handle, handle->callback_data);
+      hostEmTransition(SL_POWER_MANAGER_EM0, hostSleepEm());
+    }
+  now = end;
+} // hostAdvanceTicks()
+
+void hostAdvanceMs(uint32_t ms)
+{
+  hostAdvanceTicks((uint32_t) (((uint64_t) ms * HOST_SLEEPTIMER_HZ) / 1000));
+} // hostAdvanceMs()
+
+void hostAdvanceToUs(uint64_t us)
+{
+  uint64_t tick = (us * HOST_SLEEPTIMER_HZ) / 1000000;
+
+  if (tick > now)
+    hostAdvanceTicks((uint32_t) (tick - now));
+} // hostAdvanceToUs()
+
+uint32_t hostNowTicks(void)
+{
+  return (uint32_t) now;
+} // hostNowTicks()
+
+/*
+ * sl_sleeptimer
+ */
+
+uint32_t sl_sleeptimer_get_tick_count(void)
+{
+  return (uint32_t) now;
+} // sl_sleeptimer_get_tick_count()
+
+uint32_t sl_sleeptimer_get_timer_frequency(void)
+{
+  return HOST_SLEEPTIMER_HZ;
+} // sl_sleeptimer_get_timer_frequency()
+
+sl_status_t sl_sleeptimer_ms32_to_tick(uint32_t time_ms, uint32_t *tick)
+{
+  *tick = (uint32_t) ((((uint64_t) time_ms * HOST_SLEEPTIMER_HZ) / 1000u) + 1);
+  return SL_STATUS_OK;
+} // sl_sleeptimer_ms32_to_tick()
+
+uint32_t sl_sleeptimer_ms_to_tick(uint16_t time_ms)
+{
+  return (uint32_t) ((((uint64_t) time_ms * HOST_SLEEPTIMER_HZ) / 1000u) + 1);
+} // sl_sleeptimer_ms_to_tick()
+
+uint32_t sl_sleeptimer_tick_to_ms(uint32_t tick)
+{
+  return (uint32_t) (((uint64_t) tick * 1000u) / HOST_SLEEPTIMER_HZ);
+} // sl_sleeptimer_tick_to_ms()
+
+sl_status_t sl_sleeptimer_start_timer(sl_sleeptimer_timer_handle_t *handle, uint32_t timeout,
+                                      sl_sleeptimer_timer_callback_t callback, void *callback_data,
+                                      uint8_t priority, uint16_t option_flags)
+{
+  (void) priority;
+  (void) option_flags;
+  if (find_timer(handle) != NULL)
+    return SL_STATUS_NOT_READY; // already running, as the SDK
+  return start(handle, timeout, callback, callback_data, false);
+} // sl_sleeptimer_start_timer()
+
+sl_status_t sl_sleeptimer_restart_timer(sl_sleeptimer_timer_handle_t *handle, uint32_t timeout,
+                                        sl_sleeptimer_timer_callback_t callback, void *callback_data,
+                                        uint8_t priority, uint16_t option_flags)
+{
+  (void) priority;
+  (void) option_flags;
+  return start(handle, timeout, callback, callback_data, false);
+} // sl_sleeptimer_restart_timer()
+
+sl_status_t sl_sleeptimer_start_periodic_timer(sl_sleeptimer_timer_handle_t *handle, uint32_t timeout,
+                                               sl_sleeptimer_timer_callback_t callback, void *callback_data,
+                                               uint8_t priority, uint16_t option_flags)
+{
+  (void) priority;
+  (void) option_flags;
+  if (find_timer(handle) != NULL)
+    return SL_STATUS_NOT_READY;
+  return start(handle, timeout, callback, callback_data, true);
+} // sl_sleeptimer_start_periodic_timer()
+
+sl_status_t sl_sleeptimer_restart_periodic_timer(sl_sleeptimer_timer_handle_t *handle, uint32_t timeout,
+                                                 sl_sleeptimer_timer_callback_t callback, void *callback_data,
+                                                 uint8_t priority, uint16_t option_flags)
+{
+  (void) priority;
+  (void) option_flags;
+  return start(handle, timeout, callback, callback_data, true);
+} // sl_sleeptimer_restart_periodic_timer()
+
+sl_status_t sl_sleeptimer_stop_timer(sl_sleeptimer_timer_handle_t *handle)
+{
+  running_timer_t *slot = find_timer(handle);
+
+  if (slot == NULL)
+    return SL_STATUS_INVALID_STATE; // not running, as the SDK
+  slot->handle = NULL;
+  return SL_STATUS_OK;
+} // sl_sleeptimer_stop_timer()
+
+sl_status_t sl_sleeptimer_is_timer_running(sl_sleeptimer_timer_handle_t *handle, bool *running)
+{
+  *running = (find_timer(handle) != NULL);
+  return SL_STATUS_OK;
+} // sl_sleeptimer_is_timer_running()
+
+sl_status_t sl_sleeptimer_get_timer_time_remaining(sl_sleeptimer_timer_handle_t *handle, uint32_t *time)
+{
+  running_timer_t *slot = find_timer(handle);
+
+  if (slot == NULL)
+    return SL_STATUS_INVALID_STATE;
+  *time = (uint32_t) (slot->due - now);
+  return SL_STATUS_OK;
+} // sl_sleeptimer_get_timer_time_remaining()
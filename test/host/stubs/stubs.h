@@ -0,0 +1,91 @@
+/*
+ * File name: stubs.h
+ * File description: This file declares the calls between the host stubs, the tests use
+ *                   host.h only.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+#ifndef TEST_HOST_STUBS_STUBS_H_
+#define TEST_HOST_STUBS_STUBS_H_
+
+#include "host.h"
+
+// sl_bt_stub.c, clears the command log, forced statuses, signals and local attributes
+void hostBtReset(void);
+
+// sleeptimer_stub.c, stops every timer and sets the clock to 0
+void hostSleeptimerReset(void);
+
+// link_stub.c, forgets every connection and sets the hostRun() time to 0
+void hostLinkReset(void);
+
+// link_stub.c, the commands that reach a modelled connection: an indication goes out at
+// the next event (SL_STATUS_IN_PROGRESS while one is not confirmed), a parameter request
+// and a PHY update apply a few events later, a close at the next event. Unmodelled
+// connections return OK.
+sl_status_t hostLinkIndication(uint8_t connection, uint16_t characteristic, size_t len);
+void hostLinkSetParameters(uint8_t connection, uint16_t max_interval, uint16_t latency, uint16_t timeout);
+void hostLinkSetPreferredPhy(uint8_t connection, uint8_t preferred_phy);
+void hostLinkLocalClose(uint8_t connection);
+
+// link_stub.c, the default parameters of the connections the firmware opens as the
+// central, the connection to a peer opening: sends the firmware
+// sl_bt_evt_connection_opened_id (master) and its parameters, and the connection
+// encrypted: sends the parameters with the new security mode
+void hostLinkDefaultParameters(uint16_t max_interval, uint16_t latency, uint16_t timeout);
+void hostLinkOpenCentral(uint8_t connection, const bd_addr *address, uint8_t bonding);
+void hostLinkEncrypted(uint8_t connection, uint8_t security_mode);
+
+// link_stub.c, the server's advertising set: its interval, the length of its advertising
+// data, and advertising started in a connect mode. The stack stops it when a central
+// connects.
+void hostLinkAdvertiserTiming(uint32_t interval_max);
+void hostLinkAdvertiserData(uint8_t packet_type, size_t len);
+void hostLinkAdvertiserStart(uint8_t connect);
+
+// peer_stub.c, the GATT client procedures of the firmware a peer serves
+typedef enum
+{
+  HOST_PEER_DISCOVER_SERVICES,
+  HOST_PEER_DISCOVER_SERVICES_BY_UUID,
+  HOST_PEER_DISCOVER_CHARACTERISTICS,
+  HOST_PEER_DISCOVER_CHARACTERISTICS_BY_UUID,
+  HOST_PEER_WRITE_CCCD,
+  HOST_PEER_READ,
+  HOST_PEER_READ_BY_UUID,
+  HOST_PEER_READ_MULTIPLE,
+} host_peer_request_t;
+
+// peer_stub.c, forgets every peer and the scanner settings
+void hostPeerReset(void);
+
+// peer_stub.c, what the firmware's commands tell the peers: the scanner, the MTU, the
+// connections it opens, its GATT procedures (SL_STATUS_INVALID_STATE while one is in
+// progress) and its confirmations. Connections that are not to a peer return OK.
+void hostPeerScanTiming(uint16_t interval, uint16_t window);
+void hostPeerScanning(bool on);
+void hostPeerMaxMtu(uint16_t mtu);
+sl_status_t hostPeerConnect(bd_addr address, uint8_t connection);
+sl_status_t hostPeerRequest(uint8_t connection, uint8_t kind, uint32_t handle, uint16_t flags,
+                            const uint8_t *data, size_t len);
+void hostPeerConfirmation(uint8_t connection);
+
+// peer_stub.c, the firmware's Security Manager commands: pair or resume encryption with
+// a peer, the user's answer to the passkey, and the stack's bonds deleted
+sl_status_t hostPeerIncreaseSecurity(uint8_t connection);
+sl_status_t hostPeerPasskeyConfirm(uint8_t connection, uint8_t confirm);
+void hostPeerDeleteBondings(void);
+
+// peer_stub.c, run by the link model: one connection event of a peer's connection (returns
+// the ATT bytes exchanged), its end, and the advertising and sampling up to a point in time
+uint32_t hostPeerLinkEvent(uint8_t connection);
+void hostPeerClosed(uint8_t connection);
+void hostPeerAdvance(uint64_t us);
+
+// platform_stub.c, keeps the MCU awake for awake_us from now, a connection event's radio time
+void hostStayAwake(uint32_t awake_us);
+// platform_stub.c, the LETIMER0 underflow and COMP1 interrupts, run by hostAdvanceTicks()
+uint32_t hostLetimerNextInterrupt(uint64_t *tick);
+void hostLetimerInterrupt(uint32_t flags);
+
+#endif /* TEST_HOST_STUBS_STUBS_H_ */
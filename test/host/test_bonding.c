@@ -0,0 +1,132 @@
+/*
+ * File name: test_bonding.c
+ * File description: This file measures the bonding policy (src/bonding.c) on the host
+ *                   harness with the client role and a peer server. A new server is paired
+ *                   when PB1 reads its encrypted button_state, the test confirms the passkey
+ *                   with PB0 as soon as it shows. After a reconnect the stored bond is used:
+ *                   encryption resumes at the open with no pairing and no passkey. The time
+ *                   from the connection and from the security request to the encrypted link,
+ *                   and the SMP and LL round trips, are printed for both.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// Long enough to scan, connect, discover and subscribe
+#define SETUP_MS          (2000)
+// How long a step waits for the firmware before the test gives up
+#define WAIT_LIMIT_MS     (5000)
+// How long the test holds a button down
+#define HOLD_MS           (50)
+// Round trips of src/peer_stub.c: a pairing, and an encryption start with the stored LTK
+#define PAIRING_ROUND_TRIPS   (8)
+#define RESUME_ROUND_TRIPS    (2)
+
+static const bd_addr peer_address = { { 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 } };
+
+/*
+ * @brief Runs the firmware until a condition holds, a millisecond at a time
+ * @param done, the condition
+ * @param peer, its argument
+ * @return true if it held before WAIT_LIMIT_MS
+ */
+static bool run_until(bool (*done)(int peer), int peer)
+{
+  for (uint32_t ms = 0; ms < WAIT_LIMIT_MS; ms++)
+    {
+      if (done(peer))
+        return true;
+      hostRun(1);
+    }
+  return done(peer);
+} // run_until()
+
+/*
+ * @brief The firmware shows a passkey for PB0
+ */
+static bool passkey_shown(int peer)
+{
+  (void) peer;
+  return get_ble_data_ptr()->servers[0].passkey_available;
+} // passkey_shown()
+
+/*
+ * @brief The peer's link is not encrypted, it opened again
+ */
+static bool plain(int peer)
+{
+  return hostPeerStats(peer)->encrypted_us == 0;
+} // plain()
+
+/*
+ * @brief The peer's link is encrypted
+ */
+static bool encrypted(int peer)
+{
+  return hostPeerStats(peer)->encrypted_us != 0;
+} // encrypted()
+
+/*
+ * @brief A new server is paired once, the reconnect resumes encryption with the bond
+ */
+static void test_pair_then_resume(void)
+{
+  const host_peer_stats_t *stats;
+  const ble_server_t      *server = &get_ble_data_ptr()->servers[0];
+  int                      peer   = hostPeerAdd(&peer_address);
+  uint32_t                 paired_us, round_trips;
+
+  hostRun(SETUP_MS);
+  stats = hostPeerStats(peer);
+  CHECK(stats != NULL);
+  if (stats == NULL)
+    return;
+  CHECK(server->in_use);
+  CHECK_EQ(server->button_characteristic_handle, gattdb_button_state);
+  CHECK_EQ(stats->security_us, 0);
+
+  // PB1 reads button_state, insufficient encryption, the firmware pairs
+  hostPinEdge(PB1_port, PB1_pin, 0);
+  hostRun(HOLD_MS);
+  hostPinEdge(PB1_port, PB1_pin, 1);
+  CHECK(run_until(passkey_shown, peer));
+  CHECK_EQ(server->passkey, 123456);
+  hostPinEdge(PB0_port, PB0_pin, 0);
+  CHECK(run_until(encrypted, peer));
+  paired_us = (uint32_t) (stats->encrypted_us - stats->security_us);
+  hostPinEdge(PB0_port, PB0_pin, 1);
+  hostRun(HOLD_MS);
+  CHECK_EQ(stats->pairings, 1);
+  CHECK_EQ(stats->security_round_trips, PAIRING_ROUND_TRIPS);
+  CHECK_EQ(hostBtCount("sl_bt_sm_passkey_confirm"), 1);
+  CHECK(server->bonding_flag);
+  printf("new server:   encrypted %u ms after the security request, %u ms of it waiting for PB0 and its debounce, "
+         "%u round trips\n", (unsigned int) (paired_us / 1000), (unsigned int) (stats->passkey_wait_us / 1000),
+         (unsigned int) stats->security_round_trips);
+
+  // The bond outlives the connection
+  round_trips = stats->security_round_trips;
+  hostLinkClose(stats->connection);
+  CHECK(run_until(plain, peer));
+  CHECK(run_until(encrypted, peer));
+  hostRun(HOLD_MS);
+  CHECK(server->in_use);
+  CHECK(server->bonding_flag);
+  CHECK_EQ(stats->pairings, 1);
+  CHECK_EQ(stats->security_round_trips - round_trips, RESUME_ROUND_TRIPS);
+  CHECK_EQ(hostBtCount("sl_bt_sm_passkey_confirm"), 1);
+  CHECK(stats->security_us == stats->connected_us);
+  CHECK((stats->encrypted_us - stats->security_us) < paired_us);
+  printf("known server: encrypted %u ms after the open and the security request, %u round trips, no passkey\n",
+         (unsigned int) ((stats->encrypted_us - stats->connected_us) / 1000),
+         (unsigned int) (stats->security_round_trips - round_trips));
+} // test_pair_then_resume()
+
+int main(void)
+{
+  // Boot as the client of the peer
+  roleSave(false, &peer_address);
+  RUN_BOOTED(test_pair_then_resume);
+  return hostSummary("test_bonding");
+} // main()
@@ -0,0 +1,59 @@
+/*
+ * File name: test_boot.c
+ * File description: This file is the host harness smoke test: the firmware initialises,
+ *                   boots as a server and advertises, a client connects and the LETIMER0
+ *                   UF wakeups reach the dispatcher.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+/*
+ * @brief Boot: the server reads its address, creates an advertising set and advertises
+ */
+static void test_boot_advertises(void)
+{
+  sl_bt_msg_t evt = { 0 };
+
+  hostEvent(sl_bt_evt_system_boot_id, &evt);
+  CHECK_EQ(hostBtCount("sl_bt_system_get_identity_address"), 1);
+  CHECK_EQ(hostBtCount("sl_bt_advertiser_create_set"), 1);
+  CHECK(hostBtCount("sl_bt_advertiser_start") >= 1);
+  CHECK(get_ble_data_ptr()->advertising);
+} // test_boot_advertises()
+
+/*
+ * @brief A connection is recorded in the client table
+ */
+static void test_connection_opened(void)
+{
+  sl_bt_msg_t evt = { 0 };
+
+  evt.data.evt_connection_opened.connection = 1;
+  evt.data.evt_connection_opened.bonding    = 0xFF; // not bonded
+  hostEvent(sl_bt_evt_connection_opened_id, &evt);
+  CHECK(get_ble_data_ptr()->connection_open);
+  CHECK_EQ(get_ble_data_ptr()->client_count, 1);
+} // test_connection_opened()
+
+/*
+ * @brief The LETIMER0 period is kept by a sleeptimer and its UF signal is posted
+ */
+static void test_underflow_signal(void)
+{
+  samplerInit();
+  hostAdvanceMs(10000);
+  CHECK(hostSignalCount(evtLETIMER0_UF) >= 1);
+  CHECK(hostDeliverSignals() & evtLETIMER0_UF);
+} // test_underflow_signal()
+
+int main(void)
+{
+  hostReset(); // buttons up, PB0+PB1 held at boot would switch the role
+  app_init();
+  RUN(test_boot_advertises);
+  RUN(test_connection_opened);
+  RUN(test_underflow_signal);
+  return hostSummary("test_boot");
+} // main()
@@ -0,0 +1,219 @@
+/*
+ * File name: test_broadcast.c
+ * File description: This file runs the connectionless broadcast (src/broadcast.h) on the
+ *                   host harness. The server's radio energy per reading is compared with no
+ *                   client connected, the readings going out in the advertising data only,
+ *                   and with one subscribed client, the readings indicated on a relaxed
+ *                   connection. The client's decoder is fed hand built scan reports for its
+ *                   repeats, sequence gaps and wrap around.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// Connect and relax the connection parameters, then the minute that is measured
+#define SETUP_MS      (CONN_PARAMS_RELAX_DELAY_MS + 4000)
+#define MEASURE_MS    (60000)
+
+/*
+ * @brief Radio energy of a radio on time, at LINK_RADIO_CURRENT_UA from LINK_SUPPLY_MV
+ * @param radio_us, the radio on time
+ * @return the energy in uJ
+ */
+static uint32_t radio_uj(uint64_t radio_us)
+{
+  return (uint32_t) ((radio_us * LINK_RADIO_CURRENT_UA * LINK_SUPPLY_MV) / 1000000000);
+} // radio_uj()
+
+/*
+ * @brief Builds the scan report a scanner receives for some advertising data
+ * @param evt, the report
+ * @param sender, last byte of the sender's address
+ * @param data, len, the advertising data
+ * @return none
+ */
+static void make_report(sl_bt_msg_t *evt, uint8_t sender, const uint8_t *data, size_t len)
+{
+  memset(evt, 0, sizeof(*evt));
+  evt->data.evt_scanner_scan_report.packet_type     = 0;
+  evt->data.evt_scanner_scan_report.address.addr[0] = sender;
+  evt->data.evt_scanner_scan_report.bonding         = 0xff;
+  evt->data.evt_scanner_scan_report.data.len        = (uint8_t) len;
+  memcpy(evt->data.evt_scanner_scan_report.data.data, data, len);
+} // make_report()
+
+/*
+ * @brief Decodes the reading the server advertises now
+ * @param reading, returns the reading
+ * @return true if the advertising data carries one
+ */
+static bool advertised(broadcast_reading_t *reading)
+{
+  const host_bt_call_t *call = hostBtLast("sl_bt_advertiser_set_data");
+  sl_bt_msg_t           evt;
+
+  if ((call == NULL) || (call->args[1] != 0))
+    return false;
+  make_report(&evt, 0x01, call->data, call->len);
+  return broadcastDecode(&evt.data.evt_scanner_scan_report, reading);
+} // advertised()
+
+/*
+ * @brief Hands the decoder a broadcast with a sequence number, as the server builds it
+ * @param sender, last byte of the sender's address
+ * @param company_id, BROADCAST_COMPANY_ID, or another to be ignored
+ * @param temperature_centi_c, sequence, the reading
+ * @param reading, returns the reading
+ * @return broadcastReceived()
+ */
+static int receive(uint8_t sender, uint16_t company_id, int16_t temperature_centi_c, uint16_t sequence,
+                   broadcast_reading_t *reading)
+{
+  uint8_t data[] =
+  {
+    0x02, 0x01, 0x06,
+    0x03, 0x03, 0x09, 0x18,
+    BROADCAST_DATA_LEN + 1, AD_TYPE_MANUFACTURER,
+    (uint8_t) company_id, (uint8_t) (company_id >> 8), BROADCAST_FORMAT,
+    (uint8_t) temperature_centi_c, (uint8_t) ((uint16_t) temperature_centi_c >> 8),
+    (uint8_t) sequence, (uint8_t) (sequence >> 8),
+  };
+  sl_bt_msg_t evt;
+
+  make_report(&evt, sender, data, sizeof(data));
+  return broadcastReceived(&evt.data.evt_scanner_scan_report, reading);
+} // receive()
+
+/*
+ * @brief The advertised temperature keeps the 0.01 C of the Si7021 conversion
+ */
+static void test_centi_degrees(void)
+{
+  broadcast_reading_t reading;
+
+  hostSi7021Set(21.37f);
+  hostRun(2 * LETIMER_PERIOD_MS);
+  CHECK(advertised(&reading));
+  CHECK_EQ(reading.temperature_centi_c, 2137);
+  CHECK(reading.sequence > 0);
+
+  hostSi7021Set(-5.12f);
+  hostRun(LETIMER_PERIOD_MS);
+  CHECK(advertised(&reading));
+  CHECK_EQ(reading.temperature_centi_c, -512);
+} // test_centi_degrees()
+
+/*
+ * @brief A minute of readings with no client, in the advertising data only, then with one
+ *        subscribed client: the server's radio energy per reading of each
+ */
+static void test_energy_per_reading(void)
+{
+  const host_adv_stats_t  *adv = hostAdvertiserStats();
+  const host_link_stats_t *link;
+  broadcast_reading_t      first, last;
+  uint32_t                 adv_events, readings, confirmations, broadcast_uj, connected_uj, adv_uj;
+  uint64_t                 broadcast_us, adv_us, link_us;
+
+  // Broadcast only: nobody connects, each reading is in the adverts until the next one
+  hostRun(SETUP_MS);
+  CHECK(advertised(&first));
+  adv_events   = adv->events;
+  broadcast_us = adv->radio_us;
+  hostRun(MEASURE_MS);
+  CHECK(advertised(&last));
+  adv_events   = adv->events - adv_events;
+  broadcast_us = adv->radio_us - broadcast_us;
+  readings     = (uint16_t) (last.sequence - first.sequence);
+  CHECK(readings >= (MEASURE_MS / LETIMER_PERIOD_MS) - 1);
+  if (readings == 0)
+    return;
+  // 250 ms advertising interval, 12 adverts of each 3 s reading
+  CHECK(adv_events >= 11 * readings);
+  CHECK(adv_events <= 13 * readings);
+  broadcast_uj = radio_uj(broadcast_us) / readings;
+
+  // Connected: one client subscribed on the relaxed parameters, advertising goes on for
+  // the free slots
+  hostLinkOpen(1, 24, 0, 0);
+  hostLinkSubscribe(1, gattdb_temperature_measurement, sl_bt_gatt_indication);
+  hostRun(SETUP_MS);
+  link = hostLinkStats(1);
+  CHECK(link != NULL);
+  if (link == NULL)
+    return;
+  CHECK_EQ(link->interval, CONN_STEADY_INTERVAL_MAX);
+  link_us       = link->radio_us;
+  confirmations = link->confirmations;
+  adv_us        = adv->radio_us;
+  hostRun(MEASURE_MS);
+  link_us       = link->radio_us - link_us;
+  confirmations = link->confirmations - confirmations;
+  adv_us        = adv->radio_us - adv_us;
+  CHECK(confirmations >= (MEASURE_MS / LETIMER_PERIOD_MS) - 1);
+  if (confirmations == 0)
+    return;
+  connected_uj = radio_uj(link_us) / confirmations;
+  adv_uj       = radio_uj(adv_us) / confirmations;
+
+  // The radio wakes 12 times for each broadcast reading, the relaxed link about 3 times
+  CHECK(connected_uj < broadcast_uj);
+  printf("broadcast only: %u adverts per reading, %u uJ radio per reading, %u adverts per J\n",
+         (unsigned int) (adv_events / readings), (unsigned int) broadcast_uj,
+         (unsigned int) (((uint64_t) adv_events * 1000000) / radio_uj(broadcast_us)));
+  printf("connected     : %u uJ radio per reading on the link, %u uJ of advertising for the free slots\n",
+         (unsigned int) connected_uj, (unsigned int) adv_uj);
+  hostLinkClose(1);
+} // test_energy_per_reading()
+
+/*
+ * @brief The decoder counts a reading once however many adverts carry it, and counts the
+ *        sequence numbers it never saw
+ */
+static void test_decoder_gaps(void)
+{
+  broadcast_reading_t         reading;
+  broadcast_sender_counters_t counters;
+  int                         a, c;
+
+  // Sender 0xa1: 10, its repeat, 11, then 14 with 12 and 13 missed
+  a = receive(0xa1, BROADCAST_COMPANY_ID, 2137, 10, &reading);
+  CHECK(a >= 0);
+  CHECK_EQ(reading.temperature_centi_c, 2137);
+  CHECK_EQ(reading.sequence, 10);
+  CHECK_EQ(receive(0xa1, BROADCAST_COMPANY_ID, 2137, 10, &reading), -1);
+  CHECK_EQ(receive(0xa1, BROADCAST_COMPANY_ID, 2140, 11, &reading), a);
+  CHECK_EQ(receive(0xa1, BROADCAST_COMPANY_ID, -512, 14, &reading), a);
+  CHECK_EQ(reading.temperature_centi_c, -512);
+  // Another company's data is not a reading
+  CHECK_EQ(receive(0xa1, 0x02ff, 2137, 20, &reading), -1);
+  CHECK(broadcastSenderCounters(a, &counters));
+  CHECK_EQ(counters.readings, 3);
+  CHECK_EQ(counters.missed, 2);
+  CHECK_EQ(counters.adverts, 4);
+
+  // Sender 0xc3 across the 16 bit wrap: 0xfffe, 0xffff, 0, then 2 with 1 missed
+  c = receive(0xc3, BROADCAST_COMPANY_ID, 0, 0xfffe, &reading);
+  CHECK((c >= 0) && (c != a));
+  CHECK_EQ(receive(0xc3, BROADCAST_COMPANY_ID, 0, 0xffff, &reading), c);
+  CHECK_EQ(receive(0xc3, BROADCAST_COMPANY_ID, 0, 0, &reading), c);
+  CHECK_EQ(receive(0xc3, BROADCAST_COMPANY_ID, 0, 2, &reading), c);
+  CHECK(broadcastSenderCounters(c, &counters));
+  CHECK_EQ(counters.readings, 4);
+  CHECK_EQ(counters.missed, 1);
+
+  // The table is full after BROADCAST_MAX_SENDERS senders
+  for (uint8_t sender = 0xd0; sender < 0xd0 + BROADCAST_MAX_SENDERS - 2; sender++)
+    CHECK(receive(sender, BROADCAST_COMPANY_ID, 0, 1, &reading) >= 0);
+  CHECK_EQ(receive(0xee, BROADCAST_COMPANY_ID, 0, 1, &reading), -1);
+  CHECK(!broadcastSenderCounters(BROADCAST_MAX_SENDERS, &counters));
+} // test_decoder_gaps()
+
+int main(void)
+{
+  RUN_BOOTED(test_centi_degrees);
+  RUN_BOOTED(test_energy_per_reading);
+  RUN_BOOTED(test_decoder_gaps);
+  return hostSummary("test_broadcast");
+} // main()
@@ -0,0 +1,139 @@
+/*
+ * File name: test_buttons.c
+ * File description: This file replays button traces through the GPIO interrupts and
+ *                   checks the presses, releases and gestures src/buttons.c posts. Each
+ *                   trace in traces/ lists the edges of PB0/PB1 as "time_us button level";
+ *                   the edges that did not become a press or release are the spurious ones
+ *                   the debounce removed, they are printed per trace.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// Time after the last edge for the debounce and long press timers to finish
+#define SETTLE_MS     (2000)
+
+// Button events the firmware posts, to count them all at once
+static const uint32_t button_events[] =
+{
+  evtPB0_pressed, evtPB0_released, evtPB1_pressed, evtPB1_released
+};
+
+/*
+ * @brief Feeds a trace to the GPIO interrupts at its own times, then lets the timers run
+ * @param name, the file in traces/, without .txt
+ * @return the edges replayed, 0 if the trace could not be read
+ */
+static uint32_t replay(const char *name)
+{
+  char     path[64];
+  char     line[80];
+  uint32_t edges = 0;
+  uint32_t transitions = 0;
+  FILE    *trace;
+
+  snprintf(path, sizeof(path), "traces/%s.txt", name);
+  trace = fopen(path, "r");
+  if (trace == NULL)
+    {
+      printf("%s: cannot open\n", path);
+      CHECK(trace != NULL);
+      return 0;
+    }
+
+  while (fgets(line, sizeof(line), trace) != NULL)
+    {
+      unsigned long long time_us;
+      char               button[4];
+      unsigned int       level;
+
+      if ((line[0] == '#') || (sscanf(line, "%llu %3s %u", &time_us, button, &level) != 3))
+        continue;
+      hostAdvanceToUs(time_us);
+      if (strcmp(button, "PB0") == 0)
+        hostPinEdge(PB0_port, PB0_pin, level);
+      else
+        hostPinEdge(PB1_port, PB1_pin, level);
+      edges++;
+    }
+  fclose(trace);
+  hostAdvanceMs(SETTLE_MS);
+
+  for (size_t i = 0; i < sizeof(button_events) / sizeof(button_events[0]); i++)
+    transitions += hostSignalCount(button_events[i]);
+  printf("%-16s %2u edges, %u presses/releases, %2u spurious removed\n", name, (unsigned int) edges,
+         (unsigned int) transitions, (unsigned int) (edges - transitions));
+  return edges;
+} // replay()
+
+/*
+ * @brief A bounced press and release are posted once each
+ */
+static void test_press_release(void)
+{
+  CHECK_EQ(replay("press_release"), 10);
+  CHECK_EQ(hostSignalCount(evtPB0_pressed), 1);
+  CHECK_EQ(hostSignalCount(evtPB0_released), 1);
+  CHECK_EQ(hostSignalCount(evtPB0_long_press), 0);
+  CHECK(!buttonsPressed(BUTTON_PB0));
+} // test_press_release()
+
+/*
+ * @brief A spike shorter than the debounce time posts nothing
+ */
+static void test_glitch(void)
+{
+  CHECK_EQ(replay("glitch"), 4);
+  CHECK_EQ(hostSignalCount(evtPB0_pressed), 0);
+  CHECK_EQ(hostSignalCount(evtPB0_released), 0);
+} // test_glitch()
+
+/*
+ * @brief A second press soon after a release is a double click, on that press only
+ */
+static void test_double_click(void)
+{
+  CHECK_EQ(replay("double_click"), 12);
+  CHECK_EQ(hostSignalCount(evtPB1_pressed), 2);
+  CHECK_EQ(hostSignalCount(evtPB1_released), 2);
+  CHECK_EQ(hostSignalCount(evtPB1_double_click), 1);
+  CHECK_EQ(hostSignalCount(evtPB0_pressed), 0);
+} // test_double_click()
+
+/*
+ * @brief Held past BUTTONS_LONG_PRESS_MS, a long press is posted before the release
+ */
+static void test_long_press(void)
+{
+  CHECK_EQ(replay("long_press"), 6);
+  CHECK_EQ(hostSignalCount(evtPB0_pressed), 1);
+  CHECK_EQ(hostSignalCount(evtPB0_long_press), 1);
+  CHECK_EQ(hostSignalCount(evtPB0_released), 1);
+  CHECK_EQ(hostSignalCount(evtPB0_double_click), 0);
+} // test_long_press()
+
+/*
+ * @brief Both buttons down is a chord, posted with the second press
+ */
+static void test_chord(void)
+{
+  CHECK_EQ(replay("chord"), 12);
+  CHECK_EQ(hostSignalCount(evtPB_chord), 1);
+  CHECK_EQ(hostSignalCount(evtPB0_pressed), 1);
+  CHECK_EQ(hostSignalCount(evtPB1_pressed), 1);
+  CHECK_EQ(hostSignalCount(evtPB0_released), 1);
+  CHECK_EQ(hostSignalCount(evtPB1_released), 1);
+} // test_chord()
+
+int main(void)
+{
+  hostReset(); // buttons up, PB0+PB1 held at boot would switch the role
+  app_init();
+  RUN(test_press_release);
+  RUN(test_glitch);
+  RUN(test_double_click);
+  RUN(test_long_press);
+  RUN(test_chord);
+  return hostSummary("test_buttons");
+} // main()
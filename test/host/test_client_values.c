@@ -0,0 +1,63 @@
+/*
+ * File name: test_client_values.c
+ * File description: This file measures the client's handling of an HTM indication
+ *                   (src/client_values.c) on the host harness with a peer server: the time
+ *                   sl_bt_on_event() takes per indication, to decode it from the event
+ *                   buffer, confirm it and publish the sample to the ring. The time is host
+ *                   time in HOST_CORE_HZ cycles (hostCycleCount()), so it compares builds
+ *                   on one machine, it is not the time on the board.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// Scan, connect and subscribe, then the steady sampling that is measured
+#define SETUP_MS    (2000)
+#define STEADY_MS   (60000)
+
+static const bd_addr peer_address = { { 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 } };
+
+/*
+ * @brief Every indication is decoded, confirmed and published, the handling time is printed
+ */
+static void test_indication_handling(void)
+{
+  const host_peer_stats_t *stats;
+  const ble_server_t      *server = &get_ble_data_ptr()->servers[0];
+  int                      peer   = hostPeerAdd(&peer_address);
+  uint32_t                 indications, samples;
+  uint64_t                 cycles;
+
+  hostRun(SETUP_MS);
+  stats = hostPeerStats(peer);
+  CHECK(stats != NULL);
+  if (stats == NULL)
+    return;
+  indications = stats->indications;
+  samples     = server->samples;
+  cycles      = stats->handler_cycles_sum;
+  hostRun(STEADY_MS);
+  indications = stats->indications - indications;
+  samples     = server->samples - samples;
+  cycles      = stats->handler_cycles_sum - cycles;
+
+  CHECK(indications >= (STEADY_MS / LETIMER_PERIOD_MS) - 1);
+  CHECK_EQ(samples, indications);
+  CHECK(stats->indications - stats->confirmations <= 1);
+  CHECK_EQ(server->temp_char_value, 25);
+  CHECK(cycles > 0);
+  if (indications == 0)
+    return;
+  printf("%u indications: %u cycles avg, %u max per indication, %u ns avg\n",
+         (unsigned int) indications, (unsigned int) (cycles / indications), (unsigned int) stats->handler_cycles_max,
+         (unsigned int) ((cycles * 1000000000) / ((uint64_t) indications * HOST_CORE_HZ)));
+} // test_indication_handling()
+
+int main(void)
+{
+  // Boot as the client of the peer
+  roleSave(false, &peer_address);
+  RUN_BOOTED(test_indication_handling);
+  return hostSummary("test_client_values");
+} // main()
@@ -0,0 +1,103 @@
+/*
+ * File name: test_coalesce.c
+ * File description: This file measures the wakeup coalescer (src/coalesce.h) on the host
+ *                   harness with one subscribed client. The MCU's distinct wakeups per hour,
+ *                   the wakeups that rode on another, the EM0 time and the modelled average
+ *                   current of ten minutes of sampling are printed. The average is the one of
+ *                   src/energy.c with the EM0 time of the wakeups added, the firmware takes
+ *                   no time on the host. The Makefile builds it both ways, build/test_coalesce
+ *                   with the Si7021 waits, LCD flushes and EXTCOMIN toggles coalesced,
+ *                   build/test_coalesce_off with each of them on its own wakeup: LETIMER0
+ *                   COMP1, the BT stack soft timer and the sl_memlcd toggle timer.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// Connect and relax the connection parameters, then the sampling that is measured
+#define SETUP_MS        (CONN_PARAMS_RELAX_DELAY_MS + 4000)
+#define STEADY_MS       (600000)
+
+#if COALESCE_SENSOR_WAITS
+#define COALESCE_MODE   "coalesced"
+#else
+#define COALESCE_MODE   "not coalesced"
+#endif
+
+/*
+ * @brief Time since boot
+ * @param none
+ * @return the time in ms
+ */
+static uint64_t now_ms(void)
+{
+  return ((uint64_t) hostNowTicks() * 1000) / HOST_SLEEPTIMER_HZ;
+} // now_ms()
+
+/*
+ * @brief Per hour of STEADY_MS
+ * @param count, over STEADY_MS
+ * @return the count per hour
+ */
+static unsigned int per_hour(uint64_t count)
+{
+  return (unsigned int) ((count * MS_PER_HOUR) / STEADY_MS);
+} // per_hour()
+
+/*
+ * @brief Ten minutes of sampling, the wakeups and the average current are printed
+ */
+static void test_wakeups_and_energy(void)
+{
+  const ble_client_t *client = &get_ble_data_ptr()->clients[0];
+  uint32_t            wakeups, shared, indications, comp1, soft_timer;
+  uint64_t            awake_us, start_ms, end_ms, charge;
+
+  hostLinkOpen(1, 24, 0, 0);
+  hostLinkSubscribe(1, gattdb_temperature_measurement, sl_bt_gatt_indication);
+  hostRun(SETUP_MS);
+
+  // The average since boot, less what came before
+  start_ms    = now_ms();
+  charge      = (uint64_t) energyAverageNa() * start_ms;
+  wakeups     = hostWakeups()->wakeups;
+  shared      = hostWakeups()->shared;
+  awake_us    = hostWakeups()->awake_us;
+  indications = client->indications;
+  comp1       = energyGetWakeups(WAKEUP_LETIMER0_COMP1);
+  soft_timer  = energyGetWakeups(WAKEUP_SOFT_TIMER);
+  hostRun(STEADY_MS);
+  end_ms      = now_ms();
+  charge      = (uint64_t) energyAverageNa() * end_ms - charge;
+  wakeups     = hostWakeups()->wakeups - wakeups;
+  shared      = hostWakeups()->shared - shared;
+  awake_us    = hostWakeups()->awake_us - awake_us;
+  indications = client->indications - indications;
+  comp1       = energyGetWakeups(WAKEUP_LETIMER0_COMP1) - comp1;
+  soft_timer  = energyGetWakeups(WAKEUP_SOFT_TIMER) - soft_timer;
+  // The EM0 time of the wakeups, energy.c counted it at the sleep current
+  charge     += (awake_us * (ENERGY_EM0_NA - ENERGY_EM2_NA)) / 1000;
+
+  CHECK(indications >= (STEADY_MS / LETIMER_PERIOD_MS) - 1);
+#if COALESCE_SENSOR_WAITS
+  // The Si7021 waits and EXTCOMIN ride on the other wakeups, nothing wakes for them alone
+  CHECK_EQ(comp1, 0);
+  CHECK_EQ(soft_timer, 0);
+  CHECK(shared > 0);
+#else
+  // Power up and conversion for every sample, a soft timer a second, the memlcd toggles
+  CHECK(comp1 >= 2 * indications);
+  CHECK(soft_timer >= (STEADY_MS / EXTCOMIN_SOFT_TIMER_PERIOD_MS) - 1);
+  CHECK(wakeups >= (STEADY_MS / 1000) * EXTCOMIN_MEMLCD_TOGGLES_PER_S);
+#endif
+  printf("%s: %u wakeups/hr, %u wakeups/hr shared, %u LETIMER0 COMP1/hr, %u soft timer/hr, "
+         "EM0 %u ms/hr, %u nA average\n", COALESCE_MODE, per_hour(wakeups), per_hour(shared), per_hour(comp1),
+         per_hour(soft_timer), per_hour(awake_us / 1000), (unsigned int) (charge / (end_ms - start_ms)));
+} // test_wakeups_and_energy()
+
+int main(void)
+{
+  RUN_BOOTED(test_wakeups_and_energy);
+  return hostSummary("test_coalesce (" COALESCE_MODE ")");
+} // main()
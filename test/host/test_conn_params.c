@@ -0,0 +1,115 @@
+/*
+ * File name: test_conn_params.c
+ * File description: This file measures the connection parameter manager (src/conn_params.c)
+ *                   on the host harness. One client connects on the old fixed parameters
+ *                   (75 ms, latency 4) and subscribes to HTM. The radio on time of the server
+ *                   and the confirmation latency during steady sampling are printed for the
+ *                   manager's requests and for a central that keeps the fixed parameters.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// The parameters ble.c used to set on every connection, 75 ms and latency 4
+#define FIXED_INTERVAL   (60)
+#define FIXED_LATENCY    (4)
+// Setup, then the steady sampling that is measured
+#define SETUP_MS         (CONN_PARAMS_RELAX_DELAY_MS + 4000)
+#define STEADY_MS        (60000)
+
+typedef struct
+{
+  uint64_t radio_us;
+  uint32_t attended;
+  uint32_t indications;
+  uint32_t latency_avg_ms;
+} steady_t;
+
+/*
+ * @brief Connects a client, runs the setup, then measures STEADY_MS of sampling
+ * @param connection, the handle
+ * @param hold, true if the central keeps the fixed parameters
+ * @param steady, out: the measurement
+ * @return none
+ */
+static void measure_steady(uint8_t connection, bool hold, steady_t *steady)
+{
+  const host_link_stats_t *stats;
+  const ble_client_t      *client = &get_ble_data_ptr()->clients[0];
+  uint32_t                 indications, latency_sum_ms;
+
+  memset(steady, 0, sizeof(*steady));
+  hostLinkHoldParameters(hold);
+  hostLinkOpen(connection, FIXED_INTERVAL, FIXED_LATENCY, 0);
+  hostLinkSubscribe(connection, gattdb_temperature_measurement, sl_bt_gatt_indication);
+  hostRun(SETUP_MS);
+  stats = hostLinkStats(connection);
+  CHECK(stats != NULL);
+  if (stats == NULL)
+    return;
+
+  steady->radio_us = stats->radio_us;
+  steady->attended = stats->attended;
+  indications      = client->indications;
+  latency_sum_ms   = client->latency_sum_ms;
+  hostRun(STEADY_MS);
+  steady->radio_us    = stats->radio_us - steady->radio_us;
+  steady->attended    = stats->attended - steady->attended;
+  steady->indications = client->indications - indications;
+  if (steady->indications > 0)
+    steady->latency_avg_ms = (client->latency_sum_ms - latency_sum_ms) / steady->indications;
+
+  printf("%s: interval %u ms latency %u, %u events attended, radio on %u.%03u ms, %u indications, latency avg %u ms\n",
+         hold ? "fixed   " : "adaptive", (unsigned int) ((stats->interval * 125) / 100), (unsigned int) stats->latency,
+         (unsigned int) steady->attended, (unsigned int) (steady->radio_us / 1000), (unsigned int) (steady->radio_us % 1000),
+         (unsigned int) steady->indications, (unsigned int) steady->latency_avg_ms);
+  hostLinkClose(connection);
+  hostRun(1000);
+} // measure_steady()
+
+/*
+ * @brief The setup after open runs on the fast profile
+ */
+static void test_setup_fast(void)
+{
+  const host_link_stats_t *stats;
+
+  hostLinkOpen(1, FIXED_INTERVAL, FIXED_LATENCY, 0);
+  hostLinkSubscribe(1, gattdb_temperature_measurement, sl_bt_gatt_indication);
+  hostRun(1000);
+  stats = hostLinkStats(1);
+  CHECK(stats != NULL);
+  if (stats == NULL)
+    return;
+  CHECK_EQ(stats->interval, CONN_FAST_INTERVAL_MAX);
+  CHECK_EQ(stats->latency, CONN_FAST_LATENCY);
+  hostLinkClose(1);
+} // test_setup_fast()
+
+/*
+ * @brief The manager's steady profile needs less radio on time than the fixed parameters,
+ *        every reading is still confirmed within a few steady intervals
+ */
+static void test_steady_radio_on(void)
+{
+  steady_t fixed, adaptive;
+
+  measure_steady(1, true, &fixed);
+  measure_steady(2, false, &adaptive);
+  CHECK(fixed.indications >= (STEADY_MS / LETIMER_PERIOD_MS) - 1);
+  CHECK(adaptive.indications >= (STEADY_MS / LETIMER_PERIOD_MS) - 1);
+  CHECK(adaptive.radio_us < fixed.radio_us);
+  CHECK(adaptive.attended < fixed.attended);
+  CHECK(adaptive.latency_avg_ms <= (3 * CONN_STEADY_INTERVAL_MAX * 125) / 100);
+  printf("radio on time %u%% of the fixed parameters, latency %u ms instead of %u ms\n",
+         (unsigned int) ((adaptive.radio_us * 100) / ((fixed.radio_us > 0) ? fixed.radio_us : 1)),
+         (unsigned int) adaptive.latency_avg_ms, (unsigned int) fixed.latency_avg_ms);
+} // test_steady_radio_on()
+
+int main(void)
+{
+  RUN_BOOTED(test_setup_fast);
+  RUN_BOOTED(test_steady_radio_on);
+  return hostSummary("test_conn_params");
+} // main()
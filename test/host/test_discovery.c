@@ -0,0 +1,162 @@
+/*
+ * File name: test_discovery.c
+ * File description: This file measures the client's GATT discovery (discovery_state_machine()
+ *                   in src/scheduler.c) against a peer server on the host harness: the time
+ *                   from the connection to the CCCD writes and to the first HTM indication,
+ *                   and the GATT procedures and ATT round trips it took. The Makefile builds
+ *                   it for both discovery modes, build/test_discovery runs the single pass
+ *                   discovery and build/test_discovery_sequential the discovery by UUID.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// Long enough to scan, connect, discover and get a few readings
+#define DISCOVERY_RUN_MS  (10000)
+
+#if DISCOVERY_SINGLE_PASS
+#define DISCOVERY_MODE    "single pass"
+#else
+#define DISCOVERY_MODE    "by UUID"
+#endif
+
+// The discovery by UUID up to its last CCCD write, build/test_discovery_sequential checks
+// it still takes this and build/test_discovery that the single pass takes no more
+#define BY_UUID_PROCEDURES      (6)
+#define BY_UUID_ROUND_TRIPS     (11)
+#define BY_UUID_SUBSCRIBED_MS   (180)
+
+static const bd_addr peer_address = { { 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 } };
+
+typedef struct
+{
+  uint32_t procedures;
+  uint32_t round_trips;
+} discovery_cost_t;
+
+/*
+ * @brief Runs the firmware DISCOVERY_RUN_MS a millisecond at a time, noting the cost of
+ *        the connection's discovery up to its last CCCD write
+ * @param stats, the peer
+ * @param subscribed, out: the procedures and round trips when the last CCCD was written
+ * @return none
+ */
+static void run_to_subscribed(const host_peer_stats_t *stats, discovery_cost_t *subscribed)
+{
+  uint64_t subscribed_us = stats->subscribed_us;
+
+  for (uint32_t ms = 0; ms < DISCOVERY_RUN_MS; ms++)
+    {
+      hostRun(1);
+      if (stats->subscribed_us != subscribed_us)
+        {
+          subscribed_us           = stats->subscribed_us;
+          subscribed->procedures  = stats->procedures;
+          subscribed->round_trips = stats->round_trips;
+        }
+    }
+} // run_to_subscribed()
+
+/*
+ * @brief Prints a connection's discovery, from its open to the first indication
+ * @param what, the connection
+ * @param stats, the peer
+ * @param before, the counts before the connection
+ * @return none
+ */
+static void print_discovery(const char *what, const host_peer_stats_t *stats, const discovery_cost_t *before)
+{
+  printf("%s, %s: subscribed %u ms and first indication %u ms after the open, %u GATT procedures, %u ATT round trips\n",
+         DISCOVERY_MODE, what, (unsigned int) ((stats->subscribed_us - stats->connected_us) / 1000),
+         (unsigned int) ((stats->first_indication_us - stats->connected_us) / 1000),
+         (unsigned int) (stats->procedures - before->procedures),
+         (unsigned int) (stats->round_trips - before->round_trips));
+} // print_discovery()
+
+/*
+ * @brief A new server: the client finds its handles and gets the readings
+ */
+static void test_first_indication(void)
+{
+  const host_peer_stats_t *stats;
+  const ble_server_t      *server = &get_ble_data_ptr()->servers[0];
+  discovery_cost_t         before = { 0 }, subscribed = { 0 };
+  int                      peer   = hostPeerAdd(&peer_address);
+  uint32_t                 subscribed_ms;
+
+  stats = hostPeerStats(peer);
+  CHECK(stats != NULL);
+  if (stats == NULL)
+    return;
+  run_to_subscribed(stats, &subscribed);
+  subscribed_ms = (uint32_t) ((stats->subscribed_us - stats->connected_us) / 1000);
+  CHECK(stats->connection != 0);
+  CHECK(server->in_use);
+  CHECK_EQ(server->htm_characteristic_handle, gattdb_temperature_measurement);
+  CHECK_EQ(server->button_characteristic_handle, gattdb_button_state);
+  CHECK(stats->indications >= 3);
+  CHECK(stats->indications - stats->confirmations <= 1);
+  CHECK(server->samples >= 3);
+  CHECK_EQ(server->temp_char_value, 25);
+#if DISCOVERY_SINGLE_PASS
+  // The Read Multiple on PB1 needs the two HTM characteristics only this pass finds
+  CHECK_EQ(server->temperature_type_handle, gattdb_temperature_type);
+  CHECK_EQ(server->measurement_interval_handle, gattdb_measurement_interval);
+  // The database hash is read after the CCCD writes, the single pass is no slower
+  CHECK(subscribed.procedures <= BY_UUID_PROCEDURES);
+  CHECK(subscribed.round_trips <= BY_UUID_ROUND_TRIPS);
+  CHECK(subscribed_ms <= BY_UUID_SUBSCRIBED_MS);
+#else
+  CHECK_EQ(subscribed.procedures, BY_UUID_PROCEDURES);
+  CHECK_EQ(subscribed.round_trips, BY_UUID_ROUND_TRIPS);
+  CHECK_EQ(subscribed_ms, BY_UUID_SUBSCRIBED_MS);
+#endif
+  print_discovery("new server", stats, &before);
+  printf("%s, new server: %u GATT procedures, %u ATT round trips up to the last CCCD write\n", DISCOVERY_MODE,
+         (unsigned int) subscribed.procedures, (unsigned int) subscribed.round_trips);
+} // test_first_indication()
+
+#if GATT_CACHE_ENABLE
+/*
+ * @brief A server seen before: its database hash matches, the cached handles are used
+ */
+static void test_cached_reconnect(void)
+{
+  const host_peer_stats_t *stats;
+  const ble_server_t      *server = &get_ble_data_ptr()->servers[0];
+  discovery_cost_t         first, before;
+  int                      peer = hostPeerAdd(&peer_address);
+
+  hostRun(DISCOVERY_RUN_MS);
+  stats = hostPeerStats(peer);
+  CHECK(stats != NULL);
+  if (stats == NULL)
+    return;
+  first.procedures  = stats->procedures;
+  first.round_trips = stats->round_trips;
+  before            = first;
+  hostLinkClose(stats->connection);
+  hostRun(DISCOVERY_RUN_MS);
+  CHECK(server->in_use);
+  CHECK_EQ(server->htm_characteristic_handle, gattdb_temperature_measurement);
+  CHECK(stats->first_indication_us > stats->connected_us);
+  // Hash read and the two CCCD writes
+  CHECK_EQ(stats->procedures - before.procedures, 3);
+  CHECK(stats->round_trips - before.round_trips < first.round_trips);
+  // The samples since the reconnect reached the client
+  CHECK(server->samples >= 3);
+  print_discovery("cached server", stats, &before);
+} // test_cached_reconnect()
+#endif
+
+int main(void)
+{
+  // Boot as the client of the peer
+  roleSave(false, &peer_address);
+  RUN_BOOTED(test_first_indication);
+#if GATT_CACHE_ENABLE
+  RUN_BOOTED(test_cached_reconnect);
+#endif
+  return hostSummary("test_discovery (" DISCOVERY_MODE ")");
+} // main()
@@ -0,0 +1,156 @@
+/*
+ * File name: test_em_token.c
+ * File description: This file tests the EM requirement tokens (src/em_token.h) on the host
+ *                   harness. A transient token held across more than EM_TOKEN_LEAK_SLEEPS
+ *                   sleeps is reported as a leak once, a long lived one never. A second
+ *                   acquire and a release without an acquire are counted as errors. The
+ *                   power manager's EM requirements stay balanced, the MCU sleeps in the
+ *                   mode it slept in before the tokens once they are released.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+#define LEAK_MESSAGE    "EM token test_transient leaked?"
+
+/*
+ * @brief One sleep and wakeup of the MCU, as the power manager reports them
+ * @param none
+ * @return none
+ */
+static void sleep_once(void)
+{
+  hostEmTransition(SL_POWER_MANAGER_EM0, hostSleepEm());
+  hostEmTransition(hostSleepEm(), SL_POWER_MANAGER_EM0);
+} // sleep_once()
+
+/*
+ * @brief Counts the lines of the firmware log that contain a text
+ * @param log, the log, written with hostLogTo()
+ * @param text, the text
+ * @return the lines
+ */
+static int log_lines(FILE *log, const char *text)
+{
+  char line[256];
+  int  lines = 0;
+
+  fflush(log);
+  rewind(log);
+  while (fgets(line, sizeof(line), log) != NULL)
+    {
+      if (strstr(line, text) != NULL)
+        lines++;
+    }
+  fseek(log, 0, SEEK_END);
+  return lines;
+} // log_lines()
+
+/*
+ * @brief A transient token held across more than EM_TOKEN_LEAK_SLEEPS sleeps is reported
+ *        once, a long lived one is not, and both give their requirements back
+ */
+static void test_leak(void)
+{
+  static em_token_t      transient  = EM_TOKEN("test_transient", SL_POWER_MANAGER_EM1);
+  static em_token_t      long_lived = EM_TOKEN_LONG_LIVED("test_long_lived", SL_POWER_MANAGER_EM1);
+  FILE                  *log        = tmpfile();
+  sl_power_manager_em_t  sleep_em   = hostSleepEm();
+
+  CHECK(log != NULL);
+  if (log == NULL)
+    return;
+  hostLogTo(log);
+  CHECK(sleep_em > SL_POWER_MANAGER_EM1);
+
+  emTokenAcquire(&transient);
+  emTokenAcquire(&long_lived);
+  CHECK_EQ(hostSleepEm(), SL_POWER_MANAGER_EM1);
+
+  // Up to EM_TOKEN_LEAK_SLEEPS sleeps is not a leak
+  for (int i = 0; i < EM_TOKEN_LEAK_SLEEPS; i++)
+    sleep_once();
+  emTokenReportIfDue();
+  CHECK(!transient.leak_reported);
+  CHECK_EQ(log_lines(log, LEAK_MESSAGE), 0);
+
+  // One more is, and it is reported once per hold
+  sleep_once();
+  emTokenReportIfDue();
+  CHECK(transient.leak_reported);
+  CHECK(!long_lived.leak_reported);
+  for (int i = 0; i < EM_TOKEN_LEAK_SLEEPS; i++)
+    sleep_once();
+  emTokenReportIfDue();
+  CHECK_EQ(log_lines(log, LEAK_MESSAGE), 1);
+  CHECK_EQ(log_lines(log, "EM token test_long_lived leaked?"), 0);
+
+  // Released, the MCU sleeps as before, and the next hold starts over
+  emTokenRelease(&transient);
+  CHECK_EQ(hostSleepEm(), SL_POWER_MANAGER_EM1);
+  emTokenRelease(&long_lived);
+  CHECK_EQ(hostSleepEm(), sleep_em);
+  emTokenAcquire(&transient);
+  CHECK(!transient.leak_reported);
+  emTokenRelease(&transient);
+  CHECK_EQ(hostSleepEm(), sleep_em);
+  CHECK_EQ(transient.holds, 2);
+  CHECK_EQ(transient.errors, 0);
+  CHECK_EQ(long_lived.errors, 0);
+
+  hostLogTo(NULL);
+  fclose(log);
+} // test_leak()
+
+/*
+ * @brief A second acquire and a release without an acquire are counted and ignored, the
+ *        EM requirements stay balanced
+ */
+static void test_errors(void)
+{
+  static em_token_t      token    = EM_TOKEN("test_token", SL_POWER_MANAGER_EM1);
+  static em_token_t      other    = EM_TOKEN("test_other", SL_POWER_MANAGER_EM1);
+  FILE                  *log      = tmpfile();
+  sl_power_manager_em_t  sleep_em = hostSleepEm();
+
+  CHECK(log != NULL);
+  if (log == NULL)
+    return;
+  hostLogTo(log);
+  CHECK(sleep_em > SL_POWER_MANAGER_EM1);
+
+  // Acquired twice, one release gives the requirement back
+  emTokenAcquire(&token);
+  emTokenAcquire(&token);
+  CHECK_EQ(token.errors, 1);
+  CHECK_EQ(token.holds, 1);
+  CHECK_EQ(log_lines(log, "EM token test_token acquired twice"), 1);
+  emTokenRelease(&token);
+  CHECK_EQ(hostSleepEm(), sleep_em);
+
+  // Released again while another token holds EM1, the other's requirement stays
+  emTokenAcquire(&other);
+  emTokenRelease(&token);
+  CHECK_EQ(token.errors, 2);
+  CHECK_EQ(log_lines(log, "EM token test_token released without being acquired"), 1);
+  CHECK_EQ(hostSleepEm(), SL_POWER_MANAGER_EM1);
+  emTokenRelease(&other);
+  CHECK_EQ(hostSleepEm(), sleep_em);
+  CHECK_EQ(other.errors, 0);
+
+  // Released once more after its release
+  emTokenRelease(&other);
+  CHECK_EQ(other.errors, 1);
+  CHECK_EQ(hostSleepEm(), sleep_em);
+
+  hostLogTo(NULL);
+  fclose(log);
+} // test_errors()
+
+int main(void)
+{
+  RUN_BOOTED(test_leak);
+  RUN_BOOTED(test_errors);
+  return hostSummary("test_em_token");
+} // main()
@@ -0,0 +1,247 @@
+/*
+ * File name: test_gatt_batch.c
+ * File description: This file measures the client's PB1 read batching (src/gatt_batch.c)
+ *                   on the host harness with a peer server. The client pairs first,
+ *                   button_state needs an encrypted link, then a PB1 press reads the button
+ *                   state, Temperature Type and Measurement Interval. The GATT procedures,
+ *                   ATT round trips and the time from the press to the last value are
+ *                   printed. The Makefile builds it for both modes, build/test_gatt_batch
+ *                   reads with one Read Multiple and build/test_gatt_batch_single one
+ *                   characteristic per procedure. With Read Multiple, responses cut short by
+ *                   a server's smaller MTU are checked to leave the values that did not fit
+ *                   for the next procedure.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// Long enough to scan, connect, discover and subscribe
+#define SETUP_MS          (2000)
+// How long a step waits for the firmware before the test gives up
+#define WAIT_LIMIT_MS     (5000)
+// How long the test holds a button down
+#define HOLD_MS           (50)
+// Reads of a PB1 press
+#define PB1_READS         (3)
+
+#if GATT_BATCH_ENABLE
+#define BATCH_MODE        "Read Multiple"
+#define PB1_PROCEDURES    (1)
+#else
+#define BATCH_MODE        "single reads"
+#define PB1_PROCEDURES    (PB1_READS)
+#endif
+
+static const bd_addr peer_address = { { 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 } };
+
+#if GATT_BATCH_ENABLE
+// A server with a smaller ATT MTU than the client's default: 4 reads of 8 byte values on a
+// connection no peer runs, so the test answers each procedure
+#define SMALL_MTU_CONNECTION  (9)
+#define SMALL_MTU             (12)
+#define SMALL_MTU_READS       (4)
+#define SMALL_MTU_VALUE_LEN   (8)
+#define SMALL_MTU_HANDLE      (0x40)
+
+static uint16_t small_mtu_handles[SMALL_MTU_READS]; // in the order the values arrived
+static uint8_t  small_mtu_values;
+#endif
+
+/*
+ * @brief Runs the firmware until a condition holds, a millisecond at a time
+ * @param done, the condition
+ * @param peer, its argument
+ * @return the time it took in ms, WAIT_LIMIT_MS if it did not hold
+ */
+static uint32_t run_until(bool (*done)(int peer), int peer)
+{
+  uint32_t ms;
+
+  for (ms = 0; (ms < WAIT_LIMIT_MS) && !done(peer); ms++)
+    hostRun(1);
+  return ms;
+} // run_until()
+
+/*
+ * @brief The firmware shows a passkey for PB0
+ */
+static bool passkey_shown(int peer)
+{
+  (void) peer;
+  return get_ble_data_ptr()->servers[0].passkey_available;
+} // passkey_shown()
+
+/*
+ * @brief The peer's link is encrypted
+ */
+static bool encrypted(int peer)
+{
+  return hostPeerStats(peer)->encrypted_us != 0;
+} // encrypted()
+
+/*
+ * @brief The last read of the PB1 press reached the firmware
+ */
+static bool interval_read(int peer)
+{
+  (void) peer;
+  return get_ble_data_ptr()->servers[0].measurement_interval_s != 0;
+} // interval_read()
+
+/*
+ * @brief Presses and releases a button
+ * @param port, pin, the button
+ * @return none
+ */
+static void click(GPIO_Port_TypeDef port, unsigned int pin)
+{
+  hostPinEdge(port, pin, 0);
+  hostRun(HOLD_MS);
+  hostPinEdge(port, pin, 1);
+} // click()
+
+/*
+ * @brief After pairing, a PB1 press reads its three characteristics in PB1_PROCEDURES
+ *        procedures, one round trip each
+ */
+static void test_pb1_reads(void)
+{
+  const host_peer_stats_t *stats;
+  const ble_server_t      *server = &get_ble_data_ptr()->servers[0];
+  int                      peer   = hostPeerAdd(&peer_address);
+  uint32_t                 procedures, round_trips, ms;
+
+  hostRun(SETUP_MS);
+  stats = hostPeerStats(peer);
+  CHECK(stats != NULL);
+  if (stats == NULL)
+    return;
+  CHECK_EQ(server->button_characteristic_handle, gattdb_button_state);
+
+  // The first press needs the pairing, the passkey is confirmed at once
+  click(PB1_port, PB1_pin);
+  CHECK(run_until(passkey_shown, peer) < WAIT_LIMIT_MS);
+  hostPinEdge(PB0_port, PB0_pin, 0);
+  CHECK(run_until(encrypted, peer) < WAIT_LIMIT_MS);
+  hostPinEdge(PB0_port, PB0_pin, 1);
+  hostRun(HOLD_MS);
+  CHECK_EQ(server->measurement_interval_s, 0);
+
+  procedures  = stats->procedures;
+  round_trips = stats->round_trips;
+  hostPinEdge(PB1_port, PB1_pin, 0);
+  ms = run_until(interval_read, peer);
+  hostPinEdge(PB1_port, PB1_pin, 1);
+  hostRun(HOLD_MS);
+  CHECK(ms < WAIT_LIMIT_MS);
+  CHECK_EQ(server->temperature_type, 2);
+  CHECK_EQ(server->measurement_interval_s, 3);
+  CHECK_EQ(stats->procedures - procedures, PB1_PROCEDURES);
+  CHECK_EQ(stats->round_trips - round_trips, PB1_PROCEDURES);
+  printf("%s: %u reads in %u GATT procedures, %u ATT round trips, %u round trips saved, "
+         "last value %u ms after the press\n", BATCH_MODE, PB1_READS,
+         (unsigned int) (stats->procedures - procedures), (unsigned int) (stats->round_trips - round_trips),
+         (unsigned int) (PB1_READS - (stats->round_trips - round_trips)), (unsigned int) ms);
+} // test_pb1_reads()
+
+#if GATT_BATCH_ENABLE
+/*
+ * @brief Records a value of the small MTU batch, its first byte is its handle
+ */
+static void small_mtu_value(uint8_t connection, uint16_t characteristic, const uint8_t *value, uint8_t len)
+{
+  CHECK_EQ(connection, SMALL_MTU_CONNECTION);
+  CHECK_EQ(len, SMALL_MTU_VALUE_LEN);
+  CHECK_EQ(value[0], (uint8_t) characteristic);
+  if (small_mtu_values < SMALL_MTU_READS)
+    small_mtu_handles[small_mtu_values] = characteristic;
+  small_mtu_values++;
+} // small_mtu_value()
+
+/*
+ * @brief Answers the procedure in flight with the values of its handles, cut at the
+ *        server's ATT_MTU - 1, then completes it
+ * @param handles, the handles asked for, 2 bytes each
+ * @param handles_len, bytes of handles
+ * @param opcode, sl_bt_gatt_read_response or sl_bt_gatt_read_multiple_response
+ * @return none
+ */
+static void small_mtu_respond(const uint8_t *handles, size_t handles_len, uint8_t opcode)
+{
+  sl_bt_msg_t evt;
+  uint8_t     len = 0;
+
+  memset(&evt, 0, sizeof(evt));
+  evt.data.evt_gatt_characteristic_value.connection     = SMALL_MTU_CONNECTION;
+  evt.data.evt_gatt_characteristic_value.characteristic = (uint16_t) (handles[0] | (handles[1] << 8));
+  evt.data.evt_gatt_characteristic_value.att_opcode     = opcode;
+  for (size_t i = 0; (i + 1) < handles_len; i += 2)
+    {
+      for (uint8_t b = 0; (b < SMALL_MTU_VALUE_LEN) && (len < (SMALL_MTU - 1)); b++)
+        evt.data.evt_gatt_characteristic_value.value.data[len++] = handles[i];
+    }
+  evt.data.evt_gatt_characteristic_value.value.len = len;
+  CHECK(gattBatchValue(&evt.data.evt_gatt_characteristic_value));
+
+  memset(&evt, 0, sizeof(evt));
+  evt.data.evt_gatt_procedure_completed.connection = SMALL_MTU_CONNECTION;
+  evt.data.evt_gatt_procedure_completed.result     = 0;
+  CHECK(gattBatchCompleted(&evt.data.evt_gatt_procedure_completed));
+} // small_mtu_respond()
+
+/*
+ * @brief A Read Multiple response cut short by the server's smaller MTU: the values that
+ *        did not fit are asked again in the next procedures, every read gets its value once
+ */
+static void test_small_mtu(void)
+{
+  const host_bt_call_t *call;
+  uint32_t              multiple = hostBtCount("sl_bt_gatt_read_multiple_characteristic_values");
+  uint32_t              single   = hostBtCount("sl_bt_gatt_read_characteristic_value");
+  uint8_t               last[2]  = { SMALL_MTU_HANDLE + SMALL_MTU_READS - 1, 0 };
+
+  small_mtu_values = 0;
+  for (uint16_t i = 0; i < SMALL_MTU_READS; i++)
+    CHECK(gattBatchAdd(SMALL_MTU_CONNECTION, SMALL_MTU_HANDLE + i, SMALL_MTU_VALUE_LEN, small_mtu_value));
+  CHECK_EQ(gattBatchSubmit(SMALL_MTU_CONNECTION), SL_STATUS_OK);
+
+  // The client's default MTU fits 2 values a procedure, the server's SMALL_MTU - 1 bytes
+  // only the first. Each procedure starts at the value that was cut, not after it.
+  for (uint8_t i = 0; i < (SMALL_MTU_READS - 1); i++)
+    {
+      call = hostBtLast("sl_bt_gatt_read_multiple_characteristic_values");
+      CHECK_EQ(hostBtCount("sl_bt_gatt_read_multiple_characteristic_values") - multiple, i + 1);
+      CHECK(call != NULL);
+      if (call == NULL)
+        return;
+      CHECK_EQ(call->len, 4);
+      CHECK_EQ(call->data[0], SMALL_MTU_HANDLE + i);
+      small_mtu_respond(call->data, call->len, sl_bt_gatt_read_multiple_response);
+      CHECK_EQ(small_mtu_values, i + 1);
+    }
+
+  // The last one alone, a plain read
+  call = hostBtLast("sl_bt_gatt_read_characteristic_value");
+  CHECK_EQ(hostBtCount("sl_bt_gatt_read_characteristic_value") - single, 1);
+  CHECK((call != NULL) && (call->args[1] == last[0]));
+  small_mtu_respond(last, sizeof(last), sl_bt_gatt_read_response);
+  CHECK_EQ(hostBtCount("sl_bt_gatt_read_multiple_characteristic_values") - multiple, SMALL_MTU_READS - 1);
+
+  // Every read got its value, once and in order
+  CHECK_EQ(small_mtu_values, SMALL_MTU_READS);
+  for (uint8_t i = 0; i < SMALL_MTU_READS; i++)
+    CHECK_EQ(small_mtu_handles[i], SMALL_MTU_HANDLE + i);
+} // test_small_mtu()
+#endif
+
+int main(void)
+{
+  // Boot as the client of the peer
+  roleSave(false, &peer_address);
+  RUN_BOOTED(test_pb1_reads);
+#if GATT_BATCH_ENABLE
+  RUN_BOOTED(test_small_mtu);
+#endif
+  return hostSummary("test_gatt_batch (" BATCH_MODE ")");
+} // main()
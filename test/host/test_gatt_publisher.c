@@ -0,0 +1,247 @@
+/*
+ * File name: test_gatt_publisher.c
+ * File description: This file checks the server attribute publisher (src/gatt_publisher.c):
+ *                   unchanged values are not written to the GATT database, HTM readings are
+ *                   indicated anyway and coalesced while an indication is in flight, button
+ *                   values are queued for bonded clients only, a failed write is retried and
+ *                   a full queue drops.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+#define WRITE_API     "sl_bt_gatt_server_write_attribute_value"
+#define INDICATE_API  "sl_bt_gatt_server_send_indication"
+
+static ble_client_t *client;
+
+/*
+ * @brief Publishes a button state, indicated as flags byte then state as the server does
+ * @param state, the value
+ * @return true if it changed
+ */
+static bool publish_button(uint8_t state)
+{
+  uint8_t button_state[2] = { 0x00, state };
+
+  return gattPublish(gattdb_button_state, &button_state[1], 1, &button_state[0], sizeof(button_state));
+} // publish_button()
+
+/*
+ * @brief Publishes an HTM reading, indicated as flags byte then the value
+ * @param temperature, the value
+ * @return true if it changed
+ */
+static bool publish_htm(int32_t temperature)
+{
+  uint8_t htm[5] = { 0x00 };
+
+  memcpy(&htm[1], &temperature, sizeof(temperature));
+  return gattPublish(gattdb_temperature_measurement, (const uint8_t *) &temperature, sizeof(temperature),
+                     htm, sizeof(htm));
+} // publish_htm()
+
+/*
+ * @brief Returns a characteristic's counters
+ * @param characteristic, gattdb_* handle
+ * @return the counters
+ */
+static gatt_publisher_counters_t counters(uint16_t characteristic)
+{
+  gatt_publisher_counters_t result = { 0 };
+
+  CHECK(gattPublisherCounters(characteristic, &result));
+  return result;
+} // counters()
+
+/*
+ * @brief Caches values the tests never publish, then opens one bonded client with both
+ *        indications enabled and nothing in flight
+ * @param none
+ * @return none
+ */
+static void setup(void)
+{
+  ble_data_struct_t *ble_data_ptr = get_ble_data_ptr();
+
+  memset(ble_data_ptr->clients, 0, sizeof(ble_data_ptr->clients));
+  publish_button(0xEE);
+  publish_htm(-1);
+  hostReset();
+
+  client = &ble_data_ptr->clients[0];
+  client->in_use                     = true;
+  client->connection                 = 1;
+  client->bonding_flag               = true;
+  client->ok_to_send_htm_indications = true;
+  client->ok_to_send_PB0_indications = true;
+} // setup()
+
+/*
+ * @brief A button value equal to the last one is neither written nor indicated
+ */
+static void test_unchanged_button_skipped(void)
+{
+  gatt_publisher_counters_t before;
+  gatt_publisher_counters_t after;
+
+  setup();
+  before = counters(gattdb_button_state);
+  CHECK(publish_button(1));
+  client->indication_inflight = false; // confirmed
+  CHECK(!publish_button(1));
+  after = counters(gattdb_button_state);
+
+  CHECK_EQ(hostBtCount(WRITE_API), 1);
+  CHECK_EQ(hostBtCount(INDICATE_API), 1);
+  CHECK_EQ(after.writes - before.writes, 1);
+  CHECK_EQ(after.writes_avoided - before.writes_avoided, 1);
+  CHECK_EQ(after.sent - before.sent, 1);
+} // test_unchanged_button_skipped()
+
+/*
+ * @brief An HTM reading equal to the last one is not written but still indicated
+ */
+static void test_unchanged_htm_indicated(void)
+{
+  gatt_publisher_counters_t before;
+  gatt_publisher_counters_t after;
+
+  setup();
+  before = counters(gattdb_temperature_measurement);
+  CHECK(publish_htm(21000));
+  client->indication_inflight = false;
+  CHECK(!publish_htm(21000));
+  after = counters(gattdb_temperature_measurement);
+
+  CHECK_EQ(hostBtCount(WRITE_API), 1);
+  CHECK_EQ(hostBtCount(INDICATE_API), 2);
+  CHECK_EQ(after.writes_avoided - before.writes_avoided, 1);
+  CHECK_EQ(after.sent - before.sent, 2);
+} // test_unchanged_htm_indicated()
+
+/*
+ * @brief While an indication is in flight, only the newest HTM reading stays queued
+ */
+static void test_htm_coalesced(void)
+{
+  gatt_publisher_counters_t before;
+  gatt_publisher_counters_t after;
+  uint16_t                  handle;
+  size_t                    len;
+  uint8_t                   buffer[QUEUE_BUFFER_SIZE];
+  int32_t                   temperature;
+
+  setup();
+  client->indication_inflight = true;
+  before = counters(gattdb_temperature_measurement);
+  publish_htm(21000);
+  publish_htm(22000);
+  publish_htm(23000);
+  after = counters(gattdb_temperature_measurement);
+
+  CHECK_EQ(hostBtCount(INDICATE_API), 0);
+  CHECK_EQ(hostBtCount(WRITE_API), 3);
+  CHECK_EQ(after.queued - before.queued, 1);
+  CHECK_EQ(after.coalesced - before.coalesced, 2);
+  CHECK_EQ(get_queue_depth(&client->indication_queue), 1);
+  CHECK(read_queue(&client->indication_queue, &handle, &len, buffer) == WRITE_SUCCESS);
+  memcpy(&temperature, &buffer[1], sizeof(temperature));
+  CHECK_EQ(handle, gattdb_temperature_measurement);
+  CHECK_EQ(temperature, 23000);
+} // test_htm_coalesced()
+
+/*
+ * @brief While an indication is in flight, every button change is queued in order
+ */
+static void test_button_queued(void)
+{
+  gatt_publisher_counters_t before;
+  gatt_publisher_counters_t after;
+
+  setup();
+  client->indication_inflight = true;
+  before = counters(gattdb_button_state);
+  publish_button(1);
+  publish_button(0);
+  publish_button(1);
+  after = counters(gattdb_button_state);
+
+  CHECK_EQ(after.queued - before.queued, 3);
+  CHECK_EQ(after.coalesced - before.coalesced, 0);
+  CHECK_EQ(get_queue_depth(&client->indication_queue), 3);
+} // test_button_queued()
+
+/*
+ * @brief Button values are written but not indicated over a link that is not bonded
+ */
+static void test_button_bonded_only(void)
+{
+  setup();
+  client->bonding_flag = false;
+  CHECK(publish_button(1));
+  CHECK_EQ(hostBtCount(WRITE_API), 1);
+  CHECK_EQ(hostBtCount(INDICATE_API), 0);
+  CHECK_EQ(get_queue_depth(&client->indication_queue), 0);
+} // test_button_bonded_only()
+
+/*
+ * @brief A failed database write leaves the cache empty, the same value is written again
+ */
+static void test_write_failure_retried(void)
+{
+  gatt_publisher_counters_t before;
+  gatt_publisher_counters_t after;
+
+  setup();
+  before = counters(gattdb_button_state);
+  hostBtFailNext(WRITE_API, SL_STATUS_FAIL);
+  publish_button(1);
+  client->indication_inflight = false;
+  CHECK(publish_button(1));
+  after = counters(gattdb_button_state);
+
+  CHECK_EQ(hostBtCount(WRITE_API), 2);
+  CHECK_EQ(after.writes - before.writes, 1);
+  CHECK_EQ(after.writes_avoided - before.writes_avoided, 0);
+  CHECK_EQ(hostBtLast(WRITE_API)->data[0], 1);
+} // test_write_failure_retried()
+
+/*
+ * @brief A button change that finds the queue full is dropped
+ */
+static void test_full_queue_drops(void)
+{
+  gatt_publisher_counters_t before;
+  gatt_publisher_counters_t after;
+
+  setup();
+  client->indication_inflight = true;
+  before = counters(gattdb_button_state);
+  // The queue holds QUEUE_DEPTH - 1 elements
+  for (int i = 0; i < QUEUE_DEPTH; i++)
+    publish_button((uint8_t) (i & 1));
+  after = counters(gattdb_button_state);
+
+  CHECK_EQ(after.queued - before.queued, QUEUE_DEPTH - 1);
+  CHECK_EQ(after.dropped - before.dropped, 1);
+  CHECK_EQ(get_queue_depth(&client->indication_queue), QUEUE_DEPTH - 1);
+} // test_full_queue_drops()
+
+int main(void)
+{
+  gatt_publisher_counters_t unused;
+
+  hostReset(); // buttons up, PB0+PB1 held at boot would switch the role
+  app_init();
+  CHECK(!gattPublisherCounters(gattdb_device_name, &unused));
+  RUN(test_unchanged_button_skipped);
+  RUN(test_unchanged_htm_indicated);
+  RUN(test_htm_coalesced);
+  RUN(test_button_queued);
+  RUN(test_button_bonded_only);
+  RUN(test_write_failure_retried);
+  RUN(test_full_queue_drops);
+  return hostSummary("test_gatt_publisher");
+} // main()
@@ -0,0 +1,172 @@
+/*
+ * File name: test_link.c
+ * File description: This file runs the server firmware against the connection model of
+ *                   hostRun(): the Si7021 is read through the real state machine, the
+ *                   reading is indicated and confirmed, and the parameter and PHY requests
+ *                   of the firmware change the modelled connection.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// A central's first parameters, 30 ms and no latency
+#define OPEN_INTERVAL (24)
+
+/*
+ * @brief A subscribed client gets the temperature read from the Si7021, and confirms it
+ */
+static void test_temperature_indicated(void)
+{
+  const host_link_stats_t *stats;
+  const host_bt_call_t    *call;
+  ble_client_t            *client;
+
+  hostSi7021Set(21.0f);
+  hostLinkOpen(1, OPEN_INTERVAL, 0, 0);
+  hostLinkSubscribe(1, gattdb_temperature_measurement, sl_bt_gatt_indication);
+  hostRun(10000);
+
+  // A write and a read per sample
+  CHECK(hostI2cTransfers() >= 4);
+  CHECK((hostI2cTransfers() % 2) == 0);
+  call = hostBtLast("sl_bt_gatt_server_send_indication");
+  CHECK(call != NULL);
+  if (call != NULL)
+    {
+      CHECK_EQ(call->args[1], gattdb_temperature_measurement);
+      // IEEE-11073 FLOAT, mantissa in millidegrees, exponent -3
+      CHECK_EQ(call->data[1] | (call->data[2] << 8) | (call->data[3] << 16), 21000);
+      CHECK_EQ(call->data[4], 0xfd);
+    }
+  stats  = hostLinkStats(1);
+  client = &get_ble_data_ptr()->clients[0];
+  CHECK(stats != NULL);
+  if (stats != NULL)
+    {
+      CHECK(stats->confirmations > 0);
+      CHECK_EQ(stats->confirmations, client->indications);
+    }
+  CHECK(client->latency_max_ms > 0);
+  hostLinkClose(1);
+} // test_temperature_indicated()
+
+/*
+ * @brief Once the client has subscribed and gone quiet, the firmware relaxes the connection
+ *        and the modelled server skips events
+ */
+static void test_parameters_applied(void)
+{
+  const host_link_stats_t *stats;
+  uint32_t                 events, attended;
+
+  hostLinkOpen(1, OPEN_INTERVAL, 0, 0);
+  hostLinkSubscribe(1, gattdb_temperature_measurement, sl_bt_gatt_indication);
+  hostRun(30000);
+  stats = hostLinkStats(1);
+  CHECK(stats != NULL);
+  if (stats == NULL)
+    return;
+  CHECK_EQ(stats->interval, CONN_STEADY_INTERVAL_MAX);
+  CHECK_EQ(stats->latency, CONN_STEADY_LATENCY);
+  events   = stats->events;
+  attended = stats->attended;
+  hostRun(30000);
+  events   = stats->events - events;
+  attended = stats->attended - attended;
+  // One event in CONN_STEADY_LATENCY + 1 idle, two more for each 3 s indication
+  CHECK(events >= 59);
+  CHECK(attended <= (events / (CONN_STEADY_LATENCY + 1)) + (2 * 10) + 1);
+  CHECK(attended < events / 2);
+  hostLinkClose(1);
+} // test_parameters_applied()
+
+/*
+ * @brief Lost events only delay the confirmations
+ */
+static void test_loss_delays(void)
+{
+  const host_link_stats_t *stats;
+
+  hostLinkOpen(1, OPEN_INTERVAL, 0, 30);
+  hostLinkSubscribe(1, gattdb_temperature_measurement, sl_bt_gatt_indication);
+  hostRun(10000);
+  stats = hostLinkStats(1);
+  CHECK(stats != NULL);
+  if (stats == NULL)
+    return;
+  CHECK(stats->lost > 0);
+  CHECK(stats->confirmations > 0);
+  CHECK(stats->indications - stats->confirmations <= 1);
+  hostLinkClose(1);
+} // test_loss_delays()
+
+/*
+ * @brief A central that accepts 2M and one that refuses it: the firmware's airtime model
+ *        and the modelled radio time of the same readings follow the PHY of each
+ */
+static void test_phy_2m_and_fallback(void)
+{
+  const host_link_stats_t *fast;
+  const host_link_stats_t *slow;
+  link_model_t             model_2m;
+  link_model_t             model_1m;
+  uint64_t                 fast_us, slow_us;
+  uint32_t                 fast_confirmations, slow_confirmations;
+
+  hostLinkOpen(1, OPEN_INTERVAL, 0, 0);
+  hostLinkHoldPhy(true);
+  hostLinkOpen(2, OPEN_INTERVAL, 0, 0);
+  hostLinkSubscribe(1, gattdb_temperature_measurement, sl_bt_gatt_indication);
+  hostLinkSubscribe(2, gattdb_temperature_measurement, sl_bt_gatt_indication);
+  CHECK_EQ(hostBtCount("sl_bt_connection_set_preferred_phy"), 2);
+  hostRun(CONN_PARAMS_RELAX_DELAY_MS + 4000);
+
+  fast = hostLinkStats(1);
+  slow = hostLinkStats(2);
+  CHECK((fast != NULL) && (slow != NULL));
+  CHECK(linkGetModel(1, &model_2m));
+  CHECK(linkGetModel(2, &model_1m));
+  if ((fast == NULL) || (slow == NULL))
+    return;
+  CHECK_EQ(fast->phy, sl_bt_gap_phy_2m);
+  CHECK_EQ(model_2m.phy, LINK_PHY_2M);
+  // The refusal leaves the link on 1M, and it keeps working
+  CHECK_EQ(slow->phy, sl_bt_gap_phy_1m);
+  CHECK_EQ(model_1m.phy, LINK_PHY_1M);
+
+  // The same readings on both, from the same parameters on
+  fast_us            = fast->radio_us;
+  slow_us            = slow->radio_us;
+  fast_confirmations = fast->confirmations;
+  slow_confirmations = slow->confirmations;
+  hostRun(60000);
+  fast_us            = fast->radio_us - fast_us;
+  slow_us            = slow->radio_us - slow_us;
+  fast_confirmations = fast->confirmations - fast_confirmations;
+  slow_confirmations = slow->confirmations - slow_confirmations;
+  CHECK(fast_confirmations >= (60000 / LETIMER_PERIOD_MS) - 1);
+  CHECK_EQ(slow_confirmations, fast_confirmations);
+  CHECK(fast_us < slow_us);
+
+  // 2M sends a byte in half the time, the inter frame spaces stay
+  CHECK(model_2m.kbps > model_1m.kbps);
+  CHECK(model_2m.us_per_kb < model_1m.us_per_kb);
+  CHECK(model_2m.uj_per_kb < model_1m.uj_per_kb);
+  CHECK(model_2m.us_per_kb > model_1m.us_per_kb / 2);
+  printf("1M: ~%u kbps, ~%u uJ per KB, radio on %u.%03u ms/min\n", (unsigned int) model_1m.kbps,
+         (unsigned int) model_1m.uj_per_kb, (unsigned int) (slow_us / 1000), (unsigned int) (slow_us % 1000));
+  printf("2M: ~%u kbps, ~%u uJ per KB, radio on %u.%03u ms/min\n", (unsigned int) model_2m.kbps,
+         (unsigned int) model_2m.uj_per_kb, (unsigned int) (fast_us / 1000), (unsigned int) (fast_us % 1000));
+  hostLinkClose(1);
+  hostLinkClose(2);
+} // test_phy_2m_and_fallback()
+
+int main(void)
+{
+  RUN_BOOTED(test_temperature_indicated);
+  RUN_BOOTED(test_parameters_applied);
+  RUN_BOOTED(test_loss_delays);
+  RUN_BOOTED(test_phy_2m_and_fallback);
+  return hostSummary("test_link");
+} // main()
@@ -0,0 +1,79 @@
+/*
+ * File name: test_multi_client.c
+ * File description: This file benchmarks the multi-client server on the host harness: 1 to
+ *                   BLE_MAX_CLIENTS centrals connect and subscribe to HTM, the firmware runs
+ *                   for BENCH_RUN_MS and the indications confirmed and the confirmation
+ *                   latency of each client are printed. Each reading is read from the Si7021
+ *                   once and fanned out to every client, advertising continues while a slot
+ *                   is free.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// Simulated time of each run, and the HTM sample period of the server
+#define BENCH_RUN_MS        (60000)
+#define BENCH_SAMPLE_MS     (3000)
+// Time between two centrals connecting, and their first parameters (30 ms, no latency)
+#define BENCH_STAGGER_MS    (100)
+#define BENCH_OPEN_INTERVAL (24)
+
+static int clients; // centrals of the current run
+
+/*
+ * @brief Connects clients centrals, runs the firmware and prints each client's latency
+ */
+static void test_clients(void)
+{
+  ble_data_struct_t *ble_data = get_ble_data_ptr();
+  uint32_t           transfers;
+
+  for (int i = 0; i < clients; i++)
+    {
+      hostLinkOpen((uint8_t) (i + 1), BENCH_OPEN_INTERVAL, 0, 0);
+      hostLinkSubscribe((uint8_t) (i + 1), gattdb_temperature_measurement, sl_bt_gatt_indication);
+      hostRun(BENCH_STAGGER_MS);
+    }
+  CHECK_EQ(ble_data->client_count, clients);
+  CHECK_EQ(ble_data->advertising, clients < BLE_MAX_CLIENTS);
+
+  transfers = hostI2cTransfers();
+  hostRun(BENCH_RUN_MS);
+  // A write and a read per sample, whatever the number of clients
+  transfers = hostI2cTransfers() - transfers;
+  CHECK(transfers >= 2 * ((BENCH_RUN_MS / BENCH_SAMPLE_MS) - 1));
+  CHECK(transfers <= 2 * ((BENCH_RUN_MS / BENCH_SAMPLE_MS) + 1));
+
+  printf("%d client(s), %u Si7021 reads in %u s\n", clients, (unsigned int) (transfers / 2),
+         (unsigned int) (BENCH_RUN_MS / 1000));
+  for (int i = 0; i < BLE_MAX_CLIENTS; i++)
+    {
+      const ble_client_t      *client = &ble_data->clients[i];
+      const host_link_stats_t *stats;
+
+      if (!client->in_use)
+        continue;
+      stats = hostLinkStats(client->connection);
+      CHECK(stats != NULL);
+      if (stats == NULL)
+        continue;
+      printf("  client %d: %3u indications confirmed, latency avg %4u ms max %4u ms, interval %u.%02u ms latency %u\n",
+             (int) client->connection, (unsigned int) client->indications,
+             (unsigned int) ((client->indications) ? (client->latency_sum_ms / client->indications) : 0),
+             (unsigned int) client->latency_max_ms, (unsigned int) ((stats->interval * 125) / 100),
+             (unsigned int) ((stats->interval * 125) % 100), (unsigned int) stats->latency);
+      // Every reading reaches every client
+      CHECK(client->indications >= (BENCH_RUN_MS / BENCH_SAMPLE_MS) - 1);
+      CHECK(stats->indications - stats->confirmations <= 1);
+      // Confirmed within two events of the longest interval after the next anchor
+      CHECK(client->latency_max_ms <= (3 * CONN_STEADY_INTERVAL_MAX * 125) / 100);
+    }
+} // test_clients()
+
+int main(void)
+{
+  for (clients = 1; clients <= BLE_MAX_CLIENTS; clients++)
+    RUN_BOOTED(test_clients);
+  return hostSummary("test_multi_client");
+} // main()
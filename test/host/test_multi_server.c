@@ -0,0 +1,153 @@
+/*
+ * File name: test_multi_server.c
+ * File description: This file measures the multi-server client (BLE_MAX_SERVERS in
+ *                   src/ble.h) on the host harness. 1 to BLE_MAX_SERVERS peer servers
+ *                   advertise, the client connects to all of them, and the HTM samples it
+ *                   receives per minute from all servers together are printed for each
+ *                   count, with the reading to confirmation latency and the client's radio
+ *                   on time. Two servers connected seconds apart check that each
+ *                   connection's time since open is its own in src/ble_trace.c.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// Scan, connect and subscribe every server, then the steady sampling that is measured
+#define SETUP_MS    (10000)
+#define STEADY_MS   (60000)
+
+static uint32_t server_count = 0; // peers of the next test, set before RUN_BOOTED()
+
+/*
+ * @brief Sums the HTM samples the client received from every server
+ * @param none
+ * @return the samples
+ */
+static uint32_t client_samples(void)
+{
+  const ble_data_struct_t *ble_data = get_ble_data_ptr();
+  uint32_t                 samples  = 0;
+
+  for (int i = 0; i < BLE_MAX_SERVERS; i++)
+    samples += ble_data->servers[i].samples;
+  return samples;
+} // client_samples()
+
+/*
+ * @brief server_count servers are connected at once, every one of their readings reaches
+ *        the client
+ */
+static void test_aggregate_throughput(void)
+{
+  const host_peer_stats_t *stats[BLE_MAX_SERVERS];
+  uint32_t                 samples, confirmations = 0, peer_samples = 0;
+  uint64_t                 latency_sum_us = 0, radio_us = 0;
+  int                      peer[BLE_MAX_SERVERS];
+
+  for (uint32_t i = 0; i < server_count; i++)
+    {
+      // The first one is the client's SERVER_BT_ADDRESS, the others are found by their HTM UUID
+      bd_addr address = { { 0x66, 0x55, 0x44, 0x33, 0x22, (uint8_t) (0x11 + i) } };
+
+      peer[i] = hostPeerAdd(&address);
+      CHECK(peer[i] >= 0);
+    }
+  hostRun(SETUP_MS);
+  CHECK_EQ(get_ble_data_ptr()->server_count, server_count);
+
+  samples = client_samples();
+  for (uint32_t i = 0; i < server_count; i++)
+    {
+      stats[i]        = hostPeerStats(peer[i]);
+      confirmations  -= stats[i]->confirmations;
+      peer_samples   -= stats[i]->samples;
+      latency_sum_us -= stats[i]->latency_sum_us;
+      radio_us       -= hostLinkStats(stats[i]->connection)->radio_us;
+    }
+  hostRun(STEADY_MS);
+  samples = client_samples() - samples;
+  for (uint32_t i = 0; i < server_count; i++)
+    {
+      confirmations  += stats[i]->confirmations;
+      peer_samples   += stats[i]->samples;
+      latency_sum_us += stats[i]->latency_sum_us;
+      radio_us       += hostLinkStats(stats[i]->connection)->radio_us;
+    }
+
+  // One reading every 3 s from each server, none lost or confirmed twice
+  CHECK(samples >= (server_count * ((STEADY_MS / LETIMER_PERIOD_MS) - 1)));
+  CHECK(samples <= peer_samples);
+  CHECK_EQ(confirmations, samples);
+  printf("%u servers: %u HTM samples/min, latency avg %u ms, radio on %u.%03u ms/min\n",
+         (unsigned int) server_count, (unsigned int) ((samples * 60000) / STEADY_MS),
+         (unsigned int) ((samples > 0) ? (latency_sum_us / samples / 1000) : 0),
+         (unsigned int) (radio_us / 1000), (unsigned int) (radio_us % 1000));
+} // test_aggregate_throughput()
+
+/*
+ * @brief Milliseconds from a peer's last connection to now, on the hostRun() clock
+ * @param stats, the peer
+ * @return the time in ms
+ */
+static uint32_t ms_since_connected(const host_peer_stats_t *stats)
+{
+  return (uint32_t) (((((uint64_t) hostNowTicks() * 1000000) / HOST_SLEEPTIMER_HZ) - stats->connected_us) / 1000);
+} // ms_since_connected()
+
+/*
+ * @brief Two servers connected seconds apart: each connection's time since open is its
+ *        own, and the second one's cached reconnect leaves the kind of the traced first
+ *        connection alone
+ */
+static void test_staggered_opens(void)
+{
+  const bd_addr            second = { { 0x66, 0x55, 0x44, 0x33, 0x22, 0x12 } };
+  const bd_addr            first  = { { 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 } };
+  const host_peer_stats_t *stats[2];
+  int                      peer[2];
+  uint32_t                 procedures;
+
+  peer[0] = hostPeerAdd(&first);
+  hostRun(SETUP_MS);
+  peer[1] = hostPeerAdd(&second);
+  hostRun(SETUP_MS);
+  stats[0] = hostPeerStats(peer[0]);
+  stats[1] = hostPeerStats(peer[1]);
+  CHECK((stats[0] != NULL) && (stats[1] != NULL));
+  if ((stats[0] == NULL) || (stats[1] == NULL))
+    return;
+  CHECK_EQ(get_ble_data_ptr()->server_count, 2);
+  CHECK(stats[1]->connected_us > stats[0]->connected_us + (SETUP_MS * 1000 / 2));
+  for (int i = 0; i < 2; i++)
+    {
+      int32_t error_ms = (int32_t) bleTraceMsSinceOpen(stats[i]->connection) - (int32_t) ms_since_connected(stats[i]);
+
+      CHECK((error_ms >= -2) && (error_ms <= 2));
+    }
+  CHECK_EQ(bleTraceGetMetrics()->connection, stats[0]->connection);
+
+  // The second server reconnects from the cache while the first one is traced
+  procedures = stats[1]->procedures;
+  hostLinkClose(stats[1]->connection);
+  hostRun(SETUP_MS);
+  CHECK_EQ(get_ble_data_ptr()->server_count, 2);
+  CHECK_EQ(stats[1]->procedures - procedures, 3);
+  CHECK_EQ(bleTraceGetMetrics()->connection, stats[0]->connection);
+  CHECK_EQ(bleTraceGetMetrics()->kind, BLE_SCENARIO_CONNECT);
+  printf("staggered opens: %u ms and %u ms since open, the first connection traced as \"%s\"\n",
+         (unsigned int) bleTraceMsSinceOpen(stats[0]->connection), (unsigned int) bleTraceMsSinceOpen(stats[1]->connection),
+         (bleTraceGetMetrics()->kind == BLE_SCENARIO_CONNECT) ? "connect" : "cached reconnect");
+} // test_staggered_opens()
+
+int main(void)
+{
+  const bd_addr first = { { 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 } };
+
+  // Boot as the client of the first peer
+  roleSave(false, &first);
+  for (server_count = 1; server_count <= BLE_MAX_SERVERS; server_count++)
+    RUN_BOOTED(test_aggregate_throughput);
+  RUN_BOOTED(test_staggered_opens);
+  return hostSummary("test_multi_server");
+} // main()
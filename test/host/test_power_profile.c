@@ -0,0 +1,108 @@
+/*
+ * File name: test_power_profile.c
+ * File description: This file measures the power profiles (src/power_profile.c) on the
+ *                   host harness with one subscribed client. For each profile, the modelled
+ *                   average current of a minute of sampling (src/energy.c, the MCU sleeping
+ *                   in the lowest mode the EM requirements allow) and the error of a 1 s
+ *                   LETIMER0 delay against the clock LETIMER0 really runs at are printed,
+ *                   with the nominal clock and with the clock src/sampler.c calibrated
+ *                   against the sleeptimer. The model's ULFRCO runs at HOST_ULFRCO_HZ.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// Apply the profile on an underflow and calibrate its clock, then the sampling that is measured
+#define SETUP_MS    (3 * LETIMER_PERIOD_MS)
+#define STEADY_MS   (60000)
+
+typedef struct
+{
+  int      sleep_em;
+  uint32_t average_na;
+  uint32_t nominal_error_us;    // 1 s delay, timed with the nominal clock
+  uint32_t calibrated_error_us; // timed with the calibrated clock
+} profile_result_t;
+
+/*
+ * @brief Error of a 1 s delay timed in LETIMER0 ticks of one clock, on the real clock
+ * @param hz, the clock the ticks are worked out with
+ * @return error in us
+ */
+static uint32_t delay_error_us(uint32_t hz)
+{
+  uint32_t real_hz = hostLetimerHz();
+  uint32_t diff    = (hz > real_hz) ? (hz - real_hz) : (real_hz - hz);
+
+  return (uint32_t) (((uint64_t) diff * 1000000) / real_hz);
+} // delay_error_us()
+
+/*
+ * @brief Switches to a profile, then measures STEADY_MS of sampling
+ * @param profile, the profile
+ * @param result, out: the measurement
+ * @return none
+ */
+static void measure_profile(power_profile_t profile, profile_result_t *result)
+{
+  const ble_client_t *client     = &get_ble_data_ptr()->clients[0];
+  uint32_t            nominal_hz = (profile == POWER_PROFILE_PRECISE) ? (LFXO / LFXO_PRESCALER_VALUE)
+                                                                      : (ULFRCO / ULFRCO_PRESCALER_VALUE);
+  uint64_t            start_ms, end_ms, charge;
+  uint32_t            indications;
+
+  powerProfileSet(profile);
+  hostRun(SETUP_MS);
+  CHECK_EQ(powerProfileGet(), profile);
+  CHECK_EQ(hostLetimerHz(), (profile == POWER_PROFILE_PRECISE) ? (HOST_SLEEPTIMER_HZ / 4) : HOST_ULFRCO_HZ);
+
+  // The average since boot, less what came before
+  start_ms    = ((uint64_t) hostNowTicks() * 1000) / HOST_SLEEPTIMER_HZ;
+  charge      = (uint64_t) energyAverageNa() * start_ms;
+  indications = client->indications;
+  hostRun(STEADY_MS);
+  end_ms = ((uint64_t) hostNowTicks() * 1000) / HOST_SLEEPTIMER_HZ;
+  charge = (uint64_t) energyAverageNa() * end_ms - charge;
+  CHECK(client->indications - indications >= (STEADY_MS / LETIMER_PERIOD_MS) - 1);
+
+  result->sleep_em            = (int) hostSleepEm();
+  result->average_na          = (uint32_t) (charge / (end_ms - start_ms));
+  result->nominal_error_us    = delay_error_us(nominal_hz);
+  result->calibrated_error_us = delay_error_us(powerProfileLetimerHz());
+  // Within a clock tick, the calibration's resolution
+  CHECK(result->calibrated_error_us <= 1000000 / hostLetimerHz());
+  printf("%-9s: EM%d asleep, %u nA average, 1 s delay error %u us nominal, %u us calibrated (%d ppm), "
+         "%u us tick\n", (profile == POWER_PROFILE_PRECISE) ? "precise" : "ultra-low", result->sleep_em,
+         (unsigned int) result->average_na, (unsigned int) result->nominal_error_us,
+         (unsigned int) result->calibrated_error_us, (int) powerProfileErrorPpm(), (unsigned int) powerProfileMinUs());
+} // measure_profile()
+
+/*
+ * @brief ultra-low sleeps deeper for less current, its timing error is the ULFRCO's until
+ *        the calibration takes it out
+ */
+static void test_energy_and_error(void)
+{
+  profile_result_t precise, ultra_low;
+
+  hostLinkOpen(1, 24, 0, 0);
+  hostLinkSubscribe(1, gattdb_temperature_measurement, sl_bt_gatt_indication);
+  measure_profile(POWER_PROFILE_PRECISE, &precise);
+  measure_profile(POWER_PROFILE_ULTRA_LOW, &ultra_low);
+
+  CHECK_EQ(precise.sleep_em, SL_POWER_MANAGER_EM2);
+  CHECK_EQ(ultra_low.sleep_em, SL_POWER_MANAGER_EM3);
+  CHECK(ultra_low.average_na < precise.average_na);
+  CHECK_EQ(precise.nominal_error_us, 0);
+  CHECK(ultra_low.nominal_error_us > 10 * ultra_low.calibrated_error_us);
+  printf("ultra-low saves %u nA, %u us of 1 s delay error before calibration, %u us after\n",
+         (unsigned int) (precise.average_na - ultra_low.average_na), (unsigned int) ultra_low.nominal_error_us,
+         (unsigned int) ultra_low.calibrated_error_us);
+} // test_energy_and_error()
+
+int main(void)
+{
+  RUN_BOOTED(test_energy_and_error);
+  return hostSummary("test_power_profile");
+} // main()
@@ -0,0 +1,267 @@
+/*
+ * File name: test_replay.c
+ * File description: This file replays an event recorder dump (src/event_recorder.h) on
+ *                   the host. A live session runs in a child process: boot, a client that
+ *                   connects, enables HTM indications and disconnects, a button press and
+ *                   the LETIMER0 and sampler wakeups; its recorder ring is dumped through the
+ *                   firmware log. The dump is then fed to sl_bt_on_event() in a fresh copy of
+ *                   the firmware at the recorded times, and both runs must issue the same
+ *                   sl_bt commands. The replay is also timed, as fast as the host runs it.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "host.h"
+
+#define DUMP_FILE       "build/replay_dump.txt"
+#define LIVE_FILE       "build/replay_live.txt"
+#define REPLAYED_FILE   "build/replay_replayed.txt"
+
+// The stack delivers the pending external signals this often in the live session
+#define LIVE_STEP_MS    (10)
+#define LIVE_END_MS     (12000)
+
+/*
+ * @brief Hands one event with a few fields to the firmware
+ * @param id, sl_bt_evt_*_id
+ * @param evt, the fields
+ * @return none
+ */
+static void live_event(uint32_t id, sl_bt_msg_t evt)
+{
+  hostEvent(id, &evt);
+} // live_event()
+
+/*
+ * @brief One bounced edge of PB0
+ * @param level, the level it settles at
+ * @return none
+ */
+static void live_press(unsigned int level)
+{
+  hostPinEdge(PB0_port, PB0_pin, level);
+  hostAdvanceTicks(40);
+  hostPinEdge(PB0_port, PB0_pin, !level);
+  hostAdvanceTicks(60);
+  hostPinEdge(PB0_port, PB0_pin, level);
+} // live_press()
+
+/*
+ * @brief The live session, in the child process: every command goes to LIVE_FILE and the
+ *        recorder dump to DUMP_FILE
+ * @param none
+ * @return the exit status
+ */
+static int live_session(void)
+{
+  FILE        *dump    = fopen(DUMP_FILE, "w");
+  FILE        *journal = fopen(LIVE_FILE, "w");
+  sl_bt_msg_t  evt;
+
+  if ((dump == NULL) || (journal == NULL))
+    return 2;
+  hostReset();
+  app_init();
+  hostBtJournalTo(journal);
+
+  live_event(sl_bt_evt_system_boot_id, (sl_bt_msg_t) { 0 });
+  for (uint32_t ms = LIVE_STEP_MS; ms <= LIVE_END_MS; ms += LIVE_STEP_MS)
+    {
+      hostAdvanceMs(LIVE_STEP_MS);
+      switch (ms)
+      {
+        case 500:
+          memset(&evt, 0, sizeof(evt));
+          evt.data.evt_connection_opened.connection = 1;
+          evt.data.evt_connection_opened.bonding    = 0xFF;
+          live_event(sl_bt_evt_connection_opened_id, evt);
+          break;
+        case 600:
+          memset(&evt, 0, sizeof(evt));
+          evt.data.evt_connection_parameters.connection = 1;
+          evt.data.evt_connection_parameters.interval   = 24; // 30 ms
+          evt.data.evt_connection_parameters.timeout    = 100;
+          evt.data.evt_connection_parameters.txsize     = 27;
+          live_event(sl_bt_evt_connection_parameters_id, evt);
+          break;
+        case 1000:
+          memset(&evt, 0, sizeof(evt));
+          evt.data.evt_gatt_server_characteristic_status.connection          = 1;
+          evt.data.evt_gatt_server_characteristic_status.characteristic      = gattdb_temperature_measurement;
+          evt.data.evt_gatt_server_characteristic_status.status_flags        = sl_bt_gatt_server_client_config;
+          evt.data.evt_gatt_server_characteristic_status.client_config_flags = sl_bt_gatt_server_indication;
+          live_event(sl_bt_evt_gatt_server_characteristic_status_id, evt);
+          break;
+        case 2000:
+          live_press(0);
+          break;
+        case 2300:
+          live_press(1);
+          break;
+        case 9000:
+          memset(&evt, 0, sizeof(evt));
+          evt.data.evt_connection_closed.connection = 1;
+          evt.data.evt_connection_closed.reason     = SL_STATUS_BT_CTRL_REMOTE_USER_TERMINATED;
+          live_event(sl_bt_evt_connection_closed_id, evt);
+          break;
+        default:
+          break;
+      }
+      hostDeliverSignals();
+    }
+
+  hostBtJournalTo(NULL);
+  hostLogTo(dump);
+  eventRecorderDump();
+  hostLogTo(NULL);
+  fclose(dump);
+  fclose(journal);
+  return 0;
+} // live_session()
+
+/*
+ * @brief Replays DUMP_FILE in this process, every command goes to REPLAYED_FILE
+ * @param dropped, returns the records the ring lost
+ * @return the records replayed
+ */
+static uint32_t replay(uint32_t *dropped)
+{
+  FILE            *dump    = fopen(DUMP_FILE, "r");
+  FILE            *journal = fopen(REPLAYED_FILE, "w");
+  char             line[256];
+  uint32_t         records = 0;
+  struct timespec  start;
+  struct timespec  end;
+  double           elapsed_us;
+
+  *dropped = 0;
+  CHECK((dump != NULL) && (journal != NULL));
+  if ((dump == NULL) || (journal == NULL))
+    return 0;
+  app_init();
+  hostBtJournalTo(journal);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  while (fgets(line, sizeof(line), dump) != NULL)
+    {
+      const char   *rec = strstr(line, "rec ");
+      unsigned int  tick;
+      unsigned int  delta;
+      unsigned int  class_id;
+      unsigned int  record_dropped;
+      char          payload[2 * 32 + 1] = "";
+      sl_bt_msg_t   evt;
+
+      if (rec == NULL)
+        continue;
+      if (sscanf(rec, "rec start tick=%u hz=%*u records=%*u bytes=%*u recorded=%*u dropped=%u",
+                 &tick, &record_dropped) == 2)
+        {
+          *dropped = record_dropped;
+          hostAdvanceTicks(tick - hostNowTicks());
+          continue;
+        }
+      if (sscanf(rec, "rec +%u %4x %64s", &delta, &class_id, payload) < 2)
+        continue;
+
+      memset(&evt, 0, sizeof(evt));
+      for (size_t i = 0; (2 * i + 1) < strlen(payload); i++)
+        {
+          unsigned int byte;
+
+          sscanf(&payload[2 * i], "%2x", &byte);
+          ((uint8_t *) &evt.data)[i] = (uint8_t) byte;
+        }
+      // The timers run again on the way, the signals they post are in the recording
+      hostAdvanceTicks(delta);
+      (void) hostTakeSignals();
+      hostEvent(((class_id >> 8) << 16) | ((class_id & 0xff) << 24) | 0xa0, &evt);
+      records++;
+    }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  hostBtJournalTo(NULL);
+  fclose(dump);
+  fclose(journal);
+  elapsed_us = ((end.tv_sec - start.tv_sec) * 1e6) + ((end.tv_nsec - start.tv_nsec) / 1e3);
+  printf("replayed %u events, %.0f ms of recorded time in %.0f us, %.2f us per event\n",
+         (unsigned int) records, (hostNowTicks() * 1000.0) / HOST_SLEEPTIMER_HZ, elapsed_us,
+         (records > 0) ? (elapsed_us / records) : 0.0);
+  return records;
+} // replay()
+
+/*
+ * @brief Compares the commands of both runs, the external signals posted by timers and
+ *        button edges aside: the replay delivers them from the recording
+ * @param none
+ * @return the commands compared
+ */
+static uint32_t compare_journals(void)
+{
+  FILE     *live     = fopen(LIVE_FILE, "r");
+  FILE     *replayed = fopen(REPLAYED_FILE, "r");
+  char      a[256];
+  char      b[256];
+  uint32_t  compared = 0;
+  bool      more_a;
+  bool      more_b;
+
+  CHECK((live != NULL) && (replayed != NULL));
+  if ((live == NULL) || (replayed == NULL))
+    return 0;
+  for (;;)
+    {
+      while ((more_a = (fgets(a, sizeof(a), live) != NULL)) && (strstr(a, "sl_bt_external_signal") != NULL))
+        ;
+      while ((more_b = (fgets(b, sizeof(b), replayed) != NULL)) && (strstr(b, "sl_bt_external_signal") != NULL))
+        ;
+      if (!more_a || !more_b)
+        break;
+      if (strcmp(a, b) != 0)
+        {
+          printf("live:     %sreplayed: %s", a, b);
+          break;
+        }
+      compared++;
+    }
+  CHECK(!more_a && !more_b);
+  fclose(live);
+  fclose(replayed);
+  return compared;
+} // compare_journals()
+
+/*
+ * @brief The replay of a recorded session issues the commands of the session, in order
+ */
+static void test_replay_matches_live(void)
+{
+  pid_t    child;
+  int      status = -1;
+  uint32_t dropped;
+  uint32_t commands;
+
+  fflush(stdout);
+  child = fork();
+  if (child == 0)
+    _exit(live_session());
+  CHECK(child > 0);
+  waitpid(child, &status, 0);
+  CHECK(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+
+  CHECK(replay(&dropped) > 10);
+  CHECK_EQ(dropped, 0);
+  commands = compare_journals();
+  printf("%u commands issued by the replay as in the live session\n", (unsigned int) commands);
+  CHECK(commands > 10);
+} // test_replay_matches_live()
+
+int main(void)
+{
+  // app_init() runs once in each process, the live session's in the child
+  RUN(test_replay_matches_live);
+  return hostSummary("test_replay");
+} // main()
@@ -0,0 +1,141 @@
+/*
+ * File name: test_sampler.c
+ * File description: This file measures where the sampling period comes from (src/sampler.h)
+ *                   on the host harness, with one subscribed client and the ultra-low
+ *                   profile, the model's ULFRCO HOST_ULFRCO_HZ running 4.3% fast. The MCU's
+ *                   distinct wakeups per hour and the letimerMilliseconds() timestamp drift
+ *                   from real time over ten minutes are printed. The Makefile builds it for
+ *                   both sources, build/test_sampler samples on the sleeptimer, aligned to
+ *                   the connection events and calibrated, build/test_sampler_letimer on the
+ *                   LETIMER0 underflow interrupt.
+ * Date: 18-Oct-2026
+ * Author: Visweshwaran Baskaran viswesh.baskaran@colorado.edu
+ */
+
+#include "host.h"
+
+// Connect, apply the profile and relax the connection parameters, then the sampling that is measured
+#define SETUP_MS        (CONN_PARAMS_RELAX_DELAY_MS + 4000)
+#define STEADY_MS       (600000)
+// A central that keeps 500 ms and no latency, every connection event is attended
+#define HELD_INTERVAL   (400)
+// Calibrated, the drift at a sample stays well under a period, the measured LETIMER0 clock
+// within the count's resolution over a period, 1 in 3129 at HOST_ULFRCO_HZ
+#define MAX_SAMPLE_DRIFT_MS    (LETIMER_PERIOD_MS / 10)
+#define MAX_CALIBRATION_PPM    (1000)
+
+#if SAMPLER_ON_SLEEPTIMER
+#define SAMPLER_MODE    "sleeptimer"
+#define SAMPLE_WAKEUP   WAKEUP_SAMPLER
+#else
+#define SAMPLER_MODE    "LETIMER0 UF"
+#define SAMPLE_WAKEUP   WAKEUP_LETIMER0_UF
+#endif
+
+static power_profile_t profile = POWER_PROFILE_PRECISE; // of the next test, set before RUN_BOOTED()
+
+/*
+ * @brief Real time since boot
+ * @param none
+ * @return the time in ms
+ */
+static int64_t real_ms(void)
+{
+  return (int64_t) (((uint64_t) hostNowTicks() * 1000) / HOST_SLEEPTIMER_HZ);
+} // real_ms()
+
+#if SAMPLER_ON_SLEEPTIMER
+/*
+ * @brief The sampler's measured LETIMER0 clock against the model's
+ * @param measured_hz, sampler_counters_t measured_hz
+ * @return the error in ppm
+ */
+static int64_t calibration_error_ppm(uint32_t measured_hz)
+{
+  return (((int64_t) measured_hz - (int64_t) hostLetimerHz()) * 1000000) / hostLetimerHz();
+} // calibration_error_ppm()
+
+/*
+ * @brief Magnitude of an error
+ * @param ppm, the error
+ * @return |ppm|
+ */
+static int64_t abs_ppm(int64_t ppm)
+{
+  return (ppm < 0) ? -ppm : ppm;
+} // abs_ppm()
+#endif
+
+/*
+ * @brief Ten minutes of sampling in a profile, the wakeups and the drift are printed
+ */
+static void test_wakeups_and_drift(void)
+{
+  const host_link_stats_t *stats;
+  sampler_counters_t       counters;
+  uint32_t                 wakeups, shared, attended, samples;
+  int64_t                  drift_ms, abs_drift_ms;
+
+  powerProfileSet(profile);
+  hostLinkHoldParameters(true);
+  hostLinkOpen(1, HELD_INTERVAL, 0, 0);
+  hostLinkSubscribe(1, gattdb_temperature_measurement, sl_bt_gatt_indication);
+  hostRun(SETUP_MS);
+  stats = hostLinkStats(1);
+  CHECK(stats != NULL);
+  if (stats == NULL)
+    return;
+  CHECK_EQ(powerProfileGet(), profile);
+
+  wakeups  = hostWakeups()->wakeups;
+  shared   = hostWakeups()->shared;
+  attended = stats->attended;
+  samples  = energyGetWakeups(SAMPLE_WAKEUP);
+  hostRun(STEADY_MS);
+  wakeups      = hostWakeups()->wakeups - wakeups;
+  shared       = hostWakeups()->shared - shared;
+  attended     = stats->attended - attended;
+  samples      = energyGetWakeups(SAMPLE_WAKEUP) - samples;
+  samplerGetCounters(&counters);
+
+  CHECK(samples >= (STEADY_MS / LETIMER_PERIOD_MS) - 1);
+#if SAMPLER_ON_SLEEPTIMER
+  // letimerMilliseconds() moves a period at a time, the drift is the sampler's at the sample
+  // instants. Calibrated, it stays well under a period, the samples share the connection
+  // events' wakeups.
+  drift_ms     = counters.drift_ms;
+  abs_drift_ms = (drift_ms < 0) ? -drift_ms : drift_ms;
+  CHECK(counters.samples >= samples);
+  CHECK(abs_drift_ms <= counters.max_drift_ms);
+  CHECK(counters.max_drift_ms < MAX_SAMPLE_DRIFT_MS);
+  CHECK(abs_ppm(calibration_error_ppm(counters.measured_hz)) <= MAX_CALIBRATION_PPM);
+  if (profile != POWER_PROFILE_PRECISE)
+    CHECK_EQ(hostLetimerHz(), HOST_ULFRCO_HZ / ULFRCO_PRESCALER_VALUE);
+  CHECK(shared >= samples - 1);
+  printf("%s, %-9s: LETIMER0 measured %u Hz, %d ppm from the model's, drift %d ms at the last sample, "
+         "%d ms at most\n", SAMPLER_MODE, (profile == POWER_PROFILE_PRECISE) ? "precise" : "ultra-low",
+         (unsigned int) counters.measured_hz, (int) calibration_error_ppm(counters.measured_hz), (int) counters.drift_ms, (int) counters.max_drift_ms);
+#else
+  // The ULFRCO's error adds up, no sample instant to measure at but the underflow
+  drift_ms     = (int64_t) letimerMilliseconds() - real_ms();
+  abs_drift_ms = (drift_ms < 0) ? -drift_ms : drift_ms;
+  if (profile == POWER_PROFILE_PRECISE)
+    CHECK(abs_drift_ms <= LETIMER_PERIOD_MS);
+  else
+    CHECK(abs_drift_ms > (STEADY_MS / 100));
+#endif
+  printf("%s, %-9s: %u wakeups/hr, %u connection events/hr, %u samples/hr, %u wakeups/hr shared, "
+         "timestamp drift %d ms after %u s\n", SAMPLER_MODE, (profile == POWER_PROFILE_PRECISE) ? "precise" : "ultra-low",
+         (unsigned int) (((uint64_t) wakeups * MS_PER_HOUR) / STEADY_MS),
+         (unsigned int) (((uint64_t) attended * MS_PER_HOUR) / STEADY_MS),
+         (unsigned int) (((uint64_t) samples * MS_PER_HOUR) / STEADY_MS),
+         (unsigned int) (((uint64_t) shared * MS_PER_HOUR) / STEADY_MS), (int) drift_ms,
+         (unsigned int) (real_ms() / 1000));
+} // test_wakeups_and_drift()
+
+int main(void)
+{
+  for (profile = POWER_PROFILE_PRECISE; profile < POWER_PROFILE_COUNT; profile++)
+    RUN_BOOTED(test_wakeups_and_drift);
+  return hostSummary("test_sampler (" SAMPLER_MODE ")");
+} // main()